@@ -0,0 +1,172 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Estado de un AabbTree (ver AabbTree::getStats).
+struct AabbTreeStats {
+  size_t proxies = 0;      // Cajas en el rbol.
+  size_t nodes = 0;        // Nodos usados (hojas e internos).
+  int height = 0;          // Niveles debajo de la raz.
+  size_t updates = 0;      // Llamadas a update desde el ltimo resetCounters.
+  size_t reinserts = 0;    // De esas, las que tuvieron que mover la hoja.
+  float areaRatio = 0.0f;  // rea de los nodos internos / rea de la raz (menos es mejor).
+};
+
+// Choque de un rayo con la caja de un proxy (ver AabbTree::raycast).
+struct AabbRayHit {
+  void* userData = nullptr;
+  float distance = 0.0f;   // En unidades de la direccin del rayo.
+};
+
+/*
+ * Clase AabbTree
+ *
+ * ndice espacial de cajas alineadas a los ejes: un rbol binario dinmico
+ * (BVH) donde cada hoja es una caja con un puntero del usuario y cada nodo
+ * interno envuelve a sus dos hijos.
+ *
+ * Las hojas guardan la caja "gorda" (la real ms un margen): mientras la
+ * caja real quede dentro, update solo la anota y el rbol no cambia. Si
+ * sale, la hoja se quita y se vuelve a insertar bajando por donde menos
+ * crece el rea de los nodos, y al subir se hacen rotaciones que reducen
+ * el rea de los ancestros, as el rbol no se degrada con los cambios.
+ * Mover un objeto un poco no cuesta nada y moverlo lejos cuesta lo que
+ * mide el rbol de alto, sin reconstruirlo.
+ *
+ * Las consultas (caja, esfera, frustum y rayo) descartan subrboles enteros
+ * con la caja del nodo y prueban las hojas con la caja real.
+ *
+ * Los nmeros de proxy no cambian mientras el proxy exista. Las consultas
+ * se pueden hacer desde varios hilos a la vez mientras nadie lo modifique.
+ * No depende de Direct3D.
+ */
+class AabbTree {
+public:
+  // Proxy (u hoja, o nodo) que no existe.
+  static const uint32_t kInvalidProxy = 0xFFFFFFFFu;
+
+  /*
+   * 'margin' = cunto se agranda la caja real por cada lado al guardarla en
+   * el rbol (en unidades del mundo). Ms margen = menos reinserciones pero
+   * consultas menos precisas en los nodos.
+   */
+  explicit AabbTree(float margin = 0.1f);
+  ~AabbTree() = default;
+
+  // Agrega una caja; devuelve su proxy.
+  uint32_t
+    insert(const float min[3], const float max[3], void* userData);
+
+  void
+    remove(uint32_t proxy);
+
+  /*
+   * Cambia la caja del proxy. Devuelve true si la hoja se tuvo que mover en
+   * el rbol (la caja sali de la gorda, o la gorda qued demasiado grande).
+   */
+  bool
+    update(uint32_t proxy, const float min[3], const float max[3]);
+
+  void*
+    getUserData(uint32_t proxy) const { return m_leaves[proxy].userData; }
+
+  // Caja real del proxy (la ltima que se le pas).
+  const float*
+    getMin(uint32_t proxy) const { return m_leaves[proxy].min; }
+
+  const float*
+    getMax(uint32_t proxy) const { return m_leaves[proxy].max; }
+
+  // Agrega a 'results' los proxies cuya caja toca la caja [min, max].
+  void
+    queryAabb(const float min[3], const float max[3], std::vector<void*>& results) const;
+
+  // Agrega a 'results' los proxies cuya caja toca la esfera.
+  void
+    querySphere(const float center[3], float radius, std::vector<void*>& results) const;
+
+  /*
+   * Agrega a 'results' los proxies cuya caja no queda toda fuera de alguno
+   * de los seis planos (a, b, c, d), con a*x + b*y + c*z + d >= 0 adentro
+   * (ver frustumPlanes).
+   */
+  void
+    queryFrustum(const float planes[6][4], std::vector<void*>& results) const;
+
+  /*
+   * Agrega a 'hits' los proxies cuya caja cruza el rayo origin + t * direction
+   * con 0 <= t <= maxDistance, ordenados del ms cercano al ms lejano.
+   * Para seleccionar con el mouse, por ejemplo: el primero es el candidato
+   * ms cercano (quien llama puede probar la malla en ese orden).
+   */
+  void
+    raycast(const float origin[3], const float direction[3], float maxDistance,
+      std::vector<AabbRayHit>& hits) const;
+
+  /*
+   * Los seis planos del frustum de una matriz vista * proyeccin de 16
+   * floats por renglones (vectores fila, como XMMATRIX) con z de 0 a 1.
+   */
+  static void
+    frustumPlanes(const float viewProjection[16], float planes[6][4]);
+
+  // Proxies en el rbol.
+  size_t
+    size() const { return m_proxyCount; }
+
+  // Recorre todos los nodos (por areaRatio): para la UI, no para cada frame de un juego.
+  AabbTreeStats
+    getStats() const;
+
+  // Pone en cero los contadores de update y reinserts.
+  void
+    resetCounters() { m_updates = 0; m_reinserts = 0; }
+
+private:
+  struct Node {
+    float min[3];        // Caja del nodo (la gorda en las hojas).
+    float max[3];
+    uint32_t parent;     // En los nodos libres: siguiente libre.
+    uint32_t child1;     // kInvalidProxy en las hojas.
+    uint32_t child2;
+    int32_t height;      // 0 = hoja, -1 = libre.
+  };
+
+  // Datos de cada hoja, por el mismo nmero que su nodo.
+  struct Leaf {
+    float min[3];        // Caja real.
+    float max[3];
+    void* userData;
+  };
+
+  uint32_t
+    allocateNode();
+
+  void
+    freeNode(uint32_t node);
+
+  void
+    insertLeaf(uint32_t leaf);
+
+  void
+    removeLeaf(uint32_t leaf);
+
+  // Rotacin en 'node' si reduce el rea de sus hijos (ver el .cpp).
+  void
+    rotate(uint32_t node);
+
+  // Recalcula caja y altura de 'node' y sus ancestros (con rotaciones).
+  void
+    refitFrom(uint32_t node);
+
+  std::vector<Node> m_nodes;
+  std::vector<Leaf> m_leaves;
+  uint32_t m_root = kInvalidProxy;
+  uint32_t m_freeList = kInvalidProxy;
+  size_t m_proxyCount = 0;
+  size_t m_nodeCount = 0;
+  float m_margin;
+  size_t m_updates = 0;
+  size_t m_reinserts = 0;
+};
@@ -15,6 +15,9 @@
 #include "Model3D.h"
 #include "ECS/Actor.h"
 #include "UserInterface.h"
+#include "ECS/SystemScheduler.h"
+#include "ECS/CommandBuffer.h"
+#include "ECS/Query.h"
 
 /// Clase principal de la aplicacin.
 /// Administra la ventana, la inicializacin de DirectX y el ciclo de render.
@@ -53,6 +56,16 @@ public:
 		destroy();
 
 private:
+	/// Registra en m_scheduler los sistemas del frame (transforms, jerarqua,
+	/// actores y LOD) con los componentes y recursos que usa cada uno.
+	void
+		initSystems();
+
+	/// Actor ms cercano cuya caja cruza el rayo que sale de la cmara por el
+	/// punto (x, y) de la ventana, en pxeles; nullptr si no hay ninguno.
+	Actor*
+		pickActor(float x, float y);
+
 	/// Procedimiento de ventana para procesar mensajes de Windows.
 	/// \return Resultado del manejo del mensaje.
 	static LRESULT CALLBACK
@@ -117,6 +130,38 @@ private:
 
 	//XMFLOAT4                            m_vMeshColor;// (0.7f, 0.7f, 0.7f, 1.0f);
 
+	// Elige el nivel de detalle de los actores antes de dibujar.
+	LodSelector                         m_lodSelector;
+
+	// Cajas de los actores en espacio mundo: qu se dibuja (frustum) y qu
+	// se selecciona con el mouse (rayo). Cada actor mueve la suya en update.
+	AabbTree                            m_actorTree;
+	float                               m_frustumPlanes[6][4] = {};
+	std::vector<void*>                  m_visibleActors;   // Actor* a dibujar (queryFrustum y los que no estn en el rbol).
+
+	// Componentes de los actores por arquetipos (Transform, ActorRef, ...).
+	// Va antes de m_actors para que se destruya despus que ellos.
+	World                               m_world;
+
+	// Transforms del World que se recalcularon en el ltimo update.
+	size_t                              m_dirtyTransforms = 0;
+
+	// Actores a los que les cambi el Transform o la malla: el sistema
+	// Actors solo actualiza esos (ver initSystems).
+	Query<ActorRef>                     m_changedActors{ m_world };
+	size_t                              m_updatedActors = 0;
+
+	// Jerarqua padre/hijo de los actores (matrices mundo).
+	// Tambin va antes de m_actors: Actor::destroy saca su nodo.
+	SceneGraph                          m_sceneGraph;
+
+	// Corre los sistemas del frame en varios hilos (ver initSystems).
+	SystemScheduler                     m_scheduler;
+
+	// Cambios estructurales del World que anotan los sistemas (un buffer por
+	// hilo); se aplican en update cuando termina m_scheduler.run.
+	CommandQueue                        m_commands;
+
 	// Lista de actores presentes en la escena.
 	std::vector<EU::TSharedPointer<Actor>> m_actors;
 
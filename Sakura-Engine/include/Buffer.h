@@ -25,7 +25,7 @@ public:
    *
    * Segn el bindFlag el buffer se usa como:
    * - D3D11_BIND_VERTEX_BUFFER  -> guarda vrtices
-   * - D3D11_BIND_INDEX_BUFFER   -> guarda ndices
+   * - D3D11_BIND_INDEX_BUFFER   -> guarda ndices (16 bits si mesh.m_indexWidth es 2)
    */
   HRESULT
     init(Device& device, const MeshComponent& mesh, unsigned int bindFlag);
@@ -59,7 +59,8 @@ public:
    *
    * El comportamiento depende del tipo de buffer:
    * - Si es vertex buffer: se llama a IASetVertexBuffers.
-   * - Si es index buffer: se llama a IASetIndexBuffer.
+   * - Si es index buffer: se llama a IASetIndexBuffer. Si format es
+   *   DXGI_FORMAT_UNKNOWN se usa R16_UINT o R32_UINT segn cmo se cre.
    * - Si es constant buffer: se enlaza al VS y opcionalmente al PS.
    */
   void
@@ -92,7 +93,7 @@ private:
   // Puntero al buffer de Direct3D (vrtices, ndices o constantes)
   ID3D11Buffer* m_buffer = nullptr;
 
-  // Tamao de cada elemento en bytes (solo importa en vertex buffers)
+  // Tamao de cada elemento en bytes (vrtice, o 2/4 bytes por ndice)
   unsigned int m_stride = 0;
 
   // Desplazamiento inicial en bytes para el buffer (normalmente 0)
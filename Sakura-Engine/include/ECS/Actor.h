@@ -8,11 +8,21 @@
 //#include "Rasterizer.h"
 //#include "BlendState.h"
 #include "ShaderProgram.h"
+#include "LodSelector.h"
+#include "AabbTree.h"
 //#include "DepthStencilState.h"
 
 class Device;
 class DeviceContext;
 class MeshComponent;
+class Actor;
+
+/// <summary>
+/// Componente del World que lleva de la entidad al Actor que la cre.
+/// </summary>
+struct ActorRef {
+  Actor* actor = nullptr;
+};
 
 /// <summary>
 /// Representa una entidad grfica con mallas, texturas y recursos de renderizado.
@@ -69,12 +79,141 @@ public:
 
   /// <summary>
   /// Establece las mallas del actor y crea los buffers de vrtices/ndices.
+  /// Tambin carga la textura de cada submalla que tenga una (map_Kd del .mtl).
   /// </summary>
   /// <param name="device">Dispositivo usado para inicializar los buffers.</param>
   /// <param name="meshes">Vector de componentes de malla.</param>
   void
     setMesh(Device& device, std::vector<MeshComponent> meshes);
 
+  /// <summary>
+  /// Programa de shaders con el que se dibuja el actor. Se usa para enlazar el
+  /// Input Layout de cada malla; sin l, setMesh sube todas las mallas en Full.
+  /// Se llama antes de setMesh.
+  /// </summary>
+  /// <param name="shaderProgram">Programa de shaders (no se toma la propiedad).</param>
+  void
+    setShaderProgram(ShaderProgram* shaderProgram) { m_shaderProgram = shaderProgram; }
+
+  /// <summary>
+  /// Agrega un nivel de detalle hecho a mano (por ejemplo Alien_LOD1.fbx). Se
+  /// llama despus de setMesh, del ms detallado al ms simple. Los niveles
+  /// a mano reemplazan a los que setMesh arma con MeshComponent::m_lods.
+  /// </summary>
+  /// <param name="device">Dispositivo usado para crear los buffers.</param>
+  /// <param name="meshes">Mallas del nivel (con sus propios vrtices).</param>
+  /// <param name="screenSize">Tamao en pantalla por debajo del cual se usa el nivel (ver LodThreshold).</param>
+  void
+    addLod(Device& device, std::vector<MeshComponent> meshes, float screenSize);
+
+  /// <summary>
+  /// Selector que elige el nivel de detalle del actor en cada frame. Sin
+  /// selector el actor siempre se dibuja con LOD0.
+  /// </summary>
+  /// <param name="lodSelector">Selector de la escena (no se toma la propiedad).</param>
+  void
+    setLodSelector(LodSelector* lodSelector);
+
+  /// <summary>
+  /// ndice espacial de la escena: el actor mete ah su caja en espacio
+  /// mundo (con el Actor* como dato) y la mueve cada vez que la recalcula.
+  /// Con nullptr sale del ndice.
+  /// </summary>
+  /// <param name="aabbTree">ndice de la escena (no se toma la propiedad).</param>
+  void
+    setAabbTree(AabbTree* aabbTree);
+
+  /// <summary>
+  /// true si el actor tiene caja en un AabbTree (ver setAabbTree). Los que
+  /// no tienen no se pueden recortar con el frustum.
+  /// </summary>
+  bool
+    isInAabbTree() const { return m_treeProxy != AabbTree::kInvalidProxy; }
+
+  /// <summary>
+  /// Pasa el Transform del actor al World: queda junto a los de los dems
+  /// actores (con un ActorRef) y getComponent&lt;Transform&gt; lo lee de ah.
+  /// Quien tenga el World actualiza esos Transform (World::forEach) antes
+  /// de Actor::update. Con nullptr el Transform vuelve a ser del actor.
+  /// </summary>
+  /// <param name="world">World de la escena (no se toma la propiedad).</param>
+  void
+    setWorld(World* world);
+
+  /// <summary>
+  /// Mete al actor en la jerarqua de la escena (un nodo por actor, ver
+  /// Transform::getSceneNode). Su matriz mundo pasa a ser la del SceneGraph:
+  /// la del Transform por la del padre. El actor debe estar en el World,
+  /// porque quien lo tiene pasa las matrices locales al SceneGraph y llama
+  /// a SceneGraph::update antes de Actor::update. Con nullptr sale de la
+  /// jerarqua (sus hijos quedan colgados de su padre).
+  /// </summary>
+  /// <param name="sceneGraph">Jerarqua de la escena (no se toma la propiedad).</param>
+  void
+    setSceneGraph(SceneGraph* sceneGraph);
+
+  /// <summary>
+  /// Cuelga al actor de 'parent' (nullptr = raz). Los dos deben estar en el
+  /// mismo SceneGraph; no hace nada si eso formara un ciclo.
+  /// </summary>
+  /// <param name="parent">Actor padre, o nulo.</param>
+  void
+    setParent(Actor* parent);
+
+  /// <summary>
+  /// Nivel de detalle con el que se dibuj el ltimo frame (0 = mximo detalle).
+  /// </summary>
+  unsigned int
+    getLodLevel() const { return m_lodLevel; }
+
+  /// <summary>
+  /// Nmero de niveles de detalle, contando el LOD0.
+  /// </summary>
+  unsigned int
+    getLodCount() const { return static_cast<unsigned int>(m_lodLevels.size()) + 1; }
+
+  /// <summary>
+  /// Matriz mundo del actor: la del SceneGraph si est en uno, si no la del Transform.
+  /// </summary>
+  XMMATRIX
+    getWorldMatrix();
+
+  /// <summary>
+  /// Cambia cada vez que cambia la matriz mundo (SceneGraph::getWorldVersion
+  /// o Transform::getVersion). Nunca es 0.
+  /// </summary>
+  uint32_t
+    getWorldVersion();
+
+  /// <summary>
+  /// true si el constant buffer y los volmenes del actor ya son de la
+  /// matriz mundo actual (update no tendra nada que subir).
+  /// </summary>
+  bool
+    isWorldCurrent() {
+    const uint32_t worldVersion = getWorldVersion();
+    return m_modelVersion == worldVersion && m_boundsVersion == worldVersion;
+  }
+
+  /// <summary>
+  /// Caja alineada a los ejes en espacio mundo. Se recalcula en update solo
+  /// cuando cambia la matriz mundo (ver getWorldVersion).
+  /// </summary>
+  const XMFLOAT3&
+    getWorldAabbMin() const { return m_worldAabbMin; }
+
+  const XMFLOAT3&
+    getWorldAabbMax() const { return m_worldAabbMax; }
+
+  /// <summary>
+  /// Esfera envolvente en espacio mundo (se actualiza junto con la caja).
+  /// </summary>
+  const XMFLOAT3&
+    getWorldSphereCenter() const { return m_worldSphereCenter; }
+
+  float
+    getWorldSphereRadius() const { return m_worldSphereRadius; }
+
   /// <summary>
   /// Obtiene el nombre del actor.
   /// </summary>
@@ -118,16 +257,117 @@ public:
     renderShadow(DeviceContext& deviceContext);
 
 private:
+  /// <summary>
+  /// Nivel de detalle LOD1 en adelante. Los generados (MeshComponent::m_lods)
+  /// usan los vertex buffers del LOD0 y solo tienen index buffers propios.
+  /// </summary>
+  struct LodLevel {
+    std::vector<MeshComponent> meshes;
+    std::vector<Buffer> vertexBuffers;   // Vaco si sharesVertices.
+    std::vector<Buffer> indexBuffers;
+    std::vector<Buffer> modelBuffers;    // Constant buffer de cada malla empacada (ver createBuffers).
+    uint32_t modelVersion = 0;           // m_modelVersion con la que se llenaron los modelBuffers.
+    std::vector<std::vector<int>> subMeshTexture;
+    LodThreshold threshold;
+    bool sharesVertices = false;
+  };
+
+  /// <summary>
+  /// Crea los vertex buffers (si 'vertexBuffers' no es nulo), los index
+  /// buffers y un constant buffer por malla empacada en 'modelBuffers' (uno
+  /// por malla; el de las Full se queda vaco). Las mallas empacadas sin
+  /// layout pasan a Full.
+  /// </summary>
+  void
+    createBuffers(Device& device,
+      std::vector<MeshComponent>& meshes,
+      std::vector<Buffer>* vertexBuffers,
+      std::vector<Buffer>& indexBuffers,
+      std::vector<Buffer>& modelBuffers);
+
+  /// <summary>
+  /// Arma los niveles generados a partir de MeshComponent::m_lods de m_meshes.
+  /// </summary>
+  void
+    buildGeneratedLods(Device& device);
+
+  /// <summary>
+  /// Libera los buffers de m_lodLevels y los vaca.
+  /// </summary>
+  void
+    destroyLods();
+
+  /// <summary>
+  /// Lleva la caja y la esfera locales a espacio mundo con la matriz mundo.
+  /// </summary>
+  void
+    updateWorldBounds();
+  /// <summary>
+  /// Pasa los umbrales de m_lodLevels al selector.
+  /// </summary>
+  void
+    updateLodSelector();
+
+  /// <summary>
+  /// Dibuja un nivel de detalle completo (todas sus mallas y submallas).
+  /// Los constant buffers de las mallas empacadas se llenan solo si
+  /// 'modelVersion' qued atrs de m_modelVersion.
+  /// </summary>
+  void
+    renderMeshes(DeviceContext& deviceContext,
+      const std::vector<MeshComponent>& meshes,
+      std::vector<Buffer>& vertexBuffers,
+      std::vector<Buffer>& indexBuffers,
+      std::vector<Buffer>& modelBuffers,
+      uint32_t& modelVersion,
+      const std::vector<std::vector<int>>& subMeshTexture);
+
+  /// <summary>
+  /// Carga las texturas de las submallas de 'meshes' y llena 'subMeshTexture'.
+  /// Las rutas repetidas se cargan una sola vez, tambin entre niveles.
+  /// </summary>
+  /// <param name="device">Dispositivo usado para crear las texturas.</param>
+  /// <param name="meshes">Mallas cuyas submallas se revisan.</param>
+  /// <param name="subMeshTexture">Por malla y submalla: ndice en m_materialTextures o -1.</param>
+  void
+    loadSubMeshTextures(Device& device,
+      const std::vector<MeshComponent>& meshes,
+      std::vector<std::vector<int>>& subMeshTexture);
+
   std::vector<MeshComponent> m_meshes;   // Conjunto de mallas del actor.
   std::vector<Texture> m_textures;       // Texturas aplicadas al actor.
   std::vector<Buffer> m_vertexBuffers;   // Buffers de vrtices por malla.
   std::vector<Buffer> m_indexBuffers;    // Buffers de ndices por malla.
+  std::vector<Buffer> m_meshModelBuffers; // Constant buffer por malla empacada (vaco en las Full).
+  uint32_t m_meshModelVersion = 0;       // m_modelVersion con la que se llenaron (0 = nunca).
+  std::vector<Texture> m_materialTextures; // Texturas de los materiales de las submallas.
+  std::vector<std::string> m_materialTexturePaths; // Ruta de cada textura de m_materialTextures.
+  std::vector<std::vector<int>> m_subMeshTexture; // Por malla y submalla: ndice en m_materialTextures o -1.
+
+  std::vector<LodLevel> m_lodLevels;     // LOD1 en adelante.
+  LodSelector* m_lodSelector = nullptr;  // Selector de la escena (no se toma la propiedad).
+  uint32_t m_lodSlot = LodSelector::kInvalidSlot;
+  unsigned int m_lodLevel = 0;           // Nivel dibujado en el ltimo frame.
+  XMFLOAT3 m_boundsCenter = XMFLOAT3(0.0f, 0.0f, 0.0f); // Esfera envolvente del LOD0 en espacio local.
+  float m_boundsRadius = 0.0f;
+  XMFLOAT3 m_localAabbMin = XMFLOAT3(0.0f, 0.0f, 0.0f);  // Caja del LOD0 en espacio local.
+  XMFLOAT3 m_localAabbMax = XMFLOAT3(0.0f, 0.0f, 0.0f);
+  XMFLOAT3 m_worldAabbMin = XMFLOAT3(0.0f, 0.0f, 0.0f);  // Caja en espacio mundo.
+  XMFLOAT3 m_worldAabbMax = XMFLOAT3(0.0f, 0.0f, 0.0f);
+  XMFLOAT3 m_worldSphereCenter = XMFLOAT3(0.0f, 0.0f, 0.0f);
+  float m_worldSphereRadius = 0.0f;
+  AabbTree* m_aabbTree = nullptr;        // ndice espacial de la escena (no se toma la propiedad).
+  uint32_t m_treeProxy = AabbTree::kInvalidProxy;
+  uint32_t m_boundsVersion = 0;          // getWorldVersion con la que se calcularon (0 = nunca).
+  uint32_t m_modelVersion = 0;           // getWorldVersion de lo que hay en m_modelBuffer (0 = nada).
+  SceneGraph* m_sceneGraph = nullptr;    // Jerarqua de la escena (no se toma la propiedad).
 
   //BlendState m_blendstate;             // Estado de blending (no usado actualmente).
   //Rasterizer m_rasterizer;             // Estado de rasterizacin (no usado actualmente).
   SamplerState m_sampler;                // Sampler para las texturas del actor.
   CBChangesEveryFrame m_model;           // Datos por modelo (matriz mundo y color).
   Buffer m_modelBuffer;                  // Constant buffer que almacena m_model.
+  ShaderProgram* m_shaderProgram = nullptr; // Programa con los layouts de vrtices empacados.
 
   // Recursos para sombras
   ShaderProgram m_shaderShadow;          // Shader program para renderizar sombras.
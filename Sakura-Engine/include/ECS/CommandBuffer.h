@@ -0,0 +1,167 @@
+#pragma once
+#include "ECS/World.h"
+
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+/// <summary>
+/// Tipo de cambio estructural guardado en un CommandBuffer.
+/// </summary>
+enum class CommandType : uint8_t {
+  Create,
+  Destroy,
+  Add,
+  Remove
+};
+
+/// <summary>
+/// Cambios estructurales del World (create, destroy, add, remove) anotados
+/// para despus. Los componentes se copian a una arena lineal de bloques que
+/// se reutiliza frame tras frame. No es seguro usar el mismo buffer desde
+/// dos hilos: cada hilo usa el suyo (CommandQueue::local).
+/// </summary>
+class CommandBuffer {
+public:
+  CommandBuffer() = default;
+  ~CommandBuffer();
+
+  /// <summary>
+  /// Anota una entidad nueva. Devuelve un handle pendiente (ver isPending)
+  /// que solo sirve para los comandos de este mismo buffer; al reproducir
+  /// se cambia por el handle real.
+  /// </summary>
+  EntityHandle
+    create();
+
+  void
+    destroy(EntityHandle entity);
+
+  /// <summary>
+  /// Anota agregar (o reemplazar) el componente T.
+  /// </summary>
+  template <typename T>
+  void
+    add(EntityHandle entity, T component = T()) {
+    Command& command = push(CommandType::Add, ComponentTypes::id<T>(), entity);
+    command.payload = new (allocate(sizeof(T), alignof(T))) T(std::move(component));
+    if constexpr (IsSparseComponent<T>::value) {
+      command.addSparse = [](World& world, EntityHandle target, void* payload) {
+        world.add<T>(target, std::move(*static_cast<T*>(payload)));
+      };
+    }
+  }
+
+  template <typename T>
+  void
+    remove(EntityHandle entity) {
+    Command& command = push(CommandType::Remove, ComponentTypes::id<T>(), entity);
+    if constexpr (IsSparseComponent<T>::value) {
+      command.removeSparse = [](World& world, EntityHandle target) { world.remove<T>(target); };
+    }
+  }
+
+  /// <summary>
+  /// true si el handle lo dio create de un CommandBuffer y an no se reproduce.
+  /// </summary>
+  static bool
+    isPending(EntityHandle entity) { return entity.generation == 0 && !entity.isNull(); }
+
+  size_t
+    size() const { return m_commands.size(); }
+
+  bool
+    empty() const { return m_commands.empty(); }
+
+private:
+  friend class CommandQueue;
+
+  CommandBuffer(const CommandBuffer&) = delete;
+  CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+  struct Command {
+    CommandType type = CommandType::Create;
+    uint32_t typeId = 0;
+    EntityHandle entity;
+    void* payload = nullptr;   // Componente en la arena (Add).
+    void (*addSparse)(World&, EntityHandle, void*) = nullptr;   // Solo tipos dispersos.
+    void (*removeSparse)(World&, EntityHandle) = nullptr;
+  };
+
+  struct Block {
+    unsigned char* data = nullptr;
+    size_t size = 0;
+  };
+
+  Command&
+    push(CommandType type, uint32_t typeId, EntityHandle entity);
+
+  // Memoria de la arena alineada a 'align' (vlida hasta clear).
+  void*
+    allocate(size_t size, size_t align);
+
+  // Destruye los componentes que quedaron en la arena y la rebobina (sin liberar bloques).
+  void
+    clear();
+
+  std::vector<Command> m_commands;
+  std::vector<Block> m_blocks;
+  size_t m_block = 0;       // Bloque en uso.
+  size_t m_offset = 0;      // Siguiente byte libre del bloque en uso.
+  uint32_t m_created = 0;   // Entidades pendientes anotadas (ndices de los handles pendientes).
+};
+
+/// <summary>
+/// Resultado de la ltima CommandQueue::playback.
+/// </summary>
+struct CommandStats {
+  size_t commands = 0;     // Comandos reproducidos.
+  size_t created = 0;
+  size_t destroyed = 0;
+  size_t moves = 0;        // Cambios de arquetipo (uno por entidad aunque tuviera varios comandos).
+  size_t dropped = 0;      // Comandos sobre entidades que ya no existan.
+  double seconds = 0.0;
+};
+
+/// <summary>
+/// Un CommandBuffer por hilo y el punto donde se aplican al World.
+///
+/// Los sistemas (en cualquier hilo) anotan sus cambios en local() sin tomar
+/// candados; solo la primera vez que un hilo usa la cola se registra su
+/// buffer. playback, que se llama cuando nadie est anotando (en BaseApp
+/// despus de SystemScheduler::run), crea las entidades pendientes, ordena
+/// los comandos por entidad y aplica los de cada entidad juntos: como mucho
+/// un cambio de arquetipo por entidad. Dentro de un buffer se respeta el
+/// orden en que se anotaron; entre buffers de hilos distintos el orden no
+/// est definido. destroy gana sobre cualquier otro comando de la entidad.
+/// </summary>
+class CommandQueue {
+public:
+  CommandQueue();
+  ~CommandQueue() = default;
+
+  /// <summary>
+  /// Buffer del hilo que llama.
+  /// </summary>
+  CommandBuffer&
+    local();
+
+  /// <summary>
+  /// Aplica y vaca todos los buffers.
+  /// </summary>
+  void
+    playback(World& world);
+
+  const CommandStats&
+    getLastStats() const { return m_lastStats; }
+
+private:
+  CommandQueue(const CommandQueue&) = delete;
+  CommandQueue& operator=(const CommandQueue&) = delete;
+
+  const uint64_t m_id;   // Distingue esta cola en la cach por hilo de local().
+  std::mutex m_mutex;    // Solo para registrar buffers nuevos.
+  std::vector<std::unique_ptr<CommandBuffer>> m_buffers;
+  std::unordered_map<std::thread::id, CommandBuffer*> m_bufferByThread;
+  CommandStats m_lastStats;
+};
@@ -8,6 +8,9 @@ class DeviceContext;
  *
  * La clase Component define la interfaz bsica que todos los componentes deben implementar,
  * permitiendo actualizar y renderizar el componente, as como obtener su tipo.
+ * Cada componente concreto declara su tipo en tiempo de compilacin
+ * (static constexpr ComponentType kType) para que Entity lo encuentre
+ * sin dynamic_cast.
  */
 class
   Component {
@@ -56,5 +59,5 @@ public:
   ComponentType
     getType() const { return m_type; }
 protected:
-  ComponentType m_type; ///< Tipo del componente.
+  ComponentType m_type = NONE; ///< Tipo del componente.
 };
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include "Prerequisites.h"
 #include "Component.h"
+#include "World.h"
+#include <cstring>
 
 class DeviceContext;
 
@@ -59,29 +61,88 @@ public:
   template <typename T> void
     addComponent(EU::TSharedPointer<T> component) {
     static_assert(std::is_base_of<Component, T>::value, "T must be derived from Component");
-    m_components.push_back(component.template dynamic_pointer_cast<Component>());
+    if (m_componentSlots[T::kType] == 0) {
+      m_componentSlots[T::kType] = static_cast<uint8_t>(m_components.size() + 1);
+    }
+    // Conversin a la base sin RTTI: comparte el mismo recuento de referencias.
+    m_components.push_back(EU::TSharedPointer<Component>(component.get(), component.refCount));
+  }
+
+  /// <summary>
+  /// Quita el componente de tipo T de la entidad (si lo tiene).
+  /// </summary>
+  /// <typeparam name="T">Tipo del componente a quitar.</typeparam>
+  template <typename T> void
+    removeComponent() {
+    const uint8_t slot = m_componentSlots[T::kType];
+    if (slot == 0) {
+      return;
+    }
+    m_components.erase(m_components.begin() + (slot - 1));
+
+    // Los componentes que venan despus recorren su lugar.
+    std::memset(m_componentSlots, 0, sizeof(m_componentSlots));
+    for (size_t i = m_components.size(); i-- > 0;) {
+      const ComponentType type = m_components[i]->getType();
+      if (type < MAX_COMPONENT_TYPES) {
+        m_componentSlots[type] = static_cast<uint8_t>(i + 1);
+      }
+    }
   }
 
   /// <summary>
-  /// Obtiene un componente de la entidad por su tipo.
+  /// Obtiene un componente de la lista de la entidad por su tipo.
+  /// Solo busca en m_components: un componente que vive en el World (el
+  /// Transform de un Actor despus de setWorld) no tiene recuento de
+  /// referencias que compartir, as que para esos se usa getComponentPtr.
   /// </summary>
   /// <typeparam name="T">Tipo del componente a obtener.</typeparam>
-  /// <returns>Puntero compartido al componente si se encuentra; vaco en caso contrario.</returns>
+  /// <returns>Puntero compartido al componente si est en la lista; vaco en caso contrario.</returns>
   template<typename T>
   EU::TSharedPointer<T>
     getComponent() {
-    for (auto& component : m_components) {
-      EU::TSharedPointer<T> specificComponent = component.template dynamic_pointer_cast<T>();
-      if (specificComponent) {
-        return specificComponent;
+    const uint8_t slot = m_componentSlots[T::kType];
+    if (slot == 0) {
+      return EU::TSharedPointer<T>();
+    }
+    const EU::TSharedPointer<Component>& component = m_components[slot - 1];
+    return EU::TSharedPointer<T>(static_cast<T*>(component.get()), component.refCount);
+  }
+
+  /// <summary>
+  /// Devuelve el puntero sin tocar el recuento de referencias, est el
+  /// componente en el World o en la lista de la entidad. Es lo que se usa en
+  /// el cdigo de cada frame. Si el componente vive en el World, el puntero
+  /// es vlido hasta el siguiente cambio estructural de la entidad; si no,
+  /// mientras la entidad lo conserve.
+  /// </summary>
+  /// <typeparam name="T">Tipo del componente a obtener.</typeparam>
+  /// <returns>Puntero al componente, o nullptr si la entidad no lo tiene.</returns>
+  template<typename T>
+  T*
+    getComponentPtr() {
+    if (m_world) {
+      if (T* component = m_world->template get<T>(m_entity)) {
+        return component;
       }
     }
-    return EU::TSharedPointer<T>();
+    const uint8_t slot = m_componentSlots[T::kType];
+    return slot == 0 ? nullptr : static_cast<T*>(m_components[slot - 1].get());
   }
 
+  /// <summary>
+  /// Entidad que representa a este objeto en el World (nula si no est en ninguno).
+  /// </summary>
+  EntityHandle
+    getEntityHandle() const { return m_entity; }
+
 private:
 protected:
+  World* m_world = nullptr;  // World donde viven los componentes compartidos (no se toma la propiedad).
+  EntityHandle m_entity;     // Entidad de este objeto en m_world.
   bool m_isActive;   // Indica si la entidad est activa.
   int m_id;          // Identificador numrico de la entidad.
   std::vector<EU::TSharedPointer<Component>> m_components; // Lista de componentes asociados.
+  // Posicin + 1 en m_components del primer componente de cada ComponentType (0 = no tiene).
+  uint8_t m_componentSlots[MAX_COMPONENT_TYPES] = {};
 };
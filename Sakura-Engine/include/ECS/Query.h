@@ -0,0 +1,145 @@
+#pragma once
+#include "ECS/World.h"
+
+/// <summary>
+/// Consulta que se guarda entre frames: las entidades del World con todos
+/// los tipos T...
+///
+/// Recuerda qu arquetipos le sirven y solo revisa los que se crearon desde
+/// la ltima vez, en vez de todos en cada forEach. Con watch observa
+/// algunos tipos y forEachChanged recorre solo las entidades que los
+/// cambiaron (o los recibieron) desde el forEachChanged anterior, as que un
+/// frame en que casi nada se movi cuesta lo que cambi y no lo que hay.
+///
+///   Query&lt;ActorRef&gt; query(world);
+///   query.watch&lt;Transform, MeshComponent&gt;();
+///   query.forEachChanged([](EntityHandle e, ActorRef& ref) { ... });
+///
+/// El World debe vivir ms que la Query. Igual que en World::forEach, fn no
+/// debe hacer cambios estructurales.
+/// </summary>
+template <typename... T>
+class Query {
+public:
+  explicit Query(World& world) : m_world(world) {
+    static_assert(!std::disjunction<IsSparseComponent<T>...>::value,
+      "Los componentes dispersos se recorren con pool<T>().forEach");
+  }
+
+  ~Query() {
+    for (const Watch& watch : m_watches) m_world.unwatchChanges(watch.typeId, watch.reader);
+  }
+
+  /// <summary>
+  /// Observa los tipos U... (no hace falta que estn entre los T...).
+  /// </summary>
+  template <typename... U>
+  void
+    watch() {
+    int expand[] = { 0, (watchType(ComponentTypes::id<U>()), 0)... };
+    (void)expand;
+  }
+
+  /// <summary>
+  /// Llama a fn por cada entidad con todos los T..., como World::forEach.
+  /// </summary>
+  template <typename Fn>
+  void
+    forEach(Fn&& fn) {
+    refresh();
+    for (uint32_t index : m_archetypes) {
+      Archetype& archetype = *m_world.m_archetypes[index];
+      if (archetype.entities.empty()) continue;
+      m_world.template forEachRow_<T...>(archetype, 0, archetype.entities.size(), fn,
+        std::index_sequence_for<T...>());
+    }
+  }
+
+  /// <summary>
+  /// Llama a fn, una vez por entidad, por las entidades con todos los T...
+  /// en las que cambi algn tipo observado desde la llamada anterior. La
+  /// primera vez las recorre todas. Devuelve cuntas recorri.
+  /// </summary>
+  template <typename Fn>
+  size_t
+    forEachChanged(Fn&& fn) {
+    m_changed.clear();
+    for (const Watch& watch : m_watches) m_world.readChanges(watch.typeId, watch.reader, m_changed);
+
+    size_t visited = 0;
+    if (m_firstPass) {
+      m_firstPass = false;
+      forEach([&](EntityHandle entity, T&... components) {
+        call(fn, entity, components...);
+        ++visited;
+      });
+      return visited;
+    }
+
+    // Una entidad puede venir varias veces (o de varios tipos): m_seen
+    // guarda en qu pasada se visit cada ndice
+    if (++m_pass == 0) {
+      std::fill(m_seen.begin(), m_seen.end(), 0u);
+      m_pass = 1;
+    }
+    const ComponentMask required = World::maskOf<T...>();
+    for (const EntityHandle entity : m_changed) {
+      if (!m_world.isAlive(entity)) continue;
+      if (entity.index >= m_seen.size()) m_seen.resize(size_t(entity.index) + 1, 0u);
+      if (m_seen[entity.index] == m_pass) continue;
+      m_seen[entity.index] = m_pass;
+      if ((m_world.archetypeMask(entity) & required) != required) continue;
+      call(fn, entity, *static_cast<T*>(m_world.componentAt(entity, ComponentTypes::id<T>()))...);
+      ++visited;
+    }
+    return visited;
+  }
+
+private:
+  Query(const Query&) = delete;
+  Query& operator=(const Query&) = delete;
+
+  struct Watch {
+    uint32_t typeId;
+    uint32_t reader;   // Lector en el ChangeLog del World.
+  };
+
+  void
+    watchType(uint32_t typeId) {
+    for (const Watch& watch : m_watches) {
+      if (watch.typeId == typeId) return;
+    }
+    m_watches.push_back({ typeId, m_world.watchChanges(typeId) });
+  }
+
+  // Agrega los arquetipos nuevos que tienen todos los T...
+  void
+    refresh() {
+    const ComponentMask required = World::maskOf<T...>();
+    for (; m_checkedArchetypes < m_world.m_archetypes.size(); ++m_checkedArchetypes) {
+      if ((m_world.m_archetypes[m_checkedArchetypes]->mask & required) == required) {
+        m_archetypes.push_back(static_cast<uint32_t>(m_checkedArchetypes));
+      }
+    }
+  }
+
+  template <typename Fn>
+  static void
+    call(Fn& fn, EntityHandle entity, T&... components) {
+    if constexpr (std::is_invocable<Fn&, EntityHandle, T&...>::value) {
+      fn(entity, components...);
+    }
+    else {
+      fn(components...);
+    }
+  }
+
+  World& m_world;
+  std::vector<uint32_t> m_archetypes;   // Arquetipos con todos los T...
+  size_t m_checkedArchetypes = 0;       // Arquetipos del World ya revisados.
+  std::vector<Watch> m_watches;
+  std::vector<EntityHandle> m_changed;  // Cambios ledos en el forEachChanged en curso.
+  std::vector<uint32_t> m_seen;         // Por ndice de entidad: ltima pasada en que se visit.
+  uint32_t m_pass = 0;
+  bool m_firstPass = true;
+};
@@ -0,0 +1,167 @@
+#pragma once
+#include "ECS/World.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// Tiempo de un sistema en el ltimo SystemScheduler::run.
+/// </summary>
+struct SystemTiming {
+  std::string name;
+  double seconds = 0.0;
+};
+
+/// <summary>
+/// Resultado del ltimo SystemScheduler::run.
+/// </summary>
+struct SchedulerStats {
+  size_t systems = 0;        // Sistemas que corrieron.
+  size_t dependencies = 0;   // Pares de sistemas que no podan correr a la vez.
+  unsigned int threads = 0;  // Hilos disponibles (trabajadores + el que llama).
+  double seconds = 0.0;      // Tiempo total de run.
+  std::vector<SystemTiming> timings;  // En el orden en que se agregaron.
+};
+
+/// <summary>
+/// Corre los sistemas del frame (transforms, jerarqua, LOD, ...) en un
+/// grupo de hilos que vive mientras viva el scheduler.
+///
+/// Cada sistema declara qu tipos lee y cules escribe como ComponentMask
+/// (World::maskOf). Los recursos que no son componentes (el SceneGraph, el
+/// DeviceContext, ...) se declaran igual con un tipo etiqueta vaco. En cada
+/// run se arma el grafo: un sistema espera a los que se agregaron antes que
+/// l y escriben algo que l lee o escribe, o leen algo que l escribe; los
+/// dems corren al mismo tiempo. El resultado es el mismo que correrlos uno
+/// tras otro en el orden en que se agregaron.
+///
+/// Dentro de un sistema, parallelFor y parallelForChunks reparten un ciclo
+/// en trozos entre los mismos hilos. Los sistemas con kMainThread (los que
+/// usan el DeviceContext inmediato, por ejemplo) corren siempre en el hilo
+/// que llama a run.
+/// </summary>
+class SystemScheduler {
+public:
+  // Opciones de addSystem.
+  static const uint32_t kMainThread = 1;  // Corre en el hilo que llama a run.
+
+  /// <summary>
+  /// 'threadCount' = hilos en total contando al que llama a run (0 = todos los ncleos).
+  /// </summary>
+  explicit SystemScheduler(unsigned int threadCount = 0);
+  ~SystemScheduler();
+
+  /// <summary>
+  /// Agrega un sistema; devuelve su nmero. 'update' recibe el deltaTime de run.
+  /// </summary>
+  uint32_t
+    addSystem(const std::string& name,
+      ComponentMask reads,
+      ComponentMask writes,
+      std::function<void(float)> update,
+      uint32_t flags = 0);
+
+  /// <summary>
+  /// Activa o desactiva un sistema (los desactivados no corren ni cuentan en el grafo).
+  /// </summary>
+  void
+    setEnabled(uint32_t system, bool enabled) { m_systems[system].enabled = enabled; }
+
+  /// <summary>
+  /// Corre todos los sistemas activos y regresa cuando terminaron.
+  /// </summary>
+  void
+    run(float deltaTime);
+
+  /// <summary>
+  /// Llama a fn(begin, end) sobre trozos de hasta 'chunkSize' elementos de
+  /// [0, count), repartidos entre los hilos. El que llama tambin trabaja y
+  /// regresa cuando terminaron todos los trozos. Se puede usar desde un sistema.
+  /// </summary>
+  void
+    parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& fn);
+
+  /// <summary>
+  /// Reparte entre los hilos las entidades del World con todos los tipos T...,
+  /// en trozos de hasta 'rowsPerChunk' filas. fn(const WorldChunk&) recorre su
+  /// trozo con World::forEachInChunk; no debe hacer cambios estructurales.
+  /// </summary>
+  template <typename... T, typename Fn>
+  void
+    parallelForChunks(World& world, size_t rowsPerChunk, Fn&& fn) {
+    std::vector<WorldChunk> chunks;
+    world.getChunks<T...>(rowsPerChunk, chunks);
+    parallelFor(chunks.size(), 1, [&chunks, &fn](size_t begin, size_t end) {
+      for (size_t c = begin; c < end; ++c) fn(chunks[c]);
+    });
+  }
+
+  /// <summary>
+  /// Hilos en total, contando al que llama a run.
+  /// </summary>
+  unsigned int
+    getThreadCount() const { return static_cast<unsigned int>(m_workers.size()) + 1; }
+
+  const SchedulerStats&
+    getLastStats() const { return m_lastStats; }
+
+private:
+  SystemScheduler(const SystemScheduler&) = delete;
+  SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+  struct System {
+    std::string name;
+    ComponentMask reads = 0;
+    ComponentMask writes = 0;
+    std::function<void(float)> update;
+    uint32_t flags = 0;
+    bool enabled = true;
+    // Estado del run en curso
+    uint32_t waitingFor = 0;            // Sistemas anteriores que faltan por terminar.
+    std::vector<uint32_t> dependents;   // Sistemas que esperan a este.
+    double seconds = 0.0;
+  };
+
+  // Un trozo de parallelFor.
+  struct Chunk {
+    const std::function<void(size_t, size_t)>* fn = nullptr;
+    size_t begin = 0;
+    size_t end = 0;
+    std::atomic<size_t>* pending = nullptr;
+  };
+
+  void
+    workerLoop();
+
+  // Corre un trozo y avisa si era el ltimo de su parallelFor.
+  void
+    runChunk(const Chunk& chunk);
+
+  // Corre el sistema y libera a los que lo esperaban.
+  void
+    runSystem(uint32_t system);
+
+  // Lo pone en la cola que le toca (la del hilo principal o la general).
+  void
+    pushReadySystem(uint32_t system);
+
+  std::vector<System> m_systems;
+  std::vector<std::thread> m_workers;
+
+  std::mutex m_mutex;
+  std::condition_variable m_wake;     // Hay trabajo nuevo o algo termin.
+  std::deque<Chunk> m_chunks;         // Trozos de parallelFor (tienen prioridad).
+  std::deque<uint32_t> m_readySystems;
+  std::deque<uint32_t> m_mainThreadSystems;
+  size_t m_systemsLeft = 0;           // Sistemas del run en curso que no han terminado.
+  float m_deltaTime = 0.0f;
+  bool m_stop = false;
+
+  SchedulerStats m_lastStats;
+};
@@ -2,10 +2,14 @@
 #include "Prerequisites.h"
 #include "EngineUtilities/Vectors/Vector3.h"
 #include "Component.h"
+#include "SceneGraph.h"
 
 class
   Transform : public Component {
 public:
+  // Tipo con el que Entity busca este componente (ver Entity::getComponent)
+  static constexpr ComponentType kType = ComponentType::TRANSFORM;
+
   // Constructor que inicializa posicin, rotacin y escala por defecto
   Transform() : position(),
     rotation(),
@@ -19,12 +23,19 @@ public:
     init() {
     scale.one();
     matrix = XMMatrixIdentity();
+    dirty = true;
+    ++version;
   }
 
   // Actualiza el estado del objeto Transform basado en el tiempo transcurrido
   // @param deltaTime: Tiempo transcurrido desde la ltima actualizacin
+  // Solo recalcula la matriz si algn set* cambi los datos desde la ltima vez
   void
     update(float deltaTime) override {
+    if (!dirty) {
+      return;
+    }
+
     // Aplicar escala
     XMMATRIX scaleMatrix = XMMatrixScaling(scale.x, scale.y, scale.z);
     // Aplicar rotacion
@@ -34,8 +45,13 @@ public:
 
     // Componer la matriz final en el orden: scale -> rotation -> translation
     matrix = scaleMatrix * rotationMatrix * translationMatrix;
+    dirty = false;
   }
 
+  // true si la matriz est pendiente de recalcular (ver update)
+  bool
+    isDirty() const { return dirty; }
+
   // Renderiza el objeto Transform
   // @param deviceContext: Contexto del dispositivo de renderizado
   void
@@ -52,7 +68,7 @@ public:
 
   // Establece una nueva posicin
   void
-    setPosition(const EU::Vector3& newPos) { position = newPos; }
+    setPosition(const EU::Vector3& newPos) { position = newPos; dirty = true; ++version; }
 
   // Mtodos de acceso a los datos de rotacin
   // Retorna la rotacin actual
@@ -61,7 +77,7 @@ public:
 
   // Establece una nueva rotacin
   void
-    setRotation(const EU::Vector3& newRot) { rotation = newRot; }
+    setRotation(const EU::Vector3& newRot) { rotation = newRot; dirty = true; ++version; }
 
   // Mtodos de acceso a los datos de escala
   // Retorna la escala actual
@@ -70,7 +86,7 @@ public:
 
   // Establece una nueva escala
   void
-    setScale(const EU::Vector3& newScale) { scale = newScale; }
+    setScale(const EU::Vector3& newScale) { scale = newScale; dirty = true; ++version; }
 
   void
     setTransform(const EU::Vector3& newPos,
@@ -79,8 +95,24 @@ public:
     position = newPos;
     rotation = newRot;
     scale = newSca;
+    dirty = true;
+    ++version;
   }
 
+  // Nmero de cambios de posicin, rotacin o escala. Sirve para saber si
+  // algo que depende de la matriz (por ejemplo la caja de un Actor) est al da
+  uint32_t
+    getVersion() const { return version; }
+
+  // Nodo del SceneGraph de la escena (SceneGraph::kInvalidNode = sin jerarqua).
+  // El padre y los hijos estn en el SceneGraph; 'matrix' es la matriz local
+  // y la matriz mundo es SceneGraph::getWorld(getSceneNode())
+  uint32_t
+    getSceneNode() const { return sceneNode; }
+
+  void
+    setSceneNode(uint32_t node) { sceneNode = node; }
+
   // Mtodo para trasladar la posicin del objeto
   // @param translation: Vector que representa la cantidad de traslado en cada eje
   void
@@ -90,6 +122,9 @@ private:
   EU::Vector3 position;  // Posicin del objeto
   EU::Vector3 rotation;  // Rotacin del objeto
   EU::Vector3 scale;     // Escala del objeto
+  uint32_t version = 1;  // Sube con cada set* (ver getVersion)
+  bool dirty = true;     // La matriz no corresponde a los datos (ver update)
+  uint32_t sceneNode = SceneGraph::kInvalidNode;  // Nodo en el SceneGraph (ver getSceneNode)
 
 public:
   XMMATRIX matrix;    // Matriz de transformacin
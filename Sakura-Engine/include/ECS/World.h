@@ -0,0 +1,620 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Identificador de una entidad del World: ndice en la tabla de entidades y
+/// generacin. Cuando una entidad se destruye su ndice se recicla con otra
+/// generacin, as que un handle viejo deja de ser vlido en vez de apuntar
+/// a otra entidad. Se copia por valor (8 bytes), sin conteo de referencias.
+/// </summary>
+struct EntityHandle {
+  uint32_t index = 0xFFFFFFFFu;
+  uint32_t generation = 0;
+
+  bool
+    isNull() const { return index == 0xFFFFFFFFu; }
+
+  bool
+    operator==(const EntityHandle& other) const {
+    return index == other.index && generation == other.generation;
+  }
+
+  bool
+    operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
+
+/// <summary>
+/// Conjunto de tipos de componente (un bit por tipo). Es la firma de un arquetipo.
+/// </summary>
+using ComponentMask = uint64_t;
+
+/// <summary>
+/// Cmo mover y destruir un tipo de componente sin conocerlo en tiempo de compilacin.
+/// </summary>
+struct ComponentTypeInfo {
+  size_t size = 0;
+  size_t align = 0;
+  void (*moveConstruct)(void* destination, void* source) = nullptr;  // Construye en destination moviendo source.
+  void (*destroy)(void* object) = nullptr;
+};
+
+/// <summary>
+/// Registro global de los tipos que se guardan en un World. Cada tipo recibe
+/// un nmero (0 .. kMaxTypes - 1) la primera vez que se usa.
+/// </summary>
+class ComponentTypes {
+public:
+  // Tipos distintos que caben en una ComponentMask.
+  static const uint32_t kMaxTypes = 64;
+
+  /// <summary>
+  /// Nmero del tipo T. Es el mismo en todos los World del programa.
+  /// </summary>
+  template <typename T>
+  static uint32_t
+    id() {
+    static const uint32_t value = registerType(makeInfo<T>());
+    return value;
+  }
+
+  /// <summary>
+  /// Bit del tipo T en una ComponentMask.
+  /// </summary>
+  template <typename T>
+  static ComponentMask
+    bit() { return ComponentMask(1) << id<T>(); }
+
+  /// <summary>
+  /// Informacin del tipo con nmero 'typeId'.
+  /// </summary>
+  static const ComponentTypeInfo&
+    info(uint32_t typeId);
+
+private:
+  ComponentTypes() = delete;
+
+  template <typename T>
+  static ComponentTypeInfo
+    makeInfo() {
+    static_assert(std::is_move_constructible<T>::value, "Los componentes del World se mueven entre arquetipos");
+    ComponentTypeInfo info;
+    info.size = sizeof(T);
+    info.align = alignof(T);
+    info.moveConstruct = [](void* destination, void* source) {
+      new (destination) T(std::move(*static_cast<T*>(source)));
+    };
+    info.destroy = [](void* object) { static_cast<T*>(object)->~T(); };
+    return info;
+  }
+
+  // Guarda la informacin y devuelve el nmero asignado.
+  static uint32_t
+    registerType(const ComponentTypeInfo& info);
+};
+
+/// <summary>
+/// Entidades que tienen exactamente el mismo conjunto de componentes. Cada
+/// tipo vive en su propio arreglo contiguo (columna) y la fila 'row' de
+/// todas las columnas es la misma entidad.
+/// </summary>
+struct Archetype {
+  ComponentMask mask = 0;
+  std::vector<uint32_t> types;      // Nmeros de tipo, de menor a mayor.
+  int8_t column[ComponentTypes::kMaxTypes];  // Columna de cada tipo (-1 si no lo tiene).
+  std::vector<unsigned char*> data; // Memoria de cada columna (capacity elementos).
+  std::vector<EntityHandle> entities;  // Entidad de cada fila.
+  size_t capacity = 0;
+
+  // Arquetipo al que se llega agregando / quitando cada tipo (-1 = an no se sabe).
+  int32_t addEdge[ComponentTypes::kMaxTypes];
+  int32_t removeEdge[ComponentTypes::kMaxTypes];
+
+  size_t
+    size() const { return entities.size(); }
+
+  // Elemento 'row' de la columna del tipo 'typeId' (el arquetipo debe tenerlo).
+  void*
+    at(uint32_t typeId, size_t row) const {
+    return data[column[typeId]] + row * ComponentTypes::info(typeId).size;
+  }
+};
+
+/// <summary>
+/// true si T pide guardarse en un ComponentPool en vez de en los arquetipos:
+///
+///   struct Selected { static constexpr bool kSparseStorage = true; };
+///
+/// Conviene para componentes que se ponen y se quitan seguido (marcas,
+/// estados): agregarlos o quitarlos no mueve la entidad de arquetipo.
+/// </summary>
+template <typename T, typename = void>
+struct IsSparseComponent : std::false_type {};
+
+template <typename T>
+struct IsSparseComponent<T, std::void_t<decltype(T::kSparseStorage)>>
+  : std::integral_constant<bool, T::kSparseStorage> {};
+
+/// <summary>
+/// Parte de ComponentPool que no depende del tipo (para que World los borre todos).
+/// </summary>
+class ComponentPoolBase {
+public:
+  virtual
+    ~ComponentPoolBase() = default;
+
+  // Quita el componente de la entidad con ndice 'index' si lo tiene.
+  virtual void
+    remove(uint32_t index) = 0;
+
+  virtual size_t
+    size() const = 0;
+};
+
+/// <summary>
+/// Conjunto disperso (sparse set) de componentes T: un arreglo indexado por
+/// el ndice de la entidad dice en qu posicin del arreglo denso est su
+/// componente. Agregar, quitar y consultar son O(1) y recorrer es leer los
+/// arreglos densos seguidos. Quitar llena el hueco con el ltimo, as que el
+/// orden del recorrido cambia.
+/// </summary>
+template <typename T>
+class ComponentPool : public ComponentPoolBase {
+public:
+  static const uint32_t kNone = 0xFFFFFFFFu;
+
+  bool
+    has(uint32_t index) const { return index < m_sparse.size() && m_sparse[index] != kNone; }
+
+  T*
+    get(uint32_t index) { return has(index) ? &m_components[m_sparse[index]] : nullptr; }
+
+  // Agrega o reemplaza el componente de la entidad.
+  T&
+    add(EntityHandle entity, T component) {
+    if (entity.index >= m_sparse.size()) m_sparse.resize(size_t(entity.index) + 1, kNone);
+    if (m_sparse[entity.index] != kNone) {
+      T& existing = m_components[m_sparse[entity.index]];
+      existing = std::move(component);
+      return existing;
+    }
+    m_sparse[entity.index] = static_cast<uint32_t>(m_entities.size());
+    m_entities.push_back(entity);
+    m_components.push_back(std::move(component));
+    return m_components.back();
+  }
+
+  void
+    remove(uint32_t index) override {
+    if (!has(index)) return;
+    const uint32_t position = m_sparse[index];
+    const uint32_t last = static_cast<uint32_t>(m_entities.size() - 1);
+    if (position != last) {
+      m_entities[position] = m_entities[last];
+      m_components[position] = std::move(m_components[last]);
+      m_sparse[m_entities[position].index] = position;
+    }
+    m_entities.pop_back();
+    m_components.pop_back();
+    m_sparse[index] = kNone;
+  }
+
+  size_t
+    size() const override { return m_entities.size(); }
+
+  /// <summary>
+  /// Llama a fn(EntityHandle, T&) por cada componente, en el orden denso.
+  /// </summary>
+  template <typename Fn>
+  void
+    forEach(Fn&& fn) {
+    for (size_t i = 0; i < m_entities.size(); ++i) fn(m_entities[i], m_components[i]);
+  }
+
+  // Entidad de cada componente del arreglo denso.
+  const std::vector<EntityHandle>&
+    entities() const { return m_entities; }
+
+private:
+  std::vector<uint32_t> m_sparse;        // Por ndice de entidad: posicin en los densos o kNone.
+  std::vector<EntityHandle> m_entities;  // Densos.
+  std::vector<T> m_components;
+};
+
+template <typename T>
+const uint32_t ComponentPool<T>::kNone;
+
+/// <summary>
+/// Rango de filas [begin, end) de un arquetipo. World::getChunks parte una
+/// consulta en trozos as para repartirlos entre hilos (ver SystemScheduler).
+/// </summary>
+struct WorldChunk {
+  Archetype* archetype = nullptr;
+  size_t begin = 0;
+  size_t end = 0;
+};
+
+/// <summary>
+/// Resultado de World::getStats.
+/// </summary>
+struct WorldStats {
+  size_t entities = 0;     // Entidades vivas.
+  size_t archetypes = 0;   // Arquetipos creados (incluye el vaco).
+  size_t moves = 0;        // Entidades que cambiaron de arquetipo desde el inicio.
+};
+
+/// <summary>
+/// Almacenamiento de entidades por arquetipos.
+///
+/// Los componentes de un mismo tipo estn juntos en memoria, agrupados por
+/// la firma (el conjunto de tipos) de la entidad, as que recorrer por
+/// ejemplo todos los Transform es leer arreglos seguidos en vez de saltar
+/// entre objetos en el heap. Las consultas se hacen con forEach:
+///
+///   world.forEach<Transform, Velocity>([](Transform& t, Velocity& v) { ... });
+///
+/// Agregar o quitar un componente mueve la entidad a otro arquetipo, por
+/// eso los punteros que devuelven get y add solo valen hasta el siguiente
+/// cambio estructural (create, destroy, add o remove). Esos cambios no se
+/// deben hacer dentro de un forEach; desde un forEach o un sistema se anotan
+/// en un CommandBuffer y se aplican despus (ver CommandQueue).
+///
+/// Los componentes pueden ser cualquier tipo que se pueda mover; no tienen
+/// que derivar de Component. Los que declaran kSparseStorage (ver
+/// IsSparseComponent) no van en los arquetipos sino en un ComponentPool por
+/// tipo: add, remove, get y has funcionan igual, pero agregarlos o quitarlos
+/// no es un cambio estructural (se puede hacer dentro de un forEach) y se
+/// recorren con pool&lt;T&gt;().forEach en vez de World::forEach.
+///
+/// Para recorrer solo lo que cambi, una Query observa algunos tipos
+/// (Query::watch) y el World anota qu entidades los cambiaron: al
+/// agregarlos (create, add) y cuando alguien llama a markChanged.
+/// </summary>
+class World {
+public:
+  World();
+  ~World();
+
+  /// <summary>
+  /// Crea una entidad sin componentes.
+  /// </summary>
+  EntityHandle
+    create();
+
+  /// <summary>
+  /// Crea una entidad con los componentes dados, directo en su arquetipo.
+  /// </summary>
+  template <typename... T>
+  EntityHandle
+    create(T&&... components) {
+    static_assert(!std::disjunction<IsSparseComponent<typename std::decay<T>::type>...>::value,
+      "Los componentes dispersos se agregan con add");
+    const ComponentMask mask = maskOf<typename std::decay<T>::type...>();
+    const uint32_t archetype = findArchetype(mask);
+    const EntityHandle entity = allocateEntity();
+    const size_t row = pushRow(archetype, entity);
+    Archetype& target = *m_archetypes[archetype];
+    int expand[] = { 0, (new (target.at(ComponentTypes::id<typename std::decay<T>::type>(), row))
+      typename std::decay<T>::type(std::forward<T>(components)), 0)... };
+    (void)expand;
+    recordChanges(entity, mask);
+    return entity;
+  }
+
+  /// <summary>
+  /// Destruye la entidad y sus componentes. El handle deja de ser vlido.
+  /// </summary>
+  void
+    destroy(EntityHandle entity);
+
+  /// <summary>
+  /// true si el handle corresponde a una entidad viva.
+  /// </summary>
+  bool
+    isAlive(EntityHandle entity) const {
+    return entity.index < m_records.size() && m_records[entity.index].generation == entity.generation &&
+      m_records[entity.index].archetype >= 0;
+  }
+
+  /// <summary>
+  /// Agrega (o reemplaza) el componente T de la entidad y lo devuelve.
+  /// La entidad debe estar viva (isAlive).
+  /// </summary>
+  template <typename T>
+  T&
+    add(EntityHandle entity, T component = T()) {
+    recordChanges(entity, ComponentTypes::bit<T>());
+    if constexpr (IsSparseComponent<T>::value) {
+      return pool<T>().add(entity, std::move(component));
+    }
+    const uint32_t typeId = ComponentTypes::id<T>();
+    if (T* existing = get<T>(entity)) {
+      *existing = std::move(component);
+      return *existing;
+    }
+    const size_t row = moveEntity(entity, typeId, true);
+    const Record& record = m_records[entity.index];
+    return *new (m_archetypes[record.archetype]->at(typeId, row)) T(std::move(component));
+  }
+
+  /// <summary>
+  /// Quita el componente T de la entidad (no hace nada si no lo tiene).
+  /// </summary>
+  template <typename T>
+  void
+    remove(EntityHandle entity) {
+    if constexpr (IsSparseComponent<T>::value) {
+      if (isAlive(entity)) pool<T>().remove(entity.index);
+    }
+    else if (has<T>(entity)) {
+      moveEntity(entity, ComponentTypes::id<T>(), false);
+    }
+  }
+
+  /// <summary>
+  /// Componente T de la entidad, o nullptr si no lo tiene o el handle ya no es vlido.
+  /// </summary>
+  template <typename T>
+  T*
+    get(EntityHandle entity) {
+    if (!isAlive(entity)) return nullptr;
+    if constexpr (IsSparseComponent<T>::value) {
+      return pool<T>().get(entity.index);
+    }
+    const Record& record = m_records[entity.index];
+    const Archetype& archetype = *m_archetypes[record.archetype];
+    const uint32_t typeId = ComponentTypes::id<T>();
+    if (archetype.column[typeId] < 0) return nullptr;
+    return static_cast<T*>(archetype.at(typeId, record.row));
+  }
+
+  template <typename T>
+  bool
+    has(EntityHandle entity) const {
+    if (!isAlive(entity)) return false;
+    if constexpr (IsSparseComponent<T>::value) {
+      const uint32_t typeId = ComponentTypes::id<T>();
+      return typeId < m_pools.size() && m_pools[typeId] &&
+        static_cast<const ComponentPool<T>*>(m_pools[typeId].get())->has(entity.index);
+    }
+    return (m_archetypes[m_records[entity.index].archetype]->mask & ComponentTypes::bit<T>()) != 0;
+  }
+
+  /// <summary>
+  /// Llama a fn por cada entidad que tenga todos los tipos T..., arquetipo
+  /// por arquetipo y fila por fila. fn recibe (T&...) o (EntityHandle, T&...).
+  /// </summary>
+  template <typename... T, typename Fn>
+  void
+    forEach(Fn&& fn) {
+    static_assert(!std::disjunction<IsSparseComponent<T>...>::value,
+      "Los componentes dispersos se recorren con pool<T>().forEach");
+    const ComponentMask required = maskOf<T...>();
+    for (auto& archetype : m_archetypes) {
+      if ((archetype->mask & required) != required || archetype->entities.empty()) continue;
+      forEachRow_<T...>(*archetype, 0, archetype->entities.size(), fn, std::index_sequence_for<T...>());
+    }
+  }
+
+  /// <summary>
+  /// Parte las entidades que tienen todos los tipos T... en trozos de hasta
+  /// 'rowsPerChunk' filas (un trozo nunca mezcla arquetipos) y los agrega a
+  /// 'chunks'. Los trozos valen hasta el siguiente cambio estructural.
+  /// </summary>
+  template <typename... T>
+  void
+    getChunks(size_t rowsPerChunk, std::vector<WorldChunk>& chunks) {
+    const ComponentMask required = maskOf<T...>();
+    if (rowsPerChunk == 0) rowsPerChunk = 1;
+    for (auto& archetype : m_archetypes) {
+      if ((archetype->mask & required) != required) continue;
+      const size_t count = archetype->entities.size();
+      for (size_t begin = 0; begin < count; begin += rowsPerChunk) {
+        chunks.push_back({ archetype.get(), begin, (std::min)(begin + rowsPerChunk, count) });
+      }
+    }
+  }
+
+  /// <summary>
+  /// Como forEach, pero solo con las filas de un trozo de getChunks (que
+  /// debe haberse pedido con los mismos tipos o un subconjunto). Trozos
+  /// distintos se pueden recorrer al mismo tiempo desde varios hilos.
+  /// </summary>
+  template <typename... T, typename Fn>
+  void
+    forEachInChunk(const WorldChunk& chunk, Fn&& fn) {
+    forEachRow_<T...>(*chunk.archetype, chunk.begin, chunk.end, fn, std::index_sequence_for<T...>());
+  }
+
+  /// <summary>
+  /// Pool de un tipo disperso (ver IsSparseComponent); se crea la primera vez.
+  /// </summary>
+  template <typename T>
+  ComponentPool<T>&
+    pool() {
+    static_assert(IsSparseComponent<T>::value, "Solo los componentes dispersos tienen pool");
+    const uint32_t typeId = ComponentTypes::id<T>();
+    if (typeId >= m_pools.size()) m_pools.resize(size_t(typeId) + 1);
+    if (!m_pools[typeId]) m_pools[typeId].reset(new ComponentPool<T>());
+    return *static_cast<ComponentPool<T>*>(m_pools[typeId].get());
+  }
+
+  /// <summary>
+  /// Anota que el componente T de las entidades cambi, para las Query que
+  /// observan T (si ninguna lo observa no hace nada). Se puede llamar desde
+  /// varios hilos a la vez. Sirve tambin para tipos que la entidad guarda
+  /// fuera del World (los MeshComponent de un Actor, por ejemplo).
+  /// </summary>
+  template <typename T>
+  void
+    markChanged(const EntityHandle* entities, size_t count) {
+    if (m_watchedTypes.load(std::memory_order_relaxed) & ComponentTypes::bit<T>()) {
+      markChanged(ComponentTypes::id<T>(), entities, count);
+    }
+  }
+
+  template <typename T>
+  void
+    markChanged(EntityHandle entity) { markChanged<T>(&entity, 1); }
+
+  /// <summary>
+  /// Cuntos cambios de T se anotaron desde que se empez a observar (solo
+  /// crece). 0 si ninguna Query lo observa.
+  /// </summary>
+  template <typename T>
+  uint64_t
+    getChangeVersion() {
+    std::lock_guard<std::mutex> lock(m_changeMutex);
+    const ChangeLog* log = m_changeLogs[ComponentTypes::id<T>()].get();
+    return log ? log->base + log->entities.size() : 0;
+  }
+
+  /// <summary>
+  /// Mscara con los bits de los tipos T...
+  /// </summary>
+  template <typename... T>
+  static ComponentMask
+    maskOf() {
+    ComponentMask mask = 0;
+    int expand[] = { 0, (mask |= ComponentTypes::bit<T>(), 0)... };
+    (void)expand;
+    return mask;
+  }
+
+  /// <summary>
+  /// Entidades vivas.
+  /// </summary>
+  size_t
+    size() const { return m_records.size() - m_freeEntities.size(); }
+
+  WorldStats
+    getStats() const;
+
+private:
+  // Aplica los cambios estructurales de varios comandos en un solo movimiento.
+  friend class CommandQueue;
+  // Guarda los arquetipos que le sirven y lee los cambios que observa.
+  template <typename... T> friend class Query;
+
+  World(const World&) = delete;
+  World& operator=(const World&) = delete;
+
+  struct Record {
+    int32_t archetype = -1;   // -1 = ndice libre.
+    uint32_t row = 0;
+    uint32_t generation = 1;
+  };
+
+  // Entidades que cambiaron un tipo observado, en el orden en que se anotaron.
+  struct ChangeLog {
+    std::vector<EntityHandle> entities;
+    uint64_t base = 0;              // Versin del primer elemento de entities.
+    std::vector<uint64_t> readers;  // Versin hasta la que ley cada Query (kNoReader = libre).
+  };
+
+  static const uint64_t kNoReader = ~uint64_t(0);
+
+  template <typename... T, typename Fn, size_t... I>
+  void
+    forEachRow_(Archetype& archetype, size_t begin, size_t end, Fn& fn, std::index_sequence<I...>) {
+    std::tuple<T*...> columns(static_cast<T*>(archetype.at(ComponentTypes::id<T>(), 0))...);
+    for (size_t row = begin; row < end; ++row) {
+      if constexpr (std::is_invocable<Fn&, EntityHandle, T&...>::value) {
+        fn(archetype.entities[row], std::get<I>(columns)[row]...);
+      }
+      else {
+        fn(std::get<I>(columns)[row]...);
+      }
+    }
+  }
+
+  // ndice de la entidad nueva (reciclado si hay) y su handle.
+  EntityHandle
+    allocateEntity();
+
+  // Arquetipo con exactamente la mscara dada (lo crea si no existe).
+  uint32_t
+    findArchetype(ComponentMask mask);
+
+  // Agrega una fila al arquetipo para la entidad (componentes sin construir).
+  size_t
+    pushRow(uint32_t archetype, EntityHandle entity);
+
+  // Quita la fila (ya destruida) llenando el hueco con la ltima.
+  void
+    eraseRow(uint32_t archetype, size_t row);
+
+  /*
+   * Pasa la entidad al arquetipo con 'typeId' agregado o quitado. Mueve los
+   * componentes en comn y destruye el que sobra; el nuevo queda sin
+   * construir. Devuelve la fila en el arquetipo nuevo.
+   */
+  size_t
+    moveEntity(EntityHandle entity, uint32_t typeId, bool adding);
+
+  /*
+   * Pasa la entidad al arquetipo 'targetIndex' de una vez: mueve los
+   * componentes en comn, destruye los que no estn en el destino y deja
+   * sin construir los nuevos. Devuelve la fila en el destino.
+   */
+  size_t
+    moveEntityTo(EntityHandle entity, uint32_t targetIndex);
+
+  void
+    markChanged(uint32_t typeId, const EntityHandle* entities, size_t count);
+
+  // Anota la entidad en los tipos observados de 'mask' (create, add, CommandQueue).
+  void
+    recordChanges(EntityHandle entity, ComponentMask mask) {
+    mask &= m_watchedTypes.load(std::memory_order_relaxed);
+    for (uint32_t typeId = 0; mask; ++typeId, mask >>= 1) {
+      if (mask & 1) markChanged(typeId, &entity, 1);
+    }
+  }
+
+  // Empieza a observar el tipo desde la versin actual; devuelve el lector.
+  uint32_t
+    watchChanges(uint32_t typeId);
+
+  void
+    unwatchChanges(uint32_t typeId, uint32_t reader);
+
+  /*
+   * Agrega a 'changed' los cambios del tipo que el lector no ha visto (puede
+   * haber entidades repetidas o ya destruidas) y lo deja al da. Lo que ya
+   * leyeron todos los lectores se descarta.
+   */
+  void
+    readChanges(uint32_t typeId, uint32_t reader, std::vector<EntityHandle>& changed);
+
+  // Mscara de arquetipo de la entidad (debe estar viva).
+  ComponentMask
+    archetypeMask(EntityHandle entity) const { return m_archetypes[m_records[entity.index].archetype]->mask; }
+
+  // Componente 'typeId' de la entidad, que debe tenerlo en su arquetipo.
+  void*
+    componentAt(EntityHandle entity, uint32_t typeId) const {
+    const Record& record = m_records[entity.index];
+    return m_archetypes[record.archetype]->at(typeId, record.row);
+  }
+
+  std::vector<std::unique_ptr<Archetype>> m_archetypes;
+  std::unordered_map<ComponentMask, uint32_t> m_archetypeByMask;
+  std::vector<Record> m_records;
+  std::vector<uint32_t> m_freeEntities;
+  std::vector<std::unique_ptr<ComponentPoolBase>> m_pools;  // Por nmero de tipo (solo los dispersos).
+  std::unique_ptr<ChangeLog> m_changeLogs[ComponentTypes::kMaxTypes];  // Solo los tipos observados.
+  std::atomic<ComponentMask> m_watchedTypes{ 0 };
+  std::mutex m_changeMutex;   // Protege los ChangeLog (markChanged puede venir de varios hilos).
+  size_t m_moves = 0;
+};
@@ -27,6 +27,8 @@
  * SOFTWARE.
 */
 #pragma once
+#include <cmath>
+
 namespace EU {
 
   // Constantes matemticas
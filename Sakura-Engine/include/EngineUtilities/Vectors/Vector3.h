@@ -28,7 +28,7 @@
 */
 #pragma once
 
-#include "EngineUtilities\Utilities\EngineMath.h"
+#include "EngineUtilities/Utilities/EngineMath.h"
 namespace EU {
 	/**
  * @brief A 3D vector class.
@@ -29,7 +29,7 @@
 */
 #pragma once
 
-#include "EngineUtilities\Utilities\EngineMath.h"
+#include "EngineUtilities/Utilities/EngineMath.h"
 namespace EU {
   /**
  * @brief A 4D vector class.
@@ -1,5 +1,6 @@
 #pragma once
 #include "Prerequisites.h"
+#include "VertexCompression.h"
 
 class Device;
 class DeviceContext;
@@ -41,6 +42,14 @@ public:
   // Despus de esto, m_inputLayout queda en nullptr.
   void destroy();
 
+  // Descripcin de los atributos para cada formato de vrtice:
+  // - Full:        POSITION R32G32B32_FLOAT    + TEXCOORD R32G32_FLOAT
+  // - PackedHalf:  POSITION R16G16B16A16_SNORM + TEXCOORD R16G16_FLOAT
+  // - PackedUnorm: POSITION R16G16B16A16_SNORM + TEXCOORD R16G16_UNORM
+  // El hardware convierte los formatos empacados a float, as que el mismo
+  // vertex shader sirve para todos.
+  static std::vector<D3D11_INPUT_ELEMENT_DESC> describe(VertexFormat format);
+
 public:
   // Puntero al input layout de D3D11
   // Se crea en init() y se libera en destroy()
@@ -0,0 +1,141 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Cundo se puede usar un nivel de detalle (LOD1 en adelante). El tamao en
+ * pantalla de un actor es el dimetro de su esfera envolvente entre la altura
+ * visible a esa distancia (1.0 = llena la pantalla de arriba a abajo).
+ *
+ *  - screenSize: el nivel se usa cuando el tamao en pantalla baja de este
+ *    valor. Es lo que se usa para los LODs hechos a mano.
+ *  - relativeError: error del nivel entre el radio de la esfera. El nivel se
+ *    usa cuando ese error, proyectado, queda por debajo de
+ *    LodSelector::setPixelError. Es lo que se usa para los LODs generados.
+ *
+ * Si vienen los dos se toma el ms permisivo (el umbral ms grande).
+ */
+struct LodThreshold {
+  float screenSize = 0.0f;
+  float relativeError = 0.0f;
+};
+
+// Resultado de la ltima LodSelector::select.
+struct LodSelectorStats {
+  size_t actors = 0;      // Actores revisados.
+  size_t switches = 0;    // Actores que cambiaron de nivel.
+  double seconds = 0.0;   // Tiempo de la seleccin.
+};
+
+/*
+ * Clase LodSelector
+ *
+ * Elige el nivel de detalle de todos los actores de la escena en una sola
+ * pasada antes del render. Cada actor ocupa un slot: guarda ah su esfera
+ * envolvente en espacio mundo (Actor::update) y lee el nivel elegido al
+ * dibujar (Actor::render).
+ *
+ * Los datos estn por columnas (todas las x juntas, todos los radios juntos,
+ * etc.) para procesar cuatro actores por instruccin con SSE2.
+ *
+ * Para evitar que el modelo parpadee entre dos niveles cuando est justo
+ * en el lmite, hay histresis: para bajar de detalle el tamao tiene que
+ * quedar por debajo del umbral * (1 - h) y para subir, por encima del
+ * umbral * (1 + h). Entre esos dos valores se queda el nivel que ya tena.
+ *
+ * No depende de Direct3D: recibe la posicin de la cmara y la escala de
+ * la proyeccin como floats.
+ */
+class LodSelector {
+public:
+  // Niveles por actor, contando el LOD0.
+  static const unsigned int kMaxLevels = 4;
+
+  // Slot que no corresponde a ningn actor.
+  static const uint32_t kInvalidSlot = 0xFFFFFFFFu;
+
+  LodSelector() = default;
+  ~LodSelector() = default;
+
+  /*
+   * Reserva un slot para un actor. Empieza en LOD0, sin niveles extra y
+   * con radio 0 hasta que se llame a setLevels y setBounds.
+   */
+  uint32_t
+    add();
+
+  // Libera el slot para que lo use otro actor.
+  void
+    remove(uint32_t slot);
+
+  /*
+   * Umbrales de LOD1 .. LODcount del slot, del ms detallado al ms simple
+   * (count < kMaxLevels; los que sobren se ignoran).
+   */
+  void
+    setLevels(uint32_t slot, const LodThreshold* thresholds, unsigned int count);
+
+  // Esfera envolvente del actor en espacio mundo.
+  void
+    setBounds(uint32_t slot, float x, float y, float z, float radius);
+
+  /*
+   * Elige el nivel de todos los slots.
+   * 'projectionScale' es el elemento [1][1] de la matriz de proyeccin
+   * (cot(fov / 2)) y 'viewportHeight' la altura del viewport en pixeles.
+   */
+  void
+    select(const float cameraPosition[3], float projectionScale, float viewportHeight);
+
+  // Nivel elegido para el slot en la ltima select (0 = mximo detalle).
+  unsigned int
+    lod(uint32_t slot) const {
+    return slot < m_lod.size() ? static_cast<unsigned int>(m_lod[slot]) : 0;
+  }
+
+  // Error mximo en pixeles para los niveles con relativeError (1 por defecto).
+  void
+    setPixelError(float pixels) { m_pixelError = pixels; }
+
+  // Histresis relativa a cada umbral (0.15 por defecto).
+  void
+    setHysteresis(float hysteresis) { m_hysteresis = hysteresis; }
+
+  // Slots en uso.
+  size_t
+    size() const { return m_lod.size() - m_freeSlots.size(); }
+
+  const LodSelectorStats&
+    getLastStats() const { return m_lastStats; }
+
+private:
+  // Vuelve a calcular el umbral de los niveles del slot con m_errorScale.
+  void
+    updateThresholds(uint32_t slot);
+
+  // Esferas envolventes.
+  std::vector<float> m_x;
+  std::vector<float> m_y;
+  std::vector<float> m_z;
+  std::vector<float> m_radius;
+
+  // Umbral de tamao en pantalla de LOD1 .. LOD(kMaxLevels - 1). 0 = el nivel no existe.
+  std::vector<float> m_threshold[kMaxLevels - 1];
+
+  // Umbrales tal como los dio el actor (para recalcular m_threshold).
+  std::vector<LodThreshold> m_levels;
+
+  // Nivel elegido de cada slot.
+  std::vector<int32_t> m_lod;
+
+  std::vector<uint32_t> m_freeSlots;
+
+  float m_pixelError = 1.0f;
+  float m_hysteresis = 0.15f;
+
+  // 2 * m_pixelError / altura del viewport con la que se calcularon los umbrales.
+  float m_errorScale = 0.0f;
+
+  LodSelectorStats m_lastStats;
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/*
+ * Clase MappedFile
+ *
+ * Mapea un archivo completo a memoria de solo lectura.
+ * As los loaders (OBJ, cach de mallas, etc.) pueden recorrer el archivo
+ * directo desde memoria sin copiarlo a strings ni leerlo lnea por lnea.
+ *
+ * En Windows usa CreateFileMapping/MapViewOfFile y en otras plataformas mmap,
+ * por eso este header no incluye Prerequisites.h.
+ */
+class MappedFile {
+public:
+  // Constructor por defecto, no abre nada todava.
+  MappedFile() = default;
+
+  // Destructor: libera el mapeo si sigue abierto.
+  ~MappedFile() { close(); }
+
+  /*
+   * Abre 'path' y lo mapea completo a memoria.
+   * Devuelve true si se pudo abrir. Un archivo vaco se abre bien
+   * pero data() regresa nullptr y size() regresa 0.
+   */
+  bool open(const std::string& path);
+
+  /*
+   * Libera el mapeo y los handles del archivo.
+   * Se puede llamar varias veces sin problema.
+   */
+  void close();
+
+  // Inicio de los bytes mapeados (nullptr si no hay nada mapeado).
+  const char* data() const { return m_data; }
+
+  // Tamao del archivo en bytes.
+  size_t size() const { return m_size; }
+
+  // true si el archivo est abierto.
+  bool isOpen() const { return m_isOpen; }
+
+  /*
+   * Avisa que [offset, offset + size) ya no se va a leer: el sistema puede
+   * sacar esas pginas de la memoria del proceso (si se vuelven a tocar se
+   * leen otra vez del archivo). Solo se sueltan bloques de kReleaseAlign
+   * completos dentro del rango. Sirve para recorrer una vez un archivo
+   * enorme sin que se quede todo residente.
+   */
+  void release(size_t offset, size_t size);
+
+  // Granularidad de release (mltiplo de la pgina en Windows y en Linux).
+  static const size_t kReleaseAlign = 64 * 1024;
+
+private:
+  // Se deshabilita la copia para no liberar dos veces el mismo mapeo.
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* m_data = nullptr;   // Vista de solo lectura del archivo.
+  size_t      m_size = 0;         // Tamao del archivo en bytes.
+  bool        m_isOpen = false;   // Indica si open() tuvo xito.
+
+#ifdef _WIN32
+  void* m_file = nullptr;         // HANDLE del archivo.
+  void* m_mapping = nullptr;      // HANDLE del file mapping.
+#else
+  int   m_fd = -1;                // Descriptor del archivo (POSIX).
+#endif
+};
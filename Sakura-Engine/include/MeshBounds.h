@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Clase MeshBounds
+ *
+ * Volmenes envolventes de una malla: caja alineada a los ejes (AABB) y
+ * esfera. Las reducciones de mnimo/mximo recorren todos los vrtices, as
+ * que usan SSE2 cuando est disponible (cuatro vrtices por vuelta) y una
+ * versin escalar para el resto.
+ *
+ * Recibe bytes con stride y regresa floats, sin tipos de xnamath, para que
+ * Model3D lo use igual con lo que venga del OBJ, del FBX o de la cach. Los
+ * vrtices deben traer la posicin (3 floats) al inicio, como SimpleVertex.
+ */
+class MeshBounds {
+public:
+  /*
+   * Caja de los 'vertexCount' vrtices. Sin vrtices, la caja queda en el origen.
+   */
+  static void
+    computeAabb(const void* vertices,
+      size_t vertexCount,
+      size_t vertexStride,
+      float outMin[3],
+      float outMax[3]);
+
+  /*
+   * Radio de la esfera con centro en 'center' que contiene todos los
+   * vrtices (la distancia al vrtice ms lejano).
+   */
+  static float
+    computeRadius(const void* vertices,
+      size_t vertexCount,
+      size_t vertexStride,
+      const float center[3]);
+
+  /*
+   * Caja que contiene a la caja (min, max) transformada por 'matrix'
+   * (vectores fila, por filas como XMFLOAT4X4). Es exacta para la caja
+   * rotada, sin transformar las ocho esquinas (Arvo 1990).
+   */
+  static void
+    transformAabb(const float matrix[16],
+      const float min[3],
+      const float max[3],
+      float outMin[3],
+      float outMax[3]);
+
+private:
+  MeshBounds() = delete;
+};
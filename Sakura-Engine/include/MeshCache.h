@@ -0,0 +1,174 @@
+#pragma once
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Cach binaria de mallas (.sakmesh).
+ *
+ * Guarda los vrtices, normales y tangentes, ndices, submallas, niveles de
+ * detalle, la caja (AABB) y la esfera envolvente de cada malla ya importada,
+ * para no volver a parsear el .obj o el .fbx en cada arranque.
+ * Al leer, el archivo se mapea completo (MappedFile) y los vrtices e ndices
+ * se usan directo desde la memoria mapeada, sin parsear nada.
+ *
+ * La cach se invalida si cambia el archivo fuente: primero se compara
+ * tamao y fecha de modificacin; si solo cambi la fecha, se compara un
+ * hash del contenido (FNV-1a de 64 bits) y, si es el mismo, se guarda la
+ * fecha nueva en la cach.
+ *
+ * No depende de Direct3D ni de Prerequisites.h, as que tambin compila en Linux.
+ * El formato es little-endian (todas las plataformas que usamos lo son).
+ */
+
+// Identifica la versin del archivo fuente con el que se gener la cach.
+struct MeshCacheSource {
+  uint64_t size = 0;      // Tamao en bytes.
+  int64_t  mtime = 0;     // Fecha de modificacin (en las unidades del sistema de archivos).
+  uint64_t hash = 0;      // Hash del contenido (0 si no se calcul).
+};
+
+// Submalla para escribir en la cach.
+struct MeshCacheSubMesh {
+  std::string materialName;
+  std::string texturePath;
+  uint32_t startIndex = 0;
+  uint32_t indexCount = 0;
+};
+
+// Rango de ndices de una submalla dentro de un nivel de detalle.
+struct MeshCacheRange {
+  uint32_t startIndex = 0;
+  uint32_t indexCount = 0;
+};
+
+// Nivel de detalle para escribir en la cach. Usa los vrtices de su malla.
+struct MeshCacheLod {
+  const uint32_t* indices = nullptr;
+  uint32_t indexCount = 0;
+  float error = 0.0f;                         // Error del nivel en unidades del modelo.
+  std::vector<MeshCacheRange> subMeshRanges;  // Uno por submalla de la malla (o ninguno).
+};
+
+// Malla para escribir en la cach. Los punteros deben seguir vivos durante write().
+struct MeshCacheMesh {
+  std::string name;
+  const void* vertices = nullptr;   // vertexCount * vertexStride bytes.
+  uint32_t vertexCount = 0;
+  const uint32_t* indices = nullptr;
+  uint32_t indexCount = 0;
+  std::vector<MeshCacheSubMesh> subMeshes;
+  std::vector<MeshCacheLod> lods;
+  float aabbMin[3] = { 0.0f, 0.0f, 0.0f };
+  float aabbMax[3] = { 0.0f, 0.0f, 0.0f };
+  float sphere[4] = { 0.0f, 0.0f, 0.0f, 0.0f };  // Centro (x, y, z) y radio.
+  const float* normals = nullptr;    // 3 floats por vrtice, o nullptr si no hay.
+  const float* tangents = nullptr;   // 4 floats por vrtice (x, y, z, signo), o nullptr.
+};
+
+// Vista de una submalla dentro del archivo mapeado.
+struct MeshCacheSubMeshView {
+  std::string_view materialName;
+  std::string_view texturePath;
+  uint32_t startIndex = 0;
+  uint32_t indexCount = 0;
+};
+
+// Vista de una malla dentro del archivo mapeado. Los punteros son vlidos
+// mientras el MeshCache siga abierto.
+struct MeshCacheMeshView {
+  std::string_view name;
+  const void* vertices = nullptr;
+  uint32_t vertexCount = 0;
+  const uint32_t* indices = nullptr;
+  uint32_t indexCount = 0;
+  uint32_t subMeshCount = 0;
+  uint32_t lodCount = 0;
+  float aabbMin[3] = { 0.0f, 0.0f, 0.0f };
+  float aabbMax[3] = { 0.0f, 0.0f, 0.0f };
+  float sphere[4] = { 0.0f, 0.0f, 0.0f, 0.0f };  // Centro (x, y, z) y radio.
+  const float* normals = nullptr;    // 3 floats por vrtice, o nullptr si no hay.
+  const float* tangents = nullptr;   // 4 floats por vrtice (x, y, z, signo), o nullptr.
+};
+
+// Vista de un nivel de detalle dentro del archivo mapeado.
+struct MeshCacheLodView {
+  const uint32_t* indices = nullptr;
+  uint32_t indexCount = 0;
+  float error = 0.0f;
+  const MeshCacheRange* subMeshRanges = nullptr;  // subMeshCount rangos de la malla.
+  uint32_t subMeshCount = 0;
+};
+
+class MeshCache {
+public:
+  // Versin del formato. Se sube cada vez que cambia el layout del archivo.
+  static const uint32_t kVersion = 5;
+
+  MeshCache() = default;
+  ~MeshCache() = default;
+
+  /*
+   * Lee tamao y fecha de 'sourcePath'. Si withHash es true tambin
+   * calcula el hash del contenido. Devuelve false si el archivo no existe.
+   */
+  static bool
+    stampSource(const std::string& sourcePath, MeshCacheSource& out, bool withHash);
+
+  /*
+   * Escribe la cach en 'cachePath' (primero a un temporal y luego lo renombra,
+   * as nunca queda un archivo a medias). 'source' debe traer el hash.
+   * 'settingsHash' identifica las opciones de importacin con las que se
+   * generaron las mallas (soldadura, etc.).
+   */
+  static bool
+    write(const std::string& cachePath,
+      const MeshCacheSource& source,
+      uint64_t settingsHash,
+      uint32_t vertexStride,
+      const std::vector<MeshCacheMesh>& meshes);
+
+  /*
+   * Mapea 'cachePath' y revisa que sea vlida para 'sourcePath':
+   * misma versin, mismas opciones de importacin, mismo tamao de vrtice
+   * y mismo archivo fuente. Tambin revisa que los ndices sean menores que
+   * vertexCount y que los rangos de submallas y LODs quepan en sus ndices.
+   * Devuelve false si no existe, est corrupta o ya no corresponde.
+   */
+  bool
+    open(const std::string& cachePath, const std::string& sourcePath,
+      uint64_t settingsHash, uint32_t vertexStride);
+
+  // Cierra el archivo mapeado.
+  void
+    close();
+
+  // Nmero de mallas en la cach abierta.
+  uint32_t
+    meshCount() const { return m_meshCount; }
+
+  // Vista de la malla 'index'.
+  MeshCacheMeshView
+    mesh(uint32_t index) const;
+
+  // Vista de la submalla 'subIndex' de la malla 'meshIndex'.
+  MeshCacheSubMeshView
+    subMesh(uint32_t meshIndex, uint32_t subIndex) const;
+
+  // Vista del nivel de detalle 'lodIndex' de la malla 'meshIndex'.
+  MeshCacheLodView
+    lod(uint32_t meshIndex, uint32_t lodIndex) const;
+
+  // Hash FNV-1a de 64 bits de un bloque de memoria.
+  static uint64_t
+    hashBytes(const void* data, size_t size);
+
+private:
+  MeshCache(const MeshCache&) = delete;
+  MeshCache& operator=(const MeshCache&) = delete;
+
+  MappedFile m_file;
+  uint32_t m_meshCount = 0;
+};
@@ -1,9 +1,46 @@
 #pragma once
 #include "Prerequisites.h"
-#include "ECS\Component.h"
+#include "ECS/Component.h"
+#include "MeshOptimizer.h"
+#include "MeshletBuilder.h"
+#include "VertexCompression.h"
 
 class DeviceContext;
 
+/// <summary>
+/// Rango contiguo de ndices de una malla que se dibuja con un solo material.
+/// Todos los rangos de una malla comparten sus vrtices.
+/// </summary>
+struct SubMesh {
+  // Nombre del material (usemtl en .obj). Vaco si el archivo no trae material.
+  std::string materialName;
+
+  // Ruta de la textura difusa del material (map_Kd). Vaca si no tiene.
+  std::string texturePath;
+
+  // Primer ndice del rango dentro de m_index.
+  unsigned int startIndex = 0;
+
+  // Nmero de ndices del rango.
+  unsigned int indexCount = 0;
+};
+
+/// <summary>
+/// Nivel de detalle (LOD) simplificado de una malla. Usa los mismos vrtices
+/// (m_vertex) que la malla completa; solo cambian los ndices.
+/// </summary>
+struct MeshLod {
+  // ndices del nivel, sobre m_vertex de la malla.
+  std::vector<unsigned int> indices;
+
+  // Rangos por material, en el mismo orden que m_subMeshes de la malla.
+  // Vaco si la malla no tiene submallas.
+  std::vector<SubMesh> subMeshes;
+
+  // Error del nivel en unidades del modelo: qu tanto se aleja de la malla completa.
+  float error = 0.0f;
+};
+
 /// <summary>
 /// Componente ECS que almacena la informacin de geometra (malla) de un actor.
 /// Contiene vrtices, ndices y contadores bsicos de la malla.
@@ -11,6 +48,11 @@ class DeviceContext;
 class
   MeshComponent : public Component {
 public:
+  /// <summary>
+  /// Tipo con el que Entity busca este componente (ver Entity::getComponent).
+  /// </summary>
+  static constexpr ComponentType kType = ComponentType::MESH;
+
   /// <summary>
   /// Constructor por defecto.
   /// Inicializa la malla con cero vrtices e ndices y la marca como tipo MESH.
@@ -52,6 +94,32 @@ public:
   void
     destroy() override {};
 
+  /// <summary>
+  /// Decide el ancho de ndice de la malla. Si todos los ndices caben en
+  /// 16 bits llena m_index16 y deja m_indexWidth en 2; si no, usa m_index (4).
+  /// Se llama antes de crear el index buffer.
+  /// </summary>
+  void
+    packIndices() {
+    m_indexWidth = MeshOptimizer::chooseIndexWidth(m_index.data(), m_index.size());
+    if (m_indexWidth == 2) {
+      m_index16.resize(m_index.size());
+      MeshOptimizer::packIndices16(m_index.data(), m_index.size(), m_index16.data());
+    }
+    else {
+      m_index16.clear();
+      m_index16.shrink_to_fit();
+    }
+  }
+
+  /// <summary>
+  /// Formato con el que se enlaza el index buffer de esta malla.
+  /// </summary>
+  DXGI_FORMAT
+    getIndexFormat() const {
+    return m_indexWidth == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+  }
+
 public:
   // Nombre de la malla.
   std::string m_name;
@@ -59,12 +127,53 @@ public:
   // Lista de vrtices de la malla.
   std::vector<SimpleVertex> m_vertex;
 
+  // Normal y tangente (x, y, z, signo de la bitangente) de cada vrtice de
+  // m_vertex, en el mismo orden (ver MeshTangents). Vacos si la malla se
+  // import sin generateTangents.
+  std::vector<XMFLOAT3> m_normal;
+  std::vector<XMFLOAT4> m_tangent;
+
   // Lista de ndices que definen las primitivas de la malla.
   std::vector<unsigned int> m_index;
 
+  // Copia de m_index en 16 bits (solo si m_indexWidth es 2, ver packIndices).
+  std::vector<uint16_t> m_index16;
+
+  // Bytes por ndice del index buffer: 4 (m_index) o 2 (m_index16).
+  unsigned int m_indexWidth = 4;
+
   // Nmero total de vrtices en la malla.
   int m_numVertex;
 
   // Nmero total de ndices en la malla.
   int m_numIndex;
+
+  // Rangos de ndices por material. Si est vaco se dibuja toda la malla
+  // con un solo DrawIndexed.
+  std::vector<SubMesh> m_subMeshes;
+
+  // Niveles de detalle simplificados (LOD1, LOD2, ...), del ms detallado
+  // al ms simple. La malla misma es el LOD0.
+  std::vector<MeshLod> m_lods;
+  // Meshlets del LOD0 (ver MeshletBuilder), por submalla y en orden. Cada
+  // meshlet apunta a m_meshletVertices (ndices a m_vertex) y a
+  // m_meshletTriangles (3 ndices locales de un byte por tringulo).
+  std::vector<Meshlet> m_meshlets;
+  std::vector<uint32_t> m_meshletVertices;
+  std::vector<uint8_t> m_meshletTriangles;
+
+  // Formato del vertex buffer. Si no es Full, la GPU usa m_packedVertex
+  // (m_vertex se queda en la CPU) y m_compression trae la escala/centro
+  // para regresar la posicin a espacio local.
+  VertexFormat m_vertexFormat = VertexFormat::Full;
+  std::vector<PackedVertex> m_packedVertex;
+  VertexCompressionReport m_compression;
+
+  // Caja alineada a los ejes de la malla, en espacio local.
+  XMFLOAT3 m_aabbMin = XMFLOAT3(0.0f, 0.0f, 0.0f);
+  XMFLOAT3 m_aabbMax = XMFLOAT3(0.0f, 0.0f, 0.0f);
+  // Esfera envolvente en espacio local: centro de la caja y distancia al
+  // vrtice ms lejano.
+  XMFLOAT3 m_sphereCenter = XMFLOAT3(0.0f, 0.0f, 0.0f);
+  float m_sphereRadius = 0.0f;
 };
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Qu tan bien usa un index buffer el cache de vrtices ya transformados
+ * de la GPU (post-transform cache), simulado como FIFO.
+ *
+ *  - ACMR: vrtices transformados por tringulo. 3.0 es el peor caso
+ *    y ~0.5-0.7 es lo mejor que se consigue en mallas grandes.
+ *  - ATVR: vrtices transformados entre vrtices usados. 1.0 es el ideal.
+ */
+struct VertexCacheStats {
+  size_t triangles = 0;       // Tringulos analizados.
+  size_t vertices = 0;        // Vrtices distintos que usan esos tringulos.
+  size_t transformed = 0;     // Fallos del cache (veces que se corre el vertex shader).
+  double acmr = 0.0;          // transformed / triangles.
+  double atvr = 0.0;          // transformed / vertices.
+};
+
+/*
+ * Clase MeshOptimizer
+ *
+ * Reordena los ndices y vrtices de una malla para que la GPU trabaje menos:
+ *
+ *  1) optimizeVertexCache: reordena los tringulos con Tipsify
+ *     (Sander, Nehab y Barczak 2007) para que los vrtices se reutilicen
+ *     mientras siguen en el cache. Es lineal en el nmero de tringulos.
+ *  2) optimizeVertexFetch: renumera los vrtices en el orden en que los
+ *     usa el index buffer, para que las lecturas del vertex buffer sean
+ *     casi secuenciales.
+ *
+ * Igual que MeshWelder, trabaja con bytes e ndices de 32 bits y no depende
+ * de Direct3D.
+ */
+class MeshOptimizer {
+public:
+  // Tamao de cache que se asume cuando no se indica otro.
+  static const uint32_t kDefaultCacheSize = 16;
+
+  /*
+   * Simula un cache FIFO de 'cacheSize' entradas sobre la lista de tringulos
+   * y regresa ACMR/ATVR. No modifica nada.
+   */
+  static VertexCacheStats
+    analyzeVertexCache(const uint32_t* indices,
+      size_t indexCount,
+      size_t vertexCount,
+      uint32_t cacheSize = kDefaultCacheSize);
+
+  /*
+   * Reordena los tringulos de 'indices' (en el mismo arreglo) con Tipsify.
+   * Cada tringulo conserva su winding. Si algn ndice es >= vertexCount
+   * no se toca nada.
+   */
+  static void
+    optimizeVertexCache(uint32_t* indices,
+      size_t indexCount,
+      size_t vertexCount,
+      uint32_t cacheSize = kDefaultCacheSize);
+
+  /*
+   * Reordena los vrtices en el orden en que aparecen en 'indices' y
+   * reescribe los ndices. Los vrtices que ningn ndice usa se quitan.
+   * Devuelve cuntos vrtices quedaron (el llamador recorta su vector).
+   */
+  static size_t
+    optimizeVertexFetch(void* vertices,
+      size_t vertexCount,
+      size_t vertexStride,
+      uint32_t* indices,
+      size_t indexCount);
+
+  /*
+   * Bytes por ndice que necesita la malla: 2 si todos los ndices caben
+   * en 16 bits, 4 si no. 0xFFFF se deja libre (es el corte de strips en D3D).
+   */
+  static uint32_t
+    chooseIndexWidth(const uint32_t* indices, size_t indexCount);
+
+  /*
+   * Copia 'indices' a 'out' como enteros de 16 bits. Solo es vlido si
+   * chooseIndexWidth regres 2.
+   */
+  static void
+    packIndices16(const uint32_t* indices, size_t indexCount, uint16_t* out);
+
+private:
+  MeshOptimizer() = delete;
+};
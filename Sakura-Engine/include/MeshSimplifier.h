@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Resultado de MeshSimplifier::simplify.
+ */
+struct MeshSimplifyStats {
+  size_t trianglesBefore = 0;  // Tringulos que se recibieron.
+  size_t trianglesAfter = 0;   // Tringulos que quedaron.
+  float error = 0.0f;          // Error mximo de los colapsos, relativo al tamao de la malla.
+  unsigned int passes = 0;     // Pasadas que se hicieron.
+  double seconds = 0.0;        // Tiempo que tard la simplificacin.
+};
+
+/*
+ * Clase MeshSimplifier
+ *
+ * Simplifica una malla colapsando aristas con mtricas de error cudricas
+ * (Garland y Heckbert 1997). Cada vrtice acumula una cudrica de 5
+ * dimensiones (posicin + uv, Garland y Heckbert 1998), as que el costo de
+ * un colapso mide tanto cunto se deforma la superficie como cunto se
+ * estira la textura.
+ *
+ * Los colapsos son "half-edge": un vrtice se une a un vecino que ya existe,
+ * por lo que el resultado es solo una lista de ndices nueva sobre los mismos
+ * vrtices. As todos los niveles de detalle comparten el vertex buffer.
+ *
+ *  - Bordes abiertos: el vrtice solo se puede mover a lo largo del borde.
+ *  - Costuras de uv (dos vrtices en la misma posicin con distinta uv): los
+ *    dos lados se colapsan juntos y a lo largo de la costura, as no se abre.
+ *  - Los vrtices donde se juntan ms de dos lados, o los marcados en
+ *    'vertexLock', no se mueven nunca.
+ *
+ * Trabaja por pasadas: en cada una ordena todos los colapsos posibles por
+ * costo y aplica los ms baratos que no se tocan entre s. El orden no
+ * depende de hilos ni de direcciones de memoria, as que el resultado es
+ * siempre el mismo para la misma entrada.
+ *
+ * Corre al importar, antes de que exista cualquier buffer de la GPU, y solo
+ * produce listas de ndices nuevas sobre los mismos vrtices. Los vrtices
+ * deben traer la posicin (3 floats) y la uv (2 floats) al inicio, como
+ * SimpleVertex.
+ */
+class MeshSimplifier {
+public:
+  /*
+   * Simplifica los tringulos de 'indices' hasta dejar a lo ms
+   * 'targetIndexCount' ndices, sin pasar de 'maxError' (relativo al lado
+   * mayor de la caja de todos los vrtices). Escribe el resultado en 'out',
+   * que debe tener espacio para 'indexCount' ndices, y devuelve cuntos
+   * ndices escribi. Si no se llega al objetivo sin pasar el error, se
+   * queda con lo que se pudo.
+   *
+   * 'attributeWeight' es cunto pesa el error en uv frente al de posicin
+   * (0 = solo geometra). 'vertexLock' es opcional: vertexCount banderas,
+   * distinto de 0 = el vrtice no se puede quitar.
+   */
+  static size_t
+    simplify(const void* vertices,
+      size_t vertexCount,
+      size_t vertexStride,
+      const uint32_t* indices,
+      size_t indexCount,
+      size_t targetIndexCount,
+      float maxError,
+      float attributeWeight,
+      uint32_t* out,
+      const unsigned char* vertexLock = nullptr,
+      MeshSimplifyStats* stats = nullptr);
+
+  /*
+   * Lado mayor de la caja de los vrtices. Multiplicado por
+   * MeshSimplifyStats::error da el error en unidades del modelo.
+   */
+  static float
+    extent(const void* vertices, size_t vertexCount, size_t vertexStride);
+
+private:
+  MeshSimplifier() = delete;
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Resultado de MeshTangents::generate.
+struct MeshTangentStats {
+  size_t verticesBefore = 0;       // Vrtices que se recibieron.
+  size_t verticesAfter = 0;        // Vrtices despus de separar los espejos.
+  size_t splitVertices = 0;        // Vrtices que se duplicaron.
+  size_t degenerateTriangles = 0;  // Tringulos sin rea en uv (no aportan tangente).
+  unsigned int threads = 0;        // Hilos que se usaron.
+  double seconds = 0.0;            // Tiempo de la generacin.
+};
+
+/*
+ * Clase MeshTangents
+ *
+ * Genera una base tangente por vrtice (normal, tangente y signo de la
+ * bitangente) para normal mapping, con las mismas reglas que MikkTSpace:
+ *
+ *  - La tangente de cada esquina sale de las derivadas de la uv del
+ *    tringulo, proyectada sobre el plano de la normal del vrtice.
+ *  - Cada esquina pesa segn su ngulo, no segn el rea del tringulo.
+ *  - El signo es el de dot(cross(N, T), B): bitangente = signo * cross(N, T).
+ *
+ * Las normales se calculan de la geometra (promedio por ngulo de las
+ * caras que comparten la posicin), as que salen suaves tambin a travs
+ * de las costuras de uv.
+ *
+ * Un vrtice solo se separa en dos cuando lo usan caras con la uv en espejo
+ * (signos distintos); el duplicado se agrega al final.
+ *
+ * El trabajo se reparte entre hilos por rangos de tringulos y de vrtices,
+ * y cada vrtice suma sus esquinas siempre en el mismo orden, as que el
+ * resultado es idntico sin importar cuntos hilos haya.
+ *
+ * Las normales y tangentes salen en arreglos de floats aparte; subirlas a
+ * un vertex buffer le toca al Actor. Los vrtices deben traer la posicin
+ * (3 floats) y la uv (2 floats) al inicio, como SimpleVertex.
+ */
+class MeshTangents {
+public:
+  /*
+   * Calcula la base de cada vrtice. Devuelve cuntos vrtices quedaron
+   * (vertexCount ms los duplicados) o 0 si algn ndice es >= vertexCount,
+   * y en ese caso no se toca nada.
+   *
+   *  - 'indices' se reescribe para las esquinas que pasan a un duplicado.
+   *  - 'normals' recibe 3 floats por vrtice y 'tangents' 4 (x, y, z, signo).
+   *  - 'remap' dice de qu vrtice original es cada vrtice de salida (los
+   *    primeros vertexCount son ellos mismos); con l el llamador copia los
+   *    duplicados al final de su vector de vrtices.
+   *
+   * 'threadCount' = 0 usa todos los ncleos.
+   */
+  static size_t
+    generate(const void* vertices,
+      size_t vertexCount,
+      size_t vertexStride,
+      uint32_t* indices,
+      size_t indexCount,
+      std::vector<float>& normals,
+      std::vector<float>& tangents,
+      std::vector<uint32_t>& remap,
+      unsigned int threadCount = 0,
+      MeshTangentStats* stats = nullptr);
+
+private:
+  MeshTangents() = delete;
+};
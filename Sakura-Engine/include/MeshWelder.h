@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Resultado de MeshWelder::weld.
+ */
+struct MeshWeldStats {
+  size_t verticesBefore = 0;  // Vrtices antes de soldar.
+  size_t verticesAfter = 0;   // Vrtices que quedaron.
+  double seconds = 0.0;       // Tiempo que tard la soldadura.
+
+  // Cuntas veces se repeta cada vrtice en promedio (1.0 = no haba duplicados).
+  double ratio() const {
+    return verticesAfter > 0 ? static_cast<double>(verticesBefore) / static_cast<double>(verticesAfter) : 0.0;
+  }
+};
+
+/*
+ * Clase MeshWelder
+ *
+ * Une los vrtices repetidos de una malla y reescribe los ndices.
+ * El FBX genera un vrtice por cada esquina de polgono, as que en una
+ * malla cerrada cada vrtice aparece varias veces; despus de soldar
+ * el vertex buffer es ms chico y la GPU reutiliza mejor los vrtices.
+ *
+ * Trabaja sobre un bloque de vrtices cualquiera donde cada vrtice son
+ * 'vertexStride' bytes de floats (SimpleVertex lo cumple), as que no
+ * depende de Direct3D y se puede probar en Linux con mallas sintticas.
+ *
+ *  - epsilon == 0: solo une vrtices exactamente iguales (0.0 y -0.0 cuentan igual).
+ *  - epsilon  > 0: une vrtices cuyos floats difieren a lo ms 'epsilon'.
+ *    Para buscarlos rpido cada float se redondea a una rejilla de tamao
+ *    epsilon, por lo que dos vrtices muy cerca pero en celdas distintas
+ *    pueden quedar separados. Nunca se unen vrtices ms lejos que epsilon.
+ */
+class MeshWelder {
+public:
+  /*
+   * Suelda en el mismo arreglo: los vrtices que sobreviven quedan al inicio,
+   * en el orden en que aparecen por primera vez, y 'indices' se reescribe.
+   * Devuelve cuntos vrtices quedaron (el llamador recorta su vector).
+   */
+  static size_t
+    weld(void* vertices,
+      size_t vertexCount,
+      size_t vertexStride,
+      uint32_t* indices,
+      size_t indexCount,
+      float epsilon = 0.0f,
+      MeshWeldStats* stats = nullptr);
+
+private:
+  MeshWelder() = delete;
+};
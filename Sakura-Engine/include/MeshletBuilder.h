@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Un meshlet (cluster): grupo pequeo de tringulos vecinos con sus propios
+ * ndices locales, ms los datos para descartarlo completo en la CPU.
+ *
+ * Los vrtices del meshlet son vertexCount entradas de la lista de vrtices
+ * (ndices a m_vertex de la malla) desde vertexOffset. Los tringulos son
+ * triangleCount ternas de ndices locales (un byte cada uno) desde
+ * triangleOffset en la lista de tringulos.
+ */
+struct Meshlet {
+  uint32_t vertexOffset = 0;
+  uint32_t triangleOffset = 0;   // En bytes (3 por tringulo).
+  uint32_t vertexCount = 0;
+  uint32_t triangleCount = 0;
+  uint32_t subMesh = 0;          // Submalla a la que pertenece (0 si la malla no tiene).
+
+  // Esfera envolvente de los vrtices, en espacio local.
+  float center[3] = { 0.0f, 0.0f, 0.0f };
+  float radius = 0.0f;
+
+  // Cono de normales: todas las caras miran a menos de acos(sqrt(1 - cutoff))
+  // de 'coneAxis'. cutoff = 1 significa que el meshlet nunca se descarta por
+  // estar de espaldas.
+  float coneAxis[3] = { 0.0f, 0.0f, 1.0f };
+  float coneCutoff = 1.0f;
+};
+
+// Resultado de MeshletBuilder::build.
+struct MeshletStats {
+  size_t meshlets = 0;            // Meshlets que se crearon.
+  size_t triangles = 0;           // Tringulos repartidos.
+  double averageVertices = 0.0;   // Vrtices promedio por meshlet.
+  double averageTriangles = 0.0;  // Tringulos promedio por meshlet.
+  double seconds = 0.0;           // Tiempo de la construccin.
+};
+
+// Resultado de MeshletBuilder::cull.
+struct MeshletCullStats {
+  size_t visible = 0;        // Meshlets que pasaron.
+  size_t backfacing = 0;     // Descartados porque todas sus caras dan la espalda a la cmara.
+  size_t outside = 0;        // Descartados por estar fuera del frustum.
+  size_t triangles = 0;      // Tringulos que se escribieron.
+};
+
+/*
+ * Clase MeshletBuilder
+ *
+ * Parte una lista de tringulos en meshlets de a lo ms maxVertices vrtices
+ * y maxTriangles tringulos (64 / 124 por defecto, lo que usan las GPUs con
+ * mesh shaders). Es un algoritmo voraz: cada meshlet crece con el tringulo
+ * vecino que agrega menos vrtices nuevos y queda ms cerca de su centro, as
+ * que los meshlets salen compactos y con caras parecidas.
+ *
+ * cull es el pase de la CPU que usa esos datos: descarta los meshlets que
+ * quedan fuera del frustum o de espaldas y escribe los ndices de los dems.
+ *
+ * cull y extractFrustumPlanes reciben la cmara y la matriz como floats
+ * sueltos (por filas, como XMFLOAT4X4), as que la clase no incluye nada de
+ * Direct3D ni de xnamath. Los vrtices deben traer la posicin (3 floats)
+ * al inicio, como SimpleVertex.
+ */
+class MeshletBuilder {
+public:
+  static const uint32_t kDefaultMaxVertices = 64;
+  static const uint32_t kDefaultMaxTriangles = 124;
+
+  // Lmites de los ndices locales de un byte.
+  static const uint32_t kMaxVertices = 256;
+  static const uint32_t kMaxTriangles = 512;
+
+  /*
+   * Agrega a 'meshlets', 'meshletVertices' y 'meshletTriangles' los meshlets
+   * de los tringulos de 'indices' (no vaca lo que ya tengan, as se pueden
+   * construir varias submallas en las mismas listas). Cada tringulo queda
+   * en exactamente un meshlet y conserva su winding. Devuelve cuntos
+   * meshlets agreg.
+   */
+  static size_t
+    build(const void* vertices,
+      size_t vertexCount,
+      size_t vertexStride,
+      const uint32_t* indices,
+      size_t indexCount,
+      uint32_t maxVertices,
+      uint32_t maxTriangles,
+      uint32_t subMesh,
+      std::vector<Meshlet>& meshlets,
+      std::vector<uint32_t>& meshletVertices,
+      std::vector<uint8_t>& meshletTriangles,
+      MeshletStats* stats = nullptr);
+
+  /*
+   * Escribe en 'outIndices' los tringulos (ndices a los vrtices de la
+   * malla) de los meshlets que no se descartan y devuelve cuntos ndices
+   * escribi. 'outIndices' debe tener espacio para todos los tringulos.
+   *
+   * 'cameraPosition' y los planos van en el espacio local de la malla. Cada
+   * plano es (a, b, c, d) con a*x + b*y + c*z + d >= 0 dentro del frustum;
+   * 'planes' puede ser nulo para no recortar por frustum.
+   */
+  static size_t
+    cull(const Meshlet* meshlets,
+      size_t meshletCount,
+      const uint32_t* meshletVertices,
+      const uint8_t* meshletTriangles,
+      const float cameraPosition[3],
+      const float (*planes)[4],
+      size_t planeCount,
+      uint32_t* outIndices,
+      MeshletCullStats* stats = nullptr);
+
+  /*
+   * Los seis planos del frustum (izquierda, derecha, abajo, arriba, cerca,
+   * lejos) de una matriz mundo-vista-proyeccin de Direct3D (vectores fila,
+   * z de 0 a w), normalizados. 'matrix' va por filas, como XMFLOAT4X4.
+   */
+  static void
+    extractFrustumPlanes(const float matrix[16], float planes[6][4]);
+
+private:
+  MeshletBuilder() = delete;
+};
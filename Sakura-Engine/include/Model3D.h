@@ -13,6 +13,27 @@ enum
 	FBX   ///< Modelo en formato .fbx (usando FBX SDK).
 };
 
+/// <summary>
+/// Opciones del post-proceso que se aplica a las mallas despus de importarlas.
+/// Forman parte de la firma de la cach .sakmesh: si cambian, la cach se regenera.
+/// </summary>
+struct
+	MeshImportSettings {
+	bool weldVertices = true;   ///< Une los vrtices repetidos (ver MeshWelder).
+	float weldEpsilon = 0.0f;   ///< 0 = solo vrtices idnticos; > 0 = tolerancia por componente.
+	bool optimizeVertexCache = true;  ///< Reordena tringulos y vrtices (ver MeshOptimizer).
+	unsigned int vertexCacheSize = 16; ///< Entradas del cache de vrtices que se asume.
+	bool compactVertices = true;      ///< Empaca los vrtices para la GPU si el error cabe en vertexLimits.
+	VertexCompressionLimits vertexLimits; ///< Error mximo permitido al empacar (ver VertexCompression).
+	std::vector<float> lodRatios = { 0.5f, 0.25f, 0.125f }; ///< Fraccin de tringulos de cada LOD (vaco = sin LODs).
+	float lodMaxError = 0.05f;        ///< Error mximo de un LOD, relativo al lado mayor de la caja de la malla.
+	float lodAttributeWeight = 0.5f;  ///< Peso del error en uv frente al de posicin (ver MeshSimplifier).
+	bool buildMeshlets = false;       ///< Parte cada malla en meshlets (ver MeshletBuilder). Apagado: el render todava no los usa.
+	unsigned int meshletMaxVertices = 64;   ///< Vrtices mximos por meshlet (hasta 256).
+	unsigned int meshletMaxTriangles = 124; ///< Tringulos mximos por meshlet (hasta 512).
+	bool generateTangents = true;     ///< Calcula normal y tangente de cada vrtice (ver MeshTangents).
+};
+
 /// <summary>
 /// Recurso que representa un modelo 3D compuesto por una o varias mallas.
 /// Puede cargar modelos en formato OBJ o FBX y almacenarlos como MeshComponent.
@@ -25,8 +46,11 @@ public:
 	/// </summary>
 	/// <param name="name">Ruta o nombre del archivo del modelo.</param>
 	/// <param name="modelType">Tipo de modelo (OBJ o FBX).</param>
-	Model3D(const std::string& name, ModelType modelType)
-		: IResource(name), m_modelType(modelType), lSdkManager(nullptr), lScene(nullptr) {
+	/// <param name="settings">Opciones del post-proceso de importacin.</param>
+	Model3D(const std::string& name, ModelType modelType,
+		const MeshImportSettings& settings = MeshImportSettings())
+		: IResource(name), m_modelType(modelType), m_importSettings(settings),
+		lSdkManager(nullptr), lScene(nullptr) {
 		SetType(ResourceType::Model3D);
 		load(name);
 	}
@@ -46,6 +70,8 @@ public:
 
 	/// <summary>
 	/// Inicializa el recurso de modelo 3D.
+	/// Primero intenta leer la cach binaria (ruta + ".sakmesh"); si no existe o ya
+	/// no corresponde al archivo fuente, importa el OBJ/FBX y vuelve a escribir la cach.
 	/// </summary>
 	/// <returns>true si la inicializacin fue exitosa; false en caso contrario.</returns>
 	bool
@@ -71,6 +97,65 @@ public:
 	const std::vector<MeshComponent>&
 		GetMeshes() const { return m_meshes; }
 
+	/* OBJ MODEL LOADER*/
+
+	/// <summary>
+	/// Carga un modelo OBJ con ObjReader y agrega la malla a m_meshes.
+	/// </summary>
+	/// <param name="filePath">Ruta del archivo OBJ.</param>
+	/// <returns>true si se carg una malla vlida.</returns>
+	bool
+		LoadOBJModel(const std::string& filePath);
+
+	/// <summary>
+	/// Post-proceso de las mallas recin importadas (OBJ o FBX): soldadura de
+	/// vrtices, orden para el cache de vrtices segn m_importSettings,
+	/// normales y tangentes y clculo de la AABB.
+	/// </summary>
+	void
+		PostProcessMeshes();
+
+	/// <summary>
+	/// Genera los niveles de detalle (MeshComponent::m_lods) de cada malla segn
+	/// m_importSettings.lodRatios. Las mallas se reparten entre varios hilos; el
+	/// resultado es el mismo sin importar cuntos.
+	/// </summary>
+	void
+		GenerateLods();
+
+	/// <summary>
+	/// Elige el formato de vrtice de cada malla (Full o empacado) segn
+	/// m_importSettings y llena m_packedVertex. Corre tambin al leer la cach.
+	/// </summary>
+	void
+		CompactVertices();
+
+	/// <summary>
+	/// Parte el LOD0 de cada malla en meshlets (MeshComponent::m_meshlets)
+	/// segn m_importSettings, submalla por submalla. Solo hace algo con
+	/// buildMeshlets encendido; entonces corre tambin al leer la cach.
+	/// </summary>
+	void
+		BuildMeshlets();
+
+	/* CACH DE MALLAS (.sakmesh) */
+
+	/// <summary>
+	/// Llena m_meshes desde una cach .sakmesh vlida para m_filePath.
+	/// </summary>
+	/// <param name="cachePath">Ruta del archivo de cach.</param>
+	/// <returns>true si la cach exista y era vlida.</returns>
+	bool
+		LoadMeshCache(const std::string& cachePath);
+
+	/// <summary>
+	/// Escribe m_meshes en una cach .sakmesh ligada al archivo fuente m_filePath.
+	/// </summary>
+	/// <param name="cachePath">Ruta del archivo de cach.</param>
+	/// <returns>true si se pudo escribir.</returns>
+	bool
+		SaveMeshCache(const std::string& cachePath) const;
+
 	/* FBX MODEL LOADER*/
 
 	/// <summary>
@@ -127,5 +212,8 @@ private:
 
 public:
 	ModelType m_modelType;                  // Tipo de modelo (OBJ o FBX).
+	MeshImportSettings m_importSettings;    // Opciones del post-proceso de importacin.
 	std::vector<MeshComponent> m_meshes;    // Mallas resultantes despus de cargar el modelo.
+	bool m_loadedFromCache = false;         // true si la ltima carga sali de la cach .sakmesh.
+	double m_loadSeconds = 0.0;             // Tiempo de la ltima carga (importacin o cach).
 };
@@ -4,6 +4,53 @@
 #include <vector>
 #include <unordered_map>
 
+/*
+ * Datos de la ltima carga del ObjReader.
+ * Sirven para medir el rendimiento del parser (MB/s) y comparar
+ * el camino rpido (load) contra el camino clsico (loadLegacy).
+ */
+struct ObjLoadStats {
+  size_t bytes = 0;       // Tamao del archivo ledo en bytes.
+  double seconds = 0.0;   // Tiempo total de la carga en segundos.
+  unsigned int threads = 1; // Hilos que se usaron para parsear.
+  size_t batches = 0;     // Lotes entregados por loadStreaming (0 en las otras cargas).
+  size_t peakWorkingSetBytes = 0; // Pico de memoria propia de loadStreaming (vectores y cache, sin el archivo mapeado).
+  double preScanSeconds = 0.0; // Tiempo del pre-escaneo (suma de todos los hilos).
+  size_t reallocations = 0; // Veces que un vector o el cache tuvo que crecer.
+
+  // Velocidad de lectura en megabytes por segundo.
+  double megabytesPerSecond() const {
+    return seconds > 0.0 ? (static_cast<double>(bytes) / (1024.0 * 1024.0)) / seconds : 0.0;
+  }
+};
+
+/*
+ * Lote de tringulos que entrega ObjReader::loadStreaming.
+ *
+ * Los ndices son locales al lote (apuntan a 'vertices') y los
+ * punteros solo son vlidos durante la llamada a onBatch.
+ */
+struct ObjMeshBatch {
+  const SimpleVertex* vertices = nullptr;
+  size_t vertexCount = 0;
+  const unsigned int* indices = nullptr;
+  size_t indexCount = 0;
+  size_t batchIndex = 0;      // Nmero de lote, empieza en 0.
+  size_t firstTriangle = 0;   // Tringulos entregados antes de este lote.
+};
+
+/*
+ * Interfaz para recibir los lotes de loadStreaming.
+ * Se implementa en quien consume la malla (un cooker, un particionador, etc.).
+ */
+class IObjBatchSink {
+public:
+  virtual ~IObjBatchSink() = default;
+
+  // Recibe un lote. Si regresa false la carga se cancela.
+  virtual bool onBatch(const ObjMeshBatch& batch) = 0;
+};
+
 /*
  * Clase ObjReader
  *
@@ -14,13 +61,16 @@
  *  - v  -> posiciones
  *  - vt -> coordenadas de textura (uv)
  *  - vn -> normales
- *  - f  -> caras (polgonos)
+ *  - f  -> caras (polgonos); los ndices negativos cuentan desde el ltimo v/vt/vn definido
+ *  - usemtl / mtllib -> un rango de ndices por material (solo load())
+ *  - o  -> nombre de la malla
  *
  * Las caras se convierten a tringulos usando un fan:
  *  (0, i, i+1)
  *
- * Usa un mapa (cache) para no repetir vrtices cuando la
- * misma combinacin v/vt/vn se repite.
+ * Usa un cache para no repetir vrtices cuando la
+ * misma combinacin v/vt/vn se repite. En load() la clave es
+ * la tripleta de ndices empacada en un entero de 64 (o 96) bits.
  *
  * El parmetro flipV permite invertir la componente V de la UV
  * por si la textura est al revs verticalmente.
@@ -41,9 +91,61 @@ public:
    *
    * flipV = true invierte la V de las coordenadas de textura.
    * Devuelve true si se carg algo vlido (tiene vrtices e ndices).
+   *
+   * Los ndices quedan agrupados por material (usemtl) y cada grupo se
+   * guarda en outMesh.m_subMeshes con la textura map_Kd de su .mtl.
+   *
+   * El archivo se mapea a memoria y se tokeniza ah mismo, sin crear
+   * strings ni streams por lnea. El resultado es igual al de loadLegacy,
+   * salvo que tuplas escritas distinto pero con los mismos ndices
+   * ("1/2/3" y "01/2/3") se unen en un solo vrtice.
    */
   bool load(const std::string& path, MeshComponent& outMesh, bool flipV = true);
 
+  /*
+   * Carga clsica con std::getline + std::stringstream.
+   * Se deja como referencia para comparar resultados y velocidad con load().
+   */
+  bool loadLegacy(const std::string& path, MeshComponent& outMesh, bool flipV = true);
+
+  /*
+   * Carga en streaming para archivos muy grandes.
+   *
+   * Recorre el archivo una sola vez y entrega los tringulos a 'sink' en lotes
+   * de hasta 'maxTrianglesPerBatch'. Cada lote trae sus propios vrtices
+   * (sin repetir dentro del lote) e ndices locales, as que solo el lote
+   * actual y su cache viven en memoria. Las posiciones y UVs s se quedan
+   * completas, porque una cara puede usar cualquier v/vt anterior. Del
+   * archivo mapeado solo quedan residentes los ltimos 4 MB recorridos.
+   *
+   * Devuelve true si se entreg al menos un tringulo y nadie cancel.
+   */
+  bool loadStreaming(const std::string& path, IObjBatchSink& sink,
+    size_t maxTrianglesPerBatch = 65536, bool flipV = true);
+
+  /*
+   * Devuelve los datos (bytes y tiempo) de la ltima llamada a load, loadLegacy
+   * o loadStreaming.
+   */
+  const ObjLoadStats& getLastStats() const { return m_lastStats; }
+
+  /*
+   * Nmero de hilos que usa load() para parsear el archivo por bloques.
+   * 1 (por defecto) parsea en el hilo actual; 0 usa todos los ncleos.
+   * La malla resultante es la misma sin importar cuntos hilos se usen.
+   */
+  void setThreadCount(unsigned int threads) { m_threadCount = threads; }
+  unsigned int getThreadCount() const { return m_threadCount; }
+
+  /*
+   * Activa el pre-escaneo (activo por defecto). Antes de parsear se hace una
+   * pasada rpida que cuenta v, vt, vn y esquinas de cara, y con eso los
+   * vectores se reservan una sola vez. Al desactivarlo se vuelve a las
+   * reservas aproximadas; sirve para comparar reallocations y tiempo.
+   */
+  void setPreScan(bool enabled) { m_preScan = enabled; }
+  bool getPreScan() const { return m_preScan; }
+
 private:
   /*
    * Revisa si la cadena termina en ".obj" o ".OBJ".
@@ -72,6 +174,23 @@ private:
    */
   static void logWarn_(const std::string& msg);
 
+  /*
+   * Lee un archivo .mtl y llena diffuseMaps con material -> textura difusa (map_Kd).
+   * Las rutas de textura se regresan con 'folder' al inicio (la carpeta del .obj).
+   * Devuelve false si no se pudo abrir el archivo.
+   */
+  static bool loadMtl_(const std::string& path, const std::string& folder,
+    std::unordered_map<std::string, std::string>& diffuseMaps);
+
+  // Datos de la ltima carga.
+  ObjLoadStats m_lastStats;
+
+  // Hilos para el parseo por bloques de load().
+  unsigned int m_threadCount = 1;
+
+  // Pre-escaneo para reservar memoria exacta.
+  bool m_preScan = true;
+
   // Se deshabilita la copia del objeto para evitar duplicados
   ObjReader(const ObjReader&) = delete;
   ObjReader& operator=(const ObjReader&) = delete;
@@ -20,10 +20,10 @@
 // Libreras de terceros (EngineUtilities: vectores y sistema de memoria)
 #include "EngineUtilities/Vectors/Vector2.h"
 #include "EngineUtilities/Vectors/Vector3.h"
-#include "EngineUtilities\Memory\TSharedPointer.h"
-#include "EngineUtilities\Memory\TWeakPointer.h"
-#include "EngineUtilities\Memory\TStaticPtr.h"
-#include "EngineUtilities\Memory\TUniquePtr.h"
+#include "EngineUtilities/Memory/TSharedPointer.h"
+#include "EngineUtilities/Memory/TWeakPointer.h"
+#include "EngineUtilities/Memory/TStaticPtr.h"
+#include "EngineUtilities/Memory/TUniquePtr.h"
 
 // MACROS
 
@@ -120,5 +120,6 @@ enum
   NONE = 0,     ///< Tipo de componente no especificado.
   TRANSFORM = 1,///< Componente de transformacin.
   MESH = 2,     ///< Componente de malla.
-  MATERIAL = 3  ///< Componente de material.
+  MATERIAL = 3, ///< Componente de material.
+  MAX_COMPONENT_TYPES = 4 ///< Cuntos tipos hay (no es un tipo).
 };
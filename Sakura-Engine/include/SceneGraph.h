@@ -0,0 +1,197 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Resultado de la ltima SceneGraph::update.
+struct SceneGraphStats {
+  size_t nodes = 0;          // Nodos en el grafo.
+  size_t dirtyRoots = 0;     // Subrboles que se recalcularon (nodos marcados sin ancestro marcado).
+  size_t updatedNodes = 0;   // Matrices mundo recalculadas.
+  size_t tasks = 0;          // Rangos en los que se reparti el trabajo.
+  unsigned int threads = 0;  // Hilos que se usaron.
+  bool rebuilt = false;      // Si se volvi a armar el orden (cambi la jerarqua).
+  double seconds = 0.0;      // Tiempo de la actualizacin.
+};
+
+/*
+ * Clase SceneGraph
+ *
+ * Jerarqua padre/hijo de la escena. Cada nodo tiene una matriz local y su
+ * matriz mundo es local * mundo del padre (convencin de vectores fila,
+ * igual que XMMATRIX). Las matrices son 16 floats por renglones, el mismo
+ * layout que XMFLOAT4X4.
+ *
+ * Los nodos se guardan en arreglos planos en orden de profundidad (cada
+ * padre antes que sus hijos y cada subrbol en un rango contiguo), as que
+ * propagar un subrbol es una sola pasada lineal. update solo recorre los
+ * subrboles de los nodos a los que se les cambi la matriz local desde la
+ * ltima vez; subrboles distintos (y los hijos de un subrbol grande) se
+ * reparten entre hilos.
+ *
+ * Los nmeros de nodo no cambian aunque la jerarqua cambie. Cambiar la
+ * jerarqua (create, destroy, setParent) solo marca que hay que volver a
+ * ordenar; eso se hace una vez en el siguiente update.
+ *
+ * No depende de Direct3D.
+ */
+class SceneGraph {
+public:
+  // Nodo que no existe (o "sin padre").
+  static const uint32_t kInvalidNode = 0xFFFFFFFFu;
+
+  SceneGraph() = default;
+  ~SceneGraph() = default;
+
+  // Crea un nodo con matriz local identidad, hijo de 'parent' (o raz).
+  uint32_t
+    create(uint32_t parent = kInvalidNode);
+
+  // Borra el nodo; sus hijos pasan a ser hijos del padre del nodo.
+  void
+    destroy(uint32_t node);
+
+  /*
+   * Cambia el padre del nodo (kInvalidNode = raz). No hace nada si
+   * 'parent' es el mismo nodo o uno de sus descendientes.
+   */
+  void
+    setParent(uint32_t node, uint32_t parent);
+
+  uint32_t
+    getParent(uint32_t node) const {
+    return isValid(node) ? m_parentOf[node] : kInvalidNode;
+  }
+
+  // Cambia la matriz local del nodo; su subrbol se recalcula en el siguiente update.
+  void
+    setLocal(uint32_t node, const float matrix[16]);
+
+  /*
+   * setLocal de varios nodos ('matrices' = 16 floats por nodo). Se puede
+   * llamar desde varios hilos a la vez con nodos distintos, mientras nadie
+   * cambie la jerarqua ni llame a update.
+   */
+  void
+    setLocals(const uint32_t* nodes, const float* matrices, size_t count);
+
+  // Matriz mundo del nodo calculada en el ltimo update.
+  const float*
+    getWorld(uint32_t node) const { return &m_world[size_t(m_slotOf[node]) * 16]; }
+
+  /*
+   * Nmero de la ltima update que cambi la matriz mundo del nodo
+   * (siempre > 0). Sirve para saber si algo que depende de ella est al da.
+   */
+  uint32_t
+    getWorldVersion(uint32_t node) const { return m_worldVersion[m_slotOf[node]]; }
+
+  bool
+    isValid(uint32_t node) const { return node < m_slotOf.size() && m_slotOf[node] != kInvalidNode; }
+
+  // Dato del usuario en el nodo (por ejemplo el Actor); nulo al crearlo.
+  void
+    setUserData(uint32_t node, void* userData) { if (isValid(node)) m_userData[node] = userData; }
+
+  void*
+    getUserData(uint32_t node) const { return isValid(node) ? m_userData[node] : nullptr; }
+
+  /*
+   * Recalcula las matrices mundo de los subrboles marcados.
+   * 'threadCount' = 0 usa todos los ncleos. Cada llamada que reparte crea
+   * sus propios hilos; desde un sistema del SystemScheduler conviene la
+   * versin con ParallelFor.
+   */
+  void
+    update(unsigned int threadCount = 0);
+
+  // Corre fn(begin, end) sobre trozos de [0, count) y regresa cuando terminaron todos.
+  typedef std::function<void(size_t count, const std::function<void(size_t, size_t)>& fn)> ParallelFor;
+
+  /*
+   * Igual que update, pero las tareas se las pasa a 'parallelFor' (por
+   * ejemplo SystemScheduler::parallelFor) en vez de crear hilos.
+   * 'threadCount' solo decide en cuntas tareas se parte el trabajo.
+   */
+  void
+    update(unsigned int threadCount, const ParallelFor& parallelFor);
+
+  /*
+   * Llama fn(node) con cada nodo cuya matriz mundo recalcul el ltimo
+   * update (getLastStats().updatedNodes en total), en orden de profundidad.
+   * Vale hasta el siguiente update o destroy.
+   */
+  template <typename Fn>
+  void
+    forEachUpdated(Fn&& fn) const {
+    for (const Range& range : m_updatedRanges) {
+      for (uint32_t slot = range.begin; slot < range.end; ++slot) fn(m_nodeOfSlot[slot]);
+    }
+  }
+
+  // Nodos vivos.
+  size_t
+    size() const { return m_nodeOfSlot.size(); }
+
+  const SceneGraphStats&
+    getLastStats() const { return m_lastStats; }
+
+private:
+  struct Range {
+    uint32_t begin;
+    uint32_t end;
+  };
+
+  // Saca el nodo de la lista de hijos de su padre (o de las races).
+  void
+    unlink(uint32_t node);
+
+  // Lo agrega al final de la lista de hijos de 'parent' (o de las races).
+  void
+    link(uint32_t node, uint32_t parent);
+
+  void
+    markDirty(uint32_t node);
+
+  // Vuelve a poner los arreglos por slot en orden de profundidad.
+  void
+    rebuild();
+
+  // Recalcula las matrices mundo de los slots [begin, end).
+  void
+    propagate(uint32_t begin, uint32_t end);
+
+  // Las dos versiones de update; sin 'parallelFor' se usan hilos propios.
+  void
+    updateWith(unsigned int threadCount, const ParallelFor* parallelFor);
+
+  // Por nmero de nodo.
+  std::vector<uint32_t> m_slotOf;       // Posicin en los arreglos por slot (kInvalidNode = libre).
+  std::vector<uint32_t> m_parentOf;
+  std::vector<uint32_t> m_firstChild;
+  std::vector<uint32_t> m_lastChild;
+  std::vector<uint32_t> m_nextSibling;
+  std::vector<uint32_t> m_prevSibling;
+  std::vector<unsigned char> m_isDirty;
+  std::vector<void*> m_userData;
+  std::vector<uint32_t> m_freeNodes;
+  uint32_t m_firstRoot = kInvalidNode;
+  uint32_t m_lastRoot = kInvalidNode;
+
+  // Por slot (orden de profundidad despus de rebuild).
+  std::vector<uint32_t> m_nodeOfSlot;
+  std::vector<uint32_t> m_parentSlot;   // kInvalidNode si es raz.
+  std::vector<uint32_t> m_subtreeSize;  // El nodo y todos sus descendientes.
+  std::vector<float> m_local;           // 16 floats por slot.
+  std::vector<float> m_world;           // 16 floats por slot.
+  std::vector<uint32_t> m_worldVersion;
+
+  std::vector<Range> m_updatedRanges;   // Slots que recalcul el ltimo update (ver forEachUpdated).
+  std::vector<uint32_t> m_dirtyNodes;   // Nodos marcados desde el ltimo update.
+  std::mutex m_dirtyMutex;              // Protege m_dirtyNodes en setLocals.
+  bool m_orderDirty = false;
+  uint32_t m_version = 1;
+  SceneGraphStats m_lastStats;
+};
@@ -101,6 +101,24 @@ public:
     CreateInputLayout(Device& device,
       std::vector<D3D11_INPUT_ELEMENT_DESC> Layout);
 
+  /**
+   * @brief Indica si hay Input Layout para un formato de vrtice.
+   *
+   * Full usa el layout de init(); los formatos empacados se crean junto con l
+   * (ver InputLayout::describe) y pueden faltar si el vertex shader no los acepta.
+   */
+  bool
+    supportsVertexFormat(VertexFormat format) const;
+
+  /**
+   * @brief Enlaza solo el Input Layout del formato de vrtice indicado.
+   *
+   * @param deviceContext Contexto donde se aplicar el layout.
+   * @param format        Formato de vrtice de la malla que se va a dibujar.
+   */
+  void
+    renderInputLayout(DeviceContext& deviceContext, VertexFormat format);
+
   /**
    * @brief Crea un shader (Vertex o Pixel) a partir del archivo establecido en @c m_shaderFileName.
    *
@@ -156,6 +174,11 @@ public:
    */
   InputLayout m_inputLayout;
 
+  /**
+   * @brief Input Layouts de los formatos de vrtice empacados (el de Full no se usa).
+   */
+  InputLayout m_packedLayouts[static_cast<size_t>(VertexFormat::Count)];
+
 private:
   /**
    * @brief Nombre del archivo HLSL asociado a este programa de shaders.
@@ -1,6 +1,8 @@
 #pragma once
 #include "Prerequisites.h"
 #include "ECS/Actor.h"     // Actor, getComponent, etc.
+#include "ECS/SystemScheduler.h"
+#include "ECS/CommandBuffer.h"
 
 #include <vector>
 
@@ -8,6 +10,15 @@
 struct ID3D11Device;
 struct ID3D11DeviceContext;
 
+/**
+ * @brief Marca la entidad seleccionada en la UI. Es un componente disperso
+ *        del World (ver IsSparseComponent): seleccionar no mueve la entidad
+ *        de arquetipo y cualquier sistema puede preguntar World::has<Selected>.
+ */
+struct Selected {
+  static constexpr bool kSparseStorage = true;
+};
+
 /**
  * @brief Capa de interfaz de usuario basada en Dear ImGui.
  *
@@ -31,10 +42,53 @@ public:
   void init(void* hwnd, ID3D11Device* device, ID3D11DeviceContext* context);
 
   /**
-   * @brief Asocia el vector de actores de la escena para poder mostrarlos
-   *        en el panel de jerarqua.
+   * @brief Asocia el World de la escena: el panel de jerarqua lista las
+   *        entidades con ActorRef (ver Actor::setWorld) y la seleccin se
+   *        guarda como EntityHandle, as que si la entidad se destruye la
+   *        seleccin simplemente deja de ser vlida.
+   */
+  void setSceneWorld(World* world);
+
+  /**
+   * @brief Cuntos Transform se recalcularon en este frame (se muestra en la jerarqua).
    */
-  void setSceneActors(const std::vector<EU::TSharedPointer<Actor>>* actors);
+  void setDirtyTransformCount(size_t count) { m_dirtyTransformCount = count; }
+
+  /**
+   * @brief Cuntos actores se actualizaron en este frame (los que cambiaron).
+   */
+  void setUpdatedActorCount(size_t count) { m_updatedActorCount = count; }
+
+  /**
+   * @brief Resultado de la ltima SceneGraph::update (se muestra en la jerarqua).
+   */
+  void setSceneGraphStats(const SceneGraphStats& stats) { m_sceneGraphStats = stats; }
+
+  /**
+   * @brief Resultado del ltimo SystemScheduler::run (tiempo de cada sistema).
+   */
+  void setSchedulerStats(const SchedulerStats& stats) { m_schedulerStats = stats; }
+
+  /**
+   * @brief Resultado de la ltima CommandQueue::playback (cambios estructurales diferidos).
+   */
+  void setCommandStats(const CommandStats& stats) { m_commandStats = stats; }
+
+  /**
+   * @brief Estado del ndice espacial de los actores y cuntos pasaron el
+   *        frustum en el ltimo frame.
+   */
+  void setActorTreeStats(const AabbTreeStats& stats, size_t visible)
+  {
+    m_actorTreeStats = stats;
+    m_visibleActorCount = visible;
+  }
+
+  /**
+   * @brief Selecciona la entidad como si se hiciera clic en la jerarqua
+   *        (por ejemplo la que se eligi con el mouse en la escena).
+   */
+  void selectEntity(EntityHandle entity) { select_(entity); }
 
   /**
    * @brief Construye la UI para el frame actual (ventanas ImGui, jerarqua,
@@ -57,8 +111,15 @@ private:
   // ---------------------------------------------------------------------
   // Datos de escena
   // ---------------------------------------------------------------------
-  const std::vector<EU::TSharedPointer<Actor>>* m_actors = nullptr;
-  Actor* m_selectedActor = nullptr;
+  World* m_world = nullptr;
+  EntityHandle m_selected;   // Entidad seleccionada (con la marca Selected).
+  size_t m_dirtyTransformCount = 0;
+  size_t m_updatedActorCount = 0;
+  SceneGraphStats m_sceneGraphStats;
+  SchedulerStats m_schedulerStats;
+  CommandStats m_commandStats;
+  AabbTreeStats m_actorTreeStats;
+  size_t m_visibleActorCount = 0;
 
   // Cache sencillo para editar el Transform del actor seleccionado.
   bool        m_hasCachedTransform = false;
@@ -71,4 +132,10 @@ private:
   void drawMainMenuBar_();
   void drawHierarchy_();
   void drawInspector_();
+
+  // Cambia la seleccin (mueve la marca Selected).
+  void select_(EntityHandle entity);
+
+  // Actor de la entidad seleccionada, o nullptr si ya no existe.
+  Actor* selectedActor_();
 };
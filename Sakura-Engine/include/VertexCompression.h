@@ -0,0 +1,113 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Formatos de vrtice que puede usar una malla en la GPU.
+ *
+ *  - Full:       SimpleVertex tal cual (float3 posicin + float2 uv, 20 bytes).
+ *  - PackedHalf: posicin snorm16 x4 relativa a la caja de la malla + uv half x2 (12 bytes).
+ *  - PackedUnorm: posicin snorm16 x4 relativa a la caja + uv unorm16 x2 (12 bytes).
+ *    Solo sirve si todas las uv estn en [0, 1], pero tiene ms precisin que half.
+ *
+ * La posicin empacada va de -1 a 1 dentro de la caja; para regresar a
+ * espacio local se multiplica por 'scale' y se le suma 'offset'
+ * (ver VertexCompressionReport). La cuarta componente siempre vale 1.
+ */
+enum class
+  VertexFormat : uint32_t {
+  Full = 0,
+  PackedHalf,
+  PackedUnorm,
+  Count
+};
+
+// Vrtice empacado de PackedHalf y PackedUnorm.
+struct PackedVertex {
+  int16_t  pos[4];  // snorm16: x, y, z, 1.
+  uint16_t tex[2];  // half o unorm16 segn el formato.
+};
+
+// Tolerancias para decidir si una malla se puede empacar.
+struct VertexCompressionLimits {
+  float maxPositionError = 1.0e-4f;     // Relativo a la diagonal de la caja de la malla.
+  float maxTexCoordError = 1.0f / 2048.0f; // Absoluto, en unidades de uv.
+};
+
+// Resultado de VertexCompression::compress.
+struct VertexCompressionReport {
+  VertexFormat format = VertexFormat::Full;
+  float scale[3] = { 1.0f, 1.0f, 1.0f };  // Media caja: de snorm a espacio local.
+  float offset[3] = { 0.0f, 0.0f, 0.0f }; // Centro de la caja.
+  float maxPositionError = 0.0f;          // Error mximo medido en la posicin (unidades locales).
+  float maxTexCoordError = 0.0f;          // Error mximo medido en la uv.
+  size_t bytesBefore = 0;                 // Bytes del vertex buffer con Full.
+  size_t bytesAfter = 0;                  // Bytes con el formato elegido.
+};
+
+/*
+ * Clase VertexCompression
+ *
+ * Cuantiza los vrtices de una malla para que ocupen menos memoria y ancho
+ * de banda. Incluye los kernels de conversin (float <-> half, snorm16,
+ * unorm16) con SSE2 cuando est disponible y una versin escalar para el
+ * resto, y la codificacin octadrica para normales y tangentes.
+ *
+ * Aqu solo se convierten nmeros; los D3D11_INPUT_ELEMENT_DESC que
+ * describen cada formato a la GPU estn en InputLayout::describe.
+ */
+class VertexCompression {
+public:
+  // Bytes por vrtice de cada formato.
+  static size_t
+    vertexStride(VertexFormat format);
+
+  /*
+   * Elige el formato ms chico que respeta 'limits' y empaca los vrtices.
+   * 'vertices' son 'vertexCount' vrtices de 'vertexStride' bytes con la
+   * posicin (3 floats) al inicio y la uv (2 floats) justo despus, como
+   * SimpleVertex. Si ningn formato empacado cumple, regresa Full y
+   * 'packed' queda vaco.
+   */
+  static VertexFormat
+    compress(const void* vertices,
+      size_t vertexCount,
+      size_t vertexStride,
+      const VertexCompressionLimits& limits,
+      std::vector<PackedVertex>& packed,
+      VertexCompressionReport* report = nullptr);
+
+  /*
+   * Regresa los vrtices empacados a floats (posicin x3 + uv x2 por vrtice)
+   * en 'out', que debe tener espacio para 5 * count floats.
+   */
+  static void
+    decompress(const PackedVertex* packed,
+      size_t count,
+      const VertexCompressionReport& report,
+      float* out);
+
+  /* KERNELS (count = nmero de valores, no de vrtices) */
+
+  static void encodeHalf(const float* in, size_t count, uint16_t* out);
+  static void decodeHalf(const uint16_t* in, size_t count, float* out);
+
+  // snorm16: [-1, 1] -> [-32767, 32767]. Los valores fuera de rango se recortan.
+  static void encodeSnorm16(const float* in, size_t count, int16_t* out);
+  static void decodeSnorm16(const int16_t* in, size_t count, float* out);
+
+  // unorm16: [0, 1] -> [0, 65535]. Los valores fuera de rango se recortan.
+  static void encodeUnorm16(const float* in, size_t count, uint16_t* out);
+  static void decodeUnorm16(const uint16_t* in, size_t count, float* out);
+
+  /*
+   * Codificacin octadrica: un vector unitario (x, y, z) se guarda en dos
+   * snorm16. 'in' trae count vectores de 3 floats y 'out' recibe 2 * count valores.
+   */
+  static void encodeOctahedral(const float* in, size_t count, int16_t* out);
+  static void decodeOctahedral(const int16_t* in, size_t count, float* out);
+
+private:
+  VertexCompression() = delete;
+};
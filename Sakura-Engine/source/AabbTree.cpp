@@ -0,0 +1,495 @@
+#include "AabbTree.h"
+
+#include <algorithm>
+#include <cmath>
+
+const uint32_t AabbTree::kInvalidProxy;
+
+// La caja gorda se achica (se reinserta) si es ms grande que la real con este mltiplo del margen.
+static const float kHugeMarginScale_ = 4.0f;
+
+// Mitad del rea de la caja (basta para comparar costos).
+static inline float
+area_(const float* min, const float* max) {
+  const float dx = max[0] - min[0];
+  const float dy = max[1] - min[1];
+  const float dz = max[2] - min[2];
+  return dx * dy + dy * dz + dz * dx;
+}
+
+static inline float
+unionArea_(const float* minA, const float* maxA, const float* minB, const float* maxB) {
+  float min[3];
+  float max[3];
+  for (int i = 0; i < 3; ++i) {
+    min[i] = (std::min)(minA[i], minB[i]);
+    max[i] = (std::max)(maxA[i], maxB[i]);
+  }
+  return area_(min, max);
+}
+
+static inline bool
+overlaps_(const float* minA, const float* maxA, const float* minB, const float* maxB) {
+  return minA[0] <= maxB[0] && maxA[0] >= minB[0] &&
+    minA[1] <= maxB[1] && maxA[1] >= minB[1] &&
+    minA[2] <= maxB[2] && maxA[2] >= minB[2];
+}
+
+// true si la caja B queda toda dentro de A.
+static inline bool
+contains_(const float* minA, const float* maxA, const float* minB, const float* maxB) {
+  return minA[0] <= minB[0] && minA[1] <= minB[1] && minA[2] <= minB[2] &&
+    maxA[0] >= maxB[0] && maxA[1] >= maxB[1] && maxA[2] >= maxB[2];
+}
+
+static inline bool
+touchesSphere_(const float* min, const float* max, const float* center, float radiusSq) {
+  float distanceSq = 0.0f;
+  for (int i = 0; i < 3; ++i) {
+    const float d = center[i] < min[i] ? min[i] - center[i] : (center[i] > max[i] ? center[i] - max[i] : 0.0f);
+    distanceSq += d * d;
+  }
+  return distanceSq <= radiusSq;
+}
+
+// Distancia a la que el rayo entra a la caja, o -1 si no la cruza en [0, maxDistance].
+static inline float
+rayEnter_(const float* min, const float* max, const float* origin, const float* inverse, float maxDistance) {
+  float enter = 0.0f;
+  float exit = maxDistance;
+  for (int i = 0; i < 3; ++i) {
+    float t1 = (min[i] - origin[i]) * inverse[i];
+    float t2 = (max[i] - origin[i]) * inverse[i];
+    if (t1 > t2) std::swap(t1, t2);
+    // (NaN si el origen est justo en el plano y la direccin es 0: se toma como dentro)
+    enter = t1 > enter ? t1 : enter;
+    exit = t2 < exit ? t2 : exit;
+    if (enter > exit) return -1.0f;
+  }
+  return enter;
+}
+
+/*
+ * Prueba la caja contra los planos de 'mask' (un bit por plano). Devuelve
+ * false si queda toda fuera de alguno; en 'mask' quedan solo los planos
+ * que la cortan (los que tiene toda adentro ya no hace falta revisarlos en
+ * sus hijos).
+ */
+static inline bool
+frustumTest_(const float* min, const float* max, const float planes[6][4], uint32_t& mask) {
+  for (int p = 0; p < 6; ++p) {
+    if (!(mask & (1u << p))) continue;
+    const float* plane = planes[p];
+    // Esquina ms adentro y ms afuera respecto al plano
+    const float mostInside = plane[0] * (plane[0] >= 0.0f ? max[0] : min[0]) +
+      plane[1] * (plane[1] >= 0.0f ? max[1] : min[1]) +
+      plane[2] * (plane[2] >= 0.0f ? max[2] : min[2]) + plane[3];
+    if (mostInside < 0.0f) return false;
+    const float leastInside = plane[0] * (plane[0] >= 0.0f ? min[0] : max[0]) +
+      plane[1] * (plane[1] >= 0.0f ? min[1] : max[1]) +
+      plane[2] * (plane[2] >= 0.0f ? min[2] : max[2]) + plane[3];
+    if (leastInside >= 0.0f) mask &= ~(1u << p);
+  }
+  return true;
+}
+
+AabbTree::AabbTree(float margin)
+  : m_margin(margin) {
+}
+
+uint32_t
+AabbTree::insert(const float min[3], const float max[3], void* userData) {
+  const uint32_t proxy = allocateNode();
+  Leaf& leaf = m_leaves[proxy];
+  Node& node = m_nodes[proxy];
+  for (int i = 0; i < 3; ++i) {
+    leaf.min[i] = min[i];
+    leaf.max[i] = max[i];
+    node.min[i] = min[i] - m_margin;
+    node.max[i] = max[i] + m_margin;
+  }
+  leaf.userData = userData;
+  node.height = 0;
+  insertLeaf(proxy);
+  ++m_proxyCount;
+  return proxy;
+}
+
+void
+AabbTree::remove(uint32_t proxy) {
+  removeLeaf(proxy);
+  freeNode(proxy);
+  --m_proxyCount;
+}
+
+bool
+AabbTree::update(uint32_t proxy, const float min[3], const float max[3]) {
+  ++m_updates;
+  Leaf& leaf = m_leaves[proxy];
+  for (int i = 0; i < 3; ++i) {
+    leaf.min[i] = min[i];
+    leaf.max[i] = max[i];
+  }
+
+  // Sigue dentro de la caja gorda y esta no qued exagerada (el objeto se achic): nada que hacer
+  Node& node = m_nodes[proxy];
+  if (contains_(node.min, node.max, min, max)) {
+    const float huge = kHugeMarginScale_ * m_margin;
+    const float hugeMin[3] = { min[0] - huge, min[1] - huge, min[2] - huge };
+    const float hugeMax[3] = { max[0] + huge, max[1] + huge, max[2] + huge };
+    if (contains_(hugeMin, hugeMax, node.min, node.max)) {
+      return false;
+    }
+  }
+
+  removeLeaf(proxy);
+  for (int i = 0; i < 3; ++i) {
+    m_nodes[proxy].min[i] = min[i] - m_margin;
+    m_nodes[proxy].max[i] = max[i] + m_margin;
+  }
+  insertLeaf(proxy);
+  ++m_reinserts;
+  return true;
+}
+
+void
+AabbTree::queryAabb(const float min[3], const float max[3], std::vector<void*>& results) const {
+  if (m_root == kInvalidProxy) return;
+  thread_local std::vector<uint32_t> stack;
+  stack.clear();
+  stack.push_back(m_root);
+  while (!stack.empty()) {
+    const uint32_t index = stack.back();
+    stack.pop_back();
+    const Node& node = m_nodes[index];
+    if (!overlaps_(node.min, node.max, min, max)) continue;
+    if (node.height == 0) {
+      const Leaf& leaf = m_leaves[index];
+      if (overlaps_(leaf.min, leaf.max, min, max)) results.push_back(leaf.userData);
+    }
+    else {
+      stack.push_back(node.child1);
+      stack.push_back(node.child2);
+    }
+  }
+}
+
+void
+AabbTree::querySphere(const float center[3], float radius, std::vector<void*>& results) const {
+  if (m_root == kInvalidProxy) return;
+  const float radiusSq = radius * radius;
+  thread_local std::vector<uint32_t> stack;
+  stack.clear();
+  stack.push_back(m_root);
+  while (!stack.empty()) {
+    const uint32_t index = stack.back();
+    stack.pop_back();
+    const Node& node = m_nodes[index];
+    if (!touchesSphere_(node.min, node.max, center, radiusSq)) continue;
+    if (node.height == 0) {
+      const Leaf& leaf = m_leaves[index];
+      if (touchesSphere_(leaf.min, leaf.max, center, radiusSq)) results.push_back(leaf.userData);
+    }
+    else {
+      stack.push_back(node.child1);
+      stack.push_back(node.child2);
+    }
+  }
+}
+
+void
+AabbTree::queryFrustum(const float planes[6][4], std::vector<void*>& results) const {
+  if (m_root == kInvalidProxy) return;
+  // Cada entrada lleva los planos que todava cortan a su padre
+  struct Entry {
+    uint32_t node;
+    uint32_t mask;
+  };
+  thread_local std::vector<Entry> stack;
+  stack.clear();
+  stack.push_back({ m_root, 0x3Fu });
+  while (!stack.empty()) {
+    const Entry entry = stack.back();
+    stack.pop_back();
+    const Node& node = m_nodes[entry.node];
+    uint32_t mask = entry.mask;
+    if (mask && !frustumTest_(node.min, node.max, planes, mask)) continue;
+    if (node.height == 0) {
+      const Leaf& leaf = m_leaves[entry.node];
+      // Si la caja gorda qued toda adentro, la real tambin
+      if (!mask || frustumTest_(leaf.min, leaf.max, planes, mask)) results.push_back(leaf.userData);
+    }
+    else {
+      stack.push_back({ node.child1, mask });
+      stack.push_back({ node.child2, mask });
+    }
+  }
+}
+
+void
+AabbTree::raycast(const float origin[3], const float direction[3], float maxDistance,
+  std::vector<AabbRayHit>& hits) const {
+  if (m_root == kInvalidProxy) return;
+  const float inverse[3] = { 1.0f / direction[0], 1.0f / direction[1], 1.0f / direction[2] };
+  const size_t first = hits.size();
+  thread_local std::vector<uint32_t> stack;
+  stack.clear();
+  stack.push_back(m_root);
+  while (!stack.empty()) {
+    const uint32_t index = stack.back();
+    stack.pop_back();
+    const Node& node = m_nodes[index];
+    if (rayEnter_(node.min, node.max, origin, inverse, maxDistance) < 0.0f) continue;
+    if (node.height == 0) {
+      const Leaf& leaf = m_leaves[index];
+      const float distance = rayEnter_(leaf.min, leaf.max, origin, inverse, maxDistance);
+      if (distance >= 0.0f) hits.push_back({ leaf.userData, distance });
+    }
+    else {
+      stack.push_back(node.child1);
+      stack.push_back(node.child2);
+    }
+  }
+  std::sort(hits.begin() + first, hits.end(),
+    [](const AabbRayHit& a, const AabbRayHit& b) { return a.distance < b.distance; });
+}
+
+void
+AabbTree::frustumPlanes(const float viewProjection[16], float planes[6][4]) {
+  // Con vectores fila, clip = v * M: cada coordenada de clip sale de una columna
+  const float* m = viewProjection;
+  for (int i = 0; i < 4; ++i) {
+    const float x = m[i * 4 + 0];
+    const float y = m[i * 4 + 1];
+    const float z = m[i * 4 + 2];
+    const float w = m[i * 4 + 3];
+    planes[0][i] = w + x;   // Izquierda
+    planes[1][i] = w - x;   // Derecha
+    planes[2][i] = w + y;   // Abajo
+    planes[3][i] = w - y;   // Arriba
+    planes[4][i] = z;       // Cerca (z >= 0)
+    planes[5][i] = w - z;   // Lejos
+  }
+  for (int p = 0; p < 6; ++p) {
+    const float length = std::sqrt(planes[p][0] * planes[p][0] + planes[p][1] * planes[p][1] +
+      planes[p][2] * planes[p][2]);
+    if (length > 0.0f) {
+      for (int i = 0; i < 4; ++i) planes[p][i] /= length;
+    }
+  }
+}
+
+AabbTreeStats
+AabbTree::getStats() const {
+  AabbTreeStats stats;
+  stats.proxies = m_proxyCount;
+  stats.nodes = m_nodeCount;
+  stats.updates = m_updates;
+  stats.reinserts = m_reinserts;
+  if (m_root == kInvalidProxy) return stats;
+
+  stats.height = m_nodes[m_root].height;
+  float internalArea = 0.0f;
+  for (const Node& node : m_nodes) {
+    if (node.height > 0) internalArea += area_(node.min, node.max);
+  }
+  const float rootArea = area_(m_nodes[m_root].min, m_nodes[m_root].max);
+  stats.areaRatio = rootArea > 0.0f ? internalArea / rootArea : 0.0f;
+  return stats;
+}
+
+uint32_t
+AabbTree::allocateNode() {
+  uint32_t index;
+  if (m_freeList != kInvalidProxy) {
+    index = m_freeList;
+    m_freeList = m_nodes[index].parent;
+  }
+  else {
+    index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+    m_leaves.emplace_back();
+  }
+  Node& node = m_nodes[index];
+  node.parent = kInvalidProxy;
+  node.child1 = kInvalidProxy;
+  node.child2 = kInvalidProxy;
+  node.height = 0;
+  m_leaves[index].userData = nullptr;
+  ++m_nodeCount;
+  return index;
+}
+
+void
+AabbTree::freeNode(uint32_t node) {
+  m_nodes[node].parent = m_freeList;
+  m_nodes[node].height = -1;
+  m_freeList = node;
+  --m_nodeCount;
+}
+
+void
+AabbTree::insertLeaf(uint32_t leaf) {
+  if (m_root == kInvalidProxy) {
+    m_root = leaf;
+    m_nodes[leaf].parent = kInvalidProxy;
+    return;
+  }
+
+  // Bajar hacia el hermano donde la caja nueva agrega menos rea: lo que
+  // cuesta el padre nuevo ms lo que crecen los ancestros
+  const float* leafMin = m_nodes[leaf].min;
+  const float* leafMax = m_nodes[leaf].max;
+  uint32_t sibling = m_root;
+  while (m_nodes[sibling].height > 0) {
+    const Node& node = m_nodes[sibling];
+    const float area = area_(node.min, node.max);
+    const float combinedArea = unionArea_(node.min, node.max, leafMin, leafMax);
+    const float cost = combinedArea;                  // Padre nuevo de este nodo y la hoja.
+    const float inherited = combinedArea - area;      // Lo que crece este nodo si la hoja baja.
+
+    float childCost[2];
+    const uint32_t children[2] = { node.child1, node.child2 };
+    for (int c = 0; c < 2; ++c) {
+      const Node& child = m_nodes[children[c]];
+      const float combined = unionArea_(child.min, child.max, leafMin, leafMax);
+      childCost[c] = (child.height == 0 ? combined : combined - area_(child.min, child.max)) + inherited;
+    }
+    if (cost < childCost[0] && cost < childCost[1]) break;
+    sibling = childCost[0] < childCost[1] ? children[0] : children[1];
+  }
+
+  // Padre nuevo en el lugar del hermano
+  const uint32_t oldParent = m_nodes[sibling].parent;
+  const uint32_t newParent = allocateNode();
+  Node& parent = m_nodes[newParent];
+  const Node& siblingNode = m_nodes[sibling];
+  const Node& leafNode = m_nodes[leaf];
+  for (int i = 0; i < 3; ++i) {
+    parent.min[i] = (std::min)(siblingNode.min[i], leafNode.min[i]);
+    parent.max[i] = (std::max)(siblingNode.max[i], leafNode.max[i]);
+  }
+  parent.parent = oldParent;
+  parent.child1 = sibling;
+  parent.child2 = leaf;
+  parent.height = siblingNode.height + 1;
+  m_nodes[sibling].parent = newParent;
+  m_nodes[leaf].parent = newParent;
+
+  if (oldParent == kInvalidProxy) {
+    m_root = newParent;
+  }
+  else if (m_nodes[oldParent].child1 == sibling) {
+    m_nodes[oldParent].child1 = newParent;
+  }
+  else {
+    m_nodes[oldParent].child2 = newParent;
+  }
+
+  refitFrom(oldParent);
+}
+
+void
+AabbTree::removeLeaf(uint32_t leaf) {
+  if (leaf == m_root) {
+    m_root = kInvalidProxy;
+    return;
+  }
+
+  // El hermano toma el lugar del padre
+  const uint32_t parent = m_nodes[leaf].parent;
+  const uint32_t grandParent = m_nodes[parent].parent;
+  const uint32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+  freeNode(parent);
+  m_nodes[sibling].parent = grandParent;
+  if (grandParent == kInvalidProxy) {
+    m_root = sibling;
+    return;
+  }
+  if (m_nodes[grandParent].child1 == parent) {
+    m_nodes[grandParent].child1 = sibling;
+  }
+  else {
+    m_nodes[grandParent].child2 = sibling;
+  }
+  refitFrom(grandParent);
+}
+
+void
+AabbTree::refitFrom(uint32_t index) {
+  while (index != kInvalidProxy) {
+    rotate(index);
+    Node& node = m_nodes[index];
+    const Node& child1 = m_nodes[node.child1];
+    const Node& child2 = m_nodes[node.child2];
+    node.height = 1 + (std::max)(child1.height, child2.height);
+    for (int i = 0; i < 3; ++i) {
+      node.min[i] = (std::min)(child1.min[i], child2.min[i]);
+      node.max[i] = (std::max)(child1.max[i], child2.max[i]);
+    }
+    index = node.parent;
+  }
+}
+
+void
+AabbTree::rotate(uint32_t iA) {
+  /*
+   * Un hijo de 'a' puede bajar a cambio de un nieto del otro lado. De las
+   * cuatro opciones se toma la que ms reduce el rea del hijo que cambia
+   * (la caja de 'a' no cambia):
+   *
+   *       a                a
+   *      / \              / \
+   *     b   c     =>     f   c
+   *        / \              / \
+   *       f   g            b   g
+   */
+  Node& a = m_nodes[iA];
+  if (a.height < 2) return;
+  const uint32_t children[2] = { a.child1, a.child2 };
+
+  float bestGain = 0.0f;
+  int bestSide = -1;        // Hijo de 'a' que recibe al que baja.
+  int bestGrandChild = -1;  // Nieto que sube (0 = child1, 1 = child2).
+  for (int side = 0; side < 2; ++side) {
+    const Node& receiver = m_nodes[children[side]];
+    if (receiver.height == 0) continue;
+    const Node& down = m_nodes[children[1 - side]];
+    const float area = area_(receiver.min, receiver.max);
+    const uint32_t grandChildren[2] = { receiver.child1, receiver.child2 };
+    for (int up = 0; up < 2; ++up) {
+      // Se queda el otro nieto junto con el que baja
+      const Node& stays = m_nodes[grandChildren[1 - up]];
+      const float gain = area - unionArea_(down.min, down.max, stays.min, stays.max);
+      if (gain > bestGain) {
+        bestGain = gain;
+        bestSide = side;
+        bestGrandChild = up;
+      }
+    }
+  }
+  if (bestSide < 0) return;
+
+  const uint32_t iReceiver = children[bestSide];
+  const uint32_t iDown = children[1 - bestSide];
+  Node& receiver = m_nodes[iReceiver];
+  uint32_t& upSlot = bestGrandChild == 0 ? receiver.child1 : receiver.child2;
+  const uint32_t iUp = upSlot;
+  upSlot = iDown;
+  m_nodes[iDown].parent = iReceiver;
+  if (bestSide == 0) {
+    a.child2 = iUp;
+  }
+  else {
+    a.child1 = iUp;
+  }
+  m_nodes[iUp].parent = iA;
+
+  const Node& child1 = m_nodes[receiver.child1];
+  const Node& child2 = m_nodes[receiver.child2];
+  for (int i = 0; i < 3; ++i) {
+    receiver.min[i] = (std::min)(child1.min[i], child2.min[i]);
+    receiver.max[i] = (std::max)(child1.max[i], child2.max[i]);
+  }
+  receiver.height = 1 + (std::max)(child1.height, child2.height);
+}
@@ -1,5 +1,6 @@
 ﻿#include "BaseApp.h"
 #include "ResourceManager.h"
+#include <filesystem>
 
 // Para que el WndProc pueda pasarle eventos a ImGui
 #include "imgui.h"
@@ -9,6 +10,13 @@
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(
   HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
+// Recursos que no son componentes; los sistemas los declaran con estas
+// etiquetas para que el scheduler sepa cuáles no pueden correr a la vez
+struct SceneGraphAccess_ {};
+struct LodSelectorAccess_ {};
+struct DeviceContextAccess_ {};
+struct AabbTreeAccess_ {};
+
 int
 BaseApp::run(HINSTANCE hInst, int nCmdShow) {
   // Inicializar ventana (Window se encarga de registrar y crear el HWND)
@@ -119,6 +127,37 @@ BaseApp::init() {
     );
   }
 
+  // Define the input layout (antes de los actores: setMesh necesita saber
+  // qué formatos de vértice empacados acepta el shader)
+  std::vector<D3D11_INPUT_ELEMENT_DESC> Layout;
+  D3D11_INPUT_ELEMENT_DESC position;
+  position.SemanticName = "POSITION";
+  position.SemanticIndex = 0;
+  position.Format = DXGI_FORMAT_R32G32B32_FLOAT;
+  position.InputSlot = 0;
+  position.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT /*0*/;
+  position.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+  position.InstanceDataStepRate = 0;
+  Layout.push_back(position);
+
+  D3D11_INPUT_ELEMENT_DESC texcoord;
+  texcoord.SemanticName = "TEXCOORD";
+  texcoord.SemanticIndex = 0;
+  texcoord.Format = DXGI_FORMAT_R32G32_FLOAT;
+  texcoord.InputSlot = 0;
+  texcoord.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT /*0*/;
+  texcoord.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+  texcoord.InstanceDataStepRate = 0;
+  Layout.push_back(texcoord);
+
+  // Create the Shader Program
+  hr = m_shaderProgram.init(m_device, "Sakura-Engine.fx", Layout);
+  if (FAILED(hr)) {
+    ERROR("Main", "InitDevice",
+      ("Failed to initialize ShaderProgram. HRESULT: " + std::to_string(hr)).c_str());
+    return hr;
+  }
+
   // ---------------------------------------------------------------------
   //  Carga de recursos: Modelo Alien + textura
   // ---------------------------------------------------------------------
@@ -138,12 +177,30 @@ BaseApp::init() {
     }
     alienTextures.push_back(m_Alien_Texture);
 
+    m_alien->setShaderProgram(&m_shaderProgram);
+    m_alien->setWorld(&m_world);
+    m_alien->setSceneGraph(&m_sceneGraph);
+    m_alien->setLodSelector(&m_lodSelector);
+    m_alien->setAabbTree(&m_actorTree);
     m_alien->setMesh(m_device, alienMeshes);
+
+    // LODs hechos a mano, si vienen junto al modelo. Reemplazan a los generados
+    const char* alienLods[] = { "Alien_LOD1.fbx", "Alien_LOD2.fbx" };
+    const float alienLodScreenSize[] = { 0.5f, 0.25f };
+    MeshImportSettings lodSettings;
+    lodSettings.lodRatios.clear();
+    for (unsigned int k = 0; k < 2; k++) {
+      if (!std::filesystem::exists(alienLods[k])) {
+        break;
+      }
+      Model3D lodModel(alienLods[k], ModelType::FBX, lodSettings);
+      m_alien->addLod(m_device, lodModel.GetMeshes(), alienLodScreenSize[k]);
+    }
     m_alien->setTextures(alienTextures);
     m_alien->setName("Alien");
     m_actors.push_back(m_alien);
-    m_ui.setSceneActors(&m_actors);
-    m_alien->getComponent<Transform>()->setTransform(
+    m_ui.setSceneWorld(&m_world);
+    m_alien->getComponentPtr<Transform>()->setTransform(
       // Posición: un poco abajo y al fondo
       EU::Vector3(0.0f, -1.0f, 6.0f),
       // Rotación
@@ -157,36 +214,6 @@ BaseApp::init() {
     return E_FAIL;
   }
 
-  // Define the input layout
-  std::vector<D3D11_INPUT_ELEMENT_DESC> Layout;
-  D3D11_INPUT_ELEMENT_DESC position;
-  position.SemanticName = "POSITION";
-  position.SemanticIndex = 0;
-  position.Format = DXGI_FORMAT_R32G32B32_FLOAT;
-  position.InputSlot = 0;
-  position.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT /*0*/;
-  position.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-  position.InstanceDataStepRate = 0;
-  Layout.push_back(position);
-
-  D3D11_INPUT_ELEMENT_DESC texcoord;
-  texcoord.SemanticName = "TEXCOORD";
-  texcoord.SemanticIndex = 0;
-  texcoord.Format = DXGI_FORMAT_R32G32_FLOAT;
-  texcoord.InputSlot = 0;
-  texcoord.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT /*0*/;
-  texcoord.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-  texcoord.InstanceDataStepRate = 0;
-  Layout.push_back(texcoord);
-
-  // Create the Shader Program
-  hr = m_shaderProgram.init(m_device, "Sakura-Engine.fx", Layout);
-  if (FAILED(hr)) {
-    ERROR("Main", "InitDevice",
-      ("Failed to initialize ShaderProgram. HRESULT: " + std::to_string(hr)).c_str());
-    return hr;
-  }
-
   // Create the constant buffers
   hr = m_cbNeverChanges.init(m_device, sizeof(CBNeverChanges));
   if (FAILED(hr)) {
@@ -222,9 +249,84 @@ BaseApp::init() {
   m_Projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, m_window.m_width / (FLOAT)m_window.m_height, 0.01f, 100.0f);
   cbChangesOnResize.mProjection = XMMatrixTranspose(m_Projection);
 
+  initSystems();
+
   return S_OK;
 }
 
+void
+BaseApp::initSystems() {
+  // Transforms de todos los actores, seguidos en memoria y repartidos en
+  // trozos entre los hilos. Solo se recalculan los que cambiaron; sus
+  // matrices locales nuevas pasan al SceneGraph (un candado por trozo)
+  m_scheduler.addSystem("Transforms", 0, World::maskOf<Transform, SceneGraphAccess_>(),
+    [this](float deltaTime) {
+    std::atomic<size_t> dirtyTransforms(0);
+    m_scheduler.parallelForChunks<Transform>(m_world, 1024, [&](const WorldChunk& chunk) {
+      std::vector<EntityHandle> changed;
+      std::vector<uint32_t> nodes;
+      std::vector<XMFLOAT4X4> locals;
+      m_world.forEachInChunk<Transform>(chunk, [&](EntityHandle entity, Transform& transform) {
+        if (!transform.isDirty()) {
+          return;
+        }
+        transform.update(deltaTime);
+        changed.push_back(entity);
+        if (transform.getSceneNode() != SceneGraph::kInvalidNode) {
+          nodes.push_back(transform.getSceneNode());
+          locals.emplace_back();
+          XMStoreFloat4x4(&locals.back(), transform.matrix);
+        }
+      });
+      if (!nodes.empty()) {
+        m_sceneGraph.setLocals(nodes.data(), &locals[0].m[0][0], nodes.size());
+      }
+      m_world.markChanged<Transform>(changed.data(), changed.size());
+      dirtyTransforms += changed.size();
+    });
+    m_dirtyTransforms = dirtyTransforms;
+  });
+
+  // Matrices mundo solo de los nodos que cambiaron y sus descendientes. Si
+  // hay muchos, los subárboles se reparten en los hilos del scheduler
+  m_scheduler.addSystem("SceneGraph", 0, World::maskOf<SceneGraphAccess_>(), [this](float) {
+    m_sceneGraph.update(m_scheduler.getThreadCount(),
+      [this](size_t count, const std::function<void(size_t, size_t)>& fn) { m_scheduler.parallelFor(count, 1, fn); });
+  });
+
+  // Actualiza los actores y sube sus constant buffers: usa el contexto
+  // inmediato, así que corre en el hilo principal. Solo pasa por los que
+  // cambiaron de Transform o de malla y por los nodos que el SceneGraph
+  // recalculó en este frame (los hijos se mueven con su padre aunque su
+  // Transform no cambie); en una escena quieta no hace nada. Esos son
+  // también los únicos que mueven su caja en m_actorTree
+  m_changedActors.watch<Transform, MeshComponent>();
+  m_scheduler.addSystem("Actors", World::maskOf<Transform, SceneGraphAccess_>(),
+    World::maskOf<DeviceContextAccess_, LodSelectorAccess_, AabbTreeAccess_>(),
+    [this](float deltaTime) {
+    size_t updated = m_changedActors.forEachChanged([&](ActorRef& ref) {
+      ref.actor->update(deltaTime, m_deviceContext);
+    });
+    // Los que ya pasaron arriba quedan al día y se saltan
+    m_sceneGraph.forEachUpdated([&](uint32_t node) {
+      Actor* actor = static_cast<Actor*>(m_sceneGraph.getUserData(node));
+      if (actor && !actor->isWorldCurrent()) {
+        actor->update(deltaTime, m_deviceContext);
+        ++updated;
+      }
+    });
+    m_updatedActors = updated;
+  }, SystemScheduler::kMainThread);
+
+  // Nivel de detalle de todos los actores con la cámara y proyección de este frame
+  m_scheduler.addSystem("LOD", 0, World::maskOf<LodSelectorAccess_>(), [this](float) {
+    XMFLOAT3 eye;
+    XMStoreFloat3(&eye, XMMatrixInverse(nullptr, m_View).r[3]);
+    const float cameraPosition[3] = { eye.x, eye.y, eye.z };
+    m_lodSelector.select(cameraPosition, XMVectorGetY(m_Projection.r[1]), (float)m_window.m_height);
+  });
+}
+
 void BaseApp::update(float deltaTime)
 {
   // Update our time
@@ -250,17 +352,70 @@ void BaseApp::update(float deltaTime)
   cbChangesOnResize.mProjection = XMMatrixTranspose(m_Projection);
   m_cbChangeOnResize.update(m_deviceContext, nullptr, 0, nullptr, &cbChangesOnResize, 0, 0);
 
-  // Update Actors
-  for (auto& actor : m_actors) {
-    actor->update(deltaTime, m_deviceContext);
+  // Clic en la escena (no sobre una ventana de ImGui): seleccionar el actor
+  // bajo el mouse. Se lee el clic del frame anterior, antes del NewFrame
+  if (ImGui::IsMouseClicked(ImGuiMouseButton_Left) && !ImGui::GetIO().WantCaptureMouse) {
+    const ImVec2 mouse = ImGui::GetIO().MousePos;
+    if (Actor* picked = pickActor(mouse.x, mouse.y)) {
+      m_ui.selectEntity(picked->getEntityHandle());
+    }
   }
 
+  // Sistemas del frame: transforms, jerarquía, actores y LOD (ver initSystems).
+  // Los que no usan lo mismo corren a la vez en los hilos del scheduler
+  m_scheduler.run(deltaTime);
+
+  // Punto de sincronización: ningún sistema está corriendo, así que aquí se
+  // aplican de una vez los create/destroy/add/remove que anotaron en m_commands
+  m_commands.playback(m_world);
+
+  // Actores a dibujar: los que tocan el frustum, con las cajas ya movidas.
+  // Los que no tienen caja en m_actorTree no se pueden recortar y se
+  // dibujan siempre
+  XMFLOAT4X4 viewProjection;
+  XMStoreFloat4x4(&viewProjection, XMMatrixMultiply(m_View, m_Projection));
+  AabbTree::frustumPlanes(&viewProjection.m[0][0], m_frustumPlanes);
+  m_visibleActors.clear();
+  m_actorTree.queryFrustum(m_frustumPlanes, m_visibleActors);
+  for (const EU::TSharedPointer<Actor>& actor : m_actors) {
+    if (!actor.isNull() && !actor->isInAabbTree()) {
+      m_visibleActors.push_back(actor.get());
+    }
+  }
+
+  m_ui.setDirtyTransformCount(m_dirtyTransforms);
+  m_ui.setUpdatedActorCount(m_updatedActors);
+  m_ui.setSceneGraphStats(m_sceneGraph.getLastStats());
+  m_ui.setSchedulerStats(m_scheduler.getLastStats());
+  m_ui.setCommandStats(m_commands.getLastStats());
+  m_ui.setActorTreeStats(m_actorTree.getStats(), m_visibleActors.size());
+  m_actorTree.resetCounters();
+
   // ------------------------------------------------
   // IMGUI: construir la UI (ventanas, dockspace, etc.)
   // ------------------------------------------------
   m_ui.update();
 }
 
+Actor*
+BaseApp::pickActor(float x, float y) {
+  // El punto en el plano cercano y en el lejano (z = 0 y z = 1), en espacio mundo
+  const float ndcX = 2.0f * x / m_window.m_width - 1.0f;
+  const float ndcY = 1.0f - 2.0f * y / m_window.m_height;
+  const XMMATRIX inverse = XMMatrixInverse(nullptr, XMMatrixMultiply(m_View, m_Projection));
+  XMFLOAT3 nearPoint;
+  XMFLOAT3 farPoint;
+  XMStoreFloat3(&nearPoint, XMVector3TransformCoord(XMVectorSet(ndcX, ndcY, 0.0f, 1.0f), inverse));
+  XMStoreFloat3(&farPoint, XMVector3TransformCoord(XMVectorSet(ndcX, ndcY, 1.0f, 1.0f), inverse));
+
+  // Con dirección = lejano - cercano, la distancia 1 es el plano lejano
+  const float origin[3] = { nearPoint.x, nearPoint.y, nearPoint.z };
+  const float direction[3] = { farPoint.x - nearPoint.x, farPoint.y - nearPoint.y, farPoint.z - nearPoint.z };
+  std::vector<AabbRayHit> hits;
+  m_actorTree.raycast(origin, direction, 1.0f, hits);
+  return hits.empty() ? nullptr : static_cast<Actor*>(hits[0].userData);
+}
+
 void
 BaseApp::render() {
   // Set Render Target View
@@ -280,9 +435,9 @@ BaseApp::render() {
   m_cbNeverChanges.render(m_deviceContext, 0, 1);
   m_cbChangeOnResize.render(m_deviceContext, 1, 1);
 
-  // Render all actors
-  for (auto& actor : m_actors) {
-    actor->render(m_deviceContext);
+  // Render de los actores visibles (ver update)
+  for (void* actor : m_visibleActors) {
+    static_cast<Actor*>(actor)->render(m_deviceContext);
   }
 
   // ------------------------------------------------
@@ -25,16 +25,22 @@ Buffer::init(Device& device, const MeshComponent& mesh, unsigned int bindFlag) {
 	m_bindFlag = bindFlag;
 
 	if (bindFlag & D3D11_BIND_VERTEX_BUFFER) {
-		m_stride = sizeof(SimpleVertex);
+		// Vrtices empacados si la malla los tiene (ver VertexCompression)
+		const bool packed = mesh.m_vertexFormat != VertexFormat::Full && mesh.m_packedVertex.size() == mesh.m_vertex.size();
+		m_stride = packed ? sizeof(PackedVertex) : sizeof(SimpleVertex);
 		desc.ByteWidth = m_stride * static_cast<unsigned int>(mesh.m_vertex.size());
 		desc.BindFlags = (D3D11_BIND_FLAG)bindFlag;
-		data.pSysMem = mesh.m_vertex.data();
+		data.pSysMem = packed ? static_cast<const void*>(mesh.m_packedVertex.data())
+			: static_cast<const void*>(mesh.m_vertex.data());
 	}
 	else if (bindFlag & D3D11_BIND_INDEX_BUFFER) {
-		m_stride = sizeof(unsigned int);
+		// ndices de 16 bits si la malla ya los empac (MeshComponent::packIndices)
+		const bool use16 = mesh.m_indexWidth == 2 && mesh.m_index16.size() == mesh.m_index.size();
+		m_stride = use16 ? sizeof(uint16_t) : sizeof(unsigned int);
 		desc.ByteWidth = m_stride * static_cast<unsigned int>(mesh.m_index.size());
 		desc.BindFlags = (D3D11_BIND_FLAG)bindFlag;
-		data.pSysMem = mesh.m_index.data();
+		data.pSysMem = use16 ? static_cast<const void*>(mesh.m_index16.data())
+			: static_cast<const void*>(mesh.m_index.data());
 	}
 
 	return createBuffer(device, desc, &data);
@@ -113,6 +119,10 @@ Buffer::render(DeviceContext& deviceContext,
 		}
 		break;
 	case D3D11_BIND_INDEX_BUFFER:
+		// Sin formato explcito se usa el ancho con el que se cre el buffer
+		if (format == DXGI_FORMAT_UNKNOWN) {
+			format = (m_stride == sizeof(uint16_t)) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+		}
 		deviceContext.m_deviceContext->IASetIndexBuffer(m_buffer, format, m_offset);
 		break;
 	default:
@@ -2,6 +2,9 @@
 #include "MeshComponent.h"
 #include "Device.h"
 #include "DeviceContext.h"
+#include "MeshBounds.h"
+#include <algorithm>
+#include <cctype>
 
 /// <summary>
 /// Constructor del Actor.
@@ -85,12 +88,75 @@ Actor::update(float deltaTime, DeviceContext& deviceContext) {
 		}
 	}
 
-	// Actualizar los datos del modelo (matriz mundo y color del mesh)
-	m_model.mWorld = XMMatrixTranspose(getComponent<Transform>()->matrix);
-	m_model.vMeshColor = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+	// Datos del modelo (matriz mundo y color del mesh): solo se vuelven a
+	// subir cuando la matriz mundo cambi desde la ltima vez (el Transform
+	// del actor o, en el SceneGraph, el de algn ancestro)
+	const uint32_t worldVersion = getWorldVersion();
+	if (worldVersion != m_modelVersion) {
+		m_model.mWorld = XMMatrixTranspose(getWorldMatrix());
+		m_model.vMeshColor = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+		m_modelBuffer.update(deviceContext, nullptr, 0, nullptr, &m_model, 0, 0);
+		m_modelVersion = worldVersion;
+	}
+
+	// Volmenes en espacio mundo: solo cuando la matriz mundo cambi
+	if (worldVersion != m_boundsVersion) {
+		updateWorldBounds();
+	}
+}
 
-	// Actualizar el constant buffer asociado al modelo
-	m_modelBuffer.update(deviceContext, nullptr, 0, nullptr, &m_model, 0, 0);
+/// <summary>
+/// Matriz mundo del actor: la del SceneGraph si est en uno, si no la del Transform.
+/// </summary>
+XMMATRIX
+Actor::getWorldMatrix() {
+	const Transform* transform = getComponentPtr<Transform>();
+	if (m_sceneGraph && m_sceneGraph->isValid(transform->getSceneNode())) {
+		return XMLoadFloat4x4(reinterpret_cast<const XMFLOAT4X4*>(
+			m_sceneGraph->getWorld(transform->getSceneNode())));
+	}
+	return transform->matrix;
+}
+
+/// <summary>
+/// Versin de la matriz mundo (ver getWorldMatrix).
+/// </summary>
+uint32_t
+Actor::getWorldVersion() {
+	const Transform* transform = getComponentPtr<Transform>();
+	if (m_sceneGraph && m_sceneGraph->isValid(transform->getSceneNode())) {
+		return m_sceneGraph->getWorldVersion(transform->getSceneNode());
+	}
+	return transform->getVersion();
+}
+
+/// <summary>
+/// Recalcula la caja y la esfera en espacio mundo con la matriz mundo
+/// y se las pasa al selector de LOD y al ndice espacial.
+/// </summary>
+void
+Actor::updateWorldBounds() {
+	const XMMATRIX world = getWorldMatrix();
+
+	XMFLOAT4X4 matrix;
+	XMStoreFloat4x4(&matrix, world);
+	MeshBounds::transformAabb(&matrix.m[0][0], &m_localAabbMin.x, &m_localAabbMax.x,
+		&m_worldAabbMin.x, &m_worldAabbMax.x);
+
+	// El radio se escala con el eje ms estirado de la matriz
+	XMStoreFloat3(&m_worldSphereCenter, XMVector3TransformCoord(XMLoadFloat3(&m_boundsCenter), world));
+	const float scale = (std::max)(XMVectorGetX(XMVector3Length(world.r[0])),
+		(std::max)(XMVectorGetX(XMVector3Length(world.r[1])), XMVectorGetX(XMVector3Length(world.r[2]))));
+	m_worldSphereRadius = m_boundsRadius * scale;
+
+	if (m_lodSelector && m_lodSlot != LodSelector::kInvalidSlot) {
+		m_lodSelector->setBounds(m_lodSlot, m_worldSphereCenter.x, m_worldSphereCenter.y,
+			m_worldSphereCenter.z, m_worldSphereRadius);
+	}
+	if (m_aabbTree && m_treeProxy != AabbTree::kInvalidProxy) {
+		m_aabbTree->update(m_treeProxy, &m_worldAabbMin.x, &m_worldAabbMax.x);
+	}
+	m_boundsVersion = getWorldVersion();
 }
 
 /// <summary>
@@ -115,14 +181,76 @@ Actor::render(DeviceContext& deviceContext) {
 	// Topologa de tringulos para dibujar las mallas
 	deviceContext.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-	// Actualizar buffer y dibujar todas las mallas del actor
-	for (unsigned int i = 0; i < m_meshes.size(); i++) {
+	// Nivel elegido por el selector en la ltima LodSelector::select
+	m_lodLevel = 0;
+	if (m_lodSelector && m_lodSlot != LodSelector::kInvalidSlot) {
+		m_lodLevel = (std::min)(m_lodSelector->lod(m_lodSlot), static_cast<unsigned int>(m_lodLevels.size()));
+	}
+
+	if (m_lodLevel == 0) {
+		renderMeshes(deviceContext, m_meshes, m_vertexBuffers, m_indexBuffers,
+			m_meshModelBuffers, m_meshModelVersion, m_subMeshTexture);
+	}
+	else {
+		LodLevel& level = m_lodLevels[m_lodLevel - 1];
+		renderMeshes(deviceContext, level.meshes,
+			level.sharesVertices ? m_vertexBuffers : level.vertexBuffers,
+			level.indexBuffers, level.modelBuffers, level.modelVersion, level.subMeshTexture);
+	}
+}
+
+/// <summary>
+/// Dibuja las mallas de un nivel de detalle: Input Layout de las mallas
+/// empacadas, vertex/index buffers, constant buffer del modelo (o el de la
+/// malla, si est empacada) y un DrawIndexed por submalla.
+/// </summary>
+/// <param name="deviceContext">Contexto de dispositivo usado para dibujar.</param>
+/// <param name="meshes">Mallas del nivel.</param>
+/// <param name="vertexBuffers">Vertex buffer de cada malla.</param>
+/// <param name="indexBuffers">Index buffer de cada malla.</param>
+/// <param name="modelBuffers">Constant buffer de cada malla empacada.</param>
+/// <param name="modelVersion">m_modelVersion con la que se llenaron los modelBuffers.</param>
+/// <param name="subMeshTexture">Por malla y submalla: ndice en m_materialTextures o -1.</param>
+void
+Actor::renderMeshes(DeviceContext& deviceContext,
+	const std::vector<MeshComponent>& meshes,
+	std::vector<Buffer>& vertexBuffers,
+	std::vector<Buffer>& indexBuffers,
+	std::vector<Buffer>& modelBuffers,
+	uint32_t& modelVersion,
+	const std::vector<std::vector<int>>& subMeshTexture) {
+	// Los constant buffers de las mallas empacadas se vuelven a llenar solo
+	// si m_model cambi desde la ltima vez que se dibuj este nivel
+	const bool refreshPacked = modelVersion != m_modelVersion;
+	modelVersion = m_modelVersion;
+
+	bool packedBound = false;
+	for (unsigned int i = 0; i < meshes.size(); i++) {
+		const MeshComponent& mesh = meshes[i];
+		const bool packed = mesh.m_vertexFormat != VertexFormat::Full;
+
+		// Malla empacada: su Input Layout, y en su constant buffer la matriz
+		// mundo con la escala y el centro de la caja, para regresar la
+		// posicin snorm a espacio local
+		if (packed || packedBound) {
+			m_shaderProgram->renderInputLayout(deviceContext, mesh.m_vertexFormat);
+			packedBound = packed;
+		}
+		if (packed && refreshPacked) {
+			const VertexCompressionReport& c = mesh.m_compression;
+			XMMATRIX dequantize = XMMatrixScaling(c.scale[0], c.scale[1], c.scale[2]) *
+				XMMatrixTranslation(c.offset[0], c.offset[1], c.offset[2]);
+			CBChangesEveryFrame meshModel = m_model;
+			meshModel.mWorld = XMMatrixMultiply(m_model.mWorld, XMMatrixTranspose(dequantize));
+			modelBuffers[i].update(deviceContext, nullptr, 0, nullptr, &meshModel, 0, 0);
+		}
+
 		// Asignar vertex e index buffer de la malla actual
-		m_vertexBuffers[i].render(deviceContext, 0, 1);
-		m_indexBuffers[i].render(deviceContext, 0, 1, false, DXGI_FORMAT_R32_UINT);
+		vertexBuffers[i].render(deviceContext, 0, 1);
+		indexBuffers[i].render(deviceContext, 0, 1, false, mesh.getIndexFormat());
 
 		// Bind del constant buffer del modelo (world + color)
-		m_modelBuffer.render(deviceContext, 2, 1, true);
+		(packed ? modelBuffers[i] : m_modelBuffer).render(deviceContext, 2, 1, true);
 
 		// Render de texturas (al menos el albedo)
 		if (m_textures.size() > 0) {
@@ -137,8 +265,35 @@ Actor::render(DeviceContext& deviceContext) {
 			}
 		}
 
-		// Dibujar la malla actual
-		deviceContext.DrawIndexed(m_meshes[i].m_numIndex, 0, 0);
+		// Sin submallas se dibuja la malla completa
+		if (meshes[i].m_subMeshes.empty()) {
+			deviceContext.DrawIndexed(meshes[i].m_numIndex, 0, 0);
+			continue;
+		}
+
+		// Un DrawIndexed por material; si el material tiene textura propia
+		// se enlaza en t0, si no se queda el albedo del actor
+		for (unsigned int s = 0; s < meshes[i].m_subMeshes.size(); s++) {
+			const SubMesh& subMesh = meshes[i].m_subMeshes[s];
+			if (subMesh.indexCount == 0) {
+				continue;
+			}
+
+			const int textureIndex = (i < subMeshTexture.size() && s < subMeshTexture[i].size()) ? subMeshTexture[i][s] : -1;
+			if (textureIndex >= 0) {
+				m_materialTextures[textureIndex].render(deviceContext, 0, 1);
+			}
+			else if (!m_textures.empty()) {
+				m_textures[0].render(deviceContext, 0, 1);
+			}
+
+			deviceContext.DrawIndexed(subMesh.indexCount, subMesh.startIndex, 0);
+		}
+	}
+
+	// Dejo el layout como estaba para el siguiente actor/frame
+	if (packedBound) {
+		m_shaderProgram->renderInputLayout(deviceContext, VertexFormat::Full);
 	}
 }
 
@@ -158,11 +313,42 @@ Actor::destroy() {
 		indexBuffer.destroy();
 	}
 
+	// Liberar constant buffers de las mallas empacadas
+	for (auto& modelBuffer : m_meshModelBuffers) {
+		modelBuffer.destroy();
+	}
+	m_meshModelBuffers.clear();
+	m_meshModelVersion = 0;
+
 	// Liberar texturas asociadas al actor
 	for (auto& tex : m_textures) {
 		tex.destroy();
 	}
 
+	// Liberar texturas de los materiales
+	for (auto& tex : m_materialTextures) {
+		tex.destroy();
+	}
+	m_materialTextures.clear();
+	m_materialTexturePaths.clear();
+	m_subMeshTexture.clear();
+
+	// Liberar niveles de detalle y el slot del selector
+	destroyLods();
+	if (m_lodSelector && m_lodSlot != LodSelector::kInvalidSlot) {
+		m_lodSelector->remove(m_lodSlot);
+	}
+	m_lodSlot = LodSelector::kInvalidSlot;
+	setAabbTree(nullptr);
+
+	// Sacar al actor de la jerarqua y la entidad del World
+	setSceneGraph(nullptr);
+	if (m_world) {
+		m_world->destroy(m_entity);
+		m_world = nullptr;
+		m_entity = EntityHandle();
+	}
+
 	// Liberar constant buffer del modelo
 	m_modelBuffer.destroy();
 
@@ -183,27 +369,429 @@ Actor::destroy() {
 void
 Actor::setMesh(Device& device, std::vector<MeshComponent> meshes) {
 	m_meshes = meshes;
+	for (auto& modelBuffer : m_meshModelBuffers) {
+		modelBuffer.destroy();
+	}
+	m_meshModelBuffers.clear();
+	m_meshModelVersion = 0;
+	createBuffers(device, m_meshes, &m_vertexBuffers, m_indexBuffers, m_meshModelBuffers);
+	loadSubMeshTextures(device, m_meshes, m_subMeshTexture);
+
+	// Caja y esfera envolvente del LOD0 (de todas las mallas)
+	XMFLOAT3 minP(0.0f, 0.0f, 0.0f);
+	XMFLOAT3 maxP(0.0f, 0.0f, 0.0f);
+	for (unsigned int i = 0; i < m_meshes.size(); i++) {
+		const MeshComponent& mesh = m_meshes[i];
+		minP = i == 0 ? mesh.m_aabbMin : XMFLOAT3((std::min)(minP.x, mesh.m_aabbMin.x),
+			(std::min)(minP.y, mesh.m_aabbMin.y), (std::min)(minP.z, mesh.m_aabbMin.z));
+		maxP = i == 0 ? mesh.m_aabbMax : XMFLOAT3((std::max)(maxP.x, mesh.m_aabbMax.x),
+			(std::max)(maxP.y, mesh.m_aabbMax.y), (std::max)(maxP.z, mesh.m_aabbMax.z));
+	}
+	m_localAabbMin = minP;
+	m_localAabbMax = maxP;
+	m_boundsCenter = XMFLOAT3((minP.x + maxP.x) * 0.5f, (minP.y + maxP.y) * 0.5f, (minP.z + maxP.z) * 0.5f);
+
+	// La esfera que envuelve las esferas de las mallas, si es ms chica que
+	// la que envuelve la caja
+	m_boundsRadius = 0.5f * XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&maxP), XMLoadFloat3(&minP))));
+	float sphereRadius = 0.0f;
+	for (const MeshComponent& mesh : m_meshes) {
+		const float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&mesh.m_sphereCenter),
+			XMLoadFloat3(&m_boundsCenter))));
+		sphereRadius = (std::max)(sphereRadius, distance + mesh.m_sphereRadius);
+	}
+	if (!m_meshes.empty() && sphereRadius > 0.0f) {
+		m_boundsRadius = (std::min)(m_boundsRadius, sphereRadius);
+	}
+	m_boundsVersion = 0;
+
+	buildGeneratedLods(device);
+	updateLodSelector();
+	if (m_world) {
+		m_world->markChanged<MeshComponent>(m_entity);
+	}
+}
+
+/// <summary>
+/// Crea los vertex e index buffers de un conjunto de mallas.
+/// </summary>
+/// <param name="device">Dispositivo usado para crear los buffers.</param>
+/// <param name="meshes">Mallas; las empacadas sin layout se pasan a Full y se llena m_index16.</param>
+/// <param name="vertexBuffers">Destino de los vertex buffers, o nulo para no crearlos.</param>
+/// <param name="indexBuffers">Destino de los index buffers.</param>
+/// <param name="modelBuffers">Destino de los constant buffers, uno por malla.</param>
+void
+Actor::createBuffers(Device& device,
+	std::vector<MeshComponent>& meshes,
+	std::vector<Buffer>* vertexBuffers,
+	std::vector<Buffer>& indexBuffers,
+	std::vector<Buffer>& modelBuffers) {
 	HRESULT hr;
 
-	for (auto& mesh : m_meshes) {
-		// Crear vertex buffer
-		Buffer vertexBuffer;
-		hr = vertexBuffer.init(device, mesh, D3D11_BIND_VERTEX_BUFFER);
-		if (FAILED(hr)) {
-			ERROR("Actor", "setMesh", "Failed to create new vertexBuffer");
+	for (auto& mesh : meshes) {
+		// Sin un layout para el formato empacado la malla se sube en Full
+		if (mesh.m_vertexFormat != VertexFormat::Full &&
+			(!m_shaderProgram || !m_shaderProgram->supportsVertexFormat(mesh.m_vertexFormat))) {
+			mesh.m_vertexFormat = VertexFormat::Full;
+			mesh.m_packedVertex.clear();
 		}
-		else {
-			m_vertexBuffers.push_back(vertexBuffer);
+
+		// Crear vertex buffer
+		if (vertexBuffers) {
+			Buffer vertexBuffer;
+			hr = vertexBuffer.init(device, mesh, D3D11_BIND_VERTEX_BUFFER);
+			if (FAILED(hr)) {
+				ERROR("Actor", "setMesh", "Failed to create new vertexBuffer");
+			}
+			else {
+				vertexBuffers->push_back(vertexBuffer);
+			}
 		}
 
-		// Crear index buffer
+		// Crear index buffer (16 bits cuando todos los ndices caben)
+		mesh.packIndices();
 		Buffer indexBuffer;
 		hr = indexBuffer.init(device, mesh, D3D11_BIND_INDEX_BUFFER);
 		if (FAILED(hr)) {
 			ERROR("Actor", "setMesh", "Failed to create new indexBuffer");
 		}
 		else {
-			m_indexBuffers.push_back(indexBuffer);
+			indexBuffers.push_back(indexBuffer);
+		}
+
+		// Malla empacada: constant buffer propio para la matriz mundo con la
+		// de desempacar ya multiplicada (lo llena renderMeshes). Las Full usan
+		// m_modelBuffer y su lugar se queda vaco
+		Buffer modelBuffer;
+		if (mesh.m_vertexFormat != VertexFormat::Full) {
+			hr = modelBuffer.init(device, sizeof(CBChangesEveryFrame));
+			if (FAILED(hr)) {
+				ERROR("Actor", "setMesh", "Failed to create new CBChangesEveryFrame");
+			}
+		}
+		modelBuffers.push_back(modelBuffer);
+	}
+}
+
+/// <summary>
+/// Arma LOD1, LOD2, ... con los ndices simplificados de cada malla
+/// (MeshComponent::m_lods). Una malla con menos niveles que las dems repite
+/// su nivel ms simple. El umbral de cada nivel es su error relativo al
+/// radio de la esfera envolvente, para que el selector lo convierta a pixeles.
+/// </summary>
+/// <param name="device">Dispositivo usado para crear los index buffers.</param>
+void
+Actor::buildGeneratedLods(Device& device) {
+	destroyLods();
+
+	size_t levelCount = 0;
+	for (const MeshComponent& mesh : m_meshes) {
+		levelCount = (std::max)(levelCount, mesh.m_lods.size());
+	}
+	levelCount = (std::min)(levelCount, static_cast<size_t>(LodSelector::kMaxLevels - 1));
+	if (levelCount == 0 || m_boundsRadius <= 0.0f) {
+		return;
+	}
+
+	for (size_t k = 0; k < levelCount; k++) {
+		LodLevel level;
+		level.sharesVertices = true;
+		level.subMeshTexture = m_subMeshTexture;
+
+		float error = 0.0f;
+		for (const MeshComponent& source : m_meshes) {
+			// Copia sin vrtices: el nivel usa los vertex buffers del LOD0
+			MeshComponent mesh;
+			mesh.m_name = source.m_name;
+			mesh.m_numVertex = source.m_numVertex;
+			mesh.m_vertexFormat = source.m_vertexFormat;
+			mesh.m_compression = source.m_compression;
+			mesh.m_aabbMin = source.m_aabbMin;
+			mesh.m_aabbMax = source.m_aabbMax;
+			if (source.m_lods.empty()) {
+				mesh.m_index = source.m_index;
+				mesh.m_subMeshes = source.m_subMeshes;
+			}
+			else {
+				const MeshLod& lod = source.m_lods[(std::min)(k, source.m_lods.size() - 1)];
+				mesh.m_index = lod.indices;
+				mesh.m_subMeshes = lod.subMeshes;
+				error = (std::max)(error, lod.error);
+			}
+			mesh.m_numIndex = static_cast<int>(mesh.m_index.size());
+			level.meshes.push_back(mesh);
+		}
+
+		level.threshold.relativeError = error / m_boundsRadius;
+		createBuffers(device, level.meshes, nullptr, level.indexBuffers, level.modelBuffers);
+		m_lodLevels.push_back(level);
+	}
+}
+
+/// <summary>
+/// Agrega un nivel de detalle hecho a mano con sus propios vrtices.
+/// </summary>
+/// <param name="device">Dispositivo usado para crear los buffers y texturas.</param>
+/// <param name="meshes">Mallas del nivel.</param>
+/// <param name="screenSize">Tamao en pantalla por debajo del cual se usa el nivel.</param>
+void
+Actor::addLod(Device& device, std::vector<MeshComponent> meshes, float screenSize) {
+	// Los niveles a mano reemplazan a los generados
+	if (!m_lodLevels.empty() && m_lodLevels[0].sharesVertices) {
+		destroyLods();
+	}
+	if (m_lodLevels.size() + 1 >= LodSelector::kMaxLevels) {
+		ERROR("Actor", "addLod", "Too many LOD levels");
+		return;
+	}
+
+	LodLevel level;
+	level.meshes = meshes;
+	level.threshold.screenSize = screenSize;
+	createBuffers(device, level.meshes, &level.vertexBuffers, level.indexBuffers, level.modelBuffers);
+	loadSubMeshTextures(device, level.meshes, level.subMeshTexture);
+	m_lodLevels.push_back(level);
+
+	updateLodSelector();
+}
+
+/// <summary>
+/// Registra el actor en el selector de LOD (o lo saca del anterior).
+/// </summary>
+/// <param name="lodSelector">Selector de la escena, o nulo para dibujar siempre LOD0.</param>
+void
+Actor::setLodSelector(LodSelector* lodSelector) {
+	if (m_lodSelector && m_lodSlot != LodSelector::kInvalidSlot) {
+		m_lodSelector->remove(m_lodSlot);
+	}
+	m_lodSelector = lodSelector;
+	m_lodSlot = m_lodSelector ? m_lodSelector->add() : LodSelector::kInvalidSlot;
+	m_boundsVersion = 0;
+	updateLodSelector();
+	if (m_world) {
+		m_world->markChanged<MeshComponent>(m_entity);
+	}
+}
+
+/// <summary>
+/// Cambia de ndice espacial. La caja entra con la ltima calculada y se
+/// corrige en el prximo update (m_boundsVersion = 0 obliga a recalcularla).
+/// </summary>
+/// <param name="aabbTree">ndice de la escena, o nulo.</param>
+void
+Actor::setAabbTree(AabbTree* aabbTree) {
+	if (m_aabbTree && m_treeProxy != AabbTree::kInvalidProxy) {
+		m_aabbTree->remove(m_treeProxy);
+	}
+	m_aabbTree = aabbTree;
+	m_treeProxy = m_aabbTree
+		? m_aabbTree->insert(&m_worldAabbMin.x, &m_worldAabbMax.x, this)
+		: AabbTree::kInvalidProxy;
+	if (m_aabbTree) {
+		m_boundsVersion = 0;
+		if (m_world) {
+			m_world->markChanged<MeshComponent>(m_entity);
+		}
+	}
+}
+
+/// <summary>
+/// Mueve el Transform entre la lista de componentes del actor y el World.
+/// </summary>
+/// <param name="world">World de la escena, o nulo para que el actor guarde su Transform.</param>
+void
+Actor::setWorld(World* world) {
+	if (world == m_world) {
+		return;
+	}
+
+	Transform transform;
+	transform.init();
+	if (const Transform* current = getComponentPtr<Transform>()) {
+		transform = *current;
+	}
+
+	if (m_world) {
+		m_world->destroy(m_entity);
+		m_world = nullptr;
+		m_entity = EntityHandle();
+		addComponent(EU::MakeShared<Transform>(transform));
+	}
+	else {
+		removeComponent<Transform>();
+	}
+
+	if (world) {
+		m_entity = world->create(std::move(transform), ActorRef{ this });
+		m_world = world;
+	}
+}
+
+/// <summary>
+/// Crea (o borra) el nodo del actor en la jerarqua de la escena.
+/// </summary>
+/// <param name="sceneGraph">Jerarqua de la escena, o nulo para sacar al actor.</param>
+void
+Actor::setSceneGraph(SceneGraph* sceneGraph) {
+	Transform* transform = getComponentPtr<Transform>();
+	if (sceneGraph == m_sceneGraph || !transform) {
+		return;
+	}
+
+	if (m_sceneGraph) {
+		m_sceneGraph->destroy(transform->getSceneNode());
+		transform->setSceneNode(SceneGraph::kInvalidNode);
+	}
+
+	m_sceneGraph = sceneGraph;
+	if (m_sceneGraph) {
+		// Raz con la matriz local actual; si el Transform est pendiente,
+		// quien actualiza el World la vuelve a pasar
+		XMFLOAT4X4 local;
+		XMStoreFloat4x4(&local, transform->matrix);
+		const uint32_t node = m_sceneGraph->create();
+		m_sceneGraph->setLocal(node, &local.m[0][0]);
+		m_sceneGraph->setUserData(node, this);
+		transform->setSceneNode(node);
+	}
+
+	// La matriz mundo sale de otro lado: volver a subirla
+	m_modelVersion = 0;
+	m_boundsVersion = 0;
+	if (m_world) {
+		m_world->markChanged<Transform>(m_entity);
+	}
+}
+
+/// <summary>
+/// Cambia el padre del actor en el SceneGraph.
+/// </summary>
+/// <param name="parent">Actor padre en el mismo SceneGraph, o nulo para dejarlo como raz.</param>
+void
+Actor::setParent(Actor* parent) {
+	if (!m_sceneGraph) {
+		ERROR("Actor", "setParent", "The actor is not in a SceneGraph");
+		return;
+	}
+	if (parent && parent->m_sceneGraph != m_sceneGraph) {
+		ERROR("Actor", "setParent", "The parent is not in the same SceneGraph");
+		return;
+	}
+
+	const uint32_t parentNode = parent ? parent->getComponentPtr<Transform>()->getSceneNode()
+		: SceneGraph::kInvalidNode;
+	m_sceneGraph->setParent(getComponentPtr<Transform>()->getSceneNode(), parentNode);
+
+	if (m_world) {
+		m_world->markChanged<Transform>(m_entity);
+	}
+}
+
+/// <summary>
+/// Pasa los umbrales de los niveles al selector.
+/// </summary>
+void
+Actor::updateLodSelector() {
+	if (!m_lodSelector || m_lodSlot == LodSelector::kInvalidSlot) {
+		return;
+	}
+	LodThreshold thresholds[LodSelector::kMaxLevels - 1];
+	for (unsigned int k = 0; k < m_lodLevels.size(); k++) {
+		thresholds[k] = m_lodLevels[k].threshold;
+	}
+	m_lodSelector->setLevels(m_lodSlot, thresholds, static_cast<unsigned int>(m_lodLevels.size()));
+}
+
+/// <summary>
+/// Libera los buffers de los niveles de detalle. Los vertex buffers de los
+/// niveles generados son los del LOD0 y no se tocan aqu.
+/// </summary>
+void
+Actor::destroyLods() {
+	for (auto& level : m_lodLevels) {
+		for (auto& vertexBuffer : level.vertexBuffers) {
+			vertexBuffer.destroy();
+		}
+		for (auto& indexBuffer : level.indexBuffers) {
+			indexBuffer.destroy();
+		}
+		for (auto& modelBuffer : level.modelBuffers) {
+			modelBuffer.destroy();
+		}
+	}
+	m_lodLevels.clear();
+	m_lodLevel = 0;
+	updateLodSelector();
+}
+
+/// <summary>
+/// Carga las texturas de las submallas (map_Kd) y guarda qu textura usa
+/// cada una. Si una textura no se puede cargar, esa submalla usa el albedo del actor.
+/// </summary>
+/// <param name="device">Dispositivo usado para crear las texturas.</param>
+/// <param name="meshes">Mallas cuyas submallas se revisan.</param>
+/// <param name="subMeshTexture">Por malla y submalla: ndice en m_materialTextures o -1.</param>
+void
+Actor::loadSubMeshTextures(Device& device,
+	const std::vector<MeshComponent>& meshes,
+	std::vector<std::vector<int>>& subMeshTexture) {
+	subMeshTexture.assign(meshes.size(), std::vector<int>());
+
+	for (unsigned int i = 0; i < meshes.size(); i++) {
+		const std::vector<SubMesh>& subMeshes = meshes[i].m_subMeshes;
+		subMeshTexture[i].assign(subMeshes.size(), -1);
+
+		for (unsigned int s = 0; s < subMeshes.size(); s++) {
+			const std::string& path = subMeshes[s].texturePath;
+			if (path.empty()) {
+				continue;
+			}
+
+			// La misma ruta se carga una sola vez
+			auto found = std::find(m_materialTexturePaths.begin(), m_materialTexturePaths.end(), path);
+			if (found != m_materialTexturePaths.end()) {
+				const int index = static_cast<int>(found - m_materialTexturePaths.begin());
+				subMeshTexture[i][s] = m_materialTextures[index].m_textureFromImg ? index : -1;
+				continue;
+			}
+
+			// Texture::init agrega la extensin, as que la separo del nombre
+			const size_t dot = path.find_last_of('.');
+			std::string extension = (dot == std::string::npos) ? "" : path.substr(dot + 1);
+			for (auto& c : extension) {
+				c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+			}
+
+			ExtensionType type = PNG;
+			bool supported = true;
+			if (extension == "png") {
+				type = PNG;
+			}
+			else if (extension == "jpg" || extension == "jpeg") {
+				type = JPG;
+			}
+			else if (extension == "dds") {
+				type = DDS;
+			}
+			else {
+				supported = false;
+			}
+
+			Texture texture;
+			HRESULT hr = E_FAIL;
+			if (supported) {
+				hr = texture.init(device, path.substr(0, dot), type);
+			}
+			if (FAILED(hr)) {
+				ERROR("Actor", "loadSubMeshTextures", ("Failed to load material texture: " + path).c_str());
+			}
+
+			// Se guarda aunque falle para no intentar cargarla otra vez
+			m_materialTexturePaths.push_back(path);
+			m_materialTextures.push_back(texture);
+			if (SUCCEEDED(hr)) {
+				subMeshTexture[i][s] = static_cast<int>(m_materialTextures.size() - 1);
+			}
 		}
 	}
 }
@@ -0,0 +1,245 @@
+#include "ECS/CommandBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace {
+  // Tamao normal de un bloque de la arena (los componentes ms grandes reciben uno propio).
+  const size_t kArenaBlockSize_ = 64 * 1024;
+  const size_t kArenaBlockAlign_ = 64;
+
+  std::atomic<uint64_t> g_nextQueueId_(1);
+
+  // Buffer de este hilo para la ltima cola que us (ver CommandQueue::local).
+  struct LocalBuffer_ {
+    uint64_t queueId = 0;
+    CommandBuffer* buffer = nullptr;
+  };
+  thread_local LocalBuffer_ t_localBuffer_;
+}
+
+CommandBuffer::~CommandBuffer() {
+  clear();
+  for (const Block& block : m_blocks) {
+    ::operator delete(block.data, std::align_val_t(kArenaBlockAlign_));
+  }
+}
+
+EntityHandle
+CommandBuffer::create() {
+  EntityHandle entity;
+  entity.index = m_created++;
+  entity.generation = 0;  // Los World empiezan en la generacin 1: nunca es un handle real.
+  push(CommandType::Create, 0, entity);
+  return entity;
+}
+
+void
+CommandBuffer::destroy(EntityHandle entity) {
+  push(CommandType::Destroy, 0, entity);
+}
+
+CommandBuffer::Command&
+CommandBuffer::push(CommandType type, uint32_t typeId, EntityHandle entity) {
+  m_commands.emplace_back();
+  Command& command = m_commands.back();
+  command.type = type;
+  command.typeId = typeId;
+  command.entity = entity;
+  return command;
+}
+
+void*
+CommandBuffer::allocate(size_t size, size_t align) {
+  // Sigue en el bloque actual o pasa al siguiente que alcance (los bloques
+  // se conservan entre frames, as que despus del primero casi nunca se pide memoria)
+  while (m_block < m_blocks.size()) {
+    const Block& block = m_blocks[m_block];
+    const size_t offset = (m_offset + align - 1) & ~(align - 1);
+    if (offset + size <= block.size) {
+      m_offset = offset + size;
+      return block.data + offset;
+    }
+    ++m_block;
+    m_offset = 0;
+  }
+
+  Block block;
+  block.size = (std::max)(kArenaBlockSize_, size + align);
+  block.data = static_cast<unsigned char*>(::operator new(block.size, std::align_val_t(kArenaBlockAlign_)));
+  m_blocks.push_back(block);
+  m_block = m_blocks.size() - 1;
+  m_offset = size;
+  return block.data;
+}
+
+void
+CommandBuffer::clear() {
+  // Los componentes que playback no consumi (entidad destruida o comando
+  // reemplazado) y los que ya quedaron movidos se destruyen igual
+  for (const Command& command : m_commands) {
+    if (command.payload) ComponentTypes::info(command.typeId).destroy(command.payload);
+  }
+  m_commands.clear();
+  m_block = 0;
+  m_offset = 0;
+  m_created = 0;
+}
+
+CommandQueue::CommandQueue()
+  : m_id(g_nextQueueId_.fetch_add(1)) {
+}
+
+CommandBuffer&
+CommandQueue::local() {
+  if (t_localBuffer_.queueId == m_id) return *t_localBuffer_.buffer;
+
+  // Primera vez de este hilo (o vena de usar otra cola): buscar o registrar su buffer
+  std::lock_guard<std::mutex> lock(m_mutex);
+  CommandBuffer*& buffer = m_bufferByThread[std::this_thread::get_id()];
+  if (!buffer) {
+    m_buffers.emplace_back(new CommandBuffer());
+    buffer = m_buffers.back().get();
+  }
+  t_localBuffer_.queueId = m_id;
+  t_localBuffer_.buffer = buffer;
+  return *buffer;
+}
+
+void
+CommandQueue::playback(World& world) {
+  const auto startTime = std::chrono::steady_clock::now();
+  m_lastStats = CommandStats();
+
+  // Comando a aplicar, ya con el handle real de su entidad.
+  struct Entry {
+    EntityHandle entity;
+    CommandBuffer::Command* command;
+  };
+  std::vector<Entry> entries;
+  std::vector<EntityHandle> created;
+
+  // 1) Entidades nuevas, y los handles pendientes cambiados por los reales
+  for (auto& buffer : m_buffers) {
+    m_lastStats.commands += buffer->m_commands.size();
+    created.clear();
+    created.reserve(buffer->m_created);
+    for (auto& command : buffer->m_commands) {
+      if (command.type == CommandType::Create) {
+        created.push_back(world.create());
+        continue;
+      }
+      EntityHandle entity = command.entity;
+      if (CommandBuffer::isPending(entity)) {
+        // Un handle pendiente solo vale en su buffer y despus de su create
+        if (entity.index >= created.size()) {
+          ++m_lastStats.dropped;
+          continue;
+        }
+        entity = created[entity.index];
+      }
+      entries.push_back({ entity, &command });
+    }
+    m_lastStats.created += created.size();
+  }
+
+  // 2) Juntar los comandos de cada entidad sin perder el orden de cada buffer
+  // (si solo hay entidades nuevas de un buffer ya vienen en orden)
+  const auto byIndex = [](const Entry& a, const Entry& b) { return a.entity.index < b.entity.index; };
+  if (!std::is_sorted(entries.begin(), entries.end(), byIndex)) {
+    std::stable_sort(entries.begin(), entries.end(), byIndex);
+  }
+
+  // 3) Por entidad: un destroy, o un solo cambio de arquetipo con todos sus add/remove
+  CommandBuffer::Command* lastAdd[ComponentTypes::kMaxTypes] = {};
+  ComponentMask lastMask = 0;   // ltimo destino: casi todas las entidades van al mismo.
+  uint32_t lastArchetype = world.findArchetype(0);
+  for (size_t begin = 0; begin < entries.size();) {
+    size_t end = begin + 1;
+    while (end < entries.size() && entries[end].entity.index == entries[begin].entity.index) ++end;
+
+    // Con el mismo ndice puede haber handles viejos (otra generacin); solo
+    // uno puede estar vivo y los comandos de los dems se descartan
+    EntityHandle entity;
+    bool destroyed = false;
+    size_t stale = 0;
+    for (size_t e = begin; e < end; ++e) {
+      if (!world.isAlive(entries[e].entity)) {
+        entries[e].command = nullptr;
+        ++stale;
+      }
+      else {
+        entity = entries[e].entity;
+        destroyed = destroyed || entries[e].command->type == CommandType::Destroy;
+      }
+    }
+    m_lastStats.dropped += stale;
+    if (destroyed) {
+      world.destroy(entity);
+      ++m_lastStats.destroyed;
+      begin = end;
+      continue;
+    }
+    if (stale == end - begin) {
+      begin = end;
+      continue;
+    }
+
+    // Mscara final; de cada tipo agregado solo cuenta el ltimo add
+    const ComponentMask oldMask = world.archetypeMask(entity);
+    ComponentMask mask = oldMask;
+    ComponentMask touched = 0;
+    for (size_t e = begin; e < end; ++e) {
+      CommandBuffer::Command* command = entries[e].command;
+      if (!command) continue;
+      if (command->addSparse) {
+        command->addSparse(world, entity, command->payload);
+        continue;
+      }
+      if (command->removeSparse) {
+        command->removeSparse(world, entity);
+        continue;
+      }
+      const ComponentMask bit = ComponentMask(1) << command->typeId;
+      if (command->type == CommandType::Add) {
+        mask |= bit;
+        lastAdd[command->typeId] = command;
+        touched |= bit;
+      }
+      else if (command->type == CommandType::Remove) {
+        mask &= ~bit;
+        lastAdd[command->typeId] = nullptr;
+      }
+    }
+
+    if (mask != oldMask) {
+      if (mask != lastMask) {
+        lastMask = mask;
+        lastArchetype = world.findArchetype(mask);
+      }
+      world.moveEntityTo(entity, lastArchetype);
+      ++m_lastStats.moves;
+    }
+
+    // Construir los nuevos y reemplazar los que ya tena
+    for (ComponentMask pending = touched; pending; pending &= pending - 1) {
+      uint32_t typeId = 0;
+      while (!(pending & (ComponentMask(1) << typeId))) ++typeId;
+      CommandBuffer::Command* command = lastAdd[typeId];
+      lastAdd[typeId] = nullptr;
+      if (!command) continue;  // Un remove posterior lo cancel.
+      const ComponentTypeInfo& info = ComponentTypes::info(typeId);
+      void* destination = world.componentAt(entity, typeId);
+      if (oldMask & (ComponentMask(1) << typeId)) info.destroy(destination);
+      info.moveConstruct(destination, command->payload);
+    }
+    world.recordChanges(entity, touched & mask);
+    begin = end;
+  }
+
+  // 4) clear destruye lo que qued en las arenas (movido o sin usar)
+  for (auto& buffer : m_buffers) buffer->clear();
+
+  m_lastStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
@@ -0,0 +1,224 @@
+#include "ECS/SystemScheduler.h"
+
+#include <chrono>
+
+const uint32_t SystemScheduler::kMainThread;
+
+SystemScheduler::SystemScheduler(unsigned int threadCount) {
+  unsigned int threads = threadCount ? threadCount : std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+  m_workers.reserve(threads - 1);
+  for (unsigned int t = 1; t < threads; ++t) {
+    m_workers.emplace_back([this]() { workerLoop(); });
+  }
+}
+
+SystemScheduler::~SystemScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_wake.notify_all();
+  for (auto& worker : m_workers) worker.join();
+}
+
+uint32_t
+SystemScheduler::addSystem(const std::string& name,
+  ComponentMask reads,
+  ComponentMask writes,
+  std::function<void(float)> update,
+  uint32_t flags) {
+  System system;
+  system.name = name;
+  system.reads = reads;
+  system.writes = writes;
+  system.update = std::move(update);
+  system.flags = flags;
+  m_systems.push_back(std::move(system));
+  return static_cast<uint32_t>(m_systems.size() - 1);
+}
+
+void
+SystemScheduler::run(float deltaTime) {
+  const auto startTime = std::chrono::steady_clock::now();
+  m_lastStats = SchedulerStats();
+  m_lastStats.threads = getThreadCount();
+
+  // Grafo del frame: j espera a i (i < j) si uno escribe algo que el otro usa
+  size_t active = 0;
+  for (auto& system : m_systems) {
+    system.waitingFor = 0;
+    system.dependents.clear();
+    system.seconds = 0.0;
+  }
+  for (uint32_t j = 0; j < m_systems.size(); ++j) {
+    System& later = m_systems[j];
+    if (!later.enabled) continue;
+    ++active;
+    for (uint32_t i = 0; i < j; ++i) {
+      System& earlier = m_systems[i];
+      if (!earlier.enabled) continue;
+      const bool conflict = (earlier.writes & (later.reads | later.writes)) != 0 ||
+        (earlier.reads & later.writes) != 0;
+      if (conflict) {
+        earlier.dependents.push_back(j);
+        ++later.waitingFor;
+        ++m_lastStats.dependencies;
+      }
+    }
+  }
+  m_lastStats.systems = active;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_deltaTime = deltaTime;
+    m_systemsLeft = active;
+    for (uint32_t s = 0; s < m_systems.size(); ++s) {
+      if (m_systems[s].enabled && m_systems[s].waitingFor == 0) pushReadySystem(s);
+    }
+  }
+  m_wake.notify_all();
+
+  // El hilo principal tambin trabaja: primero lo que solo puede correr aqu
+  for (;;) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_wake.wait(lock, [this]() {
+      return m_systemsLeft == 0 || !m_mainThreadSystems.empty() || !m_chunks.empty() || !m_readySystems.empty();
+    });
+    if (m_systemsLeft == 0) break;
+
+    if (!m_mainThreadSystems.empty()) {
+      const uint32_t system = m_mainThreadSystems.front();
+      m_mainThreadSystems.pop_front();
+      lock.unlock();
+      runSystem(system);
+    }
+    else if (!m_chunks.empty()) {
+      const Chunk chunk = m_chunks.front();
+      m_chunks.pop_front();
+      lock.unlock();
+      runChunk(chunk);
+    }
+    else {
+      const uint32_t system = m_readySystems.front();
+      m_readySystems.pop_front();
+      lock.unlock();
+      runSystem(system);
+    }
+  }
+
+  for (const auto& system : m_systems) {
+    if (system.enabled) m_lastStats.timings.push_back({ system.name, system.seconds });
+  }
+  m_lastStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void
+SystemScheduler::parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& fn) {
+  if (count == 0) return;
+  if (chunkSize == 0) chunkSize = 1;
+  const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+  if (chunkCount == 1 || m_workers.empty()) {
+    fn(0, count);
+    return;
+  }
+
+  // El primer trozo lo hace el que llama; los dems van a la cola
+  std::atomic<size_t> pending(chunkCount);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t c = 1; c < chunkCount; ++c) {
+      Chunk chunk;
+      chunk.fn = &fn;
+      chunk.begin = c * chunkSize;
+      chunk.end = (std::min)(chunk.begin + chunkSize, count);
+      chunk.pending = &pending;
+      m_chunks.push_back(chunk);
+    }
+  }
+  m_wake.notify_all();
+
+  Chunk first;
+  first.fn = &fn;
+  first.begin = 0;
+  first.end = chunkSize;
+  first.pending = &pending;
+  runChunk(first);
+
+  // Mientras faltan trozos, ayuda con los que haya en la cola (de este o de
+  // otro parallelFor) en vez de quedarse esperando
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (pending.load() != 0) {
+    if (!m_chunks.empty()) {
+      const Chunk chunk = m_chunks.front();
+      m_chunks.pop_front();
+      lock.unlock();
+      runChunk(chunk);
+      lock.lock();
+    }
+    else {
+      m_wake.wait(lock, [this, &pending]() { return pending.load() == 0 || !m_chunks.empty(); });
+    }
+  }
+}
+
+void
+SystemScheduler::workerLoop() {
+  for (;;) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_wake.wait(lock, [this]() { return m_stop || !m_chunks.empty() || !m_readySystems.empty(); });
+    if (!m_chunks.empty()) {
+      const Chunk chunk = m_chunks.front();
+      m_chunks.pop_front();
+      lock.unlock();
+      runChunk(chunk);
+    }
+    else if (!m_readySystems.empty()) {
+      const uint32_t system = m_readySystems.front();
+      m_readySystems.pop_front();
+      lock.unlock();
+      runSystem(system);
+    }
+    else {
+      return;  // m_stop y no queda trabajo
+    }
+  }
+}
+
+void
+SystemScheduler::runChunk(const Chunk& chunk) {
+  (*chunk.fn)(chunk.begin, chunk.end);
+  if (chunk.pending->fetch_sub(1) == 1) {
+    // Era el ltimo: despertar al que espera en parallelFor. El candado evita
+    // que el aviso llegue entre su revisin de 'pending' y su wait
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_wake.notify_all();
+  }
+}
+
+void
+SystemScheduler::runSystem(uint32_t index) {
+  System& system = m_systems[index];
+  const auto startTime = std::chrono::steady_clock::now();
+  system.update(m_deltaTime);
+  system.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (uint32_t dependent : system.dependents) {
+      if (--m_systems[dependent].waitingFor == 0) pushReadySystem(dependent);
+    }
+    --m_systemsLeft;
+  }
+  m_wake.notify_all();
+}
+
+void
+SystemScheduler::pushReadySystem(uint32_t system) {
+  if (m_systems[system].flags & kMainThread) {
+    m_mainThreadSystems.push_back(system);
+  }
+  else {
+    m_readySystems.push_back(system);
+  }
+}
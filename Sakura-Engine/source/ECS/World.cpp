@@ -0,0 +1,274 @@
+#include "ECS/World.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+// Las columnas se alinean al menos a 16 bytes (XMMATRIX, SSE).
+static const size_t kMinColumnAlign_ = 16;
+
+static ComponentTypeInfo g_componentTypes_[ComponentTypes::kMaxTypes];
+static uint32_t g_componentTypeCount_ = 0;
+static std::mutex g_componentTypesMutex_;
+
+uint32_t
+ComponentTypes::registerType(const ComponentTypeInfo& info) {
+  std::lock_guard<std::mutex> lock(g_componentTypesMutex_);
+  if (g_componentTypeCount_ >= kMaxTypes) {
+    // Ms tipos de los que caben en la mscara: es un error de programacin.
+    std::abort();
+  }
+  g_componentTypes_[g_componentTypeCount_] = info;
+  return g_componentTypeCount_++;
+}
+
+const ComponentTypeInfo&
+ComponentTypes::info(uint32_t typeId) {
+  return g_componentTypes_[typeId];
+}
+
+static size_t
+columnAlign_(uint32_t typeId) {
+  const size_t align = ComponentTypes::info(typeId).align;
+  return align > kMinColumnAlign_ ? align : kMinColumnAlign_;
+}
+
+static void
+freeColumn_(unsigned char* data, uint32_t typeId) {
+  if (data) ::operator delete(data, std::align_val_t(columnAlign_(typeId)));
+}
+
+const uint64_t World::kNoReader;
+
+World::World() {
+  findArchetype(0);  // Arquetipo 0: entidades sin componentes.
+}
+
+World::~World() {
+  for (auto& archetype : m_archetypes) {
+    for (size_t c = 0; c < archetype->types.size(); ++c) {
+      const uint32_t typeId = archetype->types[c];
+      const ComponentTypeInfo& info = ComponentTypes::info(typeId);
+      for (size_t row = 0; row < archetype->entities.size(); ++row) {
+        info.destroy(archetype->data[c] + row * info.size);
+      }
+      freeColumn_(archetype->data[c], typeId);
+    }
+  }
+}
+
+EntityHandle
+World::create() {
+  const EntityHandle entity = allocateEntity();
+  pushRow(0, entity);
+  return entity;
+}
+
+void
+World::destroy(EntityHandle entity) {
+  if (!isAlive(entity)) return;
+
+  Record& record = m_records[entity.index];
+  Archetype& archetype = *m_archetypes[record.archetype];
+  for (uint32_t typeId : archetype.types) {
+    ComponentTypes::info(typeId).destroy(archetype.at(typeId, record.row));
+  }
+  eraseRow(static_cast<uint32_t>(record.archetype), record.row);
+  for (auto& pool : m_pools) {
+    if (pool) pool->remove(entity.index);
+  }
+
+  record.archetype = -1;
+  ++record.generation;
+  m_freeEntities.push_back(entity.index);
+}
+
+void
+World::markChanged(uint32_t typeId, const EntityHandle* entities, size_t count) {
+  std::lock_guard<std::mutex> lock(m_changeMutex);
+  ChangeLog* log = m_changeLogs[typeId].get();
+  if (log) log->entities.insert(log->entities.end(), entities, entities + count);
+}
+
+uint32_t
+World::watchChanges(uint32_t typeId) {
+  std::lock_guard<std::mutex> lock(m_changeMutex);
+  std::unique_ptr<ChangeLog>& log = m_changeLogs[typeId];
+  if (!log) log.reset(new ChangeLog());
+  m_watchedTypes.fetch_or(ComponentMask(1) << typeId);
+
+  const uint64_t version = log->base + log->entities.size();
+  for (uint32_t reader = 0; reader < log->readers.size(); ++reader) {
+    if (log->readers[reader] == kNoReader) {
+      log->readers[reader] = version;
+      return reader;
+    }
+  }
+  log->readers.push_back(version);
+  return static_cast<uint32_t>(log->readers.size() - 1);
+}
+
+void
+World::unwatchChanges(uint32_t typeId, uint32_t reader) {
+  std::lock_guard<std::mutex> lock(m_changeMutex);
+  ChangeLog& log = *m_changeLogs[typeId];
+  log.readers[reader] = kNoReader;
+  if (std::all_of(log.readers.begin(), log.readers.end(), [](uint64_t version) { return version == kNoReader; })) {
+    // Nadie ms lo observa: dejar de anotar
+    m_watchedTypes.fetch_and(~(ComponentMask(1) << typeId));
+    log.base += log.entities.size();
+    log.entities.clear();
+    log.readers.clear();
+  }
+}
+
+void
+World::readChanges(uint32_t typeId, uint32_t reader, std::vector<EntityHandle>& changed) {
+  std::lock_guard<std::mutex> lock(m_changeMutex);
+  ChangeLog& log = *m_changeLogs[typeId];
+  const size_t begin = static_cast<size_t>(log.readers[reader] - log.base);
+  changed.insert(changed.end(), log.entities.begin() + begin, log.entities.end());
+  log.readers[reader] = log.base + log.entities.size();
+
+  // Quitar del principio lo que ya leyeron todos (cuando es al menos la
+  // mitad, para que cada entrada se copie pocas veces)
+  const uint64_t oldest = *std::min_element(log.readers.begin(), log.readers.end());
+  const size_t consumed = static_cast<size_t>(oldest - log.base);
+  if (consumed > 0 && consumed * 2 >= log.entities.size()) {
+    log.entities.erase(log.entities.begin(), log.entities.begin() + consumed);
+    log.base = oldest;
+  }
+}
+
+WorldStats
+World::getStats() const {
+  WorldStats stats;
+  stats.entities = size();
+  stats.archetypes = m_archetypes.size();
+  stats.moves = m_moves;
+  return stats;
+}
+
+EntityHandle
+World::allocateEntity() {
+  EntityHandle entity;
+  if (!m_freeEntities.empty()) {
+    entity.index = m_freeEntities.back();
+    m_freeEntities.pop_back();
+  }
+  else {
+    entity.index = static_cast<uint32_t>(m_records.size());
+    m_records.emplace_back();
+  }
+  entity.generation = m_records[entity.index].generation;
+  return entity;
+}
+
+uint32_t
+World::findArchetype(ComponentMask mask) {
+  auto found = m_archetypeByMask.find(mask);
+  if (found != m_archetypeByMask.end()) return found->second;
+
+  std::unique_ptr<Archetype> archetype(new Archetype());
+  archetype->mask = mask;
+  std::memset(archetype->column, -1, sizeof(archetype->column));
+  std::fill(archetype->addEdge, archetype->addEdge + ComponentTypes::kMaxTypes, -1);
+  std::fill(archetype->removeEdge, archetype->removeEdge + ComponentTypes::kMaxTypes, -1);
+  for (uint32_t typeId = 0; typeId < ComponentTypes::kMaxTypes; ++typeId) {
+    if (mask & (ComponentMask(1) << typeId)) {
+      archetype->column[typeId] = static_cast<int8_t>(archetype->types.size());
+      archetype->types.push_back(typeId);
+    }
+  }
+  archetype->data.assign(archetype->types.size(), nullptr);
+
+  const uint32_t index = static_cast<uint32_t>(m_archetypes.size());
+  m_archetypes.push_back(std::move(archetype));
+  m_archetypeByMask[mask] = index;
+  return index;
+}
+
+size_t
+World::pushRow(uint32_t archetypeIndex, EntityHandle entity) {
+  Archetype& archetype = *m_archetypes[archetypeIndex];
+  const size_t row = archetype.entities.size();
+
+  if (row == archetype.capacity) {
+    // Crece al doble; los componentes se mueven a la memoria nueva.
+    const size_t capacity = archetype.capacity ? archetype.capacity * 2 : 16;
+    for (size_t c = 0; c < archetype.types.size(); ++c) {
+      const uint32_t typeId = archetype.types[c];
+      const ComponentTypeInfo& info = ComponentTypes::info(typeId);
+      unsigned char* data = static_cast<unsigned char*>(
+        ::operator new(capacity * info.size, std::align_val_t(columnAlign_(typeId))));
+      for (size_t r = 0; r < row; ++r) {
+        info.moveConstruct(data + r * info.size, archetype.data[c] + r * info.size);
+        info.destroy(archetype.data[c] + r * info.size);
+      }
+      freeColumn_(archetype.data[c], typeId);
+      archetype.data[c] = data;
+    }
+    archetype.capacity = capacity;
+  }
+
+  archetype.entities.push_back(entity);
+  Record& record = m_records[entity.index];
+  record.archetype = static_cast<int32_t>(archetypeIndex);
+  record.row = static_cast<uint32_t>(row);
+  return row;
+}
+
+void
+World::eraseRow(uint32_t archetypeIndex, size_t row) {
+  Archetype& archetype = *m_archetypes[archetypeIndex];
+  const size_t last = archetype.entities.size() - 1;
+  if (row != last) {
+    for (size_t c = 0; c < archetype.types.size(); ++c) {
+      const ComponentTypeInfo& info = ComponentTypes::info(archetype.types[c]);
+      info.moveConstruct(archetype.data[c] + row * info.size, archetype.data[c] + last * info.size);
+      info.destroy(archetype.data[c] + last * info.size);
+    }
+    const EntityHandle moved = archetype.entities[last];
+    archetype.entities[row] = moved;
+    m_records[moved.index].row = static_cast<uint32_t>(row);
+  }
+  archetype.entities.pop_back();
+}
+
+size_t
+World::moveEntity(EntityHandle entity, uint32_t typeId, bool adding) {
+  // El arquetipo destino se busca una vez y queda en la arista.
+  // (los Archetype no se mueven de lugar aunque m_archetypes crezca).
+  Archetype& source = *m_archetypes[m_records[entity.index].archetype];
+  int32_t* edges = adding ? source.addEdge : source.removeEdge;
+  if (edges[typeId] < 0) {
+    const ComponentMask bit = ComponentMask(1) << typeId;
+    edges[typeId] = static_cast<int32_t>(findArchetype(adding ? (source.mask | bit) : (source.mask & ~bit)));
+  }
+  return moveEntityTo(entity, static_cast<uint32_t>(edges[typeId]));
+}
+
+size_t
+World::moveEntityTo(EntityHandle entity, uint32_t targetIndex) {
+  const uint32_t sourceIndex = static_cast<uint32_t>(m_records[entity.index].archetype);
+  const size_t sourceRow = m_records[entity.index].row;
+  Archetype& source = *m_archetypes[sourceIndex];
+
+  const size_t targetRow = pushRow(targetIndex, entity);
+  Archetype& target = *m_archetypes[targetIndex];
+  for (size_t c = 0; c < source.types.size(); ++c) {
+    const uint32_t type = source.types[c];
+    const ComponentTypeInfo& info = ComponentTypes::info(type);
+    void* from = source.data[c] + sourceRow * info.size;
+    if (target.column[type] >= 0) {
+      info.moveConstruct(target.at(type, targetRow), from);
+    }
+    info.destroy(from);
+  }
+  eraseRow(sourceIndex, sourceRow);
+
+  // pushRow dej el registro en el destino; eraseRow solo toca a la entidad que llen el hueco.
+  ++m_moves;
+  return targetRow;
+}
@@ -48,4 +48,41 @@ InputLayout::render(DeviceContext& deviceContext) {
 void
 InputLayout::destroy() {
 	SAFE_RELEASE(m_inputLayout);
-}
\ No newline at end of file
+}
+
+std::vector<D3D11_INPUT_ELEMENT_DESC>
+InputLayout::describe(VertexFormat format) {
+	DXGI_FORMAT positionFormat = DXGI_FORMAT_R32G32B32_FLOAT;
+	DXGI_FORMAT texcoordFormat = DXGI_FORMAT_R32G32_FLOAT;
+	if (format == VertexFormat::PackedHalf) {
+		positionFormat = DXGI_FORMAT_R16G16B16A16_SNORM;
+		texcoordFormat = DXGI_FORMAT_R16G16_FLOAT;
+	}
+	else if (format == VertexFormat::PackedUnorm) {
+		positionFormat = DXGI_FORMAT_R16G16B16A16_SNORM;
+		texcoordFormat = DXGI_FORMAT_R16G16_UNORM;
+	}
+
+	std::vector<D3D11_INPUT_ELEMENT_DESC> Layout;
+	D3D11_INPUT_ELEMENT_DESC position;
+	position.SemanticName = "POSITION";
+	position.SemanticIndex = 0;
+	position.Format = positionFormat;
+	position.InputSlot = 0;
+	position.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	position.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	position.InstanceDataStepRate = 0;
+	Layout.push_back(position);
+
+	D3D11_INPUT_ELEMENT_DESC texcoord;
+	texcoord.SemanticName = "TEXCOORD";
+	texcoord.SemanticIndex = 0;
+	texcoord.Format = texcoordFormat;
+	texcoord.InputSlot = 0;
+	texcoord.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	texcoord.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	texcoord.InstanceDataStepRate = 0;
+	Layout.push_back(texcoord);
+
+	return Layout;
+}
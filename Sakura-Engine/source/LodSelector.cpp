@@ -0,0 +1,189 @@
+#include "LodSelector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define LOD_SELECTOR_SSE2 1
+#endif
+
+uint32_t
+LodSelector::add() {
+  uint32_t slot;
+  if (!m_freeSlots.empty()) {
+    slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+  }
+  else {
+    slot = static_cast<uint32_t>(m_lod.size());
+    m_x.push_back(0.0f);
+    m_y.push_back(0.0f);
+    m_z.push_back(0.0f);
+    m_radius.push_back(0.0f);
+    for (unsigned int k = 0; k + 1 < kMaxLevels; ++k) {
+      m_threshold[k].push_back(0.0f);
+    }
+    m_levels.resize(m_levels.size() + (kMaxLevels - 1));
+    m_lod.push_back(0);
+  }
+
+  // Un slot reciclado empieza igual que uno nuevo.
+  setLevels(slot, nullptr, 0);
+  setBounds(slot, 0.0f, 0.0f, 0.0f, 0.0f);
+  m_lod[slot] = 0;
+  return slot;
+}
+
+void
+LodSelector::remove(uint32_t slot) {
+  if (slot >= m_lod.size()) {
+    return;
+  }
+  // Sin umbrales el slot se queda en LOD0 y no cuenta como cambio en select.
+  setLevels(slot, nullptr, 0);
+  m_lod[slot] = 0;
+  m_freeSlots.push_back(slot);
+}
+
+void
+LodSelector::setLevels(uint32_t slot, const LodThreshold* thresholds, unsigned int count) {
+  if (slot >= m_lod.size()) {
+    return;
+  }
+  LodThreshold* levels = &m_levels[static_cast<size_t>(slot) * (kMaxLevels - 1)];
+  for (unsigned int k = 0; k + 1 < kMaxLevels; ++k) {
+    levels[k] = k < count && thresholds ? thresholds[k] : LodThreshold();
+  }
+  updateThresholds(slot);
+
+  // Si el actor perdi niveles, no puede quedarse en uno que ya no existe.
+  if (static_cast<unsigned int>(m_lod[slot]) > count) {
+    m_lod[slot] = static_cast<int32_t>(count);
+  }
+}
+
+void
+LodSelector::setBounds(uint32_t slot, float x, float y, float z, float radius) {
+  if (slot >= m_lod.size()) {
+    return;
+  }
+  m_x[slot] = x;
+  m_y[slot] = y;
+  m_z[slot] = z;
+  m_radius[slot] = radius;
+}
+
+void
+LodSelector::updateThresholds(uint32_t slot) {
+  const LodThreshold* levels = &m_levels[static_cast<size_t>(slot) * (kMaxLevels - 1)];
+  float previous = INFINITY;
+  for (unsigned int k = 0; k + 1 < kMaxLevels; ++k) {
+    float threshold = levels[k].screenSize;
+    if (levels[k].relativeError > 0.0f && m_errorScale > 0.0f) {
+      // Error en pixeles = relativeError * tamao * altura / 2.
+      threshold = (std::max)(threshold, m_errorScale / levels[k].relativeError);
+    }
+    // Un nivel ms simple nunca puede entrar antes que el anterior; as
+    // el nivel es simplemente cuntos umbrales quedan por encima del tamao.
+    threshold = (std::min)(threshold, previous);
+    m_threshold[k][slot] = threshold;
+    previous = threshold;
+  }
+}
+
+void
+LodSelector::select(const float cameraPosition[3], float projectionScale, float viewportHeight) {
+  const auto startTime = std::chrono::steady_clock::now();
+
+  // Los umbrales por error dependen del viewport: solo se recalculan si cambi.
+  const float errorScale = viewportHeight > 0.0f ? 2.0f * m_pixelError / viewportHeight : 0.0f;
+  if (errorScale != m_errorScale) {
+    m_errorScale = errorScale;
+    for (uint32_t slot = 0; slot < m_lod.size(); ++slot) {
+      updateThresholds(slot);
+    }
+  }
+
+  /*
+   * Tamao en pantalla s = radio * P11 / distancia. Para no dividir se
+   * compara radio * P11 contra umbral * distancia.
+   *  - down: niveles cuyo umbral * (1 - h) ya qued por encima -> nivel mnimo.
+   *  - up:   niveles cuyo umbral * (1 + h) qued por encima    -> nivel mximo.
+   * El nivel actual se recorta a [down, up].
+   */
+  const float lower = 1.0f - m_hysteresis;
+  const float upper = 1.0f + m_hysteresis;
+  const size_t count = m_lod.size();
+  size_t switches = 0;
+  size_t i = 0;
+
+#ifdef LOD_SELECTOR_SSE2
+  const __m128 cameraX = _mm_set1_ps(cameraPosition[0]);
+  const __m128 cameraY = _mm_set1_ps(cameraPosition[1]);
+  const __m128 cameraZ = _mm_set1_ps(cameraPosition[2]);
+  const __m128 scale = _mm_set1_ps(projectionScale);
+  const __m128 lower4 = _mm_set1_ps(lower);
+  const __m128 upper4 = _mm_set1_ps(upper);
+
+  for (; i + 4 <= count; i += 4) {
+    const __m128 dx = _mm_sub_ps(_mm_loadu_ps(&m_x[i]), cameraX);
+    const __m128 dy = _mm_sub_ps(_mm_loadu_ps(&m_y[i]), cameraY);
+    const __m128 dz = _mm_sub_ps(_mm_loadu_ps(&m_z[i]), cameraZ);
+    const __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+                                                   _mm_mul_ps(dz, dz)));
+    const __m128 projected = _mm_mul_ps(_mm_loadu_ps(&m_radius[i]), scale);
+    const __m128 lowerDistance = _mm_mul_ps(distance, lower4);
+    const __m128 upperDistance = _mm_mul_ps(distance, upper4);
+
+    // Las mscaras valen -1 donde se cumple: restarlas suma 1 por nivel.
+    __m128i down = _mm_setzero_si128();
+    __m128i up = _mm_setzero_si128();
+    for (unsigned int k = 0; k + 1 < kMaxLevels; ++k) {
+      const __m128 threshold = _mm_loadu_ps(&m_threshold[k][i]);
+      down = _mm_sub_epi32(down, _mm_castps_si128(_mm_cmplt_ps(projected, _mm_mul_ps(threshold, lowerDistance))));
+      up = _mm_sub_epi32(up, _mm_castps_si128(_mm_cmplt_ps(projected, _mm_mul_ps(threshold, upperDistance))));
+    }
+
+    // clamp(current, down, up) con comparaciones (SSE2 no tiene min/max de enteros de 32 bits).
+    const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_lod[i]));
+    const __m128i belowDown = _mm_cmplt_epi32(current, down);
+    __m128i chosen = _mm_or_si128(_mm_and_si128(belowDown, down), _mm_andnot_si128(belowDown, current));
+    const __m128i aboveUp = _mm_cmpgt_epi32(chosen, up);
+    chosen = _mm_or_si128(_mm_and_si128(aboveUp, up), _mm_andnot_si128(aboveUp, chosen));
+
+    const int changed = ~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(chosen, current))) & 0xF;
+    if (changed) {
+      switches += (changed & 1) + ((changed >> 1) & 1) + ((changed >> 2) & 1) + ((changed >> 3) & 1);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(&m_lod[i]), chosen);
+    }
+  }
+#endif
+
+  for (; i < count; ++i) {
+    const float dx = m_x[i] - cameraPosition[0];
+    const float dy = m_y[i] - cameraPosition[1];
+    const float dz = m_z[i] - cameraPosition[2];
+    const float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+    const float projected = m_radius[i] * projectionScale;
+
+    int32_t down = 0;
+    int32_t up = 0;
+    for (unsigned int k = 0; k + 1 < kMaxLevels; ++k) {
+      down += projected < m_threshold[k][i] * (distance * lower) ? 1 : 0;
+      up += projected < m_threshold[k][i] * (distance * upper) ? 1 : 0;
+    }
+
+    const int32_t current = m_lod[i];
+    const int32_t chosen = current < down ? down : (current > up ? up : current);
+    if (chosen != current) {
+      m_lod[i] = chosen;
+      ++switches;
+    }
+  }
+
+  m_lastStats.actors = size();
+  m_lastStats.switches = switches;
+  m_lastStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
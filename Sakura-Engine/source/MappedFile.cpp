@@ -0,0 +1,132 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const size_t MappedFile::kReleaseAlign;
+
+// Abre el archivo y mapea todo su contenido como solo lectura.
+bool MappedFile::open(const std::string& path) {
+  close();
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER fileSize{};
+  if (!GetFileSizeEx(file, &fileSize)) {
+    CloseHandle(file);
+    return false;
+  }
+
+  m_file = file;
+  m_size = static_cast<size_t>(fileSize.QuadPart);
+  m_isOpen = true;
+
+  // CreateFileMapping falla con archivos de 0 bytes, as que ah me detengo.
+  if (m_size == 0) {
+    return true;
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) {
+    close();
+    return false;
+  }
+  m_mapping = mapping;
+
+  m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  if (!m_data) {
+    close();
+    return false;
+  }
+#else
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st {};
+  if (fstat(fd, &st) != 0) {
+    ::close(fd);
+    return false;
+  }
+
+  m_fd = fd;
+  m_size = static_cast<size_t>(st.st_size);
+  m_isOpen = true;
+
+  // mmap tampoco acepta longitud 0.
+  if (m_size == 0) {
+    return true;
+  }
+
+  void* view = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (view == MAP_FAILED) {
+    close();
+    return false;
+  }
+  m_data = static_cast<const char*>(view);
+#endif
+
+  return true;
+}
+
+// Suelta las pginas de los bloques completos de [offset, offset + size).
+void MappedFile::release(size_t offset, size_t size) {
+  if (!m_data || offset >= m_size) {
+    return;
+  }
+  const size_t end = (size > m_size - offset) ? m_size : offset + size;
+  const size_t first = (offset + kReleaseAlign - 1) & ~(kReleaseAlign - 1);
+  const size_t last = end & ~(kReleaseAlign - 1);
+  if (first >= last) {
+    return;
+  }
+
+#ifdef _WIN32
+  // En pginas que no estn bloqueadas, VirtualUnlock solo las saca del
+  // working set (y devuelve error, que aqu no importa).
+  VirtualUnlock(const_cast<char*>(m_data + first), last - first);
+#else
+  madvise(const_cast<char*>(m_data + first), last - first, MADV_DONTNEED);
+#endif
+}
+
+// Libera la vista y los handles. Deja el objeto listo para otro open().
+void MappedFile::close() {
+#ifdef _WIN32
+  if (m_data) {
+    UnmapViewOfFile(m_data);
+  }
+  if (m_mapping) {
+    CloseHandle(static_cast<HANDLE>(m_mapping));
+  }
+  if (m_file) {
+    CloseHandle(static_cast<HANDLE>(m_file));
+  }
+  m_mapping = nullptr;
+  m_file = nullptr;
+#else
+  if (m_data) {
+    munmap(const_cast<char*>(m_data), m_size);
+  }
+  if (m_fd >= 0) {
+    ::close(m_fd);
+  }
+  m_fd = -1;
+#endif
+
+  m_data = nullptr;
+  m_size = 0;
+  m_isOpen = false;
+}
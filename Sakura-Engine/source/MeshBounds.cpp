@@ -0,0 +1,147 @@
+#include "MeshBounds.h"
+
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MESH_BOUNDS_SSE2 1
+#endif
+
+static inline const float* position_(const unsigned char* base, size_t stride, size_t index) {
+  return reinterpret_cast<const float*>(base + index * stride);
+}
+
+void
+MeshBounds::computeAabb(const void* vertices,
+  size_t vertexCount,
+  size_t vertexStride,
+  float outMin[3],
+  float outMax[3]) {
+  if (!vertices || vertexCount == 0) {
+    for (int k = 0; k < 3; ++k) outMin[k] = outMax[k] = 0.0f;
+    return;
+  }
+
+  const unsigned char* base = static_cast<const unsigned char*>(vertices);
+  const float* first = position_(base, vertexStride, 0);
+  float minP[3] = { first[0], first[1], first[2] };
+  float maxP[3] = { first[0], first[1], first[2] };
+  size_t i = 1;
+
+#ifdef MESH_BOUNDS_SSE2
+  // Cada vrtice se lee como 4 floats (x, y, z y lo que siga); la cuarta
+  // componente se ignora al final. Solo es seguro si el vrtice mide al
+  // menos 16 bytes, as la lectura no se sale del ltimo vrtice.
+  if (vertexStride >= 4 * sizeof(float)) {
+    __m128 min0 = _mm_loadu_ps(first);
+    __m128 max0 = min0;
+    __m128 min1 = min0;
+    __m128 max1 = min0;
+    for (; i + 4 <= vertexCount; i += 4) {
+      const __m128 p0 = _mm_loadu_ps(position_(base, vertexStride, i + 0));
+      const __m128 p1 = _mm_loadu_ps(position_(base, vertexStride, i + 1));
+      const __m128 p2 = _mm_loadu_ps(position_(base, vertexStride, i + 2));
+      const __m128 p3 = _mm_loadu_ps(position_(base, vertexStride, i + 3));
+      // Dos acumuladores para no encadenar cada min/max con el anterior.
+      min0 = _mm_min_ps(min0, _mm_min_ps(p0, p1));
+      max0 = _mm_max_ps(max0, _mm_max_ps(p0, p1));
+      min1 = _mm_min_ps(min1, _mm_min_ps(p2, p3));
+      max1 = _mm_max_ps(max1, _mm_max_ps(p2, p3));
+    }
+    float lo[4];
+    float hi[4];
+    _mm_storeu_ps(lo, _mm_min_ps(min0, min1));
+    _mm_storeu_ps(hi, _mm_max_ps(max0, max1));
+    for (int k = 0; k < 3; ++k) {
+      minP[k] = lo[k];
+      maxP[k] = hi[k];
+    }
+  }
+#endif
+
+  for (; i < vertexCount; ++i) {
+    const float* p = position_(base, vertexStride, i);
+    for (int k = 0; k < 3; ++k) {
+      if (p[k] < minP[k]) minP[k] = p[k];
+      if (p[k] > maxP[k]) maxP[k] = p[k];
+    }
+  }
+
+  for (int k = 0; k < 3; ++k) {
+    outMin[k] = minP[k];
+    outMax[k] = maxP[k];
+  }
+}
+
+float
+MeshBounds::computeRadius(const void* vertices,
+  size_t vertexCount,
+  size_t vertexStride,
+  const float center[3]) {
+  if (!vertices || vertexCount == 0) {
+    return 0.0f;
+  }
+
+  const unsigned char* base = static_cast<const unsigned char*>(vertices);
+  float maxDistance = 0.0f;
+  size_t i = 0;
+
+#ifdef MESH_BOUNDS_SSE2
+  if (vertexStride >= 4 * sizeof(float)) {
+    // Cuatro vrtices a la vez: se transponen para tener x, y, z por separado.
+    const __m128 centerX = _mm_set1_ps(center[0]);
+    const __m128 centerY = _mm_set1_ps(center[1]);
+    const __m128 centerZ = _mm_set1_ps(center[2]);
+    __m128 maxDistance4 = _mm_setzero_ps();
+    for (; i + 4 <= vertexCount; i += 4) {
+      __m128 x = _mm_loadu_ps(position_(base, vertexStride, i + 0));
+      __m128 y = _mm_loadu_ps(position_(base, vertexStride, i + 1));
+      __m128 z = _mm_loadu_ps(position_(base, vertexStride, i + 2));
+      __m128 w = _mm_loadu_ps(position_(base, vertexStride, i + 3));
+      _MM_TRANSPOSE4_PS(x, y, z, w);
+      x = _mm_sub_ps(x, centerX);
+      y = _mm_sub_ps(y, centerY);
+      z = _mm_sub_ps(z, centerZ);
+      const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+      maxDistance4 = _mm_max_ps(maxDistance4, distance);
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, maxDistance4);
+    for (int k = 0; k < 4; ++k) {
+      if (lanes[k] > maxDistance) maxDistance = lanes[k];
+    }
+  }
+#endif
+
+  for (; i < vertexCount; ++i) {
+    const float* p = position_(base, vertexStride, i);
+    const float dx = p[0] - center[0];
+    const float dy = p[1] - center[1];
+    const float dz = p[2] - center[2];
+    const float distance = dx * dx + dy * dy + dz * dz;
+    if (distance > maxDistance) maxDistance = distance;
+  }
+  return std::sqrt(maxDistance);
+}
+
+void
+MeshBounds::transformAabb(const float matrix[16],
+  const float min[3],
+  const float max[3],
+  float outMin[3],
+  float outMax[3]) {
+  // Con vectores fila: out[c] = traslacin[c] + suma de min/max[r] * m[r][c],
+  // tomando para cada trmino el extremo que lo hace menor o mayor.
+  for (int c = 0; c < 3; ++c) {
+    float lo = matrix[12 + c];
+    float hi = matrix[12 + c];
+    for (int r = 0; r < 3; ++r) {
+      const float a = matrix[r * 4 + c] * min[r];
+      const float b = matrix[r * 4 + c] * max[r];
+      lo += a < b ? a : b;
+      hi += a < b ? b : a;
+    }
+    outMin[c] = lo;
+    outMax[c] = hi;
+  }
+}
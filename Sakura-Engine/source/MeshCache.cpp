@@ -0,0 +1,502 @@
+#include "MeshCache.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+// ---------------------------------------------------------------------------
+// Formato del archivo (todos los offsets son desde el inicio del archivo):
+//
+//   SakMeshHeader_
+//   SakMeshRecord_     x meshCount
+//   SakSubMeshRecord_  x (suma de subMeshCount)
+//   SakLodRecord_      x (suma de lodCount)
+//   MeshCacheRange     x (subMeshCount de cada LOD)
+//   nombres de mallas, materiales y texturas (sin '\0')
+//   por malla: vrtices, normales y tangentes (si hay), ndices e ndices de
+//   cada LOD, cada bloque alineado a 16 bytes
+// ---------------------------------------------------------------------------
+
+static const char kMagic_[8] = { 'S', 'A', 'K', 'M', 'E', 'S', 'H', '\0' };
+
+struct SakMeshHeader_ {
+  char     magic[8];
+  uint32_t version;
+  uint32_t vertexStride;
+  uint64_t sourceSize;
+  int64_t  sourceMTime;
+  uint64_t sourceHash;
+  uint64_t fileSize;
+  uint32_t meshCount;
+  uint32_t reserved;
+  uint64_t settingsHash;
+};
+
+struct SakMeshRecord_ {
+  uint64_t vertexOffset;
+  uint64_t indexOffset;
+  uint64_t subMeshOffset;
+  uint64_t nameOffset;
+  uint32_t nameLength;
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  uint32_t subMeshCount;
+  float    aabbMin[3];
+  float    aabbMax[3];
+  uint64_t lodOffset;
+  uint32_t lodCount;
+  uint32_t reserved;
+  float    sphere[4];
+  uint64_t normalOffset;   // 3 floats por vrtice; 0 = la malla no trae normales.
+  uint64_t tangentOffset;  // 4 floats por vrtice; 0 = la malla no trae tangentes.
+};
+
+struct SakSubMeshRecord_ {
+  uint64_t materialOffset;
+  uint64_t textureOffset;
+  uint32_t materialLength;
+  uint32_t textureLength;
+  uint32_t startIndex;
+  uint32_t indexCount;
+};
+
+struct SakLodRecord_ {
+  uint64_t indexOffset;
+  uint64_t rangeOffset;
+  uint32_t indexCount;
+  float    error;
+};
+
+// El layout en disco no debe depender del compilador.
+static_assert(sizeof(SakMeshHeader_) == 64, "SakMeshHeader_ cambi de tamao");
+static_assert(sizeof(SakMeshRecord_) == 120, "SakMeshRecord_ cambi de tamao");
+static_assert(sizeof(SakSubMeshRecord_) == 32, "SakSubMeshRecord_ cambi de tamao");
+static_assert(sizeof(SakLodRecord_) == 24, "SakLodRecord_ cambi de tamao");
+static_assert(sizeof(MeshCacheRange) == 8, "MeshCacheRange cambi de tamao");
+
+static inline uint64_t align16_(uint64_t offset) {
+  return (offset + 15) & ~uint64_t(15);
+}
+
+// Revisa que [offset, offset + size) quede dentro del archivo.
+static inline bool inFile_(uint64_t offset, uint64_t size, uint64_t fileSize) {
+  return offset <= fileSize && size <= fileSize - offset;
+}
+
+// Revisa que cada rango [startIndex, startIndex + indexCount) quepa en 'indexCount' ndices.
+template<typename Range>
+static bool rangesFit_(const Range* ranges, uint32_t count, uint32_t indexCount) {
+  for (uint32_t i = 0; i < count; ++i) {
+    if (uint64_t(ranges[i].startIndex) + ranges[i].indexCount > indexCount) return false;
+  }
+  return true;
+}
+
+// Revisa que ningn ndice apunte fuera de los vrtices de la malla.
+static bool indicesFit_(const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount) {
+  uint32_t maxIndex = 0;
+  for (uint32_t i = 0; i < indexCount; ++i) {
+    if (indices[i] > maxIndex) maxIndex = indices[i];
+  }
+  return indexCount == 0 || maxIndex < vertexCount;
+}
+
+// Guarda la nueva fecha del archivo fuente en el encabezado de la cach,
+// para no volver a calcular el hash en cada arranque.
+static bool patchSourceMTime_(const std::string& cachePath, int64_t mtime) {
+  std::fstream file(cachePath, std::ios::binary | std::ios::in | std::ios::out);
+  if (!file.is_open()) return false;
+  file.seekp(offsetof(SakMeshHeader_, sourceMTime));
+  file.write(reinterpret_cast<const char*>(&mtime), sizeof(mtime));
+  return file.good();
+}
+
+uint64_t
+MeshCache::hashBytes(const void* data, size_t size) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+bool
+MeshCache::stampSource(const std::string& sourcePath, MeshCacheSource& out, bool withHash) {
+  std::error_code ec;
+  const std::filesystem::path path(sourcePath);
+
+  const uintmax_t size = std::filesystem::file_size(path, ec);
+  if (ec) return false;
+  const auto mtime = std::filesystem::last_write_time(path, ec);
+  if (ec) return false;
+
+  out.size = static_cast<uint64_t>(size);
+  out.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+  out.hash = 0;
+
+  if (withHash) {
+    MappedFile file;
+    if (!file.open(sourcePath)) return false;
+    out.hash = hashBytes(file.data(), file.size());
+  }
+  return true;
+}
+
+bool
+MeshCache::write(const std::string& cachePath,
+  const MeshCacheSource& source,
+  uint64_t settingsHash,
+  uint32_t vertexStride,
+  const std::vector<MeshCacheMesh>& meshes)
+{
+  // 1) Calculo dnde va cada cosa antes de escribir.
+  size_t totalSubMeshes = 0;
+  size_t totalLods = 0;
+  size_t totalRanges = 0;
+  for (const MeshCacheMesh& mesh : meshes) {
+    totalSubMeshes += mesh.subMeshes.size();
+    totalLods += mesh.lods.size();
+    for (const MeshCacheLod& lod : mesh.lods) {
+      // Cada LOD trae exactamente un rango por submalla.
+      if (lod.subMeshRanges.size() != mesh.subMeshes.size()) return false;
+      totalRanges += lod.subMeshRanges.size();
+    }
+  }
+
+  uint64_t offset = sizeof(SakMeshHeader_);
+  const uint64_t recordsOffset = offset;
+  offset += sizeof(SakMeshRecord_) * meshes.size();
+  const uint64_t subMeshesOffset = offset;
+  offset += sizeof(SakSubMeshRecord_) * totalSubMeshes;
+  const uint64_t lodsOffset = offset;
+  offset += sizeof(SakLodRecord_) * totalLods;
+  const uint64_t rangesOffset = offset;
+  offset += sizeof(MeshCacheRange) * totalRanges;
+
+  std::vector<SakMeshRecord_> records(meshes.size());
+  std::vector<SakSubMeshRecord_> subRecords(totalSubMeshes);
+  std::vector<SakLodRecord_> lodRecords(totalLods);
+  std::vector<MeshCacheRange> ranges;
+  ranges.reserve(totalRanges);
+  std::string strings;
+
+  size_t subCursor = 0;
+  size_t lodCursor = 0;
+  for (size_t m = 0; m < meshes.size(); ++m) {
+    const MeshCacheMesh& mesh = meshes[m];
+    SakMeshRecord_& record = records[m];
+    std::memset(&record, 0, sizeof(record));
+
+    record.nameOffset = offset + strings.size();
+    record.nameLength = static_cast<uint32_t>(mesh.name.size());
+    strings += mesh.name;
+
+    record.subMeshOffset = subMeshesOffset + sizeof(SakSubMeshRecord_) * subCursor;
+    record.subMeshCount = static_cast<uint32_t>(mesh.subMeshes.size());
+    for (const MeshCacheSubMesh& subMesh : mesh.subMeshes) {
+      SakSubMeshRecord_& subRecord = subRecords[subCursor++];
+      subRecord.materialOffset = offset + strings.size();
+      subRecord.materialLength = static_cast<uint32_t>(subMesh.materialName.size());
+      strings += subMesh.materialName;
+      subRecord.textureOffset = offset + strings.size();
+      subRecord.textureLength = static_cast<uint32_t>(subMesh.texturePath.size());
+      strings += subMesh.texturePath;
+      subRecord.startIndex = subMesh.startIndex;
+      subRecord.indexCount = subMesh.indexCount;
+    }
+
+    record.lodOffset = lodsOffset + sizeof(SakLodRecord_) * lodCursor;
+    record.lodCount = static_cast<uint32_t>(mesh.lods.size());
+    for (const MeshCacheLod& lod : mesh.lods) {
+      SakLodRecord_& lodRecord = lodRecords[lodCursor++];
+      std::memset(&lodRecord, 0, sizeof(lodRecord));
+      lodRecord.rangeOffset = rangesOffset + sizeof(MeshCacheRange) * ranges.size();
+      lodRecord.indexCount = lod.indexCount;
+      lodRecord.error = lod.error;
+      ranges.insert(ranges.end(), lod.subMeshRanges.begin(), lod.subMeshRanges.end());
+    }
+
+    record.vertexCount = mesh.vertexCount;
+    record.indexCount = mesh.indexCount;
+    std::memcpy(record.aabbMin, mesh.aabbMin, sizeof(record.aabbMin));
+    std::memcpy(record.aabbMax, mesh.aabbMax, sizeof(record.aabbMax));
+    std::memcpy(record.sphere, mesh.sphere, sizeof(record.sphere));
+  }
+  offset += strings.size();
+
+  for (size_t m = 0; m < meshes.size(); ++m) {
+    offset = align16_(offset);
+    records[m].vertexOffset = offset;
+    offset += uint64_t(meshes[m].vertexCount) * vertexStride;
+    if (meshes[m].normals) {
+      offset = align16_(offset);
+      records[m].normalOffset = offset;
+      offset += uint64_t(meshes[m].vertexCount) * 3 * sizeof(float);
+    }
+    if (meshes[m].tangents) {
+      offset = align16_(offset);
+      records[m].tangentOffset = offset;
+      offset += uint64_t(meshes[m].vertexCount) * 4 * sizeof(float);
+    }
+    offset = align16_(offset);
+    records[m].indexOffset = offset;
+    offset += uint64_t(meshes[m].indexCount) * sizeof(uint32_t);
+    for (uint32_t l = 0; l < records[m].lodCount; ++l) {
+      SakLodRecord_& lodRecord = lodRecords[(records[m].lodOffset - lodsOffset) / sizeof(SakLodRecord_) + l];
+      offset = align16_(offset);
+      lodRecord.indexOffset = offset;
+      offset += uint64_t(lodRecord.indexCount) * sizeof(uint32_t);
+    }
+  }
+
+  SakMeshHeader_ header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic_, sizeof(kMagic_));
+  header.version = kVersion;
+  header.vertexStride = vertexStride;
+  header.sourceSize = source.size;
+  header.sourceMTime = source.mtime;
+  header.sourceHash = source.hash;
+  header.fileSize = offset;
+  header.meshCount = static_cast<uint32_t>(meshes.size());
+  header.settingsHash = settingsHash;
+
+  // 2) Escribo a un temporal y lo renombro al final.
+  const std::string tempPath = cachePath + ".tmp";
+  {
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    static const char kZeros[16] = {};
+    auto padTo = [&out](uint64_t target) {
+      const uint64_t current = static_cast<uint64_t>(out.tellp());
+      if (target > current) out.write(kZeros, static_cast<std::streamsize>(target - current));
+    };
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    padTo(recordsOffset);
+    if (!records.empty())
+      out.write(reinterpret_cast<const char*>(records.data()), sizeof(SakMeshRecord_) * records.size());
+    if (!subRecords.empty())
+      out.write(reinterpret_cast<const char*>(subRecords.data()), sizeof(SakSubMeshRecord_) * subRecords.size());
+    if (!lodRecords.empty())
+      out.write(reinterpret_cast<const char*>(lodRecords.data()), sizeof(SakLodRecord_) * lodRecords.size());
+    if (!ranges.empty())
+      out.write(reinterpret_cast<const char*>(ranges.data()), sizeof(MeshCacheRange) * ranges.size());
+    out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+    for (size_t m = 0; m < meshes.size(); ++m) {
+      padTo(records[m].vertexOffset);
+      out.write(static_cast<const char*>(meshes[m].vertices),
+        static_cast<std::streamsize>(uint64_t(meshes[m].vertexCount) * vertexStride));
+      if (records[m].normalOffset) {
+        padTo(records[m].normalOffset);
+        out.write(reinterpret_cast<const char*>(meshes[m].normals),
+          static_cast<std::streamsize>(uint64_t(meshes[m].vertexCount) * 3 * sizeof(float)));
+      }
+      if (records[m].tangentOffset) {
+        padTo(records[m].tangentOffset);
+        out.write(reinterpret_cast<const char*>(meshes[m].tangents),
+          static_cast<std::streamsize>(uint64_t(meshes[m].vertexCount) * 4 * sizeof(float)));
+      }
+      padTo(records[m].indexOffset);
+      out.write(reinterpret_cast<const char*>(meshes[m].indices),
+        static_cast<std::streamsize>(uint64_t(meshes[m].indexCount) * sizeof(uint32_t)));
+      for (uint32_t l = 0; l < records[m].lodCount; ++l) {
+        const SakLodRecord_& lodRecord = lodRecords[(records[m].lodOffset - lodsOffset) / sizeof(SakLodRecord_) + l];
+        padTo(lodRecord.indexOffset);
+        out.write(reinterpret_cast<const char*>(meshes[m].lods[l].indices),
+          static_cast<std::streamsize>(uint64_t(lodRecord.indexCount) * sizeof(uint32_t)));
+      }
+    }
+
+    if (!out.good()) {
+      out.close();
+      std::remove(tempPath.c_str());
+      return false;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tempPath, cachePath, ec);
+  if (ec) {
+    std::remove(tempPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool
+MeshCache::open(const std::string& cachePath, const std::string& sourcePath,
+  uint64_t settingsHash, uint32_t vertexStride) {
+  close();
+  if (!m_file.open(cachePath)) return false;
+
+  const uint64_t fileSize = m_file.size();
+  if (fileSize < sizeof(SakMeshHeader_)) {
+    close();
+    return false;
+  }
+
+  const SakMeshHeader_* header = reinterpret_cast<const SakMeshHeader_*>(m_file.data());
+  if (std::memcmp(header->magic, kMagic_, sizeof(kMagic_)) != 0 ||
+    header->version != kVersion ||
+    header->vertexStride != vertexStride ||
+    header->settingsHash != settingsHash ||
+    header->fileSize != fileSize ||
+    !inFile_(sizeof(SakMeshHeader_), uint64_t(header->meshCount) * sizeof(SakMeshRecord_), fileSize)) {
+    close();
+    return false;
+  }
+
+  // Reviso que todos los bloques de cada malla estn dentro del archivo, que
+  // los rangos de submallas y LODs quepan en sus ndices y que los ndices
+  // apunten a vrtices que existen, as mesh(), subMesh() y lod() ya no
+  // tienen que validar nada y quien dibuje la malla no lee fuera del buffer.
+  const SakMeshRecord_* records = reinterpret_cast<const SakMeshRecord_*>(m_file.data() + sizeof(SakMeshHeader_));
+  for (uint32_t m = 0; m < header->meshCount; ++m) {
+    const SakMeshRecord_& record = records[m];
+    if (!inFile_(record.nameOffset, record.nameLength, fileSize) ||
+      !inFile_(record.vertexOffset, uint64_t(record.vertexCount) * vertexStride, fileSize) ||
+      !inFile_(record.indexOffset, uint64_t(record.indexCount) * sizeof(uint32_t), fileSize) ||
+      !inFile_(record.subMeshOffset, uint64_t(record.subMeshCount) * sizeof(SakSubMeshRecord_), fileSize) ||
+      !inFile_(record.lodOffset, uint64_t(record.lodCount) * sizeof(SakLodRecord_), fileSize) ||
+      (record.normalOffset && !inFile_(record.normalOffset, uint64_t(record.vertexCount) * 3 * sizeof(float), fileSize)) ||
+      (record.tangentOffset && !inFile_(record.tangentOffset, uint64_t(record.vertexCount) * 4 * sizeof(float), fileSize)) ||
+      (record.vertexOffset & 15) != 0 || (record.indexOffset & 15) != 0 ||
+      (record.normalOffset & 15) != 0 || (record.tangentOffset & 15) != 0) {
+      close();
+      return false;
+    }
+
+    const SakLodRecord_* lodRecords = reinterpret_cast<const SakLodRecord_*>(m_file.data() + record.lodOffset);
+    for (uint32_t l = 0; l < record.lodCount; ++l) {
+      if (!inFile_(lodRecords[l].indexOffset, uint64_t(lodRecords[l].indexCount) * sizeof(uint32_t), fileSize) ||
+        !inFile_(lodRecords[l].rangeOffset, uint64_t(record.subMeshCount) * sizeof(MeshCacheRange), fileSize) ||
+        (lodRecords[l].indexOffset & 15) != 0 || (lodRecords[l].rangeOffset & 7) != 0 ||
+        !rangesFit_(reinterpret_cast<const MeshCacheRange*>(m_file.data() + lodRecords[l].rangeOffset),
+          record.subMeshCount, lodRecords[l].indexCount) ||
+        !indicesFit_(reinterpret_cast<const uint32_t*>(m_file.data() + lodRecords[l].indexOffset),
+          lodRecords[l].indexCount, record.vertexCount)) {
+        close();
+        return false;
+      }
+    }
+
+    const SakSubMeshRecord_* subRecords = reinterpret_cast<const SakSubMeshRecord_*>(m_file.data() + record.subMeshOffset);
+    for (uint32_t s = 0; s < record.subMeshCount; ++s) {
+      if (!inFile_(subRecords[s].materialOffset, subRecords[s].materialLength, fileSize) ||
+        !inFile_(subRecords[s].textureOffset, subRecords[s].textureLength, fileSize)) {
+        close();
+        return false;
+      }
+    }
+    if (!rangesFit_(subRecords, record.subMeshCount, record.indexCount) ||
+      !indicesFit_(reinterpret_cast<const uint32_t*>(m_file.data() + record.indexOffset),
+        record.indexCount, record.vertexCount)) {
+      close();
+      return false;
+    }
+  }
+
+  // El archivo fuente: si ya no existe se usa la cach tal cual (por ejemplo
+  // cuando solo se distribuyen los .sakmesh). Si existe, tiene que coincidir.
+  MeshCacheSource source;
+  if (stampSource(sourcePath, source, false)) {
+    if (source.size != header->sourceSize) {
+      close();
+      return false;
+    }
+    if (source.mtime != header->sourceMTime) {
+      // Cambi la fecha pero no el tamao: comparo el contenido.
+      if (!stampSource(sourcePath, source, true) || source.hash != header->sourceHash) {
+        close();
+        return false;
+      }
+      // Es el mismo contenido: apunto la fecha nueva para que el prximo
+      // arranque no tenga que volver a leer todo el fuente. El mapeo es de
+      // solo lectura (y en Windows bloquea la escritura), as que lo cierro,
+      // parcho el encabezado y vuelvo a mapear. Si no se puede escribir, la
+      // cach sigue siendo vlida; solo se volver a comparar el hash.
+      m_file.close();
+      patchSourceMTime_(cachePath, source.mtime);
+      if (!m_file.open(cachePath) || m_file.size() != fileSize) {
+        close();
+        return false;
+      }
+      header = reinterpret_cast<const SakMeshHeader_*>(m_file.data());
+    }
+  }
+
+  m_meshCount = header->meshCount;
+  return true;
+}
+
+void
+MeshCache::close() {
+  m_file.close();
+  m_meshCount = 0;
+}
+
+MeshCacheMeshView
+MeshCache::mesh(uint32_t index) const {
+  MeshCacheMeshView view;
+  if (index >= m_meshCount) return view;
+
+  const char* base = m_file.data();
+  const SakMeshRecord_& record = reinterpret_cast<const SakMeshRecord_*>(base + sizeof(SakMeshHeader_))[index];
+
+  view.name = std::string_view(base + record.nameOffset, record.nameLength);
+  view.vertices = base + record.vertexOffset;
+  view.vertexCount = record.vertexCount;
+  view.indices = reinterpret_cast<const uint32_t*>(base + record.indexOffset);
+  view.indexCount = record.indexCount;
+  view.subMeshCount = record.subMeshCount;
+  view.lodCount = record.lodCount;
+  std::memcpy(view.aabbMin, record.aabbMin, sizeof(view.aabbMin));
+  std::memcpy(view.aabbMax, record.aabbMax, sizeof(view.aabbMax));
+  std::memcpy(view.sphere, record.sphere, sizeof(view.sphere));
+  if (record.normalOffset) view.normals = reinterpret_cast<const float*>(base + record.normalOffset);
+  if (record.tangentOffset) view.tangents = reinterpret_cast<const float*>(base + record.tangentOffset);
+  return view;
+}
+
+MeshCacheSubMeshView
+MeshCache::subMesh(uint32_t meshIndex, uint32_t subIndex) const {
+  MeshCacheSubMeshView view;
+  if (meshIndex >= m_meshCount) return view;
+
+  const char* base = m_file.data();
+  const SakMeshRecord_& record = reinterpret_cast<const SakMeshRecord_*>(base + sizeof(SakMeshHeader_))[meshIndex];
+  if (subIndex >= record.subMeshCount) return view;
+
+  const SakSubMeshRecord_& subRecord = reinterpret_cast<const SakSubMeshRecord_*>(base + record.subMeshOffset)[subIndex];
+  view.materialName = std::string_view(base + subRecord.materialOffset, subRecord.materialLength);
+  view.texturePath = std::string_view(base + subRecord.textureOffset, subRecord.textureLength);
+  view.startIndex = subRecord.startIndex;
+  view.indexCount = subRecord.indexCount;
+  return view;
+}
+
+MeshCacheLodView
+MeshCache::lod(uint32_t meshIndex, uint32_t lodIndex) const {
+  MeshCacheLodView view;
+  if (meshIndex >= m_meshCount) return view;
+
+  const char* base = m_file.data();
+  const SakMeshRecord_& record = reinterpret_cast<const SakMeshRecord_*>(base + sizeof(SakMeshHeader_))[meshIndex];
+  if (lodIndex >= record.lodCount) return view;
+
+  const SakLodRecord_& lodRecord = reinterpret_cast<const SakLodRecord_*>(base + record.lodOffset)[lodIndex];
+  view.indices = reinterpret_cast<const uint32_t*>(base + lodRecord.indexOffset);
+  view.indexCount = lodRecord.indexCount;
+  view.error = lodRecord.error;
+  view.subMeshRanges = reinterpret_cast<const MeshCacheRange*>(base + lodRecord.rangeOffset);
+  view.subMeshCount = record.subMeshCount;
+  return view;
+}
@@ -0,0 +1,188 @@
+#include "MeshOptimizer.h"
+
+#include <cstring>
+#include <vector>
+
+VertexCacheStats
+MeshOptimizer::analyzeVertexCache(const uint32_t* indices,
+  size_t indexCount,
+  size_t vertexCount,
+  uint32_t cacheSize)
+{
+  VertexCacheStats stats;
+  stats.triangles = indexCount / 3;
+  if (stats.triangles == 0 || cacheSize == 0) return stats;
+
+  // En un FIFO un vrtice sigue en el cache mientras hayan entrado menos de
+  // 'cacheSize' vrtices despus de l, as que basta con guardar en qu
+  // fallo entr cada uno.
+  const uint64_t kNever = ~uint64_t(0);
+  std::vector<uint64_t> insertedAt(vertexCount, kNever);
+  uint64_t misses = 0;
+
+  for (size_t i = 0; i < stats.triangles * 3; ++i) {
+    const uint32_t v = indices[i];
+    if (v >= vertexCount) continue;
+
+    if (insertedAt[v] == kNever) {
+      ++stats.vertices;
+    }
+    else if (misses - insertedAt[v] < cacheSize) {
+      continue;
+    }
+    insertedAt[v] = misses++;
+  }
+
+  stats.transformed = static_cast<size_t>(misses);
+  stats.acmr = static_cast<double>(misses) / static_cast<double>(stats.triangles);
+  stats.atvr = stats.vertices > 0 ? static_cast<double>(misses) / static_cast<double>(stats.vertices) : 0.0;
+  return stats;
+}
+
+void
+MeshOptimizer::optimizeVertexCache(uint32_t* indices,
+  size_t indexCount,
+  size_t vertexCount,
+  uint32_t cacheSize)
+{
+  const size_t triangleCount = indexCount / 3;
+  if (triangleCount < 2 || vertexCount == 0 || cacheSize == 0) return;
+  for (size_t i = 0; i < triangleCount * 3; ++i) {
+    if (indices[i] >= vertexCount) return;
+  }
+
+  // 1) Adyacencia vrtice -> tringulos en formato compacto (offsets + lista).
+  std::vector<uint32_t> live(vertexCount, 0);
+  for (size_t i = 0; i < triangleCount * 3; ++i) {
+    ++live[indices[i]];
+  }
+  std::vector<uint32_t> offsets(vertexCount + 1, 0);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    offsets[v + 1] = offsets[v] + live[v];
+  }
+  std::vector<uint32_t> adjacency(triangleCount * 3);
+  {
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t) {
+      for (size_t k = 0; k < 3; ++k) {
+        adjacency[cursor[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+      }
+    }
+  }
+
+  // 2) Tipsify. 'live' = tringulos pendientes por vrtice y 'cacheTime' =
+  //    momento en que el vrtice entr al cache (simulado con un reloj).
+  std::vector<uint32_t> output;
+  output.reserve(triangleCount * 3);
+  std::vector<uint32_t> cacheTime(vertexCount, 0);
+  std::vector<bool> emitted(triangleCount, false);
+  std::vector<uint32_t> deadEnd;
+  deadEnd.reserve(triangleCount * 3);
+  std::vector<uint32_t> candidates;
+  candidates.reserve(64);
+
+  uint32_t time = cacheSize + 1;
+  size_t scanCursor = 1;
+  int64_t fan = 0;
+
+  while (fan >= 0) {
+    const uint32_t f = static_cast<uint32_t>(fan);
+    candidates.clear();
+
+    // Emito todos los tringulos pendientes alrededor del vrtice actual.
+    for (uint32_t a = offsets[f]; a < offsets[f + 1]; ++a) {
+      const uint32_t t = adjacency[a];
+      if (emitted[t]) continue;
+      emitted[t] = true;
+
+      for (size_t k = 0; k < 3; ++k) {
+        const uint32_t v = indices[t * 3 + k];
+        output.push_back(v);
+        deadEnd.push_back(v);
+        candidates.push_back(v);
+        --live[v];
+        if (time - cacheTime[v] > cacheSize) {
+          cacheTime[v] = time++;
+        }
+      }
+    }
+
+    // Siguiente abanico: el candidato que seguir en el cache y lleva ms
+    // tiempo ah (as se aprovecha antes de que lo saquen).
+    fan = -1;
+    int64_t bestPriority = -1;
+    for (uint32_t v : candidates) {
+      if (live[v] == 0) continue;
+      int64_t priority = 0;
+      if (time - cacheTime[v] + 2 * live[v] <= cacheSize) {
+        priority = time - cacheTime[v];
+      }
+      if (priority > bestPriority) {
+        bestPriority = priority;
+        fan = v;
+      }
+    }
+
+    // Si ningn candidato sirve, regreso por la pila de vrtices recientes
+    // y si tampoco hay, busco en orden el siguiente con tringulos pendientes.
+    while (fan < 0 && !deadEnd.empty()) {
+      const uint32_t v = deadEnd.back();
+      deadEnd.pop_back();
+      if (live[v] > 0) fan = v;
+    }
+    while (fan < 0 && scanCursor < vertexCount) {
+      if (live[scanCursor] > 0) fan = static_cast<int64_t>(scanCursor);
+      ++scanCursor;
+    }
+  }
+
+  std::memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+}
+
+size_t
+MeshOptimizer::optimizeVertexFetch(void* vertices,
+  size_t vertexCount,
+  size_t vertexStride,
+  uint32_t* indices,
+  size_t indexCount)
+{
+  if (!vertices || vertexCount == 0) return vertexCount;
+  for (size_t i = 0; i < indexCount; ++i) {
+    if (indices[i] >= vertexCount) return vertexCount;
+  }
+
+  const uint32_t kUnused = 0xFFFFFFFFu;
+  std::vector<uint32_t> remap(vertexCount, kUnused);
+  uint32_t next = 0;
+  for (size_t i = 0; i < indexCount; ++i) {
+    uint32_t& slot = remap[indices[i]];
+    if (slot == kUnused) slot = next++;
+    indices[i] = slot;
+  }
+
+  // Copia temporal para poder mover los vrtices sin pisarlos.
+  const unsigned char* source = static_cast<const unsigned char*>(vertices);
+  std::vector<unsigned char> reordered(static_cast<size_t>(next) * vertexStride);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    if (remap[v] != kUnused) {
+      std::memcpy(&reordered[remap[v] * vertexStride], source + v * vertexStride, vertexStride);
+    }
+  }
+  std::memcpy(vertices, reordered.data(), reordered.size());
+  return next;
+}
+
+uint32_t
+MeshOptimizer::chooseIndexWidth(const uint32_t* indices, size_t indexCount) {
+  for (size_t i = 0; i < indexCount; ++i) {
+    if (indices[i] >= 0xFFFFu) return 4;
+  }
+  return 2;
+}
+
+void
+MeshOptimizer::packIndices16(const uint32_t* indices, size_t indexCount, uint16_t* out) {
+  for (size_t i = 0; i < indexCount; ++i) {
+    out[i] = static_cast<uint16_t>(indices[i]);
+  }
+}
@@ -0,0 +1,553 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+static const uint32_t kNone_ = 0xFFFFFFFFu;
+
+// Dimensiones de la cudrica: posicin (3) + uv (2).
+static const int kDims_ = 5;
+
+// Peso de los planos que detienen los bordes abiertos, frente al de los tringulos.
+static const double kBorderWeight_ = 4.0;
+
+// Un colapso se rechaza si algn tringulo gira ms de ~75 grados (cos < 0.25).
+static const double kMinFlipCos_ = 0.25;
+
+// Posicin de (i, j) dentro de la parte superior de una matriz simtrica de 5x5.
+static const int kSym_[kDims_][kDims_] = {
+  { 0, 1,  2,  3,  4 },
+  { 1, 5,  6,  7,  8 },
+  { 2, 6,  9, 10, 11 },
+  { 3, 7, 10, 12, 13 },
+  { 4, 8, 11, 13, 14 },
+};
+
+/*
+ * Cudrica de error: error(v) = v^T A v + 2 bv + c, con A simtrica.
+ * 'weight' es la suma de los pesos (reas) acumulados; al dividir entre l
+ * el error queda como distancia al cuadrado.
+ */
+struct Quadric_ {
+  double a[15];
+  double b[kDims_];
+  double c;
+  double weight;
+};
+
+enum class VertexKind_ : unsigned char {
+  Manifold,  // Interior: se puede colapsar hacia cualquier vecino.
+  Border,    // Borde abierto: solo a lo largo del borde.
+  Seam,      // Costura de uv: junto con su gemelo y a lo largo de la costura.
+  Locked     // No se mueve.
+};
+
+// Colapso candidato: 'from' se une a 'to' (y 'twinFrom' a 'twinTo' en las costuras).
+struct Collapse_ {
+  double cost;
+  uint32_t from;
+  uint32_t to;
+  uint32_t twinFrom;
+  uint32_t twinTo;
+};
+
+static inline void quadricAdd_(Quadric_& to, const Quadric_& from) {
+  for (int i = 0; i < 15; ++i) to.a[i] += from.a[i];
+  for (int i = 0; i < kDims_; ++i) to.b[i] += from.b[i];
+  to.c += from.c;
+  to.weight += from.weight;
+}
+
+static inline double quadricError_(const Quadric_& q, const double* v) {
+  double error = q.c;
+  for (int i = 0; i < kDims_; ++i) {
+    double row = 0.0;
+    for (int j = 0; j < kDims_; ++j) row += q.a[kSym_[i][j]] * v[j];
+    error += v[i] * (row + 2.0 * q.b[i]);
+  }
+  if (error < 0.0) error = 0.0;
+  return q.weight > 0.0 ? error / q.weight : error;
+}
+
+/*
+ * Cudrica de un tringulo en el espacio posicin + uv: distancia al cuadrado
+ * al plano (de 2 dimensiones) que forman sus tres puntos. Se arma con una base
+ * ortonormal e1, e2 del tringulo: A = I - e1 e1^T - e2 e2^T.
+ */
+static void quadricFromTriangle_(Quadric_& q, const double* p0, const double* p1,
+  const double* p2, double weight)
+{
+  std::memset(&q, 0, sizeof(q));
+
+  double e1[kDims_], e2[kDims_];
+  double length1 = 0.0;
+  for (int i = 0; i < kDims_; ++i) {
+    e1[i] = p1[i] - p0[i];
+    length1 += e1[i] * e1[i];
+  }
+  if (length1 <= 0.0) return;
+  length1 = std::sqrt(length1);
+  for (int i = 0; i < kDims_; ++i) e1[i] /= length1;
+
+  double along = 0.0;
+  for (int i = 0; i < kDims_; ++i) along += (p2[i] - p0[i]) * e1[i];
+  double length2 = 0.0;
+  for (int i = 0; i < kDims_; ++i) {
+    e2[i] = p2[i] - p0[i] - along * e1[i];
+    length2 += e2[i] * e2[i];
+  }
+  if (length2 <= 0.0) return;
+  length2 = std::sqrt(length2);
+  for (int i = 0; i < kDims_; ++i) e2[i] /= length2;
+
+  double pe1 = 0.0, pe2 = 0.0, pp = 0.0;
+  for (int i = 0; i < kDims_; ++i) {
+    pe1 += p0[i] * e1[i];
+    pe2 += p0[i] * e2[i];
+    pp += p0[i] * p0[i];
+  }
+
+  for (int i = 0; i < kDims_; ++i) {
+    for (int j = i; j < kDims_; ++j) {
+      const double identity = (i == j) ? 1.0 : 0.0;
+      q.a[kSym_[i][j]] = (identity - e1[i] * e1[j] - e2[i] * e2[j]) * weight;
+    }
+    q.b[i] = (pe1 * e1[i] + pe2 * e2[i] - p0[i]) * weight;
+  }
+  q.c = (pp - pe1 * pe1 - pe2 * pe2) * weight;
+  q.weight = weight;
+}
+
+// Cudrica del plano np + d = 0 (solo posicin; la uv no cuenta).
+static void quadricFromPlane_(Quadric_& q, const double* n, double d, double weight) {
+  std::memset(&q, 0, sizeof(q));
+  for (int i = 0; i < 3; ++i) {
+    for (int j = i; j < 3; ++j) {
+      q.a[kSym_[i][j]] = n[i] * n[j] * weight;
+    }
+    q.b[i] = d * n[i] * weight;
+  }
+  q.c = d * d * weight;
+  q.weight = weight;
+}
+
+static inline void cross_(const double* a, const double* b, double* out) {
+  out[0] = a[1] * b[2] - a[2] * b[1];
+  out[1] = a[2] * b[0] - a[0] * b[2];
+  out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static inline double dot3_(const double* a, const double* b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// Caja de los vrtices. Devuelve el lado mayor y deja la esquina mnima en 'minP'.
+static float bounds_(const unsigned char* bytes, size_t vertexCount, size_t vertexStride, float* minP) {
+  float maxP[3];
+  for (int i = 0; i < 3; ++i) {
+    minP[i] = 0.0f;
+    maxP[i] = 0.0f;
+  }
+  for (size_t v = 0; v < vertexCount; ++v) {
+    float p[3];
+    std::memcpy(p, bytes + v * vertexStride, sizeof(p));
+    for (int i = 0; i < 3; ++i) {
+      if (v == 0 || p[i] < minP[i]) minP[i] = p[i];
+      if (v == 0 || p[i] > maxP[i]) maxP[i] = p[i];
+    }
+  }
+  return (std::max)(maxP[0] - minP[0], (std::max)(maxP[1] - minP[1], maxP[2] - minP[2]));
+}
+
+float
+MeshSimplifier::extent(const void* vertices, size_t vertexCount, size_t vertexStride) {
+  if (!vertices || vertexCount == 0) return 0.0f;
+  float minP[3];
+  return bounds_(static_cast<const unsigned char*>(vertices), vertexCount, vertexStride, minP);
+}
+
+size_t
+MeshSimplifier::simplify(const void* vertices,
+  size_t vertexCount,
+  size_t vertexStride,
+  const uint32_t* indices,
+  size_t indexCount,
+  size_t targetIndexCount,
+  float maxError,
+  float attributeWeight,
+  uint32_t* out,
+  const unsigned char* vertexLock,
+  MeshSimplifyStats* stats)
+{
+  const auto startTime = std::chrono::steady_clock::now();
+  const size_t triangleCount = indexCount / 3;
+
+  if (stats) {
+    *stats = MeshSimplifyStats();
+    stats->trianglesBefore = triangleCount;
+    stats->trianglesAfter = triangleCount;
+  }
+
+  std::vector<uint32_t> current(indices, indices + triangleCount * 3);
+  bool valid = vertices && vertexStride >= 5 * sizeof(float);
+  for (size_t i = 0; valid && i < current.size(); ++i) {
+    if (current[i] >= vertexCount) valid = false;
+  }
+  if (!valid || triangleCount == 0 || targetIndexCount >= current.size()) {
+    std::memcpy(out, current.data(), current.size() * sizeof(uint32_t));
+    return current.size();
+  }
+  const size_t targetTriangles = targetIndexCount / 3;
+
+  // 1) Posicin normalizada a la caja (lado mayor = 1) y uv por el peso.
+  const unsigned char* bytes = static_cast<const unsigned char*>(vertices);
+  float minP[3];
+  const float size = bounds_(bytes, vertexCount, vertexStride, minP);
+  const double invSize = size > 0.0f ? 1.0 / size : 1.0;
+
+  std::vector<double> attr(vertexCount * kDims_);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    float values[5];
+    std::memcpy(values, bytes + v * vertexStride, sizeof(values));
+    double* a = &attr[v * kDims_];
+    for (int i = 0; i < 3; ++i) a[i] = (values[i] - minP[i]) * invSize;
+    a[3] = values[3] * attributeWeight;
+    a[4] = values[4] * attributeWeight;
+  }
+  auto samePosition = [&attr](uint32_t a, uint32_t b) {
+    return attr[a * kDims_] == attr[b * kDims_] &&
+      attr[a * kDims_ + 1] == attr[b * kDims_ + 1] &&
+      attr[a * kDims_ + 2] == attr[b * kDims_ + 2];
+  };
+
+  // 2) Anillos de vrtices con la misma posicin (wedges): wedge[v] es el
+  //    siguiente del anillo. Se ordena por posicin e ndice para que no
+  //    dependa de ninguna tabla hash.
+  std::vector<uint32_t> wedge(vertexCount);
+  {
+    std::vector<uint32_t> order(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) order[v] = static_cast<uint32_t>(v);
+    std::sort(order.begin(), order.end(), [&attr](uint32_t a, uint32_t b) {
+      for (int i = 0; i < 3; ++i) {
+        if (attr[a * kDims_ + i] != attr[b * kDims_ + i]) return attr[a * kDims_ + i] < attr[b * kDims_ + i];
+      }
+      return a < b;
+    });
+    size_t first = 0;
+    for (size_t i = 1; i <= vertexCount; ++i) {
+      if (i == vertexCount || !samePosition(order[i], order[first])) {
+        for (size_t k = first; k < i; ++k) {
+          wedge[order[k]] = order[k + 1 < i ? k + 1 : first];
+        }
+        first = i;
+      }
+    }
+  }
+
+  // 3) Cudrica de cada vrtice: suma de las de sus tringulos, pesadas por rea.
+  std::vector<Quadric_> quadrics(vertexCount);
+  std::memset(quadrics.data(), 0, quadrics.size() * sizeof(Quadric_));
+  for (size_t t = 0; t < triangleCount; ++t) {
+    const double* p0 = &attr[current[t * 3 + 0] * kDims_];
+    const double* p1 = &attr[current[t * 3 + 1] * kDims_];
+    const double* p2 = &attr[current[t * 3 + 2] * kDims_];
+    double e1[3], e2[3], n[3];
+    for (int i = 0; i < 3; ++i) {
+      e1[i] = p1[i] - p0[i];
+      e2[i] = p2[i] - p0[i];
+    }
+    cross_(e1, e2, n);
+    const double area = 0.5 * std::sqrt(dot3_(n, n));
+
+    Quadric_ q;
+    quadricFromTriangle_(q, p0, p1, p2, area);
+    for (int k = 0; k < 3; ++k) quadricAdd_(quadrics[current[t * 3 + k]], q);
+  }
+
+  // Estado de cada pasada (se reutiliza la memoria).
+  std::vector<uint32_t> remap(vertexCount);
+  for (size_t v = 0; v < vertexCount; ++v) remap[v] = static_cast<uint32_t>(v);
+  std::vector<uint32_t> valence(vertexCount);
+  std::vector<uint32_t> offsets(vertexCount + 1);
+  std::vector<uint32_t> adjacency;
+  std::vector<unsigned char> openEdge;
+  std::vector<uint32_t> loop(vertexCount), loopBack(vertexCount), twin(vertexCount);
+  std::vector<unsigned char> openOut(vertexCount), openIn(vertexCount);
+  std::vector<VertexKind_> kind(vertexCount);
+  std::vector<unsigned char> touched(vertexCount);
+  std::vector<Collapse_> candidates;
+
+  // Algn tringulo tiene la arista dirigida a -> b?
+  auto hasHalfEdge = [&](uint32_t a, uint32_t b) {
+    for (uint32_t i = offsets[a]; i < offsets[a + 1]; ++i) {
+      const uint32_t* tri = &current[adjacency[i] * 3];
+      for (int k = 0; k < 3; ++k) {
+        if (tri[k] == a && tri[(k + 1) % 3] == b) return true;
+      }
+    }
+    return false;
+  };
+
+  // Revisa si u -> v se permite y calcula su costo.
+  auto evaluate = [&](uint32_t u, uint32_t v, Collapse_& collapse) {
+    const VertexKind_ kindU = kind[u];
+    if (kindU == VertexKind_::Locked) return false;
+    if (kindU != VertexKind_::Manifold && v != loop[u] && v != loopBack[u]) return false;
+
+    collapse.from = u;
+    collapse.to = v;
+    collapse.twinFrom = kNone_;
+    collapse.twinTo = kNone_;
+    collapse.cost = quadricError_(quadrics[u], &attr[v * kDims_]);
+
+    if (kindU == VertexKind_::Seam) {
+      // Del otro lado de la costura la arista va al revs.
+      // El gemelo se mueve junto con u, as que tampoco puede estar bloqueado.
+      const uint32_t u2 = twin[u];
+      if (kind[u2] == VertexKind_::Locked) return false;
+      const uint32_t v2 = (v == loop[u]) ? loopBack[u2] : loop[u2];
+      if (v2 == kNone_ || v2 == u || u2 == v || !samePosition(v2, v)) return false;
+      collapse.twinFrom = u2;
+      collapse.twinTo = v2;
+      collapse.cost = (std::max)(collapse.cost, quadricError_(quadrics[u2], &attr[v2 * kDims_]));
+    }
+    return true;
+  };
+
+  // Mover u a la posicin de v voltea o aplasta algn tringulo de u?
+  auto flips = [&](uint32_t u, uint32_t v) {
+    const double* pu = &attr[u * kDims_];
+    const double* pv = &attr[v * kDims_];
+    for (uint32_t i = offsets[u]; i < offsets[u + 1]; ++i) {
+      const uint32_t* tri = &current[adjacency[i] * 3];
+      if (tri[0] == v || tri[1] == v || tri[2] == v) continue;
+
+      const int k = (tri[0] == u) ? 0 : (tri[1] == u) ? 1 : 2;
+      const double* pb = &attr[tri[(k + 1) % 3] * kDims_];
+      const double* pc = &attr[tri[(k + 2) % 3] * kDims_];
+      double eb[3], ec[3], n0[3], n1[3];
+      for (int j = 0; j < 3; ++j) {
+        eb[j] = pb[j] - pu[j];
+        ec[j] = pc[j] - pu[j];
+      }
+      cross_(eb, ec, n0);
+      for (int j = 0; j < 3; ++j) {
+        eb[j] = pb[j] - pv[j];
+        ec[j] = pc[j] - pv[j];
+      }
+      cross_(eb, ec, n1);
+
+      const double length0 = dot3_(n0, n0);
+      const double length1 = dot3_(n1, n1);
+      if (length0 <= 0.0) continue;
+      if (length1 <= length0 * 1e-12) return true;
+      if (dot3_(n0, n1) < kMinFlipCos_ * std::sqrt(length0 * length1)) return true;
+    }
+    return false;
+  };
+
+  double maxCost = 0.0;
+  const double maxCostAllowed = static_cast<double>(maxError) * maxError;
+  unsigned int passes = 0;
+
+  while (current.size() / 3 > targetTriangles) {
+    const size_t currentTriangles = current.size() / 3;
+
+    // a) Adyacencia vrtice -> tringulos.
+    std::fill(valence.begin(), valence.end(), 0);
+    for (uint32_t v : current) ++valence[v];
+    offsets[0] = 0;
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] = offsets[v] + valence[v];
+    adjacency.resize(current.size());
+    {
+      std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+      for (size_t t = 0; t < currentTriangles; ++t) {
+        for (int k = 0; k < 3; ++k) {
+          adjacency[cursor[current[t * 3 + k]]++] = static_cast<uint32_t>(t);
+        }
+      }
+    }
+
+    // b) Aristas abiertas (sin la arista opuesta) y el recorrido del borde:
+    //    loop[a] = b para la arista abierta a -> b y loopBack[b] = a.
+    std::fill(loop.begin(), loop.end(), kNone_);
+    std::fill(loopBack.begin(), loopBack.end(), kNone_);
+    std::fill(openOut.begin(), openOut.end(), 0);
+    std::fill(openIn.begin(), openIn.end(), 0);
+    openEdge.assign(current.size(), 0);
+    for (size_t t = 0; t < currentTriangles; ++t) {
+      for (int k = 0; k < 3; ++k) {
+        const uint32_t a = current[t * 3 + k];
+        const uint32_t b = current[t * 3 + (k + 1) % 3];
+        if (hasHalfEdge(b, a)) continue;
+        openEdge[t * 3 + k] = 1;
+        loop[a] = b;
+        loopBack[b] = a;
+        if (openOut[a] < 2) ++openOut[a];
+        if (openIn[b] < 2) ++openIn[b];
+      }
+    }
+
+    // c) Tipo de cada vrtice.
+    for (size_t v = 0; v < vertexCount; ++v) {
+      twin[v] = kNone_;
+      if (valence[v] == 0 || (vertexLock && vertexLock[v])) {
+        kind[v] = VertexKind_::Locked;
+        continue;
+      }
+
+      uint32_t twins = 0;
+      for (uint32_t w = wedge[v]; w != v; w = wedge[w]) {
+        if (valence[w] == 0) continue;
+        twin[v] = w;
+        ++twins;
+      }
+
+      if (openOut[v] == 0 && openIn[v] == 0) {
+        kind[v] = twins == 0 ? VertexKind_::Manifold : VertexKind_::Locked;
+      }
+      else if (openOut[v] == 1 && openIn[v] == 1 && twins == 0) {
+        kind[v] = VertexKind_::Border;
+      }
+      else if (openOut[v] == 1 && openIn[v] == 1 && twins == 1) {
+        const uint32_t t = twin[v];
+        const bool matches = openOut[t] == 1 && openIn[t] == 1 &&
+          samePosition(loop[v], loopBack[t]) &&
+          samePosition(loopBack[v], loop[t]);
+        kind[v] = matches ? VertexKind_::Seam : VertexKind_::Locked;
+      }
+      else {
+        kind[v] = VertexKind_::Locked;
+      }
+    }
+
+    // En la primera pasada los bordes abiertos reciben un plano perpendicular
+    // al tringulo, para que al simplificar no se encojan.
+    if (passes == 0) {
+      for (size_t t = 0; t < currentTriangles; ++t) {
+        for (int k = 0; k < 3; ++k) {
+          if (!openEdge[t * 3 + k]) continue;
+          const uint32_t a = current[t * 3 + k];
+          const uint32_t b = current[t * 3 + (k + 1) % 3];
+          const uint32_t c = current[t * 3 + (k + 2) % 3];
+          const double* pa = &attr[a * kDims_];
+          const double* pb = &attr[b * kDims_];
+          const double* pc = &attr[c * kDims_];
+
+          double edge[3], side[3], normal[3], plane[3];
+          for (int j = 0; j < 3; ++j) {
+            edge[j] = pb[j] - pa[j];
+            side[j] = pc[j] - pa[j];
+          }
+          cross_(edge, side, normal);
+          cross_(edge, normal, plane);
+          const double length = std::sqrt(dot3_(plane, plane));
+          if (length <= 0.0) continue;
+          for (int j = 0; j < 3; ++j) plane[j] /= length;
+
+          Quadric_ q;
+          quadricFromPlane_(q, plane, -dot3_(plane, pa), dot3_(edge, edge) * kBorderWeight_);
+          quadricAdd_(quadrics[a], q);
+          quadricAdd_(quadrics[b], q);
+        }
+      }
+    }
+
+    // d) Candidatos: por cada arista, la direccin ms barata que se permita.
+    //    Las aristas interiores aparecen dos veces; me quedo con a < b.
+    candidates.clear();
+    for (size_t t = 0; t < currentTriangles; ++t) {
+      for (int k = 0; k < 3; ++k) {
+        const uint32_t a = current[t * 3 + k];
+        const uint32_t b = current[t * 3 + (k + 1) % 3];
+        if (a > b && !openEdge[t * 3 + k]) continue;
+
+        Collapse_ ab, ba;
+        const bool canAB = evaluate(a, b, ab);
+        const bool canBA = evaluate(b, a, ba);
+        if (canAB && (!canBA || ab.cost <= ba.cost)) candidates.push_back(ab);
+        else if (canBA) candidates.push_back(ba);
+      }
+    }
+    if (candidates.empty()) break;
+
+    std::sort(candidates.begin(), candidates.end(), [](const Collapse_& x, const Collapse_& y) {
+      if (x.cost != y.cost) return x.cost < y.cost;
+      if (x.from != y.from) return x.from < y.from;
+      return x.to < y.to;
+    });
+
+    // e) Aplico los ms baratos que no se tocan entre s. Cada colapso quita
+    //    ~2 tringulos, as que no hago ms de los que faltan. Tampoco paso de
+    //    1.5 veces el costo de referencia (el del colapso que hara falta, o el
+    //    del primer cuarto de la lista), para no gastar colapsos caros cuando
+    //    todava hay baratos que aparecen en la siguiente pasada; pero siempre
+    //    hago al menos 1/8 de los que faltan para que la pasada avance aunque
+    //    los baratos se rechacen por voltear tringulos.
+    const size_t collapseGoal = (currentTriangles - targetTriangles) / 2 + 1;
+    const size_t goalIndex = (std::max)(collapseGoal, candidates.size() / 4);
+    const double costGoal = candidates[(std::min)(goalIndex, candidates.size() - 1)].cost * 1.5;
+
+    std::fill(touched.begin(), touched.end(), 0);
+    size_t removed = 0;
+    size_t collapses = 0;
+    for (const Collapse_& collapse : candidates) {
+      if (collapse.cost > maxCostAllowed) break;
+      if (collapse.cost > costGoal && collapses > collapseGoal / 8) break;
+      if (collapses >= collapseGoal) break;
+      if (currentTriangles - removed <= targetTriangles) break;
+
+      const uint32_t u = collapse.from, v = collapse.to;
+      const uint32_t u2 = collapse.twinFrom, v2 = collapse.twinTo;
+      if (touched[u] || touched[v]) continue;
+      if (u2 != kNone_ && (touched[u2] || touched[v2])) continue;
+      if (flips(u, v) || (u2 != kNone_ && flips(u2, v2))) continue;
+
+      const uint32_t from[2] = { u, u2 };
+      const uint32_t to[2] = { v, v2 };
+      for (int side = 0; side < 2; ++side) {
+        if (from[side] == kNone_) continue;
+        remap[from[side]] = to[side];
+        quadricAdd_(quadrics[to[side]], quadrics[from[side]]);
+        touched[to[side]] = 1;
+        for (uint32_t i = offsets[from[side]]; i < offsets[from[side] + 1]; ++i) {
+          const uint32_t* tri = &current[adjacency[i] * 3];
+          if (tri[0] == to[side] || tri[1] == to[side] || tri[2] == to[side]) ++removed;
+          touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+        }
+      }
+
+      maxCost = (std::max)(maxCost, collapse.cost);
+      ++collapses;
+    }
+
+    ++passes;
+    if (collapses == 0) break;
+
+    // f) Reescribo los ndices y quito los tringulos que quedaron degenerados.
+    size_t write = 0;
+    for (size_t t = 0; t < currentTriangles; ++t) {
+      const uint32_t a = remap[current[t * 3 + 0]];
+      const uint32_t b = remap[current[t * 3 + 1]];
+      const uint32_t c = remap[current[t * 3 + 2]];
+      if (a == b || b == c || a == c) continue;
+      current[write++] = a;
+      current[write++] = b;
+      current[write++] = c;
+    }
+    current.resize(write);
+  }
+
+  std::memcpy(out, current.data(), current.size() * sizeof(uint32_t));
+
+  if (stats) {
+    stats->trianglesAfter = current.size() / 3;
+    stats->error = static_cast<float>(std::sqrt(maxCost));
+    stats->passes = passes;
+    stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  }
+  return current.size();
+}
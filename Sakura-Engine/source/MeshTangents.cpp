@@ -0,0 +1,332 @@
+#include "MeshTangents.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+// Elementos por bloque que toma cada hilo.
+static const size_t kChunk_ = 16384;
+
+/*
+ * Reparte [0, count) en bloques de kChunk_ entre 'threads' hilos (el que
+ * llama tambin trabaja). fn(begin, end) no debe escribir fuera de su rango.
+ */
+template <typename Fn>
+static void
+parallelRanges_(size_t count, unsigned int threads, const Fn& fn) {
+  const size_t chunks = (count + kChunk_ - 1) / kChunk_;
+  if (threads <= 1 || chunks <= 1) {
+    if (count > 0) fn(size_t(0), count);
+    return;
+  }
+
+  std::atomic<size_t> nextChunk(0);
+  auto worker = [&]() {
+    for (size_t c = nextChunk++; c < chunks; c = nextChunk++) {
+      const size_t begin = c * kChunk_;
+      fn(begin, begin + kChunk_ < count ? begin + kChunk_ : count);
+    }
+  };
+
+  const unsigned int poolSize = static_cast<unsigned int>(chunks < threads ? chunks : threads);
+  std::vector<std::thread> pool;
+  pool.reserve(poolSize - 1);
+  for (unsigned int t = 1; t < poolSize; ++t) pool.emplace_back(worker);
+  worker();
+  for (auto& thread : pool) thread.join();
+}
+
+static inline const float* vertex_(const unsigned char* base, size_t stride, uint32_t index) {
+  return reinterpret_cast<const float*>(base + static_cast<size_t>(index) * stride);
+}
+
+static inline float dot3_(const float* a, const float* b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static inline void cross3_(const float* a, const float* b, float* out) {
+  out[0] = a[1] * b[2] - a[2] * b[1];
+  out[1] = a[2] * b[0] - a[0] * b[2];
+  out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static inline bool normalize3_(float* v) {
+  const float length = std::sqrt(dot3_(v, v));
+  if (!(length > 1.0e-20f)) return false;
+  const float scale = 1.0f / length;
+  v[0] *= scale;
+  v[1] *= scale;
+  v[2] *= scale;
+  return true;
+}
+
+// ngulo entre dos vectores ya normalizados.
+static inline float angle_(const float* a, const float* b) {
+  float d = dot3_(a, b);
+  d = d < -1.0f ? -1.0f : (d > 1.0f ? 1.0f : d);
+  return std::acos(d);
+}
+
+// Una tangente cualquiera perpendicular a 'n', para vrtices sin uv til.
+static inline void anyPerpendicular_(const float* n, float* out) {
+  const float axis[3] = { std::fabs(n[0]) < 0.9f ? 1.0f : 0.0f, std::fabs(n[0]) < 0.9f ? 0.0f : 1.0f, 0.0f };
+  const float d = dot3_(axis, n);
+  for (int k = 0; k < 3; ++k) out[k] = axis[k] - n[k] * d;
+  normalize3_(out);
+}
+
+static inline uint32_t floatBits_(float value) {
+  value += 0.0f;  // -0 y +0 caen en la misma posicin.
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+/*
+ * Agrupa los vrtices con exactamente la misma posicin: groupOf[v] es el
+ * nmero de grupo (en orden de primera aparicin). Devuelve cuntos grupos hay.
+ */
+static uint32_t
+groupByPosition_(const unsigned char* base, size_t stride, size_t vertexCount, std::vector<uint32_t>& groupOf) {
+  size_t tableSize = 16;
+  while (tableSize < vertexCount * 2) tableSize <<= 1;
+  std::vector<uint32_t> table(tableSize, UINT32_MAX);  // Primer vrtice de cada grupo.
+  groupOf.resize(vertexCount);
+
+  uint32_t groups = 0;
+  for (size_t v = 0; v < vertexCount; ++v) {
+    const float* p = vertex_(base, stride, static_cast<uint32_t>(v));
+    const uint32_t x = floatBits_(p[0]);
+    const uint32_t y = floatBits_(p[1]);
+    const uint32_t z = floatBits_(p[2]);
+    size_t slot = ((x * 73856093u) ^ (y * 19349663u) ^ (z * 83492791u)) & (tableSize - 1);
+    for (;;) {
+      const uint32_t other = table[slot];
+      if (other == UINT32_MAX) {
+        table[slot] = static_cast<uint32_t>(v);
+        groupOf[v] = groups++;
+        break;
+      }
+      const float* q = vertex_(base, stride, other);
+      if (floatBits_(q[0]) == x && floatBits_(q[1]) == y && floatBits_(q[2]) == z) {
+        groupOf[v] = groupOf[other];
+        break;
+      }
+      slot = (slot + 1) & (tableSize - 1);
+    }
+  }
+  return groups;
+}
+
+/*
+ * Lista de esquinas por llave (CSR): las esquinas de la llave k son
+ * corners[offsets[k] .. offsets[k + 1]), en orden creciente.
+ */
+static void
+buildCornerLists_(const uint32_t* keyOfCorner, size_t cornerCount, size_t keyCount,
+  std::vector<uint32_t>& offsets, std::vector<uint32_t>& corners) {
+  offsets.assign(keyCount + 1, 0);
+  for (size_t c = 0; c < cornerCount; ++c) ++offsets[keyOfCorner[c] + 1];
+  for (size_t k = 0; k < keyCount; ++k) offsets[k + 1] += offsets[k];
+  corners.resize(cornerCount);
+  std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+  for (size_t c = 0; c < cornerCount; ++c) corners[fill[keyOfCorner[c]]++] = static_cast<uint32_t>(c);
+}
+
+size_t
+MeshTangents::generate(const void* vertices,
+  size_t vertexCount,
+  size_t vertexStride,
+  uint32_t* indices,
+  size_t indexCount,
+  std::vector<float>& normals,
+  std::vector<float>& tangents,
+  std::vector<uint32_t>& remap,
+  unsigned int threadCount,
+  MeshTangentStats* stats) {
+  const auto startTime = std::chrono::steady_clock::now();
+  if (stats) *stats = MeshTangentStats();
+
+  const size_t triangleCount = indexCount / 3;
+  const size_t cornerCount = triangleCount * 3;
+  if (!vertices || vertexCount == 0 || vertexStride < 5 * sizeof(float)) return 0;
+  for (size_t c = 0; c < cornerCount; ++c) {
+    if (indices[c] >= vertexCount) return 0;
+  }
+
+  unsigned int threads = threadCount ? threadCount : std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+  const unsigned char* base = static_cast<const unsigned char*>(vertices);
+
+  // 1) Por tringulo: normal de la cara, ngulo de cada esquina y las
+  //    direcciones de u (T) y v (B) en el espacio del modelo.
+  std::vector<float> faceNormal(triangleCount * 3);
+  std::vector<float> faceTangent(triangleCount * 6);   // T (3) y B (3), o ceros sin rea en uv.
+  std::vector<float> cornerAngle(cornerCount);
+  std::atomic<size_t> degenerate(0);
+
+  parallelRanges_(triangleCount, threads, [&](size_t begin, size_t end) {
+    size_t localDegenerate = 0;
+    for (size_t t = begin; t < end; ++t) {
+      const float* v0 = vertex_(base, vertexStride, indices[t * 3 + 0]);
+      const float* v1 = vertex_(base, vertexStride, indices[t * 3 + 1]);
+      const float* v2 = vertex_(base, vertexStride, indices[t * 3 + 2]);
+      const float* p[3] = { v0, v1, v2 };
+
+      float e1[3] = { v1[0] - v0[0], v1[1] - v0[1], v1[2] - v0[2] };
+      float e2[3] = { v2[0] - v0[0], v2[1] - v0[1], v2[2] - v0[2] };
+      float* n = &faceNormal[t * 3];
+      cross3_(e1, e2, n);
+      const bool hasArea = normalize3_(n);
+      if (!hasArea) n[0] = n[1] = n[2] = 0.0f;
+
+      for (int corner = 0; corner < 3; ++corner) {
+        const float* a = p[corner];
+        const float* b = p[(corner + 1) % 3];
+        const float* c = p[(corner + 2) % 3];
+        float ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        float ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        const bool valid = hasArea && normalize3_(ab) && normalize3_(ac);
+        cornerAngle[t * 3 + corner] = valid ? angle_(ab, ac) : 0.0f;
+      }
+
+      const float du1 = v1[3] - v0[3];
+      const float dv1 = v1[4] - v0[4];
+      const float du2 = v2[3] - v0[3];
+      const float dv2 = v2[4] - v0[4];
+      const float r = du1 * dv2 - du2 * dv1;
+      float* tb = &faceTangent[t * 6];
+      if (!hasArea || std::fabs(r) <= 1.0e-20f) {
+        for (int k = 0; k < 6; ++k) tb[k] = 0.0f;
+        ++localDegenerate;
+        continue;
+      }
+      // T = (e1 * dv2 - e2 * dv1) / r, B = (e2 * du1 - e1 * du2) / r. Como
+      // luego se normaliza, basta con el signo de r.
+      const float s = r > 0.0f ? 1.0f : -1.0f;
+      for (int k = 0; k < 3; ++k) {
+        tb[k] = (e1[k] * dv2 - e2[k] * dv1) * s;
+        tb[3 + k] = (e2[k] * du1 - e1[k] * du2) * s;
+      }
+    }
+    degenerate += localDegenerate;
+  });
+
+  // 2) Normal de cada posicin: suma de las normales de sus caras por ngulo.
+  std::vector<uint32_t> groupOf;
+  const uint32_t groupCount = groupByPosition_(base, vertexStride, vertexCount, groupOf);
+
+  std::vector<uint32_t> cornerKey(cornerCount);
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> cornerList;
+  for (size_t c = 0; c < cornerCount; ++c) cornerKey[c] = groupOf[indices[c]];
+  buildCornerLists_(cornerKey.data(), cornerCount, groupCount, offsets, cornerList);
+
+  std::vector<float> groupNormal(static_cast<size_t>(groupCount) * 3);
+  parallelRanges_(groupCount, threads, [&](size_t begin, size_t end) {
+    for (size_t g = begin; g < end; ++g) {
+      float sum[3] = { 0.0f, 0.0f, 0.0f };
+      for (uint32_t i = offsets[g]; i < offsets[g + 1]; ++i) {
+        const uint32_t c = cornerList[i];
+        const float* n = &faceNormal[(c / 3) * 3];
+        for (int k = 0; k < 3; ++k) sum[k] += n[k] * cornerAngle[c];
+      }
+      if (!normalize3_(sum)) {
+        sum[0] = 0.0f;
+        sum[1] = 1.0f;
+        sum[2] = 0.0f;
+      }
+      std::memcpy(&groupNormal[g * 3], sum, sizeof(sum));
+    }
+  });
+
+  // 3) Tangente de cada vrtice, separando las esquinas por signo.
+  for (size_t c = 0; c < cornerCount; ++c) cornerKey[c] = indices[c];
+  buildCornerLists_(cornerKey.data(), cornerCount, vertexCount, offsets, cornerList);
+
+  std::vector<float> vertexTangent(vertexCount * 8);   // Grupo positivo (4) y negativo (4).
+  std::vector<unsigned char> split(vertexCount, 0);
+  std::vector<signed char> cornerSign(cornerCount, 1);
+
+  parallelRanges_(vertexCount, threads, [&](size_t begin, size_t end) {
+    for (size_t v = begin; v < end; ++v) {
+      const float* n = &groupNormal[static_cast<size_t>(groupOf[v]) * 3];
+      float sum[2][3] = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+      bool used[2] = { false, false };
+
+      for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+        const uint32_t c = cornerList[i];
+        const float* tb = &faceTangent[(c / 3) * 6];
+        float t[3] = { tb[0], tb[1], tb[2] };
+        const float d = dot3_(n, t);
+        for (int k = 0; k < 3; ++k) t[k] -= n[k] * d;
+        if (!normalize3_(t) || cornerAngle[c] <= 0.0f) continue;
+
+        float nxt[3];
+        cross3_(n, tb, nxt);
+        const int group = dot3_(nxt, tb + 3) < 0.0f ? 1 : 0;
+        cornerSign[c] = group ? -1 : 1;
+        used[group] = true;
+        for (int k = 0; k < 3; ++k) sum[group][k] += t[k] * cornerAngle[c];
+      }
+
+      // Las esquinas sin tangente til se quedan con el signo que conserva el vrtice.
+      const int keep = used[0] || !used[1] ? 0 : 1;
+      if (keep == 1) {
+        for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) cornerSign[cornerList[i]] = -1;
+      }
+      split[v] = used[0] && used[1] ? 1 : 0;
+
+      for (int group = 0; group < 2; ++group) {
+        float* out = &vertexTangent[v * 8 + group * 4];
+        std::memcpy(out, sum[group], sizeof(sum[group]));
+        if (!normalize3_(out)) anyPerpendicular_(n, out);
+        out[3] = group ? -1.0f : 1.0f;
+      }
+    }
+  });
+
+  // 4) Numerar los duplicados en orden de vrtice, as no dependen de los hilos.
+  std::vector<uint32_t> duplicateOf(vertexCount, 0);
+  size_t outputCount = vertexCount;
+  for (size_t v = 0; v < vertexCount; ++v) {
+    if (split[v]) duplicateOf[v] = static_cast<uint32_t>(outputCount++);
+  }
+
+  normals.resize(outputCount * 3);
+  tangents.resize(outputCount * 4);
+  remap.resize(outputCount);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    const float* n = &groupNormal[static_cast<size_t>(groupOf[v]) * 3];
+    const bool negativeOnly = !split[v] && offsets[v] < offsets[v + 1] && cornerSign[cornerList[offsets[v]]] < 0;
+    remap[v] = static_cast<uint32_t>(v);
+    std::memcpy(&normals[v * 3], n, sizeof(float) * 3);
+    std::memcpy(&tangents[v * 4], &vertexTangent[v * 8 + (negativeOnly ? 4 : 0)], sizeof(float) * 4);
+    if (split[v]) {
+      const size_t d = duplicateOf[v];
+      remap[d] = static_cast<uint32_t>(v);
+      std::memcpy(&normals[d * 3], n, sizeof(float) * 3);
+      std::memcpy(&tangents[d * 4], &vertexTangent[v * 8 + 4], sizeof(float) * 4);
+    }
+  }
+
+  // 5) Las esquinas en espejo de un vrtice separado pasan al duplicado.
+  parallelRanges_(cornerCount, threads, [&](size_t begin, size_t end) {
+    for (size_t c = begin; c < end; ++c) {
+      const uint32_t v = indices[c];
+      if (split[v] && cornerSign[c] < 0) indices[c] = duplicateOf[v];
+    }
+  });
+
+  if (stats) {
+    stats->verticesBefore = vertexCount;
+    stats->verticesAfter = outputCount;
+    stats->splitVertices = outputCount - vertexCount;
+    stats->degenerateTriangles = degenerate;
+    stats->threads = threads;
+    stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  }
+  return outputCount;
+}
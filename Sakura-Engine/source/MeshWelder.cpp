@@ -0,0 +1,125 @@
+#include "MeshWelder.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// Bits de un float con 0.0 y -0.0 unificados, para que ambos den la misma clave.
+static inline uint32_t floatBits_(float value) {
+  if (value == 0.0f) return 0;
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+// Celda de la rejilla (de ancho epsilon) en la que cae el float.
+static inline int64_t floatCell_(float value, float invEpsilon) {
+  return static_cast<int64_t>(std::floor(static_cast<double>(value) * invEpsilon + 0.5));
+}
+
+static inline uint64_t mix_(uint64_t hash, uint64_t value) {
+  hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+  return hash;
+}
+
+/*
+ * Lee el vrtice como floats y guarda en 'keys' el valor que se compara:
+ * los bits (modo exacto) o la celda de la rejilla (modo epsilon).
+ * Regresa el hash de esas claves.
+ */
+static uint64_t vertexKey_(const unsigned char* vertex, size_t floatCount,
+  float invEpsilon, int64_t* keys)
+{
+  uint64_t hash = 0;
+  for (size_t f = 0; f < floatCount; ++f) {
+    float value;
+    std::memcpy(&value, vertex + f * sizeof(float), sizeof(float));
+    keys[f] = invEpsilon > 0.0f ? floatCell_(value, invEpsilon) : static_cast<int64_t>(floatBits_(value));
+    hash = mix_(hash, static_cast<uint64_t>(keys[f]));
+  }
+  // Mezcla final para que los bits bajos (los que usa la tabla) salgan parejos.
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+size_t
+MeshWelder::weld(void* vertices,
+  size_t vertexCount,
+  size_t vertexStride,
+  uint32_t* indices,
+  size_t indexCount,
+  float epsilon,
+  MeshWeldStats* stats)
+{
+  const auto startTime = std::chrono::steady_clock::now();
+  const size_t floatCount = vertexStride / sizeof(float);
+
+  if (stats) {
+    stats->verticesBefore = vertexCount;
+    stats->verticesAfter = vertexCount;
+    stats->seconds = 0.0;
+  }
+  if (!vertices || vertexCount == 0 || floatCount == 0) {
+    return vertexCount;
+  }
+
+  const float invEpsilon = epsilon > 0.0f ? 1.0f / epsilon : 0.0f;
+  unsigned char* bytes = static_cast<unsigned char*>(vertices);
+
+  // Tabla hash con direccionamiento abierto (potencia de 2, carga <= 0.5).
+  // Cada celda guarda el ndice ya compactado del vrtice, o kEmpty.
+  const uint32_t kEmpty = 0xFFFFFFFFu;
+  size_t capacity = 16;
+  while (capacity < vertexCount * 2) capacity <<= 1;
+  const size_t mask = capacity - 1;
+  std::vector<uint32_t> table(capacity, kEmpty);
+
+  // Claves de cada vrtice que sobrevive, para compararlas sin volver a
+  // calcular la rejilla.
+  std::vector<int64_t> keys;
+  keys.reserve(vertexCount * floatCount);
+  std::vector<int64_t> current(floatCount);
+
+  std::vector<uint32_t> remap(vertexCount);
+  size_t unique = 0;
+
+  for (size_t v = 0; v < vertexCount; ++v) {
+    const uint64_t hash = vertexKey_(bytes + v * vertexStride, floatCount, invEpsilon, current.data());
+
+    size_t slot = static_cast<size_t>(hash) & mask;
+    while (true) {
+      const uint32_t candidate = table[slot];
+      if (candidate == kEmpty) {
+        // Vrtice nuevo: lo muevo a su lugar compactado.
+        table[slot] = static_cast<uint32_t>(unique);
+        remap[v] = static_cast<uint32_t>(unique);
+        if (unique != v) {
+          std::memcpy(bytes + unique * vertexStride, bytes + v * vertexStride, vertexStride);
+        }
+        keys.insert(keys.end(), current.begin(), current.end());
+        ++unique;
+        break;
+      }
+      if (std::memcmp(&keys[candidate * floatCount], current.data(), floatCount * sizeof(int64_t)) == 0) {
+        remap[v] = candidate;
+        break;
+      }
+      slot = (slot + 1) & mask;
+    }
+  }
+
+  for (size_t i = 0; i < indexCount; ++i) {
+    if (indices[i] < vertexCount) {
+      indices[i] = remap[indices[i]];
+    }
+  }
+
+  if (stats) {
+    stats->verticesAfter = unique;
+    stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  }
+  return unique;
+}
@@ -0,0 +1,343 @@
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+// Posicin (3 floats al inicio del vrtice).
+static inline const float* position_(const unsigned char* base, size_t stride, uint32_t index) {
+  return reinterpret_cast<const float*>(base + static_cast<size_t>(index) * stride);
+}
+
+static inline float dot3_(const float* a, const float* b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+/*
+ * Esfera envolvente de Ritter: parte del par de puntos extremos ms lejano
+ * en los tres ejes y crece la esfera con los que quedan afuera.
+ */
+static void
+boundingSphere_(const unsigned char* base, size_t stride, const uint32_t* vertices, size_t count,
+  float center[3], float& radius) {
+  uint32_t minV[3] = { vertices[0], vertices[0], vertices[0] };
+  uint32_t maxV[3] = { vertices[0], vertices[0], vertices[0] };
+  for (size_t i = 1; i < count; ++i) {
+    const float* p = position_(base, stride, vertices[i]);
+    for (int axis = 0; axis < 3; ++axis) {
+      if (p[axis] < position_(base, stride, minV[axis])[axis]) minV[axis] = vertices[i];
+      if (p[axis] > position_(base, stride, maxV[axis])[axis]) maxV[axis] = vertices[i];
+    }
+  }
+
+  int bestAxis = 0;
+  float bestDistance = -1.0f;
+  for (int axis = 0; axis < 3; ++axis) {
+    const float* a = position_(base, stride, minV[axis]);
+    const float* b = position_(base, stride, maxV[axis]);
+    const float d[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    const float distance = dot3_(d, d);
+    if (distance > bestDistance) {
+      bestDistance = distance;
+      bestAxis = axis;
+    }
+  }
+
+  const float* a = position_(base, stride, minV[bestAxis]);
+  const float* b = position_(base, stride, maxV[bestAxis]);
+  for (int k = 0; k < 3; ++k) center[k] = (a[k] + b[k]) * 0.5f;
+  radius = std::sqrt(bestDistance) * 0.5f;
+
+  for (size_t i = 0; i < count; ++i) {
+    const float* p = position_(base, stride, vertices[i]);
+    const float d[3] = { p[0] - center[0], p[1] - center[1], p[2] - center[2] };
+    const float distance = std::sqrt(dot3_(d, d));
+    if (distance > radius) {
+      // La esfera nueva toca el punto y el lado opuesto de la anterior.
+      const float grown = (radius + distance) * 0.5f;
+      const float shift = (grown - radius) / distance;
+      for (int k = 0; k < 3; ++k) center[k] += d[k] * shift;
+      radius = grown;
+    }
+  }
+}
+
+size_t
+MeshletBuilder::build(const void* vertices,
+  size_t vertexCount,
+  size_t vertexStride,
+  const uint32_t* indices,
+  size_t indexCount,
+  uint32_t maxVertices,
+  uint32_t maxTriangles,
+  uint32_t subMesh,
+  std::vector<Meshlet>& meshlets,
+  std::vector<uint32_t>& meshletVertices,
+  std::vector<uint8_t>& meshletTriangles,
+  MeshletStats* stats) {
+  const auto startTime = std::chrono::steady_clock::now();
+  const size_t meshletsBefore = meshlets.size();
+  const size_t verticesBefore = meshletVertices.size();
+  if (stats) *stats = MeshletStats();
+
+  const size_t triangleCount = indexCount / 3;
+  if (!vertices || !indices || triangleCount == 0 || vertexStride < 3 * sizeof(float)) {
+    return 0;
+  }
+  for (size_t i = 0; i < triangleCount * 3; ++i) {
+    if (indices[i] >= vertexCount) return 0;
+  }
+
+  maxVertices = maxVertices < 3 ? 3 : (maxVertices > kMaxVertices ? kMaxVertices : maxVertices);
+  maxTriangles = maxTriangles < 1 ? 1 : (maxTriangles > kMaxTriangles ? kMaxTriangles : maxTriangles);
+  const unsigned char* base = static_cast<const unsigned char*>(vertices);
+
+  // Tringulos de cada vrtice (CSR).
+  std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+  for (size_t i = 0; i < triangleCount * 3; ++i) {
+    ++adjacencyOffset[indices[i] + 1];
+  }
+  for (size_t v = 0; v < vertexCount; ++v) {
+    adjacencyOffset[v + 1] += adjacencyOffset[v];
+  }
+  std::vector<uint32_t> adjacency(triangleCount * 3);
+  {
+    std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+      adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+  }
+
+  // Centro y normal unitaria de cada tringulo (normal 0 si es degenerado).
+  std::vector<float> triangleCenter(triangleCount * 3);
+  std::vector<float> triangleNormal(triangleCount * 3);
+  for (size_t t = 0; t < triangleCount; ++t) {
+    const float* p0 = position_(base, vertexStride, indices[t * 3 + 0]);
+    const float* p1 = position_(base, vertexStride, indices[t * 3 + 1]);
+    const float* p2 = position_(base, vertexStride, indices[t * 3 + 2]);
+    const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+    const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+    float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+    const float length = std::sqrt(dot3_(n, n));
+    const float scale = length > 0.0f ? 1.0f / length : 0.0f;
+    for (int k = 0; k < 3; ++k) {
+      triangleCenter[t * 3 + k] = (p0[k] + p1[k] + p2[k]) * (1.0f / 3.0f);
+      triangleNormal[t * 3 + k] = n[k] * scale;
+    }
+  }
+
+  std::vector<unsigned char> emitted(triangleCount, 0);
+  // Tringulos sin repartir de cada vrtice: los vrtices en 0 no se revisan.
+  std::vector<uint32_t> liveTriangles(vertexCount);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    liveTriangles[v] = adjacencyOffset[v + 1] - adjacencyOffset[v];
+  }
+  // Lugar del vrtice dentro del meshlet actual, o -1.
+  std::vector<int32_t> localIndex(vertexCount, -1);
+
+  Meshlet current;
+  current.subMesh = subMesh;
+  current.vertexOffset = static_cast<uint32_t>(meshletVertices.size());
+  current.triangleOffset = static_cast<uint32_t>(meshletTriangles.size());
+  float centerSum[3] = { 0.0f, 0.0f, 0.0f };
+  float normalSum[3] = { 0.0f, 0.0f, 0.0f };
+
+  auto flush = [&]() {
+    if (current.triangleCount == 0) return;
+    const uint32_t* meshletVerts = meshletVertices.data() + current.vertexOffset;
+    boundingSphere_(base, vertexStride, meshletVerts, current.vertexCount, current.center, current.radius);
+
+    // Cono de normales: eje = normal promedio, apertura = la cara ms alejada.
+    const float length = std::sqrt(dot3_(normalSum, normalSum));
+    current.coneCutoff = 1.0f;
+    if (length > 1.0e-6f) {
+      for (int k = 0; k < 3; ++k) current.coneAxis[k] = normalSum[k] / length;
+      float minDot = 1.0f;
+      const uint8_t* local = meshletTriangles.data() + current.triangleOffset;
+      for (uint32_t t = 0; t < current.triangleCount; ++t) {
+        const uint32_t a = meshletVerts[local[t * 3 + 0]];
+        const uint32_t b = meshletVerts[local[t * 3 + 1]];
+        const uint32_t c = meshletVerts[local[t * 3 + 2]];
+        const float* p0 = position_(base, vertexStride, a);
+        const float* p1 = position_(base, vertexStride, b);
+        const float* p2 = position_(base, vertexStride, c);
+        const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+        const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+        const float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+        const float nLength = std::sqrt(dot3_(n, n));
+        if (nLength > 0.0f) {
+          minDot = (std::min)(minDot, dot3_(n, current.coneAxis) / nLength);
+        }
+      }
+      // Con caras a casi 90 o ms del eje el cono no descarta nada.
+      if (minDot > 0.1f) {
+        current.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+      }
+    }
+    else {
+      current.coneAxis[0] = 0.0f;
+      current.coneAxis[1] = 0.0f;
+      current.coneAxis[2] = 1.0f;
+    }
+
+    for (uint32_t v = 0; v < current.vertexCount; ++v) {
+      localIndex[meshletVerts[v]] = -1;
+    }
+    meshlets.push_back(current);
+
+    current = Meshlet();
+    current.subMesh = subMesh;
+    current.vertexOffset = static_cast<uint32_t>(meshletVertices.size());
+    current.triangleOffset = static_cast<uint32_t>(meshletTriangles.size());
+    std::memset(centerSum, 0, sizeof(centerSum));
+    std::memset(normalSum, 0, sizeof(normalSum));
+  };
+
+  size_t cursor = 0;
+  for (size_t remaining = triangleCount; remaining > 0; --remaining) {
+    // El mejor vecino: el que agrega menos vrtices y, de esos, el ms cercano
+    // al centro del meshlet y con la normal ms parecida.
+    size_t best = triangleCount;
+    if (current.triangleCount > 0) {
+      const float scale = 1.0f / static_cast<float>(current.triangleCount);
+      const float center[3] = { centerSum[0] * scale, centerSum[1] * scale, centerSum[2] * scale };
+      const float normalLength = std::sqrt(dot3_(normalSum, normalSum));
+      const float normalScale = normalLength > 0.0f ? 1.0f / normalLength : 0.0f;
+      const float axis[3] = { normalSum[0] * normalScale, normalSum[1] * normalScale, normalSum[2] * normalScale };
+
+      uint32_t bestExtra = 4;
+      float bestScore = 0.0f;
+      for (uint32_t v = 0; v < current.vertexCount; ++v) {
+        const uint32_t vertex = meshletVertices[current.vertexOffset + v];
+        if (liveTriangles[vertex] == 0) continue;
+        for (uint32_t a = adjacencyOffset[vertex]; a < adjacencyOffset[vertex + 1]; ++a) {
+          const uint32_t t = adjacency[a];
+          if (emitted[t]) continue;
+
+          const uint32_t extra = (localIndex[indices[t * 3 + 0]] < 0 ? 1u : 0u) +
+            (localIndex[indices[t * 3 + 1]] < 0 ? 1u : 0u) +
+            (localIndex[indices[t * 3 + 2]] < 0 ? 1u : 0u);
+          if (current.vertexCount + extra > maxVertices || extra > bestExtra) continue;
+
+          const float* c = &triangleCenter[t * 3];
+          const float d[3] = { c[0] - center[0], c[1] - center[1], c[2] - center[2] };
+          const float score = dot3_(d, d) * (2.0f - dot3_(&triangleNormal[t * 3], axis));
+          if (extra < bestExtra || score < bestScore || (score == bestScore && t < best)) {
+            best = t;
+            bestExtra = extra;
+            bestScore = score;
+          }
+        }
+      }
+    }
+
+    // Sin vecinos que quepan: se cierra el meshlet y se empieza otro con el
+    // siguiente tringulo en el orden del index buffer.
+    if (best == triangleCount) {
+      flush();
+      while (emitted[cursor]) ++cursor;
+      best = cursor;
+    }
+
+    for (int corner = 0; corner < 3; ++corner) {
+      const uint32_t vertex = indices[best * 3 + corner];
+      if (localIndex[vertex] < 0) {
+        localIndex[vertex] = static_cast<int32_t>(current.vertexCount++);
+        meshletVertices.push_back(vertex);
+      }
+      meshletTriangles.push_back(static_cast<uint8_t>(localIndex[vertex]));
+      --liveTriangles[vertex];
+    }
+    emitted[best] = 1;
+    ++current.triangleCount;
+    for (int k = 0; k < 3; ++k) {
+      centerSum[k] += triangleCenter[best * 3 + k];
+      normalSum[k] += triangleNormal[best * 3 + k];
+    }
+
+    if (current.triangleCount == maxTriangles) {
+      flush();
+    }
+  }
+  flush();
+
+  const size_t added = meshlets.size() - meshletsBefore;
+  if (stats) {
+    stats->meshlets = added;
+    stats->triangles = triangleCount;
+    stats->averageVertices = static_cast<double>(meshletVertices.size() - verticesBefore) / static_cast<double>(added);
+    stats->averageTriangles = static_cast<double>(triangleCount) / static_cast<double>(added);
+    stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  }
+  return added;
+}
+
+size_t
+MeshletBuilder::cull(const Meshlet* meshlets,
+  size_t meshletCount,
+  const uint32_t* meshletVertices,
+  const uint8_t* meshletTriangles,
+  const float cameraPosition[3],
+  const float (*planes)[4],
+  size_t planeCount,
+  uint32_t* outIndices,
+  MeshletCullStats* stats) {
+  MeshletCullStats result;
+  size_t written = 0;
+
+  for (size_t m = 0; m < meshletCount; ++m) {
+    const Meshlet& meshlet = meshlets[m];
+
+    // Fuera si la esfera queda completa detrs de algn plano.
+    bool inside = true;
+    for (size_t p = 0; planes && p < planeCount && inside; ++p) {
+      inside = dot3_(planes[p], meshlet.center) + planes[p][3] >= -meshlet.radius;
+    }
+    if (!inside) {
+      ++result.outside;
+      continue;
+    }
+
+    // De espaldas si, desde cualquier punto de la esfera, la cmara queda
+    // dentro del cono opuesto al de las normales.
+    const float d[3] = { meshlet.center[0] - cameraPosition[0],
+                         meshlet.center[1] - cameraPosition[1],
+                         meshlet.center[2] - cameraPosition[2] };
+    if (dot3_(d, meshlet.coneAxis) >= meshlet.coneCutoff * std::sqrt(dot3_(d, d)) + meshlet.radius) {
+      ++result.backfacing;
+      continue;
+    }
+
+    const uint32_t* vertices = meshletVertices + meshlet.vertexOffset;
+    const uint8_t* triangles = meshletTriangles + meshlet.triangleOffset;
+    for (uint32_t i = 0; i < meshlet.triangleCount * 3; ++i) {
+      outIndices[written++] = vertices[triangles[i]];
+    }
+    ++result.visible;
+  }
+
+  result.triangles = written / 3;
+  if (stats) *stats = result;
+  return written;
+}
+
+void
+MeshletBuilder::extractFrustumPlanes(const float matrix[16], float planes[6][4]) {
+  // Con vectores fila, clip = v * M: cada coordenada de clip es una columna de M.
+  auto column = [matrix](int c, int r) { return matrix[r * 4 + c]; };
+  for (int r = 0; r < 4; ++r) {
+    planes[0][r] = column(3, r) + column(0, r);   // izquierda: w + x >= 0
+    planes[1][r] = column(3, r) - column(0, r);   // derecha:   w - x >= 0
+    planes[2][r] = column(3, r) + column(1, r);   // abajo:     w + y >= 0
+    planes[3][r] = column(3, r) - column(1, r);   // arriba:    w - y >= 0
+    planes[4][r] = column(2, r);                  // cerca:     z >= 0
+    planes[5][r] = column(3, r) - column(2, r);   // lejos:     w - z >= 0
+  }
+  for (int p = 0; p < 6; ++p) {
+    const float length = std::sqrt(dot3_(planes[p], planes[p]));
+    if (length > 0.0f) {
+      for (int r = 0; r < 4; ++r) planes[p][r] /= length;
+    }
+  }
+}
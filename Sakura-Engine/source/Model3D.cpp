@@ -1,4 +1,151 @@
 #include "Model3D.h"
+#include "OBJReader.h"
+#include "MeshCache.h"
+#include "MeshWelder.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshBounds.h"
+#include "MeshTangents.h"
+#include <atomic>
+#include <chrono>
+#include <cfloat>
+#include <cstring>
+#include <thread>
+
+/// <summary>
+/// Calcula la caja alineada a los ejes (AABB) y la esfera envolvente de la
+/// malla a partir de sus vrtices (ver MeshBounds).
+/// </summary>
+/// <param name="mesh">Malla a la que se le llenan m_aabbMin/Max y m_sphereCenter/Radius.</param>
+static void
+computeBounds_(MeshComponent& mesh) {
+  float minP[3];
+  float maxP[3];
+  MeshBounds::computeAabb(mesh.m_vertex.data(), mesh.m_vertex.size(), sizeof(SimpleVertex), minP, maxP);
+
+  const float center[3] = { (minP[0] + maxP[0]) * 0.5f, (minP[1] + maxP[1]) * 0.5f, (minP[2] + maxP[2]) * 0.5f };
+  mesh.m_aabbMin = XMFLOAT3(minP[0], minP[1], minP[2]);
+  mesh.m_aabbMax = XMFLOAT3(maxP[0], maxP[1], maxP[2]);
+  mesh.m_sphereCenter = XMFLOAT3(center[0], center[1], center[2]);
+  mesh.m_sphereRadius = MeshBounds::computeRadius(mesh.m_vertex.data(), mesh.m_vertex.size(),
+    sizeof(SimpleVertex), center);
+}
+
+/// <summary>
+/// Hash de las opciones de importacin que cambian el contenido de las mallas.
+/// Se guarda en la cach para regenerarla cuando cambian.
+/// </summary>
+/// <param name="settings">Opciones de importacin.</param>
+static uint64_t
+settingsHash_(const MeshImportSettings& settings) {
+  const float weldEpsilon = settings.weldVertices ? settings.weldEpsilon : 0.0f;
+  const unsigned int cacheSize = settings.optimizeVertexCache ? settings.vertexCacheSize : 0;
+  std::vector<unsigned char> bytes;
+  auto append = [&bytes](const void* data, size_t size) {
+    const unsigned char* begin = static_cast<const unsigned char*>(data);
+    bytes.insert(bytes.end(), begin, begin + size);
+  };
+
+  bytes.push_back(settings.weldVertices ? 1 : 0);
+  bytes.push_back(settings.optimizeVertexCache ? 1 : 0);
+  bytes.push_back(settings.generateTangents ? 1 : 0);
+  append(&weldEpsilon, sizeof(float));
+  append(&cacheSize, sizeof(unsigned int));
+  if (!settings.lodRatios.empty()) {
+    append(settings.lodRatios.data(), settings.lodRatios.size() * sizeof(float));
+    append(&settings.lodMaxError, sizeof(float));
+    append(&settings.lodAttributeWeight, sizeof(float));
+  }
+  return MeshCache::hashBytes(bytes.data(), bytes.size());
+}
+
+/// <summary>
+/// Genera los LODs de una malla. Cada nivel se simplifica desde la malla
+/// completa (no desde el nivel anterior) y cada submalla por separado, para
+/// que los rangos por material sigan valiendo.
+/// </summary>
+/// <param name="mesh">Malla ya post-procesada; se llena m_lods.</param>
+/// <param name="settings">Opciones de importacin (razones, error y peso de la uv).</param>
+/// <param name="stats">Resultado de cada nivel generado.</param>
+static void
+generateMeshLods_(MeshComponent& mesh, const MeshImportSettings& settings,
+  std::vector<MeshSimplifyStats>& stats) {
+  mesh.m_lods.clear();
+  stats.clear();
+  if (mesh.m_index.empty() || mesh.m_vertex.empty()) return;
+
+  std::vector<SubMesh> ranges = mesh.m_subMeshes;
+  if (ranges.empty()) {
+    SubMesh whole;
+    whole.indexCount = static_cast<unsigned int>(mesh.m_index.size());
+    ranges.push_back(whole);
+  }
+
+  // Un vrtice que usan dos submallas no se puede quitar: cada una se
+  // simplifica por su lado y se abrira una grieta entre materiales.
+  std::vector<unsigned char> lock;
+  if (ranges.size() > 1) {
+    const unsigned int kNoOwner = 0xFFFFFFFFu;
+    std::vector<unsigned int> owner(mesh.m_vertex.size(), kNoOwner);
+    lock.assign(mesh.m_vertex.size(), 0);
+    for (unsigned int r = 0; r < ranges.size(); ++r) {
+      if (ranges[r].startIndex + ranges[r].indexCount > mesh.m_index.size()) continue;
+      for (unsigned int i = 0; i < ranges[r].indexCount; ++i) {
+        const unsigned int v = mesh.m_index[ranges[r].startIndex + i];
+        if (owner[v] == kNoOwner) owner[v] = r;
+        else if (owner[v] != r) lock[v] = 1;
+      }
+    }
+  }
+
+  const float extent = MeshSimplifier::extent(mesh.m_vertex.data(), mesh.m_vertex.size(), sizeof(SimpleVertex));
+  std::vector<uint32_t> scratch(mesh.m_index.size());
+
+  for (float ratio : settings.lodRatios) {
+    MeshLod lod;
+    MeshSimplifyStats levelStats;
+
+    for (const SubMesh& range : ranges) {
+      SubMesh subMesh = range;
+      subMesh.startIndex = static_cast<unsigned int>(lod.indices.size());
+      subMesh.indexCount = 0;
+
+      if (range.startIndex + range.indexCount <= mesh.m_index.size()) {
+        const size_t target = static_cast<size_t>(range.indexCount / 3 * ratio) * 3;
+        MeshSimplifyStats rangeStats;
+        const size_t count = MeshSimplifier::simplify(mesh.m_vertex.data(), mesh.m_vertex.size(),
+          sizeof(SimpleVertex), mesh.m_index.data() + range.startIndex, range.indexCount, target,
+          settings.lodMaxError, settings.lodAttributeWeight, scratch.data(),
+          lock.empty() ? nullptr : lock.data(), &rangeStats);
+
+        if (settings.optimizeVertexCache) {
+          MeshOptimizer::optimizeVertexCache(scratch.data(), count, mesh.m_vertex.size(), settings.vertexCacheSize);
+        }
+        lod.indices.insert(lod.indices.end(), scratch.begin(), scratch.begin() + count);
+        subMesh.indexCount = static_cast<unsigned int>(count);
+
+        levelStats.trianglesBefore += rangeStats.trianglesBefore;
+        levelStats.trianglesAfter += rangeStats.trianglesAfter;
+        levelStats.error = (std::max)(levelStats.error, rangeStats.error);
+        levelStats.passes = (std::max)(levelStats.passes, rangeStats.passes);
+        levelStats.seconds += rangeStats.seconds;
+      }
+
+      if (!mesh.m_subMeshes.empty()) {
+        lod.subMeshes.push_back(subMesh);
+      }
+    }
+
+    // Si el error mximo ya no deja bajar ms, los siguientes niveles
+    // saldran iguales: me quedo con los que s reducen.
+    const size_t previous = mesh.m_lods.empty() ? mesh.m_index.size() : mesh.m_lods.back().indices.size();
+    if (lod.indices.size() >= previous) break;
+
+    lod.error = levelStats.error * extent;
+    mesh.m_lods.push_back(std::move(lod));
+    stats.push_back(levelStats);
+  }
+}
 
 /// <summary>
 /// Carga el modelo desde la ruta indicada y actualiza el estado del recurso.
@@ -10,23 +157,400 @@ Model3D::load(const std::string& path) {
   SetPath(path);
   SetState(ResourceState::Loading);
 
-  init();
-
-  bool success = true; // Cambia esto segn el resultado real.
+  bool success = init();
 
   SetState(success ? ResourceState::Loaded : ResourceState::Failed);
   return success;
 }
 
 /// <summary>
-/// Inicializa el modelo 3D y desencadena la carga del modelo FBX.
+/// Inicializa el modelo 3D: usa la cach .sakmesh si es vlida y si no
+/// importa el OBJ/FBX y escribe la cach para el siguiente arranque.
 /// </summary>
 /// <returns>true si la inicializacin fue exitosa; false en caso contrario.</returns>
 bool Model3D::init()
 {
-  // Inicializar recursos GPU, buffers, etc.
-  LoadFBXModel(m_filePath);
-  return false;
+  const auto startTime = std::chrono::steady_clock::now();
+  const std::string cachePath = m_filePath + ".sakmesh";
+
+  m_meshes.clear();
+  m_loadedFromCache = LoadMeshCache(cachePath);
+
+  if (!m_loadedFromCache) {
+    // Arranque en fro: importo el archivo fuente.
+    if (m_modelType == ModelType::OBJ) {
+      LoadOBJModel(m_filePath);
+    }
+    else {
+      LoadFBXModel(m_filePath);
+    }
+
+    PostProcessMeshes();
+    GenerateLods();
+
+    if (!m_meshes.empty() && !SaveMeshCache(cachePath)) {
+      ERROR("Model3D", "init", ("Failed to write mesh cache: " + cachePath).c_str());
+    }
+  }
+
+  // La cach guarda los vrtices en Full; el empacado (y los meshlets, si
+  // se pidieron) se hacen en cada carga.
+  CompactVertices();
+  BuildMeshlets();
+
+  m_loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  MESSAGE("Model3D", "init", m_filePath.c_str() << (m_loadedFromCache ? " (cache)" : " (import)")
+    << " loaded in " << m_loadSeconds * 1000.0 << " ms");
+
+  return !m_meshes.empty();
+}
+
+/// <summary>
+/// Carga un modelo OBJ con ObjReader y agrega la malla a m_meshes.
+/// </summary>
+/// <param name="filePath">Ruta del archivo OBJ.</param>
+/// <returns>true si se carg una malla vlida.</returns>
+bool
+Model3D::LoadOBJModel(const std::string& filePath) {
+  ObjReader reader;
+  reader.setThreadCount(0);
+
+  MeshComponent mesh;
+  if (!reader.load(filePath, mesh)) {
+    ERROR("Model3D", "LoadOBJModel", ("Unable to load OBJ: " + filePath).c_str());
+    return false;
+  }
+
+  if (mesh.m_name.empty()) {
+    mesh.m_name = m_name;
+  }
+  m_meshes.push_back(std::move(mesh));
+  return true;
+}
+
+/// <summary>
+/// Post-proceso comn de OBJ y FBX: suelda los vrtices repetidos, reordena
+/// tringulos y vrtices para el cache de la GPU, genera normales y tangentes
+/// y calcula la caja de cada malla.
+/// </summary>
+void
+Model3D::PostProcessMeshes() {
+  for (auto& mesh : m_meshes) {
+    if (m_importSettings.weldVertices && !mesh.m_vertex.empty()) {
+      // Soldar solo cambia los valores de los ndices, no su orden,
+      // as que los rangos de m_subMeshes siguen siendo vlidos.
+      MeshWeldStats weldStats;
+      const size_t count = MeshWelder::weld(mesh.m_vertex.data(), mesh.m_vertex.size(),
+        sizeof(SimpleVertex), mesh.m_index.data(), mesh.m_index.size(),
+        m_importSettings.weldEpsilon, &weldStats);
+      mesh.m_vertex.resize(count);
+      mesh.m_vertex.shrink_to_fit();
+      mesh.m_numVertex = static_cast<int>(mesh.m_vertex.size());
+
+      MESSAGE("Model3D", "PostProcessMeshes", mesh.m_name.c_str() << ": welded "
+        << weldStats.verticesBefore << " -> " << weldStats.verticesAfter << " vertices in "
+        << weldStats.seconds * 1000.0 << " ms");
+    }
+
+    if (m_importSettings.optimizeVertexCache && !mesh.m_index.empty()) {
+      const uint32_t cacheSize = m_importSettings.vertexCacheSize;
+      const VertexCacheStats before = MeshOptimizer::analyzeVertexCache(mesh.m_index.data(),
+        mesh.m_index.size(), mesh.m_vertex.size(), cacheSize);
+
+      // Cada submalla se reordena por separado para no mover tringulos
+      // de un material a otro.
+      if (mesh.m_subMeshes.empty()) {
+        MeshOptimizer::optimizeVertexCache(mesh.m_index.data(), mesh.m_index.size(),
+          mesh.m_vertex.size(), cacheSize);
+      }
+      for (const SubMesh& subMesh : mesh.m_subMeshes) {
+        if (subMesh.startIndex + subMesh.indexCount > mesh.m_index.size()) continue;
+        MeshOptimizer::optimizeVertexCache(mesh.m_index.data() + subMesh.startIndex,
+          subMesh.indexCount, mesh.m_vertex.size(), cacheSize);
+      }
+
+      const size_t count = MeshOptimizer::optimizeVertexFetch(mesh.m_vertex.data(), mesh.m_vertex.size(),
+        sizeof(SimpleVertex), mesh.m_index.data(), mesh.m_index.size());
+      mesh.m_vertex.resize(count);
+      mesh.m_numVertex = static_cast<int>(mesh.m_vertex.size());
+
+      const VertexCacheStats after = MeshOptimizer::analyzeVertexCache(mesh.m_index.data(),
+        mesh.m_index.size(), mesh.m_vertex.size(), cacheSize);
+      MESSAGE("Model3D", "PostProcessMeshes", mesh.m_name.c_str() << ": ACMR "
+        << before.acmr << " -> " << after.acmr << ", ATVR " << before.atvr << " -> " << after.atvr);
+    }
+
+    if (m_importSettings.generateTangents && !mesh.m_index.empty()) {
+      // Va despus de reordenar: los vrtices en espejo que se duplican
+      // quedan al final y no cambian el orden de los dems ni el de los ndices.
+      std::vector<float> normals;
+      std::vector<float> tangents;
+      std::vector<uint32_t> remap;
+      MeshTangentStats tangentStats;
+      const size_t count = MeshTangents::generate(mesh.m_vertex.data(), mesh.m_vertex.size(),
+        sizeof(SimpleVertex), mesh.m_index.data(), mesh.m_index.size(),
+        normals, tangents, remap, 0, &tangentStats);
+
+      if (count > 0) {
+        const size_t original = mesh.m_vertex.size();
+        mesh.m_vertex.resize(count);
+        for (size_t v = original; v < count; ++v) mesh.m_vertex[v] = mesh.m_vertex[remap[v]];
+        mesh.m_normal.resize(count);
+        mesh.m_tangent.resize(count);
+        std::memcpy(mesh.m_normal.data(), normals.data(), count * sizeof(XMFLOAT3));
+        std::memcpy(mesh.m_tangent.data(), tangents.data(), count * sizeof(XMFLOAT4));
+        mesh.m_numVertex = static_cast<int>(count);
+
+        MESSAGE("Model3D", "PostProcessMeshes", mesh.m_name.c_str() << ": tangents, "
+          << tangentStats.splitVertices << " mirrored vertices split, "
+          << tangentStats.degenerateTriangles << " degenerate uv triangles, "
+          << tangentStats.threads << " threads, " << tangentStats.seconds * 1000.0 << " ms");
+      }
+      else {
+        ERROR("Model3D", "PostProcessMeshes", (mesh.m_name + ": invalid indices, tangents skipped").c_str());
+      }
+    }
+
+    computeBounds_(mesh);
+  }
+}
+
+/// <summary>
+/// Genera los LODs de todas las mallas en paralelo (una malla por hilo a la vez)
+/// y deja en el Output los tringulos y el error de cada nivel.
+/// </summary>
+void
+Model3D::GenerateLods() {
+  if (m_importSettings.lodRatios.empty() || m_meshes.empty()) {
+    for (auto& mesh : m_meshes) mesh.m_lods.clear();
+    return;
+  }
+
+  const auto startTime = std::chrono::steady_clock::now();
+  std::vector<std::vector<MeshSimplifyStats>> stats(m_meshes.size());
+
+  unsigned int threads = std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+  if (threads > m_meshes.size()) threads = static_cast<unsigned int>(m_meshes.size());
+
+  // Cada hilo toma la siguiente malla libre. Cada malla se simplifica
+  // completa en un solo hilo, as que el resultado no depende del reparto.
+  std::atomic<size_t> nextMesh(0);
+  auto worker = [this, &stats, &nextMesh]() {
+    for (size_t m = nextMesh++; m < m_meshes.size(); m = nextMesh++) {
+      generateMeshLods_(m_meshes[m], m_importSettings, stats[m]);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (unsigned int t = 1; t < threads; ++t) pool.emplace_back(worker);
+  worker();
+  for (auto& thread : pool) thread.join();
+
+  for (size_t m = 0; m < m_meshes.size(); ++m) {
+    const MeshComponent& mesh = m_meshes[m];
+    for (size_t l = 0; l < mesh.m_lods.size(); ++l) {
+      MESSAGE("Model3D", "GenerateLods", mesh.m_name.c_str() << ": LOD" << (l + 1) << " "
+        << stats[m][l].trianglesBefore << " -> " << stats[m][l].trianglesAfter << " triangles, error "
+        << mesh.m_lods[l].error << " (" << stats[m][l].error * 100.0f << "% of size), "
+        << stats[m][l].passes << " passes, " << stats[m][l].seconds * 1000.0 << " ms");
+    }
+  }
+
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  MESSAGE("Model3D", "GenerateLods", m_meshes.size() << " meshes on " << threads
+    << " threads in " << seconds * 1000.0 << " ms");
+}
+
+/// <summary>
+/// Empaca los vrtices de cada malla si el error queda dentro de los lmites
+/// y deja en el Output el formato elegido, el error medido y los bytes.
+/// </summary>
+void
+Model3D::CompactVertices() {
+  for (auto& mesh : m_meshes) {
+    mesh.m_vertexFormat = VertexFormat::Full;
+    mesh.m_packedVertex.clear();
+    if (!m_importSettings.compactVertices || mesh.m_vertex.empty()) {
+      continue;
+    }
+
+    mesh.m_vertexFormat = VertexCompression::compress(mesh.m_vertex.data(), mesh.m_vertex.size(),
+      sizeof(SimpleVertex), m_importSettings.vertexLimits, mesh.m_packedVertex, &mesh.m_compression);
+
+    static const char* kFormatNames[] = { "Full", "PackedHalf", "PackedUnorm" };
+    MESSAGE("Model3D", "CompactVertices", mesh.m_name.c_str() << ": "
+      << kFormatNames[static_cast<size_t>(mesh.m_vertexFormat)]
+      << ", position error " << mesh.m_compression.maxPositionError
+      << ", uv error " << mesh.m_compression.maxTexCoordError << ", "
+      << mesh.m_compression.bytesBefore << " -> " << mesh.m_compression.bytesAfter << " bytes");
+  }
+}
+
+/// <summary>
+/// Arma los meshlets de cada malla, una submalla a la vez para que ningn
+/// meshlet mezcle materiales, y deja en el Output cuntos salieron y qu tan llenos.
+/// </summary>
+void
+Model3D::BuildMeshlets() {
+  for (auto& mesh : m_meshes) {
+    mesh.m_meshlets.clear();
+    mesh.m_meshletVertices.clear();
+    mesh.m_meshletTriangles.clear();
+    if (!m_importSettings.buildMeshlets || mesh.m_index.empty() || mesh.m_vertex.empty()) {
+      continue;
+    }
+
+    std::vector<SubMesh> ranges = mesh.m_subMeshes;
+    if (ranges.empty()) {
+      SubMesh all;
+      all.indexCount = static_cast<unsigned int>(mesh.m_index.size());
+      ranges.push_back(all);
+    }
+
+    MeshletStats total;
+    for (unsigned int s = 0; s < ranges.size(); s++) {
+      const SubMesh& range = ranges[s];
+      if (range.startIndex + range.indexCount > mesh.m_index.size()) continue;
+
+      MeshletStats stats;
+      MeshletBuilder::build(mesh.m_vertex.data(), mesh.m_vertex.size(), sizeof(SimpleVertex),
+        mesh.m_index.data() + range.startIndex, range.indexCount,
+        m_importSettings.meshletMaxVertices, m_importSettings.meshletMaxTriangles, s,
+        mesh.m_meshlets, mesh.m_meshletVertices, mesh.m_meshletTriangles, &stats);
+      total.meshlets += stats.meshlets;
+      total.triangles += stats.triangles;
+      total.seconds += stats.seconds;
+    }
+
+    if (total.meshlets > 0) {
+      total.averageVertices = static_cast<double>(mesh.m_meshletVertices.size()) / total.meshlets;
+      total.averageTriangles = static_cast<double>(total.triangles) / total.meshlets;
+    }
+    MESSAGE("Model3D", "BuildMeshlets", mesh.m_name.c_str() << ": " << total.meshlets
+      << " meshlets, " << total.averageVertices << " vertices and " << total.averageTriangles
+      << " triangles on average, " << total.seconds * 1000.0 << " ms");
+  }
+}
+
+/// <summary>
+/// Llena m_meshes desde la cach. Vrtices e ndices se copian directo
+/// desde el archivo mapeado, sin parsear.
+/// </summary>
+/// <param name="cachePath">Ruta del archivo de cach.</param>
+/// <returns>true si la cach exista y era vlida.</returns>
+bool
+Model3D::LoadMeshCache(const std::string& cachePath) {
+  MeshCache cache;
+  if (!cache.open(cachePath, m_filePath, settingsHash_(m_importSettings), sizeof(SimpleVertex))) {
+    return false;
+  }
+
+  m_meshes.resize(cache.meshCount());
+  for (uint32_t m = 0; m < cache.meshCount(); ++m) {
+    const MeshCacheMeshView view = cache.mesh(m);
+    MeshComponent& mesh = m_meshes[m];
+
+    const SimpleVertex* vertices = static_cast<const SimpleVertex*>(view.vertices);
+    mesh.m_name = std::string(view.name);
+    mesh.m_vertex.assign(vertices, vertices + view.vertexCount);
+    mesh.m_index.assign(view.indices, view.indices + view.indexCount);
+    mesh.m_numVertex = static_cast<int>(view.vertexCount);
+    mesh.m_numIndex = static_cast<int>(view.indexCount);
+    mesh.m_aabbMin = XMFLOAT3(view.aabbMin[0], view.aabbMin[1], view.aabbMin[2]);
+    mesh.m_aabbMax = XMFLOAT3(view.aabbMax[0], view.aabbMax[1], view.aabbMax[2]);
+    mesh.m_sphereCenter = XMFLOAT3(view.sphere[0], view.sphere[1], view.sphere[2]);
+    mesh.m_sphereRadius = view.sphere[3];
+    if (view.normals && view.tangents) {
+      const XMFLOAT3* normals = reinterpret_cast<const XMFLOAT3*>(view.normals);
+      const XMFLOAT4* tangents = reinterpret_cast<const XMFLOAT4*>(view.tangents);
+      mesh.m_normal.assign(normals, normals + view.vertexCount);
+      mesh.m_tangent.assign(tangents, tangents + view.vertexCount);
+    }
+
+    mesh.m_subMeshes.resize(view.subMeshCount);
+    for (uint32_t s = 0; s < view.subMeshCount; ++s) {
+      const MeshCacheSubMeshView subView = cache.subMesh(m, s);
+      mesh.m_subMeshes[s].materialName = std::string(subView.materialName);
+      mesh.m_subMeshes[s].texturePath = std::string(subView.texturePath);
+      mesh.m_subMeshes[s].startIndex = subView.startIndex;
+      mesh.m_subMeshes[s].indexCount = subView.indexCount;
+    }
+
+    mesh.m_lods.resize(view.lodCount);
+    for (uint32_t l = 0; l < view.lodCount; ++l) {
+      const MeshCacheLodView lodView = cache.lod(m, l);
+      MeshLod& lod = mesh.m_lods[l];
+      lod.indices.assign(lodView.indices, lodView.indices + lodView.indexCount);
+      lod.error = lodView.error;
+      lod.subMeshes = mesh.m_subMeshes;
+      for (uint32_t s = 0; s < lodView.subMeshCount; ++s) {
+        lod.subMeshes[s].startIndex = lodView.subMeshRanges[s].startIndex;
+        lod.subMeshes[s].indexCount = lodView.subMeshRanges[s].indexCount;
+      }
+    }
+  }
+  return !m_meshes.empty();
+}
+
+/// <summary>
+/// Escribe m_meshes en la cach .sakmesh junto con la firma del archivo fuente.
+/// </summary>
+/// <param name="cachePath">Ruta del archivo de cach.</param>
+/// <returns>true si se pudo escribir.</returns>
+bool
+Model3D::SaveMeshCache(const std::string& cachePath) const {
+  MeshCacheSource source;
+  if (!MeshCache::stampSource(m_filePath, source, true)) {
+    return false;
+  }
+
+  std::vector<MeshCacheMesh> cacheMeshes(m_meshes.size());
+  for (size_t m = 0; m < m_meshes.size(); ++m) {
+    const MeshComponent& mesh = m_meshes[m];
+    MeshCacheMesh& out = cacheMeshes[m];
+
+    out.name = mesh.m_name;
+    out.vertices = mesh.m_vertex.data();
+    out.vertexCount = static_cast<uint32_t>(mesh.m_vertex.size());
+    out.indices = mesh.m_index.data();
+    out.indexCount = static_cast<uint32_t>(mesh.m_index.size());
+    out.aabbMin[0] = mesh.m_aabbMin.x; out.aabbMin[1] = mesh.m_aabbMin.y; out.aabbMin[2] = mesh.m_aabbMin.z;
+    out.aabbMax[0] = mesh.m_aabbMax.x; out.aabbMax[1] = mesh.m_aabbMax.y; out.aabbMax[2] = mesh.m_aabbMax.z;
+    out.sphere[0] = mesh.m_sphereCenter.x; out.sphere[1] = mesh.m_sphereCenter.y;
+    out.sphere[2] = mesh.m_sphereCenter.z; out.sphere[3] = mesh.m_sphereRadius;
+    if (mesh.m_normal.size() == mesh.m_vertex.size() && mesh.m_tangent.size() == mesh.m_vertex.size()) {
+      out.normals = reinterpret_cast<const float*>(mesh.m_normal.data());
+      out.tangents = reinterpret_cast<const float*>(mesh.m_tangent.data());
+    }
+
+    for (const SubMesh& subMesh : mesh.m_subMeshes) {
+      MeshCacheSubMesh subOut;
+      subOut.materialName = subMesh.materialName;
+      subOut.texturePath = subMesh.texturePath;
+      subOut.startIndex = subMesh.startIndex;
+      subOut.indexCount = subMesh.indexCount;
+      out.subMeshes.push_back(subOut);
+    }
+
+    for (const MeshLod& lod : mesh.m_lods) {
+      MeshCacheLod lodOut;
+      lodOut.indices = lod.indices.data();
+      lodOut.indexCount = static_cast<uint32_t>(lod.indices.size());
+      lodOut.error = lod.error;
+      for (const SubMesh& subMesh : lod.subMeshes) {
+        MeshCacheRange range;
+        range.startIndex = subMesh.startIndex;
+        range.indexCount = subMesh.indexCount;
+        lodOut.subMeshRanges.push_back(range);
+      }
+      out.lods.push_back(lodOut);
+    }
+  }
+
+  return MeshCache::write(cachePath, source, settingsHash_(m_importSettings),
+    sizeof(SimpleVertex), cacheMeshes);
 }
 
 /// <summary>
@@ -1,9 +1,23 @@
-#include "ObjReader.h"
+#include "OBJReader.h"
+#include "MappedFile.h"
 
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define OBJ_PRESCAN_SSE2 1
+#endif
 
 // Funcin auxiliar para reservar memoria aproximada en los vectores.
 // La idea es evitar muchas realocaciones mientras se lee el .obj.
@@ -54,9 +68,304 @@ void ObjReader::parseTuple_(const std::string& key, int& vi, int& ti, int& ni) {
   if (std::getline(ss, part, '/') && !part.empty()) ni = std::stoi(part) - 1;
 }
 
+// ---------------------------------------------------------------------------
+// Helpers del parser rpido. Trabajan directo sobre los bytes mapeados
+// con punteros [p, end), sin copiar nada a strings.
+// ---------------------------------------------------------------------------
+
+// Espacios dentro de una lnea (el '\n' lo maneja el ciclo de lneas).
+static inline bool isBlank_(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static inline bool isDigit_(char c) {
+  return c >= '0' && c <= '9';
+}
+
+// Avanza p mientras haya espacios.
+static inline const char* skipBlanks_(const char* p, const char* end) {
+  while (p < end && isBlank_(*p)) ++p;
+  return p;
+}
+
+// Avanza p hasta el siguiente espacio (fin del token actual).
+static inline const char* skipToken_(const char* p, const char* end) {
+  while (p < end && !isBlank_(*p)) ++p;
+  return p;
+}
+
+// Potencias de 10 que son exactas en float (10^10 = 2^10 * 5^10 y 5^10 < 2^24).
+static const float kPow10f_[] = {
+  1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+// Parsea un float en [p, end) y deja p despus del nmero.
+// Camino rpido: si la mantisa cabe en 24 bits y el exponente es chico,
+// una sola multiplicacin/divisin en float da el resultado exacto (bien redondeado).
+// Si no, copio el nmero a un buffer local y uso strtof para no perder precisin.
+static bool parseFloat_(const char*& p, const char* end, float& out) {
+  p = skipBlanks_(p, end);
+  const char* start = p;
+
+  bool negative = false;
+  if (p < end && (*p == '+' || *p == '-')) {
+    negative = (*p == '-');
+    ++p;
+  }
+
+  unsigned long long mantissa = 0;
+  int digits = 0;       // Dgitos significativos guardados en la mantisa.
+  int exponent = 0;     // Exponente decimal acumulado.
+  bool anyDigit = false;
+  bool exact = true;
+
+  while (p < end && isDigit_(*p)) {
+    anyDigit = true;
+    if (digits < 19) {
+      mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+      if (mantissa != 0) ++digits;
+    }
+    else {
+      ++exponent;
+      exact = false;
+    }
+    ++p;
+  }
+
+  if (p < end && *p == '.') {
+    ++p;
+    while (p < end && isDigit_(*p)) {
+      anyDigit = true;
+      if (digits < 19) {
+        mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+        if (mantissa != 0) ++digits;
+        --exponent;
+      }
+      else {
+        exact = false;
+      }
+      ++p;
+    }
+  }
+
+  if (!anyDigit) {
+    p = start;
+    return false;
+  }
+
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    const char* expStart = p;
+    ++p;
+    bool expNegative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+      expNegative = (*p == '-');
+      ++p;
+    }
+    if (p < end && isDigit_(*p)) {
+      int e = 0;
+      while (p < end && isDigit_(*p)) {
+        if (e < 100000) e = e * 10 + (*p - '0');
+        ++p;
+      }
+      exponent += expNegative ? -e : e;
+    }
+    else {
+      // Una 'e' sin dgitos no es parte del nmero.
+      p = expStart;
+    }
+  }
+
+  if (exact && mantissa <= (1ull << 24) && exponent >= -10 && exponent <= 10) {
+    float value = static_cast<float>(mantissa);
+    value = (exponent < 0) ? value / kPow10f_[-exponent] : value * kPow10f_[exponent];
+    out = negative ? -value : value;
+    return true;
+  }
+
+  // Camino lento (nmeros largos o exponentes grandes).
+  char buffer[128];
+  const size_t length = static_cast<size_t>(p - start);
+  if (length >= sizeof(buffer)) {
+    const std::string longNumber(start, length);
+    out = std::strtof(longNumber.c_str(), nullptr);
+    return true;
+  }
+  std::memcpy(buffer, start, length);
+  buffer[length] = '\0';
+  out = std::strtof(buffer, nullptr);
+  return true;
+}
+
+// Parsea un entero con signo opcional. Devuelve false si no hay dgitos.
+static inline bool parseInt_(const char*& p, const char* end, int& out) {
+  bool negative = false;
+  const char* start = p;
+  if (p < end && (*p == '+' || *p == '-')) {
+    negative = (*p == '-');
+    ++p;
+  }
+  if (p >= end || !isDigit_(*p)) {
+    p = start;
+    return false;
+  }
+  long long value = 0;
+  while (p < end && isDigit_(*p)) {
+    if (value < 0x7fffffffll) value = value * 10 + (*p - '0');
+    ++p;
+  }
+  out = static_cast<int>(negative ? -value : value);
+  return true;
+}
+
+// Versin de parseTuple_ sobre el token mapeado [p, end).
+// Cada campo separado por '/' se convierte a base 0; si est vaco queda en -1.
+static inline void parseTupleView_(const char* p, const char* end, int& vi, int& ti, int& ni) {
+  int* fields[3] = { &vi, &ti, &ni };
+  vi = ti = ni = -1;
+
+  for (int f = 0; f < 3; ++f) {
+    int value = 0;
+    if (parseInt_(p, end, value)) {
+      *fields[f] = value - 1;
+    }
+    // Igual que std::stoi, ignoro lo que venga despus del nmero en el campo.
+    while (p < end && *p != '/') ++p;
+    if (p >= end) break;
+    ++p; // salto el '/'
+  }
+}
+
+// ndice base 0 de un campo de parseTuple_. Los negativos del .obj son
+// relativos a lo definido hasta ah (-1 = el ltimo): -1 en el .obj llega
+// como -2, y -1 sigue siendo "no tiene".
+static inline int resolveIndex_(int index, size_t countSoFar) {
+  return index < -1 ? static_cast<int>(countSoFar) + index + 1 : index;
+}
+
+// ---------------------------------------------------------------------------
+// Pre-escaneo. Una pasada rpida que solo cuenta lneas v/vt/vn/f y esquinas
+// de cara, para reservar los vectores una sola vez con el tamao exacto.
+// Busca los saltos de lnea y cuenta las tuplas de las caras de 16 en 16 bytes
+// con SSE2 cuando est disponible.
+// ---------------------------------------------------------------------------
+
+// Conteos del pre-escaneo. Son exactos para un .obj bien formado;
+// con lneas mal formadas solo pueden sobrar, nunca faltar.
+struct ObjCounts_ {
+  size_t positions = 0;
+  size_t texcoords = 0;
+  size_t normals = 0;
+  size_t faces = 0;
+  size_t corners = 0;
+  size_t indices = 0;   // 3 * (esquinas - 2) por cara, lo que genera el "fan".
+};
+
+// push_back que cuenta cuntas veces el vector tuvo que crecer.
+template<typename T>
+static inline void pushCounted_(std::vector<T>& v, const T& value, size_t& reallocs) {
+  if (v.size() == v.capacity()) ++reallocs;
+  v.push_back(value);
+}
+
+#ifdef OBJ_PRESCAN_SSE2
+// Mscara de 16 bits con 1 donde el byte es espacio (igual que isBlank_).
+static inline unsigned int blankMask16_(__m128i bytes) {
+  __m128i blank = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '));
+  blank = _mm_or_si128(blank, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t')));
+  blank = _mm_or_si128(blank, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r')));
+  blank = _mm_or_si128(blank, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\v')));
+  blank = _mm_or_si128(blank, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\f')));
+  return static_cast<unsigned int>(_mm_movemask_epi8(blank));
+}
+
+static inline unsigned int popCount16_(unsigned int x) {
+  unsigned int count = 0;
+  for (; x; x &= x - 1) ++count;
+  return count;
+}
+#endif
+
+// Siguiente '\n' en [p, end), o end si no hay.
+static inline const char* findNewline_(const char* p, const char* end) {
+#ifdef OBJ_PRESCAN_SSE2
+  const __m128i newline = _mm_set1_epi8('\n');
+  while (end - p >= 16) {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline)));
+    if (mask) {
+      unsigned int bit = 0;
+      while (!(mask & (1u << bit))) ++bit;
+      return p + bit;
+    }
+    p += 16;
+  }
+#endif
+  while (p < end && *p != '\n') ++p;
+  return p;
+}
+
+// Cuenta los tokens (tuplas) de [p, end): cada inicio de algo que no es espacio.
+static inline size_t countTokens_(const char* p, const char* end) {
+  size_t count = 0;
+  bool prevBlank = true;
+#ifdef OBJ_PRESCAN_SSE2
+  while (end - p >= 16) {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const unsigned int solid = ~blankMask16_(bytes) & 0xFFFFu;
+    // Un token empieza donde hay un byte slido y el anterior era espacio.
+    const unsigned int starts = solid & ~((solid << 1) | (prevBlank ? 0u : 1u));
+    count += popCount16_(starts & 0xFFFFu);
+    prevBlank = !(solid & 0x8000u);
+    p += 16;
+  }
+#endif
+  for (; p < end; ++p) {
+    const bool blank = isBlank_(*p);
+    if (!blank && prevBlank) ++count;
+    prevBlank = blank;
+  }
+  return count;
+}
+
+// Pre-escaneo de [begin, end). Solo mira el tag de cada lnea y, en las caras,
+// cuenta las tuplas; no convierte ningn nmero.
+static void countObj_(const char* begin, const char* end, ObjCounts_& out) {
+  const char* cursor = begin;
+  while (cursor < end) {
+    const char* lineEnd = findNewline_(cursor, end);
+    const char* p = skipBlanks_(cursor, lineEnd);
+    cursor = (lineEnd < end) ? lineEnd + 1 : end;
+
+    const size_t length = static_cast<size_t>(lineEnd - p);
+    if (length == 0) continue;
+
+    // Solo cuento tags seguidos de espacio; una lnea "v" sola no trae datos.
+    const bool tag1 = length >= 2 && isBlank_(p[1]);
+    const bool tag2 = length >= 3 && isBlank_(p[2]);
+
+    if (p[0] == 'v') {
+      if (tag1) ++out.positions;
+      else if (tag2 && p[1] == 't') ++out.texcoords;
+      else if (tag2 && p[1] == 'n') ++out.normals;
+    }
+    else if (p[0] == 'f' && tag1) {
+      const size_t corners = countTokens_(p + 1, lineEnd);
+      if (corners >= 3) {
+        ++out.faces;
+        out.corners += corners;
+        out.indices += (corners - 2) * 3;
+      }
+    }
+  }
+}
+
 // Carga un archivo .obj sencillo (posiciones y UVs) y rellena un MeshComponent.
 // flipV sirve para invertir la coordenada V de las UV si hace falta.
-bool ObjReader::load(const std::string& path, MeshComponent& outMesh, bool flipV) {
+// Es el camino original con streams; load() hace lo mismo sobre el archivo mapeado.
+bool ObjReader::loadLegacy(const std::string& path, MeshComponent& outMesh, bool flipV) {
+  const auto startTime = std::chrono::steady_clock::now();
+  m_lastStats = ObjLoadStats();
+
   // Limpio primero los datos que hubiera en la malla de salida.
   outMesh.m_vertex.clear();
   outMesh.m_index.clear();
@@ -68,23 +377,50 @@ bool ObjReader::load(const std::string& path, MeshComponent& outMesh, bool flipV
   std::vector<XMFLOAT3> positions;
   std::vector<XMFLOAT2> texcoords;
   std::vector<XMFLOAT3> normals;
-  reserveAprox_(positions, texcoords, normals);
 
   // Estos vectores son el resultado final que se copiar al MeshComponent.
   std::vector<SimpleVertex>   verts;
-  verts.reserve(2048);            // reservo algo de espacio extra
   std::vector<unsigned int>   indices;
-  indices.reserve(4096);
 
   // Cache para no crear vrtices duplicados.
   // La clave es la tupla completa en texto, por ejemplo "1/2/3".
   // El valor es el ndice del vrtice en el vector verts.
   std::unordered_map<std::string, unsigned int> vcache;
-  vcache.reserve(4096);
 
   // Si la ruta no trae ".obj" al final, se lo agrego.
   const std::string filePath = endsWithObj_(path) ? path : (path + ".obj");
 
+  // Con el pre-escaneo reservo los tamaos exactos; si no, uso las reservas
+  // aproximadas de siempre.
+  ObjCounts_ counts;
+  bool counted = false;
+  if (m_preScan) {
+    const auto scanStart = std::chrono::steady_clock::now();
+    MappedFile mapped;
+    if (mapped.open(filePath)) {
+      countObj_(mapped.data(), mapped.data() + mapped.size(), counts);
+      counted = true;
+    }
+    m_lastStats.preScanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - scanStart).count();
+  }
+
+  if (counted) {
+    positions.reserve(counts.positions);
+    texcoords.reserve(counts.texcoords);
+    // Los vrtices nicos no se saben hasta deduplicar; nunca son ms que las esquinas.
+    const size_t expected = (std::min)(counts.corners, (std::max)(counts.positions, counts.texcoords) + (std::max)(counts.positions, counts.texcoords) / 4);
+    verts.reserve(expected);
+    indices.reserve(counts.indices);
+    vcache.reserve(expected);
+  }
+  else {
+    reserveAprox_(positions, texcoords, normals);
+    verts.reserve(2048);            // reservo algo de espacio extra
+    indices.reserve(4096);
+    vcache.reserve(4096);
+  }
+  const size_t vcacheBuckets = vcache.bucket_count();
+
   // Abro el archivo .obj.
   std::ifstream ifs(filePath);
   if (!ifs.is_open()) {
@@ -92,6 +428,11 @@ bool ObjReader::load(const std::string& path, MeshComponent& outMesh, bool flipV
     return false;
   }
 
+  // Tamao del archivo, solo para las estadsticas de la carga.
+  ifs.seekg(0, std::ios::end);
+  m_lastStats.bytes = static_cast<size_t>(ifs.tellg());
+  ifs.seekg(0, std::ios::beg);
+
   std::string line;
   line.reserve(256);
 
@@ -114,7 +455,7 @@ bool ObjReader::load(const std::string& path, MeshComponent& outMesh, bool flipV
       XMFLOAT3 v{};
       ss >> v.x >> v.y >> v.z;
       if (!ss.fail())
-        positions.push_back(v);
+        pushCounted_(positions, v, m_lastStats.reallocations);
       else
         logWarn_("v mal formada: " + line);
     }
@@ -125,7 +466,7 @@ bool ObjReader::load(const std::string& path, MeshComponent& outMesh, bool flipV
       if (!ss.fail()) {
         // A veces la V viene al revs, as que se puede invertir si flipV es true.
         if (flipV) t.y = 1.0f - t.y;
-        texcoords.push_back(t);
+        pushCounted_(texcoords, t, m_lastStats.reallocations);
       }
       else {
         logWarn_("vt mal formada: " + line);
@@ -173,6 +514,8 @@ bool ObjReader::load(const std::string& path, MeshComponent& outMesh, bool flipV
         // Si no est en cache, parseo la tupla para obtener los ndices numricos.
         int vi, ti, ni;
         parseTuple_(key, vi, ti, ni);
+        vi = resolveIndex_(vi, positions.size());
+        ti = resolveIndex_(ti, texcoords.size());
 
         // Verifico que el ndice de posicin sea vlido.
         if (vi < 0 || vi >= static_cast<int>(positions.size())) {
@@ -191,7 +534,7 @@ bool ObjReader::load(const std::string& path, MeshComponent& outMesh, bool flipV
           sv.Tex = XMFLOAT2(0.f, 0.f);
 
         // Agrego el nuevo vrtice al vector de vrtices finales.
-        verts.push_back(sv);
+        pushCounted_(verts, sv, m_lastStats.reallocations);
 
         // El ndice del nuevo vrtice es el ltimo del vector.
         const unsigned int newIdx = static_cast<unsigned int>(verts.size() - 1);
@@ -209,9 +552,9 @@ bool ObjReader::load(const std::string& path, MeshComponent& outMesh, bool flipV
       // Convierto la cara con N vrtices en tringulos usando modo "fan":
       // (0, 1, 2), (0, 2, 3), etc.
       for (unsigned int i = 1; i + 1 < local.size(); ++i) {
-        indices.push_back(local[0]);
-        indices.push_back(local[i]);
-        indices.push_back(local[i + 1]);
+        pushCounted_(indices, local[0], m_lastStats.reallocations);
+        pushCounted_(indices, local[i], m_lastStats.reallocations);
+        pushCounted_(indices, local[i + 1], m_lastStats.reallocations);
       }
     }
     // Aqu se podran manejar otros tags del .obj como g, o, usemtl, mtllib, etc.
@@ -220,12 +563,881 @@ bool ObjReader::load(const std::string& path, MeshComponent& outMesh, bool flipV
   // Cierro el archivo .obj.
   ifs.close();
 
+  // Si el cache cambi de buckets es que tuvo que rehashear.
+  if (vcache.bucket_count() != vcacheBuckets) ++m_lastStats.reallocations;
+
   // Copio los datos finales a la malla de salida.
   outMesh.m_vertex = std::move(verts);
   outMesh.m_index = std::move(indices);
   outMesh.m_numVertex = static_cast<int>(outMesh.m_vertex.size());
   outMesh.m_numIndex = static_cast<int>(outMesh.m_index.size());
 
+  m_lastStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
   // Regreso true si se carg al menos un vrtice y un ndice.
   return (outMesh.m_numVertex > 0 && outMesh.m_numIndex > 0);
 }
+
+// ---------------------------------------------------------------------------
+// Parseo por bloques (chunks).
+// El archivo se parte en bloques alineados a lneas. Cada bloque se parsea por
+// separado (en paralelo si hay varios hilos) y luego se mezclan en orden de
+// archivo, as el resultado no depende de cuntos hilos se usaron.
+// ---------------------------------------------------------------------------
+
+// Esquina de una cara: ndices v/vt/vn ya convertidos a base 0 (-1 si no vienen).
+struct ObjCorner_ {
+  int vi, ti, ni;
+};
+
+// Cara leda en un bloque. positionsBefore/texcoordsBefore guardan cuntas
+// v/vt del mismo bloque haba antes de la cara, para validar ndices igual
+// que el parser secuencial (solo cuentan las que aparecen antes en el archivo).
+struct ObjFace_ {
+  unsigned int firstCorner;
+  unsigned int cornerCount;
+  unsigned int positionsBefore;
+  unsigned int texcoordsBefore;
+  unsigned int normalsBefore;   // Para los ndices vn negativos (relativos).
+  std::string_view line;
+};
+
+// Cambio de material (usemtl) dentro de un bloque: aplica desde la cara
+// 'firstFace' del bloque en adelante.
+struct ObjMaterialSwitch_ {
+  size_t firstFace;
+  std::string_view name;
+};
+
+// Resultado de parsear un bloque del archivo.
+struct ObjChunk_ {
+  const char* begin = nullptr;
+  const char* end = nullptr;
+  std::vector<XMFLOAT3> positions;
+  std::vector<XMFLOAT2> texcoords;
+  std::vector<ObjCorner_> corners;
+  std::vector<ObjFace_> faces;
+  size_t normals = 0;                  // Solo se cuentan; sirven para armar la clave del cache.
+  std::vector<std::string> warnings;   // Se imprimen en orden al mezclar.
+  ObjCounts_ counts;                   // Pre-escaneo del bloque (si est activo).
+  double preScanSeconds = 0.0;
+  size_t reallocs = 0;
+  std::vector<ObjMaterialSwitch_> materialSwitches;
+  std::vector<std::string_view> materialLibs;   // Archivos de mtllib.
+  std::string_view objectName;                  // Primer "o" del bloque.
+};
+
+// Resto de la lnea sin espacios al inicio ni al final (nombres de o/g/usemtl/mtllib).
+static inline std::string_view restOfLine_(const char* p, const char* lineEnd) {
+  p = skipBlanks_(p, lineEnd);
+  while (lineEnd > p && isBlank_(lineEnd[-1])) --lineEnd;
+  return std::string_view(p, static_cast<size_t>(lineEnd - p));
+}
+
+// Tamao mnimo de un bloque; con archivos chicos no vale la pena crear hilos.
+static const size_t kMinChunkBytes_ = 1u << 20;
+
+// Parsea las lneas de [chunk.begin, chunk.end). No toca nada compartido,
+// as que se puede llamar desde varios hilos a la vez.
+// Con preScan primero cuenta el bloque y reserva los vectores a su tamao exacto.
+static void parseChunk_(ObjChunk_& chunk, bool flipV, bool preScan) {
+  const char* cursor = chunk.begin;
+  const char* const chunkEnd = chunk.end;
+
+  if (preScan) {
+    const auto scanStart = std::chrono::steady_clock::now();
+    countObj_(chunk.begin, chunk.end, chunk.counts);
+    chunk.positions.reserve(chunk.counts.positions);
+    chunk.texcoords.reserve(chunk.counts.texcoords);
+    chunk.corners.reserve(chunk.counts.corners);
+    chunk.faces.reserve(chunk.counts.faces);
+    chunk.preScanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - scanStart).count();
+  }
+
+  while (cursor < chunkEnd) {
+    // Delimito la lnea actual [lineBegin, lineEnd).
+    const char* lineBegin = cursor;
+    const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(chunkEnd - cursor)));
+    if (!lineEnd) lineEnd = chunkEnd;
+    cursor = (lineEnd < chunkEnd) ? lineEnd + 1 : chunkEnd;
+
+    const char* p = skipBlanks_(lineBegin, lineEnd);
+    if (p >= lineEnd || *p == '#') continue;
+
+    // Tag de la lnea: "v", "vt", "vn", "f", etc.
+    const char* tagEnd = skipToken_(p, lineEnd);
+    const std::string_view tag(p, static_cast<size_t>(tagEnd - p));
+    p = tagEnd;
+
+    if (tag == "v") {
+      XMFLOAT3 v{};
+      if (parseFloat_(p, lineEnd, v.x) && parseFloat_(p, lineEnd, v.y) && parseFloat_(p, lineEnd, v.z))
+        pushCounted_(chunk.positions, v, chunk.reallocs);
+      else
+        chunk.warnings.push_back("v mal formada: " + std::string(lineBegin, lineEnd));
+    }
+    else if (tag == "vt") {
+      XMFLOAT2 t{};
+      if (parseFloat_(p, lineEnd, t.x) && parseFloat_(p, lineEnd, t.y)) {
+        if (flipV) t.y = 1.0f - t.y;
+        pushCounted_(chunk.texcoords, t, chunk.reallocs);
+      }
+      else {
+        chunk.warnings.push_back("vt mal formada: " + std::string(lineBegin, lineEnd));
+      }
+    }
+    else if (tag == "vn") {
+      // Igual que en loadLegacy: las normales todava no se guardan en SimpleVertex.
+      ++chunk.normals;
+    }
+    else if (tag == "f") {
+      ObjFace_ face{};
+      face.firstCorner = static_cast<unsigned int>(chunk.corners.size());
+      face.positionsBefore = static_cast<unsigned int>(chunk.positions.size());
+      face.texcoordsBefore = static_cast<unsigned int>(chunk.texcoords.size());
+      face.normalsBefore = static_cast<unsigned int>(chunk.normals);
+      face.line = std::string_view(lineBegin, static_cast<size_t>(lineEnd - lineBegin));
+
+      p = skipBlanks_(p, lineEnd);
+      while (p < lineEnd) {
+        const char* keyEnd = skipToken_(p, lineEnd);
+        ObjCorner_ corner{};
+        parseTupleView_(p, keyEnd, corner.vi, corner.ti, corner.ni);
+        pushCounted_(chunk.corners, corner, chunk.reallocs);
+        p = skipBlanks_(keyEnd, lineEnd);
+      }
+
+      face.cornerCount = static_cast<unsigned int>(chunk.corners.size()) - face.firstCorner;
+      if (face.cornerCount < 3) {
+        // Si hay menos de 3 vrtices no se puede formar un tringulo.
+        chunk.corners.resize(face.firstCorner);
+        chunk.warnings.push_back("f con menos de 3 vrtices: " + std::string(face.line));
+        continue;
+      }
+      pushCounted_(chunk.faces, face, chunk.reallocs);
+    }
+    else if (tag == "usemtl") {
+      chunk.materialSwitches.push_back(ObjMaterialSwitch_{ chunk.faces.size(), restOfLine_(p, lineEnd) });
+    }
+    else if (tag == "mtllib") {
+      chunk.materialLibs.push_back(restOfLine_(p, lineEnd));
+    }
+    else if (tag == "o") {
+      if (chunk.objectName.empty()) chunk.objectName = restOfLine_(p, lineEnd);
+    }
+    else if (tag == "g" || tag == "s") {
+      // Los grupos y el suavizado no cambian la malla; los rangos se arman por material.
+    }
+  }
+}
+
+// Parte [data, data + size) en 'count' bloques que terminan justo despus de un '\n'.
+static std::vector<ObjChunk_> splitChunks_(const char* data, size_t size, unsigned int count) {
+  std::vector<ObjChunk_> chunks(count);
+  const char* const fileEnd = data + size;
+  const char* begin = data;
+
+  for (unsigned int i = 0; i < count; ++i) {
+    const char* end = fileEnd;
+    if (i + 1 < count) {
+      end = data + (size / count) * (i + 1);
+      if (end < begin) end = begin;
+      const char* newline = static_cast<const char*>(std::memchr(end, '\n', static_cast<size_t>(fileEnd - end)));
+      end = newline ? newline + 1 : fileEnd;
+    }
+    chunks[i].begin = begin;
+    chunks[i].end = end;
+    begin = end;
+  }
+  return chunks;
+}
+
+// ---------------------------------------------------------------------------
+// Cache de vrtices con clave entera.
+// La clave es la tripleta (v, vt, vn) ya parseada, guardada como ndice + 1
+// para que 0 signifique "no viene". As "1/2/3" y "01/2/3" son el mismo vrtice
+// y no se crea ni se hashea un string por esquina.
+// ---------------------------------------------------------------------------
+
+// Clave de 96 bits para mallas con 2^21 o ms v/vt/vn.
+struct ObjKey96_ {
+  uint32_t v, t, n;
+};
+
+static inline bool operator==(const ObjKey96_& a, const ObjKey96_& b) {
+  return a.v == b.v && a.t == b.t && a.n == b.n;
+}
+
+// Cuando los tres conteos caben en 21 bits la clave cabe en un uint64.
+static const unsigned int kKeyFieldBits_ = 21;
+
+static inline uint64_t makeKey_(uint64_t*, uint32_t v, uint32_t t, uint32_t n) {
+  return (uint64_t(v) << (2 * kKeyFieldBits_)) | (uint64_t(t) << kKeyFieldBits_) | uint64_t(n);
+}
+
+static inline ObjKey96_ makeKey_(ObjKey96_*, uint32_t v, uint32_t t, uint32_t n) {
+  return ObjKey96_{ v, t, n };
+}
+
+// v nunca es 0 en una clave guardada (solo entran posiciones vlidas),
+// por eso una clave con v == 0 marca una casilla vaca.
+static inline bool isEmptyKey_(uint64_t key) { return key == 0; }
+static inline bool isEmptyKey_(const ObjKey96_& key) { return key.v == 0; }
+
+// Mezcla de bits tipo murmur3 para repartir bien claves muy parecidas.
+static inline size_t hashKey_(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  return static_cast<size_t>(key);
+}
+
+static inline size_t hashKey_(const ObjKey96_& key) {
+  return hashKey_((uint64_t(key.v) << 32 | key.t) ^ (uint64_t(key.n) * 0x9E3779B97F4A7C15ULL));
+}
+
+// Tabla de direccionamiento abierto (sondeo lineal) de clave -> ndice de vrtice.
+// Se crea con capacidad para 'expected' vrtices y solo crece si se queda corta.
+template<typename Key>
+class ObjVertexCache_ {
+public:
+  explicit ObjVertexCache_(size_t expected) {
+    size_t capacity = 64;
+    while (capacity < expected * 2) capacity <<= 1;
+    m_slots.resize(capacity);
+    m_mask = capacity - 1;
+  }
+
+  // Busca 'key'. Si no est la inserta con 'value' y pone isNew en true.
+  // Devuelve el ndice de vrtice guardado para esa clave.
+  unsigned int findOrAdd(const Key& key, unsigned int value, bool& isNew) {
+    size_t i = hashKey_(key) & m_mask;
+    while (!isEmptyKey_(m_slots[i].key)) {
+      if (m_slots[i].key == key) {
+        isNew = false;
+        return m_slots[i].value;
+      }
+      i = (i + 1) & m_mask;
+    }
+
+    m_slots[i].key = key;
+    m_slots[i].value = value;
+    isNew = true;
+    if (++m_count * 2 > m_slots.size()) grow_();
+    return value;
+  }
+
+  // Vaca la tabla sin soltar su memoria (para reutilizarla en otro lote).
+  void clear() {
+    if (m_count == 0) return;
+    std::fill(m_slots.begin(), m_slots.end(), Slot());
+    m_count = 0;
+  }
+
+  // Bytes que ocupa la tabla.
+  size_t memoryBytes() const { return m_slots.capacity() * sizeof(Slot); }
+
+  // Veces que la tabla tuvo que crecer desde que se cre.
+  size_t growCount() const { return m_grows; }
+
+private:
+  struct Slot {
+    Key key{};
+    unsigned int value = 0;
+  };
+
+  // Duplica la tabla y reinserta todo; mantiene la carga por debajo de 1/2.
+  void grow_() {
+    std::vector<Slot> old(m_slots.size() * 2);
+    old.swap(m_slots);
+    ++m_grows;
+    m_mask = m_slots.size() - 1;
+    for (const Slot& slot : old) {
+      if (isEmptyKey_(slot.key)) continue;
+      size_t i = hashKey_(slot.key) & m_mask;
+      while (!isEmptyKey_(m_slots[i].key)) i = (i + 1) & m_mask;
+      m_slots[i] = slot;
+    }
+  }
+
+  std::vector<Slot> m_slots;
+  size_t m_mask = 0;
+  size_t m_count = 0;
+  size_t m_grows = 0;
+};
+
+// Conteos de todo el archivo, sacados de los bloques ya parseados.
+struct ObjTotals_ {
+  size_t positions = 0;
+  size_t texcoords = 0;
+  size_t normals = 0;
+  size_t corners = 0;
+};
+
+// ndices agrupados por material (usemtl), en el orden en que aparece cada
+// material en el archivo. Todos los grupos comparten el mismo vector de vrtices.
+struct ObjMaterialGroups_ {
+  std::vector<std::string> names;
+  std::vector<std::vector<unsigned int>> indices;
+  size_t firstReserve = 0;   // Reserva para el primer grupo (el nico si no hay usemtl).
+
+  // Devuelve el grupo de 'name' y lo crea si es nuevo. Casi siempre hay
+  // pocos materiales, as que una bsqueda lineal basta.
+  size_t select(std::string_view name) {
+    for (size_t i = 0; i < names.size(); ++i) {
+      if (names[i] == name) return i;
+    }
+    names.emplace_back(name);
+    indices.emplace_back();
+    if (names.size() == 1) indices.back().reserve(firstReserve);
+    return names.size() - 1;
+  }
+};
+
+// Resuelve las caras de todos los bloques en orden de archivo y arma
+// vrtices e ndices por material. 'Key' es uint64_t u ObjKey96_ segn los conteos.
+template<typename Key>
+static void resolveFaces_(std::vector<ObjChunk_>& chunks,
+  const std::vector<XMFLOAT3>& positions,
+  const std::vector<XMFLOAT2>& texcoords,
+  const std::vector<unsigned int>& positionBase,
+  const std::vector<unsigned int>& texcoordBase,
+  const std::vector<unsigned int>& normalBase,
+  const ObjTotals_& totals,
+  std::vector<SimpleVertex>& verts,
+  ObjMaterialGroups_& groups,
+  size_t& reallocs,
+  void (*logWarn)(const std::string&))
+{
+  // Estimo los vrtices nicos como el mayor entre v y vt (las costuras de UV
+  // agregan algunos ms). Nunca puede haber ms que esquinas.
+  size_t expected = (totals.positions > totals.texcoords ? totals.positions : totals.texcoords);
+  expected += expected / 4;
+  if (expected > totals.corners) expected = totals.corners;
+  ObjVertexCache_<Key> vcache(expected);
+  verts.reserve(expected);
+
+  // Un vt que todava no existe da el mismo vrtice que no ponerlo (UV en 0),
+  // as que lo guardo como 0; igual con un vn fuera de rango. As la clave
+  // define por completo el vrtice y cada campo cabe en su conteo.
+  const int totalNormals = static_cast<int>(totals.normals);
+
+  // ndices de la cara actual. Se reutiliza entre caras para no reservar cada vez.
+  std::vector<unsigned int> local;
+  local.reserve(16);
+
+  // Material activo. El grupo se crea hasta que una cara lo usa, as no
+  // quedan rangos vacos por un usemtl sin caras.
+  std::string_view materialName;
+  const size_t kNoGroup = ~size_t(0);
+  size_t group = kNoGroup;
+
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    ObjChunk_& chunk = chunks[c];
+    for (const std::string& warning : chunk.warnings) logWarn(warning);
+
+    size_t nextSwitch = 0;
+    for (size_t f = 0; f < chunk.faces.size(); ++f) {
+      const ObjFace_& face = chunk.faces[f];
+
+      while (nextSwitch < chunk.materialSwitches.size() && chunk.materialSwitches[nextSwitch].firstFace <= f) {
+        materialName = chunk.materialSwitches[nextSwitch++].name;
+        group = kNoGroup;
+      }
+
+      // Solo son vlidas las posiciones/UVs que aparecieron antes de esta cara.
+      const int positionsSoFar = static_cast<int>(positionBase[c] + face.positionsBefore);
+      const int texcoordsSoFar = static_cast<int>(texcoordBase[c] + face.texcoordsBefore);
+      const size_t normalsSoFar = normalBase[c] + face.normalsBefore;
+
+      local.clear();
+      for (unsigned int k = 0; k < face.cornerCount; ++k) {
+        ObjCorner_ corner = chunk.corners[face.firstCorner + k];
+        corner.vi = resolveIndex_(corner.vi, size_t(positionsSoFar));
+        corner.ti = resolveIndex_(corner.ti, size_t(texcoordsSoFar));
+        corner.ni = resolveIndex_(corner.ni, normalsSoFar);
+
+        // Una posicin que ya estaba en el cache fue vlida antes, as que
+        // sigue sindolo; puedo revisar el rango antes de buscar.
+        if (corner.vi < 0 || corner.vi >= positionsSoFar) {
+          logWarn("ndice v fuera de rango: " + std::to_string(corner.vi + 1) + "   << " + std::string(face.line));
+          continue;
+        }
+
+        const bool hasTexcoord = (corner.ti >= 0 && corner.ti < texcoordsSoFar);
+        const uint32_t t = hasTexcoord ? uint32_t(corner.ti + 1) : 0u;
+        const uint32_t n = (corner.ni >= 0 && corner.ni < totalNormals) ? uint32_t(corner.ni + 1) : 0u;
+        const Key key = makeKey_(static_cast<Key*>(nullptr), uint32_t(corner.vi + 1), t, n);
+
+        bool isNew = false;
+        const unsigned int idx = vcache.findOrAdd(key, static_cast<unsigned int>(verts.size()), isNew);
+        if (isNew) {
+          SimpleVertex sv{};
+          sv.Pos = positions[corner.vi];
+          sv.Tex = hasTexcoord ? texcoords[corner.ti] : XMFLOAT2(0.f, 0.f);
+          pushCounted_(verts, sv, reallocs);
+        }
+        local.push_back(idx);
+      }
+
+      if (local.size() < 3) continue;
+
+      if (group == kNoGroup) group = groups.select(materialName);
+      std::vector<unsigned int>& indices = groups.indices[group];
+
+      // Triangulacin en "fan", igual que en loadLegacy.
+      for (unsigned int i = 1; i + 1 < local.size(); ++i) {
+        pushCounted_(indices, local[0], reallocs);
+        pushCounted_(indices, local[i], reallocs);
+        pushCounted_(indices, local[i + 1], reallocs);
+      }
+    }
+
+    // Un usemtl despus de la ltima cara del bloque sigue activo en el siguiente.
+    for (; nextSwitch < chunk.materialSwitches.size(); ++nextSwitch) {
+      materialName = chunk.materialSwitches[nextSwitch].name;
+      group = kNoGroup;
+    }
+
+    // Ya no necesito las esquinas de este bloque; libero memoria mientras avanzo.
+    std::vector<ObjCorner_>().swap(chunk.corners);
+    std::vector<ObjFace_>().swap(chunk.faces);
+  }
+
+  reallocs += vcache.growCount();
+}
+
+// Camino rpido: mapea el .obj a memoria y lo parsea por bloques (en paralelo
+// si setThreadCount lo permite). Despus mezcla los bloques en orden de archivo,
+// as la malla es la misma sin importar los hilos. A diferencia de loadLegacy,
+// el cache compara los ndices ya parseados y no el texto de la tupla.
+bool ObjReader::load(const std::string& path, MeshComponent& outMesh, bool flipV) {
+  const auto startTime = std::chrono::steady_clock::now();
+  m_lastStats = ObjLoadStats();
+
+  outMesh.m_vertex.clear();
+  outMesh.m_index.clear();
+  outMesh.m_subMeshes.clear();
+
+  const std::string filePath = endsWithObj_(path) ? path : (path + ".obj");
+
+  MappedFile file;
+  if (!file.open(filePath)) {
+    logWarn_("No se pudo abrir: " + filePath);
+    return false;
+  }
+  m_lastStats.bytes = file.size();
+
+  // Nmero de hilos: 0 significa "todos los ncleos". Nunca uso ms bloques
+  // de los que justifican el tamao del archivo.
+  unsigned int threads = (m_threadCount == 0) ? std::thread::hardware_concurrency() : m_threadCount;
+  if (threads == 0) threads = 1;
+  const size_t maxChunks = file.size() / kMinChunkBytes_ + 1;
+  if (threads > maxChunks) threads = static_cast<unsigned int>(maxChunks);
+  m_lastStats.threads = threads;
+
+  // 1) Parseo de bloques. Cada hilo toma el siguiente bloque libre.
+  std::vector<ObjChunk_> chunks = splitChunks_(file.data(), file.size(), threads);
+
+  if (threads == 1) {
+    parseChunk_(chunks[0], flipV, m_preScan);
+  }
+  else {
+    std::atomic<unsigned int> nextChunk(0);
+    const bool preScan = m_preScan;
+    auto worker = [&chunks, &nextChunk, flipV, preScan]() {
+      for (unsigned int c = nextChunk++; c < chunks.size(); c = nextChunk++) {
+        parseChunk_(chunks[c], flipV, preScan);
+      }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned int t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+  }
+
+  // 2) Mezcla determinista: junto posiciones y UVs en orden de archivo.
+  // Los conteos de los bloques sirven para dimensionar todo.
+  std::vector<XMFLOAT3> positions;
+  std::vector<XMFLOAT2> texcoords;
+  std::vector<unsigned int> positionBase(chunks.size());
+  std::vector<unsigned int> texcoordBase(chunks.size());
+  std::vector<unsigned int> normalBase(chunks.size());
+  ObjTotals_ totals;
+  size_t totalIndices = 0;
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    m_lastStats.preScanSeconds += chunks[c].preScanSeconds;
+    m_lastStats.reallocations += chunks[c].reallocs;
+    totalIndices += chunks[c].counts.indices;
+    positionBase[c] = static_cast<unsigned int>(totals.positions);
+    texcoordBase[c] = static_cast<unsigned int>(totals.texcoords);
+    normalBase[c] = static_cast<unsigned int>(totals.normals);
+    totals.positions += chunks[c].positions.size();
+    totals.texcoords += chunks[c].texcoords.size();
+    totals.normals += chunks[c].normals;
+    totals.corners += chunks[c].corners.size();
+  }
+  positions.reserve(totals.positions);
+  texcoords.reserve(totals.texcoords);
+  for (ObjChunk_& chunk : chunks) {
+    positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+    texcoords.insert(texcoords.end(), chunk.texcoords.begin(), chunk.texcoords.end());
+    std::vector<XMFLOAT3>().swap(chunk.positions);
+    std::vector<XMFLOAT2>().swap(chunk.texcoords);
+  }
+
+  // 3) Resuelvo las caras en orden con el cache de vrtices.
+  std::vector<SimpleVertex> verts;
+  ObjMaterialGroups_ groups;
+
+  // Sin usemtl todo cae en un solo grupo. Con el pre-escaneo s exactamente
+  // cuntos ndices salen del "fan"; con varios materiales cada grupo crece solo.
+  bool hasMaterials = false;
+  for (const ObjChunk_& chunk : chunks) hasMaterials = hasMaterials || !chunk.materialSwitches.empty();
+  if (!hasMaterials)
+    groups.firstReserve = m_preScan ? totalIndices : (totals.corners > 4096 ? totals.corners : 4096);
+
+  // Si v, vt y vn caben en 21 bits cada uno, la clave es un solo uint64.
+  const size_t kKeyFieldMax = (size_t(1) << kKeyFieldBits_) - 1;
+  if (totals.positions <= kKeyFieldMax && totals.texcoords <= kKeyFieldMax && totals.normals <= kKeyFieldMax)
+    resolveFaces_<uint64_t>(chunks, positions, texcoords, positionBase, texcoordBase, normalBase, totals, verts, groups, m_lastStats.reallocations, &ObjReader::logWarn_);
+  else
+    resolveFaces_<ObjKey96_>(chunks, positions, texcoords, positionBase, texcoordBase, normalBase, totals, verts, groups, m_lastStats.reallocations, &ObjReader::logWarn_);
+
+  // 4) Junto los grupos en un solo buffer de ndices: cada material queda
+  // en un rango contiguo, en el orden en que apareci en el archivo.
+  std::vector<unsigned int> indices;
+  if (groups.indices.size() == 1) {
+    indices = std::move(groups.indices[0]);
+  }
+  else {
+    size_t total = 0;
+    for (const auto& group : groups.indices) total += group.size();
+    indices.reserve(total);
+  }
+
+  for (size_t g = 0; g < groups.names.size(); ++g) {
+    SubMesh subMesh;
+    subMesh.materialName = groups.names[g];
+    if (groups.indices.size() == 1) {
+      subMesh.startIndex = 0;
+      subMesh.indexCount = static_cast<unsigned int>(indices.size());
+    }
+    else {
+      subMesh.startIndex = static_cast<unsigned int>(indices.size());
+      subMesh.indexCount = static_cast<unsigned int>(groups.indices[g].size());
+      indices.insert(indices.end(), groups.indices[g].begin(), groups.indices[g].end());
+      std::vector<unsigned int>().swap(groups.indices[g]);
+    }
+    outMesh.m_subMeshes.push_back(subMesh);
+  }
+
+  // 5) Texturas de los materiales: leo cada mtllib (relativo al .obj) y
+  // guardo el map_Kd de cada material que usa la malla.
+  const size_t slash = filePath.find_last_of("/\\");
+  const std::string folder = (slash == std::string::npos) ? std::string() : filePath.substr(0, slash + 1);
+
+  std::unordered_map<std::string, std::string> diffuseMaps;
+  std::vector<std::string> libsRead;
+  for (const ObjChunk_& chunk : chunks) {
+    for (std::string_view lib : chunk.materialLibs) {
+      const std::string libPath = folder + std::string(lib);
+      if (std::find(libsRead.begin(), libsRead.end(), libPath) != libsRead.end()) continue;
+      libsRead.push_back(libPath);
+      if (!loadMtl_(libPath, folder, diffuseMaps)) logWarn_("No se pudo abrir el mtllib: " + libPath);
+    }
+  }
+  for (SubMesh& subMesh : outMesh.m_subMeshes) {
+    auto it = diffuseMaps.find(subMesh.materialName);
+    if (it != diffuseMaps.end()) subMesh.texturePath = it->second;
+  }
+
+  // El primer "o" del archivo le da nombre a la malla si todava no tiene.
+  for (const ObjChunk_& chunk : chunks) {
+    if (!chunk.objectName.empty()) {
+      if (outMesh.m_name.empty()) outMesh.m_name = std::string(chunk.objectName);
+      break;
+    }
+  }
+
+  outMesh.m_vertex = std::move(verts);
+  outMesh.m_index = std::move(indices);
+  outMesh.m_numVertex = static_cast<int>(outMesh.m_vertex.size());
+  outMesh.m_numIndex = static_cast<int>(outMesh.m_index.size());
+
+  m_lastStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+  return (outMesh.m_numVertex > 0 && outMesh.m_numIndex > 0);
+}
+
+// Lee un .mtl y guarda el map_Kd (textura difusa) de cada newmtl.
+// Las rutas de las texturas se dejan relativas a 'folder', igual que el .obj.
+bool ObjReader::loadMtl_(const std::string& path, const std::string& folder,
+  std::unordered_map<std::string, std::string>& diffuseMaps)
+{
+  MappedFile file;
+  if (!file.open(path)) return false;
+
+  const char* cursor = file.data();
+  const char* const fileEnd = file.data() + file.size();
+  std::string current;
+
+  while (cursor < fileEnd) {
+    const char* lineBegin = cursor;
+    const char* lineEnd = findNewline_(cursor, fileEnd);
+    cursor = (lineEnd < fileEnd) ? lineEnd + 1 : fileEnd;
+
+    const char* p = skipBlanks_(lineBegin, lineEnd);
+    if (p >= lineEnd || *p == '#') continue;
+
+    const char* tagEnd = skipToken_(p, lineEnd);
+    const std::string_view tag(p, static_cast<size_t>(tagEnd - p));
+
+    if (tag == "newmtl") {
+      current = std::string(restOfLine_(tagEnd, lineEnd));
+    }
+    else if (tag == "map_Kd" && !current.empty()) {
+      // map_Kd puede traer opciones antes del archivo ("-s 1 1 1 tex.png");
+      // en ese caso el archivo es el ltimo token de la lnea.
+      std::string_view texture = restOfLine_(tagEnd, lineEnd);
+      if (!texture.empty() && texture[0] == '-') {
+        const size_t lastBlank = texture.find_last_of(" \t");
+        if (lastBlank != std::string_view::npos) texture = texture.substr(lastBlank + 1);
+      }
+      if (!texture.empty() && diffuseMaps.find(current) == diffuseMaps.end()) {
+        diffuseMaps.emplace(current, folder + std::string(texture));
+      }
+    }
+  }
+  return true;
+}
+
+// Capacidad en bytes de un vector; sirve para medir el working set del streaming.
+template<typename T>
+static inline size_t capacityBytes_(const std::vector<T>& v) {
+  return v.capacity() * sizeof(T);
+}
+
+// Cada cunto loadStreaming suelta las pginas del archivo que ya recorri.
+static const size_t kStreamWindowBytes_ = 4u << 20;
+
+// Carga en streaming: una sola pasada por el archivo mapeado. Los vrtices
+// se deduplican solo dentro del lote y el cache se vaca en cada entrega,
+// as la memoria propia queda acotada por el tamao del lote (ms v/vt).
+// Del archivo solo quedan residentes los ltimos kStreamWindowBytes_.
+bool ObjReader::loadStreaming(const std::string& path, IObjBatchSink& sink,
+  size_t maxTrianglesPerBatch, bool flipV)
+{
+  const auto startTime = std::chrono::steady_clock::now();
+  m_lastStats = ObjLoadStats();
+
+  if (maxTrianglesPerBatch == 0) maxTrianglesPerBatch = 1;
+
+  const std::string filePath = endsWithObj_(path) ? path : (path + ".obj");
+
+  MappedFile file;
+  if (!file.open(filePath)) {
+    logWarn_("No se pudo abrir: " + filePath);
+    return false;
+  }
+  m_lastStats.bytes = file.size();
+
+  std::vector<XMFLOAT3> positions;
+  std::vector<XMFLOAT2> texcoords;
+  size_t normals = 0;
+
+  // Las v y vt se quedan en memoria todo el tiempo; con el pre-escaneo
+  // se reservan una sola vez en lugar de ir duplicando. El pre-escaneo va
+  // por ventanas que terminan en salto de lnea y suelta cada una al acabar.
+  if (m_preScan) {
+    const auto scanStart = std::chrono::steady_clock::now();
+    ObjCounts_ counts;
+    size_t scanned = 0;
+    while (scanned < file.size()) {
+      size_t windowEnd = (std::min)(scanned + kStreamWindowBytes_, file.size());
+      const char* newline = static_cast<const char*>(std::memchr(file.data() + windowEnd - 1, '\n', file.size() - windowEnd + 1));
+      windowEnd = newline ? static_cast<size_t>(newline - file.data()) + 1 : file.size();
+      countObj_(file.data() + scanned, file.data() + windowEnd, counts);
+      file.release(scanned & ~(MappedFile::kReleaseAlign - 1), windowEnd - (scanned & ~(MappedFile::kReleaseAlign - 1)));
+      scanned = windowEnd;
+    }
+    positions.reserve(counts.positions);
+    texcoords.reserve(counts.texcoords);
+    m_lastStats.preScanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - scanStart).count();
+  }
+
+  // Datos del lote actual. Un lote nunca pasa de 3 vrtices por tringulo.
+  const size_t maxBatchIndices = maxTrianglesPerBatch * 3;
+  std::vector<SimpleVertex> batchVerts;
+  std::vector<unsigned int> batchIndices;
+  // Reservo de a poco: con lotes enormes y archivos chicos no quiero pedir
+  // de golpe memoria que nunca se va a usar. Despus crecen hasta el lote.
+  const size_t initialReserve = (std::min)(maxBatchIndices, size_t(1) << 16);
+  batchVerts.reserve(initialReserve);
+  batchIndices.reserve(initialReserve);
+
+  // En streaming no conozco los conteos finales, as que uso la clave de 96 bits.
+  ObjVertexCache_<ObjKey96_> vcache(initialReserve);
+
+  std::vector<ObjCorner_> corners;
+  std::vector<unsigned int> local;
+  corners.reserve(16);
+  local.reserve(16);
+
+  size_t triangles = 0;
+  bool cancelled = false;
+
+  auto trackPeak = [&]() {
+    const size_t bytes = capacityBytes_(positions) + capacityBytes_(texcoords) +
+      capacityBytes_(batchVerts) + capacityBytes_(batchIndices) +
+      capacityBytes_(corners) + capacityBytes_(local) + vcache.memoryBytes();
+    if (bytes > m_lastStats.peakWorkingSetBytes) m_lastStats.peakWorkingSetBytes = bytes;
+  };
+
+  // Entrega el lote actual y deja todo listo para el siguiente.
+  auto flush = [&]() -> bool {
+    if (batchIndices.empty()) return true;
+
+    ObjMeshBatch batch;
+    batch.vertices = batchVerts.data();
+    batch.vertexCount = batchVerts.size();
+    batch.indices = batchIndices.data();
+    batch.indexCount = batchIndices.size();
+    batch.batchIndex = m_lastStats.batches;
+    batch.firstTriangle = triangles;
+
+    trackPeak();
+    triangles += batchIndices.size() / 3;
+    ++m_lastStats.batches;
+
+    // 'batch' apunta a batchVerts y batchIndices: se vacan hasta que el sink termin
+    const bool keepGoing = sink.onBatch(batch);
+    batchVerts.clear();
+    batchIndices.clear();
+    vcache.clear();
+    return keepGoing;
+  };
+
+  const char* cursor = file.data();
+  const char* const fileEnd = file.data() + file.size();
+  size_t released = 0;   // Hasta dnde ya se soltaron las pginas del archivo.
+
+  while (cursor < fileEnd && !cancelled) {
+    const char* lineBegin = cursor;
+    const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(fileEnd - cursor)));
+    if (!lineEnd) lineEnd = fileEnd;
+    cursor = (lineEnd < fileEnd) ? lineEnd + 1 : fileEnd;
+
+    // Lo ya recorrido no se vuelve a leer (los vrtices se copian al lote)
+    const size_t consumed = static_cast<size_t>(lineBegin - file.data());
+    if (consumed - released >= kStreamWindowBytes_) {
+      file.release(released, consumed - released);
+      released = consumed & ~(MappedFile::kReleaseAlign - 1);
+    }
+
+    const char* p = skipBlanks_(lineBegin, lineEnd);
+    if (p >= lineEnd || *p == '#') continue;
+
+    const char* tagEnd = skipToken_(p, lineEnd);
+    const std::string_view tag(p, static_cast<size_t>(tagEnd - p));
+    p = tagEnd;
+
+    if (tag == "v") {
+      XMFLOAT3 v{};
+      if (parseFloat_(p, lineEnd, v.x) && parseFloat_(p, lineEnd, v.y) && parseFloat_(p, lineEnd, v.z))
+        pushCounted_(positions, v, m_lastStats.reallocations);
+      else
+        logWarn_("v mal formada: " + std::string(lineBegin, lineEnd));
+    }
+    else if (tag == "vt") {
+      XMFLOAT2 t{};
+      if (parseFloat_(p, lineEnd, t.x) && parseFloat_(p, lineEnd, t.y)) {
+        if (flipV) t.y = 1.0f - t.y;
+        pushCounted_(texcoords, t, m_lastStats.reallocations);
+      }
+      else {
+        logWarn_("vt mal formada: " + std::string(lineBegin, lineEnd));
+      }
+    }
+    else if (tag == "vn") {
+      ++normals;
+    }
+    else if (tag == "f") {
+      corners.clear();
+      p = skipBlanks_(p, lineEnd);
+      while (p < lineEnd) {
+        const char* keyEnd = skipToken_(p, lineEnd);
+        ObjCorner_ corner{};
+        parseTupleView_(p, keyEnd, corner.vi, corner.ti, corner.ni);
+        corners.push_back(corner);
+        p = skipBlanks_(keyEnd, lineEnd);
+      }
+
+      if (corners.size() < 3) {
+        logWarn_("f con menos de 3 vrtices: " + std::string(lineBegin, lineEnd));
+        continue;
+      }
+
+      // Si la cara ya no cabe en el lote, entrego el lote antes de agregarla.
+      // Una cara ms grande que un lote completo sale sola en su propio lote.
+      const size_t faceIndices = (corners.size() - 2) * 3;
+      if (!batchIndices.empty() && batchIndices.size() + faceIndices > maxBatchIndices) {
+        if (!flush()) {
+          cancelled = true;
+          break;
+        }
+      }
+
+      const int positionsSoFar = static_cast<int>(positions.size());
+      const int texcoordsSoFar = static_cast<int>(texcoords.size());
+      const int normalsSoFar = static_cast<int>(normals);
+
+      local.clear();
+      for (ObjCorner_ corner : corners) {
+        corner.vi = resolveIndex_(corner.vi, positions.size());
+        corner.ti = resolveIndex_(corner.ti, texcoords.size());
+        corner.ni = resolveIndex_(corner.ni, normals);
+        if (corner.vi < 0 || corner.vi >= positionsSoFar) {
+          logWarn_("ndice v fuera de rango: " + std::to_string(corner.vi + 1) + "   << " + std::string(lineBegin, lineEnd));
+          continue;
+        }
+
+        const bool hasTexcoord = (corner.ti >= 0 && corner.ti < texcoordsSoFar);
+        const uint32_t t = hasTexcoord ? uint32_t(corner.ti + 1) : 0u;
+        const uint32_t n = (corner.ni >= 0 && corner.ni < normalsSoFar) ? uint32_t(corner.ni + 1) : 0u;
+
+        bool isNew = false;
+        const unsigned int idx = vcache.findOrAdd(ObjKey96_{ uint32_t(corner.vi + 1), t, n },
+          static_cast<unsigned int>(batchVerts.size()), isNew);
+        if (isNew) {
+          SimpleVertex sv{};
+          sv.Pos = positions[corner.vi];
+          sv.Tex = hasTexcoord ? texcoords[corner.ti] : XMFLOAT2(0.f, 0.f);
+          batchVerts.push_back(sv);
+        }
+        local.push_back(idx);
+      }
+
+      for (unsigned int i = 1; i + 1 < local.size(); ++i) {
+        batchIndices.push_back(local[0]);
+        batchIndices.push_back(local[i]);
+        batchIndices.push_back(local[i + 1]);
+      }
+    }
+  }
+
+  if (!cancelled && !flush()) cancelled = true;
+  trackPeak();
+
+  m_lastStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+  if (cancelled) {
+    logWarn_("Carga en streaming cancelada: " + filePath);
+    return false;
+  }
+  return triangles > 0;
+}
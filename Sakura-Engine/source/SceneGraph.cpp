@@ -0,0 +1,389 @@
+#include "SceneGraph.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define SCENE_GRAPH_SSE 1
+#endif
+
+const uint32_t SceneGraph::kInvalidNode;
+
+// Con menos nodos marcados que esto no vale la pena repartir entre hilos.
+static const size_t kMinParallelNodes_ = 8192;
+// Tamao mnimo de un rango al partir subrboles grandes.
+static const size_t kMinTaskNodes_ = 1024;
+
+static const float kIdentity_[16] = {
+  1.0f, 0.0f, 0.0f, 0.0f,
+  0.0f, 1.0f, 0.0f, 0.0f,
+  0.0f, 0.0f, 1.0f, 0.0f,
+  0.0f, 0.0f, 0.0f, 1.0f
+};
+
+// out = a * b (matrices por renglones, vectores fila). 'out' no puede ser 'b'.
+static inline void
+multiply_(const float* a, const float* b, float* out) {
+#ifdef SCENE_GRAPH_SSE
+  const __m128 b0 = _mm_loadu_ps(b);
+  const __m128 b1 = _mm_loadu_ps(b + 4);
+  const __m128 b2 = _mm_loadu_ps(b + 8);
+  const __m128 b3 = _mm_loadu_ps(b + 12);
+  for (int r = 0; r < 4; ++r) {
+    const float* row = a + r * 4;
+    __m128 sum = _mm_mul_ps(_mm_set1_ps(row[0]), b0);
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(row[1]), b1));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(row[2]), b2));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(row[3]), b3));
+    _mm_storeu_ps(out + r * 4, sum);
+  }
+#else
+  for (int r = 0; r < 4; ++r) {
+    for (int c = 0; c < 4; ++c) {
+      out[r * 4 + c] = a[r * 4 + 0] * b[0 * 4 + c] + a[r * 4 + 1] * b[1 * 4 + c] +
+        a[r * 4 + 2] * b[2 * 4 + c] + a[r * 4 + 3] * b[3 * 4 + c];
+    }
+  }
+#endif
+}
+
+uint32_t
+SceneGraph::create(uint32_t parent) {
+  uint32_t node;
+  if (!m_freeNodes.empty()) {
+    node = m_freeNodes.back();
+    m_freeNodes.pop_back();
+  }
+  else {
+    node = static_cast<uint32_t>(m_slotOf.size());
+    m_slotOf.push_back(kInvalidNode);
+    m_parentOf.push_back(kInvalidNode);
+    m_firstChild.push_back(kInvalidNode);
+    m_lastChild.push_back(kInvalidNode);
+    m_nextSibling.push_back(kInvalidNode);
+    m_prevSibling.push_back(kInvalidNode);
+    m_isDirty.push_back(0);
+    m_userData.push_back(nullptr);
+  }
+
+  // Va al final de los arreglos por slot; rebuild lo pone en su lugar
+  const uint32_t slot = static_cast<uint32_t>(m_nodeOfSlot.size());
+  m_slotOf[node] = slot;
+  m_firstChild[node] = kInvalidNode;
+  m_lastChild[node] = kInvalidNode;
+  m_isDirty[node] = 0;
+  m_userData[node] = nullptr;
+  m_nodeOfSlot.push_back(node);
+  m_parentSlot.push_back(kInvalidNode);
+  m_subtreeSize.push_back(1);
+  m_local.insert(m_local.end(), kIdentity_, kIdentity_ + 16);
+  m_world.insert(m_world.end(), kIdentity_, kIdentity_ + 16);
+  m_worldVersion.push_back(m_version);
+
+  link(node, isValid(parent) ? parent : kInvalidNode);
+  m_orderDirty = true;
+  markDirty(node);
+  return node;
+}
+
+void
+SceneGraph::destroy(uint32_t node) {
+  if (!isValid(node)) return;
+
+  // Los hijos pasan al padre del nodo, en el mismo orden
+  const uint32_t parent = m_parentOf[node];
+  uint32_t child = m_firstChild[node];
+  while (child != kInvalidNode) {
+    const uint32_t next = m_nextSibling[child];
+    unlink(child);
+    link(child, parent);
+    markDirty(child);
+    child = next;
+  }
+  unlink(node);
+
+  // Llena el hueco con el ltimo slot
+  const uint32_t slot = m_slotOf[node];
+  const uint32_t last = static_cast<uint32_t>(m_nodeOfSlot.size() - 1);
+  if (slot != last) {
+    const uint32_t moved = m_nodeOfSlot[last];
+    m_nodeOfSlot[slot] = moved;
+    m_parentSlot[slot] = m_parentSlot[last];
+    m_subtreeSize[slot] = m_subtreeSize[last];
+    std::memcpy(&m_local[size_t(slot) * 16], &m_local[size_t(last) * 16], 16 * sizeof(float));
+    std::memcpy(&m_world[size_t(slot) * 16], &m_world[size_t(last) * 16], 16 * sizeof(float));
+    m_worldVersion[slot] = m_worldVersion[last];
+    m_slotOf[moved] = slot;
+  }
+  m_nodeOfSlot.pop_back();
+  m_parentSlot.pop_back();
+  m_subtreeSize.pop_back();
+  m_local.resize(m_local.size() - 16);
+  m_world.resize(m_world.size() - 16);
+  m_worldVersion.pop_back();
+
+  m_slotOf[node] = kInvalidNode;
+  m_isDirty[node] = 0;
+  m_userData[node] = nullptr;
+  m_freeNodes.push_back(node);
+  m_orderDirty = true;
+  // Los slots se movieron: los rangos del ltimo update ya no sirven
+  m_updatedRanges.clear();
+}
+
+void
+SceneGraph::setParent(uint32_t node, uint32_t parent) {
+  if (!isValid(node)) return;
+  if (!isValid(parent)) parent = kInvalidNode;
+  if (m_parentOf[node] == parent) return;
+
+  // No se puede colgar un nodo de s mismo ni de un descendiente
+  for (uint32_t ancestor = parent; ancestor != kInvalidNode; ancestor = m_parentOf[ancestor]) {
+    if (ancestor == node) return;
+  }
+
+  unlink(node);
+  link(node, parent);
+  m_orderDirty = true;
+  markDirty(node);
+}
+
+void
+SceneGraph::setLocal(uint32_t node, const float matrix[16]) {
+  if (!isValid(node)) return;
+  std::memcpy(&m_local[size_t(m_slotOf[node]) * 16], matrix, 16 * sizeof(float));
+  markDirty(node);
+}
+
+void
+SceneGraph::setLocals(const uint32_t* nodes, const float* matrices, size_t count) {
+  // Cada nodo tiene su propio slot, as que copiar no necesita candado
+  for (size_t i = 0; i < count; ++i) {
+    if (isValid(nodes[i])) {
+      std::memcpy(&m_local[size_t(m_slotOf[nodes[i]]) * 16], matrices + i * 16, 16 * sizeof(float));
+    }
+  }
+  std::lock_guard<std::mutex> lock(m_dirtyMutex);
+  for (size_t i = 0; i < count; ++i) {
+    if (isValid(nodes[i])) markDirty(nodes[i]);
+  }
+}
+
+void
+SceneGraph::unlink(uint32_t node) {
+  const uint32_t parent = m_parentOf[node];
+  const uint32_t prev = m_prevSibling[node];
+  const uint32_t next = m_nextSibling[node];
+  uint32_t& first = parent != kInvalidNode ? m_firstChild[parent] : m_firstRoot;
+  uint32_t& last = parent != kInvalidNode ? m_lastChild[parent] : m_lastRoot;
+  if (prev != kInvalidNode) m_nextSibling[prev] = next;
+  else first = next;
+  if (next != kInvalidNode) m_prevSibling[next] = prev;
+  else last = prev;
+  m_parentOf[node] = kInvalidNode;
+  m_prevSibling[node] = kInvalidNode;
+  m_nextSibling[node] = kInvalidNode;
+}
+
+void
+SceneGraph::link(uint32_t node, uint32_t parent) {
+  uint32_t& first = parent != kInvalidNode ? m_firstChild[parent] : m_firstRoot;
+  uint32_t& last = parent != kInvalidNode ? m_lastChild[parent] : m_lastRoot;
+  m_parentOf[node] = parent;
+  m_prevSibling[node] = last;
+  m_nextSibling[node] = kInvalidNode;
+  if (last != kInvalidNode) m_nextSibling[last] = node;
+  else first = node;
+  last = node;
+}
+
+void
+SceneGraph::markDirty(uint32_t node) {
+  if (m_isDirty[node]) return;
+  m_isDirty[node] = 1;
+  m_dirtyNodes.push_back(node);
+}
+
+void
+SceneGraph::rebuild() {
+  const size_t count = m_nodeOfSlot.size();
+  std::vector<uint32_t> order;
+  order.reserve(count);
+
+  // Recorrido en profundidad sin pila: primer hijo, si no el siguiente
+  // hermano, si no subir hasta encontrar uno
+  for (uint32_t root = m_firstRoot; root != kInvalidNode; root = m_nextSibling[root]) {
+    uint32_t node = root;
+    for (;;) {
+      order.push_back(node);
+      if (m_firstChild[node] != kInvalidNode) {
+        node = m_firstChild[node];
+        continue;
+      }
+      while (node != root && m_nextSibling[node] == kInvalidNode) node = m_parentOf[node];
+      if (node == root) break;
+      node = m_nextSibling[node];
+    }
+  }
+
+  std::vector<uint32_t> parentSlot(count);
+  std::vector<uint32_t> subtreeSize(count, 1);
+  std::vector<float> local(count * 16);
+  std::vector<float> world(count * 16);
+  std::vector<uint32_t> worldVersion(count);
+  for (size_t slot = 0; slot < count; ++slot) {
+    const uint32_t node = order[slot];
+    const uint32_t oldSlot = m_slotOf[node];
+    std::memcpy(&local[slot * 16], &m_local[size_t(oldSlot) * 16], 16 * sizeof(float));
+    std::memcpy(&world[slot * 16], &m_world[size_t(oldSlot) * 16], 16 * sizeof(float));
+    worldVersion[slot] = m_worldVersion[oldSlot];
+  }
+  for (size_t slot = 0; slot < count; ++slot) {
+    m_slotOf[order[slot]] = static_cast<uint32_t>(slot);
+  }
+  // El padre ya tiene su slot nuevo porque va antes que sus hijos
+  for (size_t slot = 0; slot < count; ++slot) {
+    const uint32_t parent = m_parentOf[order[slot]];
+    parentSlot[slot] = parent != kInvalidNode ? m_slotOf[parent] : kInvalidNode;
+  }
+  for (size_t slot = count; slot-- > 0;) {
+    if (parentSlot[slot] != kInvalidNode) subtreeSize[parentSlot[slot]] += subtreeSize[slot];
+  }
+
+  m_nodeOfSlot.swap(order);
+  m_parentSlot.swap(parentSlot);
+  m_subtreeSize.swap(subtreeSize);
+  m_local.swap(local);
+  m_world.swap(world);
+  m_worldVersion.swap(worldVersion);
+  m_orderDirty = false;
+}
+
+void
+SceneGraph::propagate(uint32_t begin, uint32_t end) {
+  const float* local = m_local.data();
+  float* world = m_world.data();
+  for (uint32_t slot = begin; slot < end; ++slot) {
+    const uint32_t parent = m_parentSlot[slot];
+    if (parent == kInvalidNode) {
+      std::memcpy(world + size_t(slot) * 16, local + size_t(slot) * 16, 16 * sizeof(float));
+    }
+    else {
+      multiply_(local + size_t(slot) * 16, world + size_t(parent) * 16, world + size_t(slot) * 16);
+    }
+    m_worldVersion[slot] = m_version;
+  }
+}
+
+void
+SceneGraph::update(unsigned int threadCount) {
+  updateWith(threadCount, nullptr);
+}
+
+void
+SceneGraph::update(unsigned int threadCount, const ParallelFor& parallelFor) {
+  updateWith(threadCount, &parallelFor);
+}
+
+void
+SceneGraph::updateWith(unsigned int threadCount, const ParallelFor* parallelFor) {
+  const auto startTime = std::chrono::steady_clock::now();
+  m_lastStats = SceneGraphStats();
+  m_lastStats.nodes = m_nodeOfSlot.size();
+  m_updatedRanges.clear();
+
+  if (m_orderDirty) {
+    rebuild();
+    m_lastStats.rebuilt = true;
+  }
+
+  // Slots marcados, en orden; se descartan los que quedan dentro del
+  // subrbol de otro marcado (ya se recalculan con l)
+  std::vector<uint32_t> dirtySlots;
+  dirtySlots.reserve(m_dirtyNodes.size());
+  for (uint32_t node : m_dirtyNodes) {
+    if (isValid(node) && m_isDirty[node]) dirtySlots.push_back(m_slotOf[node]);
+    m_isDirty[node] = 0;
+  }
+  m_dirtyNodes.clear();
+  std::sort(dirtySlots.begin(), dirtySlots.end());
+
+  std::vector<Range> ranges;
+  uint32_t coveredEnd = 0;
+  size_t nodeCount = 0;
+  for (uint32_t slot : dirtySlots) {
+    if (!ranges.empty() && slot < coveredEnd) continue;
+    coveredEnd = slot + m_subtreeSize[slot];
+    ranges.push_back({ slot, coveredEnd });
+    nodeCount += m_subtreeSize[slot];
+  }
+  m_lastStats.dirtyRoots = ranges.size();
+  m_lastStats.updatedNodes = nodeCount;
+  m_updatedRanges = ranges;
+
+  if (ranges.empty()) {
+    m_lastStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return;
+  }
+  ++m_version;
+
+  unsigned int threads = threadCount ? threadCount : std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+
+  if (threads <= 1 || nodeCount < kMinParallelNodes_) {
+    for (const Range& range : ranges) propagate(range.begin, range.end);
+    m_lastStats.tasks = ranges.size();
+    m_lastStats.threads = 1;
+  }
+  else {
+    /*
+     * Los rangos grandes se parten: se calcula aqu la raz del subrbol y
+     * cada hijo queda como un rango aparte (su padre ya est listo). Una
+     * cadena profunda sin ramas se queda casi toda en este hilo, pero no
+     * hay forma de repartirla.
+     */
+    const size_t taskSize = (std::max)(kMinTaskNodes_, nodeCount / (size_t(threads) * 4));
+    std::vector<Range> tasks;
+    while (!ranges.empty()) {
+      const Range range = ranges.back();
+      ranges.pop_back();
+      if (range.end - range.begin <= taskSize) {
+        tasks.push_back(range);
+        continue;
+      }
+      propagate(range.begin, range.begin + 1);
+      for (uint32_t child = range.begin + 1; child < range.end; child += m_subtreeSize[child]) {
+        ranges.push_back({ child, child + m_subtreeSize[child] });
+      }
+    }
+
+    const unsigned int poolSize = static_cast<unsigned int>(tasks.size() < threads ? tasks.size() : threads);
+    if (parallelFor) {
+      (*parallelFor)(tasks.size(), [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) propagate(tasks[t].begin, tasks[t].end);
+      });
+    }
+    else {
+      std::atomic<size_t> nextTask(0);
+      auto worker = [&]() {
+        for (size_t t = nextTask++; t < tasks.size(); t = nextTask++) {
+          propagate(tasks[t].begin, tasks[t].end);
+        }
+      };
+      std::vector<std::thread> pool;
+      if (poolSize > 1) pool.reserve(poolSize - 1);
+      for (unsigned int t = 1; t < poolSize; ++t) pool.emplace_back(worker);
+      worker();
+      for (auto& thread : pool) thread.join();
+    }
+
+    m_lastStats.tasks = tasks.size();
+    m_lastStats.threads = poolSize ? poolSize : 1;
+  }
+
+  m_lastStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
@@ -61,6 +61,16 @@ ShaderProgram::CreateInputLayout(Device& device,
 	}
 
 	HRESULT hr = m_inputLayout.init(device, Layout, m_vertexShaderData);
+
+	// Layouts de los formatos empacados; necesitan el bytecode del VS,
+	// por eso se crean aqu antes de liberarlo. Si fallan, las mallas se
+	// quedan en Full.
+	for (size_t f = 1; SUCCEEDED(hr) && f < static_cast<size_t>(VertexFormat::Count); ++f) {
+		std::vector<D3D11_INPUT_ELEMENT_DESC> packedLayout = InputLayout::describe(static_cast<VertexFormat>(f));
+		if (FAILED(m_packedLayouts[f].init(device, packedLayout, m_vertexShaderData))) {
+			ERROR("ShaderProgram", "CreateInputLayout", "Packed vertex format not supported by the vertex shader.");
+		}
+	}
 	SAFE_RELEASE(m_vertexShaderData);
 
 	if (FAILED(hr)) {
@@ -220,6 +230,24 @@ ShaderProgram::render(DeviceContext& deviceContext) {
 	deviceContext.m_deviceContext->PSSetShader(m_PixelShader, nullptr, 0);
 }
 
+bool
+ShaderProgram::supportsVertexFormat(VertexFormat format) const {
+	if (format == VertexFormat::Full) {
+		return m_inputLayout.m_inputLayout != nullptr;
+	}
+	const size_t index = static_cast<size_t>(format);
+	return index < static_cast<size_t>(VertexFormat::Count) && m_packedLayouts[index].m_inputLayout != nullptr;
+}
+
+void
+ShaderProgram::renderInputLayout(DeviceContext& deviceContext, VertexFormat format) {
+	if (format == VertexFormat::Full || !supportsVertexFormat(format)) {
+		m_inputLayout.render(deviceContext);
+		return;
+	}
+	m_packedLayouts[static_cast<size_t>(format)].render(deviceContext);
+}
+
 void
 ShaderProgram::render(DeviceContext& deviceContext, ShaderType type) {
 	if (!deviceContext.m_deviceContext) {
@@ -242,6 +270,9 @@ void
 ShaderProgram::destroy() {
 	SAFE_RELEASE(m_VertexShader);
 	m_inputLayout.destroy();
+	for (auto& packedLayout : m_packedLayouts) {
+		packedLayout.destroy();
+	}
 	SAFE_RELEASE(m_PixelShader);
 	SAFE_RELEASE(m_vertexShaderData);
 	SAFE_RELEASE(m_pixelShaderData);
@@ -29,23 +29,60 @@ void UserInterface::init(void* hwnd, ID3D11Device* device, ID3D11DeviceContext*
 }
 
 /// <summary>
-/// Asigna la lista de actores de la escena para que la UI pueda mostrarlos en la jerarqua.
-/// Tambin resetea el actor seleccionado y la cach de Transform.
+/// Asigna el World de la escena para que la UI pueda mostrar sus actores en la jerarqua.
+/// Selecciona el primer actor que encuentre.
 /// </summary>
-/// <param name="actors">Puntero a un vector con actores compartidos.</param>
-void UserInterface::setSceneActors(const std::vector<EU::TSharedPointer<Actor>>* actors)
+/// <param name="world">World con las entidades de los actores.</param>
+void UserInterface::setSceneWorld(World* world)
 {
-  m_actors = actors;
-  m_selectedActor = nullptr;
+  m_world = world;
+  m_selected = EntityHandle();
   m_hasCachedTransform = false;
 
-  if (m_actors && !m_actors->empty())
+  if (m_world)
   {
-    m_selectedActor = (*m_actors)[0].get();
-    m_hasCachedTransform = false;
+    EntityHandle first;
+    m_world->forEach<ActorRef>([&first](EntityHandle entity, ActorRef&) {
+      if (first.isNull()) first = entity;
+    });
+    select_(first);
   }
 }
 
+/// <summary>
+/// Quita la marca Selected de la entidad anterior y se la pone a 'entity'.
+/// No es un cambio estructural del World, as que se puede llamar dentro de un forEach.
+/// </summary>
+/// <param name="entity">Entidad a seleccionar (un handle nulo deja todo sin seleccin).</param>
+void UserInterface::select_(EntityHandle entity)
+{
+  if (m_world)
+  {
+    m_world->remove<Selected>(m_selected);
+    if (m_world->isAlive(entity))
+    {
+      m_world->add<Selected>(entity);
+    }
+  }
+  m_selected = entity;
+  m_hasCachedTransform = false; // reset cache al cambiar de actor
+}
+
+/// <summary>
+/// Resuelve el handle seleccionado. Si la entidad se destruy, la seleccin se limpia.
+/// </summary>
+/// <returns>Actor seleccionado o nullptr.</returns>
+Actor* UserInterface::selectedActor_()
+{
+  ActorRef* ref = m_world ? m_world->get<ActorRef>(m_selected) : nullptr;
+  if (!ref)
+  {
+    m_selected = EntityHandle();
+    return nullptr;
+  }
+  return ref->actor;
+}
+
 /// <summary>
 /// Actualiza el frame de la interfaz de usuario.
 /// Prepara un nuevo frame de ImGui y dibuja las ventanas principales (men, jerarqua, inspector).
@@ -120,34 +157,54 @@ void UserInterface::drawHierarchy_()
 {
   ImGui::Begin("Hierarchy");
 
-  if (!m_actors)
+  if (!m_world || m_world->size() == 0)
   {
     ImGui::Text("No hay actores en la escena.");
     ImGui::End();
     return;
   }
 
-  for (auto& actorPtr : *m_actors)
-  {
-    Actor* actor = actorPtr.get();
-    if (!actor) continue;
+  // Seleccionar solo mueve la marca Selected (componente disperso), as
+  // que se puede hacer mientras se recorre el World
+  m_world->forEach<ActorRef>([this](EntityHandle entity, ActorRef& ref) {
+    Actor* actor = ref.actor;
+    if (!actor) return;
 
-    const std::string& nameStr = actor->getName();
+    const std::string nameStr = actor->getName();
     // Label visible: si no tiene nombre, se muestra "Actor"
     const char* visibleLabel = nameStr.empty() ? "Actor" : nameStr.c_str();
 
-    // ID nico basado en el puntero del actor (evita conflictos de ID en ImGui)
-    ImGui::PushID(actor);
+    // ID nico basado en el ndice de la entidad (evita conflictos de ID en ImGui)
+    ImGui::PushID(static_cast<int>(entity.index));
 
-    bool selected = (m_selectedActor == actor);
-    if (ImGui::Selectable(visibleLabel, selected))
+    if (ImGui::Selectable(visibleLabel, m_world->has<Selected>(entity)))
     {
-      m_selectedActor = actor;
-      m_hasCachedTransform = false; // reset cache al cambiar de actor
+      select_(entity);
     }
 
     ImGui::PopID();
+  });
+
+  ImGui::Separator();
+  ImGui::Text("Transforms actualizados: %u", static_cast<unsigned int>(m_dirtyTransformCount));
+  ImGui::Text("Actores actualizados: %u", static_cast<unsigned int>(m_updatedActorCount));
+  ImGui::Text("Jerarquia: %u nodos, %u matrices mundo (%.3f ms)",
+    static_cast<unsigned int>(m_sceneGraphStats.nodes),
+    static_cast<unsigned int>(m_sceneGraphStats.updatedNodes),
+    m_sceneGraphStats.seconds * 1000.0);
+  ImGui::Text("Sistemas: %.3f ms en %u hilos", m_schedulerStats.seconds * 1000.0, m_schedulerStats.threads);
+  for (const auto& timing : m_schedulerStats.timings) {
+    ImGui::BulletText("%s: %.3f ms", timing.name.c_str(), timing.seconds * 1000.0);
   }
+  ImGui::Text("Comandos: %u, %u cambios de arquetipo (%.3f ms)",
+    static_cast<unsigned int>(m_commandStats.commands),
+    static_cast<unsigned int>(m_commandStats.moves),
+    m_commandStats.seconds * 1000.0);
+  ImGui::Text("BVH: %u actores, %u visibles, altura %d, %u reinserciones",
+    static_cast<unsigned int>(m_actorTreeStats.proxies),
+    static_cast<unsigned int>(m_visibleActorCount),
+    m_actorTreeStats.height,
+    static_cast<unsigned int>(m_actorTreeStats.reinserts));
 
   ImGui::End();
 }
@@ -160,20 +217,22 @@ void UserInterface::drawInspector_()
 {
   ImGui::Begin("Inspector");
 
-  if (!m_selectedActor)
+  Actor* selectedActor = selectedActor_();
+  if (!selectedActor)
   {
     ImGui::Text("Ningun actor seleccionado.");
     ImGui::End();
     return;
   }
 
-  ImGui::Text("Actor: %s", m_selectedActor->getName().c_str());
+  ImGui::Text("Actor: %s", selectedActor->getName().c_str());
+  ImGui::Text("LOD: %u / %u", selectedActor->getLodLevel(), selectedActor->getLodCount());
   ImGui::Separator();
 
   // Transform
-  auto transform = m_selectedActor->getComponent<Transform>();
+  Transform* transform = selectedActor->getComponentPtr<Transform>();
 
-  if (!transform.isNull())
+  if (transform)
   {
     ImGui::Text("Transform");
 
@@ -0,0 +1,454 @@
+#include "VertexCompression.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define VERTEX_COMPRESSION_SSE2 1
+#endif
+
+// ---------------------------------------------------------------------------
+// Conversiones escalares (tambin sirven para las colas de los kernels SSE2)
+// ---------------------------------------------------------------------------
+
+static inline uint32_t asUint_(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static inline float asFloat_(uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// float -> half con redondeo al par ms cercano.
+static inline uint16_t floatToHalf_(float value) {
+  uint32_t bits = asUint_(value);
+  const uint32_t sign = bits & 0x80000000u;
+  bits ^= sign;
+
+  uint32_t half;
+  if (bits >= (143u << 23)) {
+    // Fuera de rango: infinito, o NaN si ya era NaN.
+    half = bits > 0x7f800000u ? 0x7e00u : 0x7c00u;
+  }
+  else if (bits < (113u << 23)) {
+    // Resultado subnormal: dejo que la suma de floats haga el redondeo.
+    const uint32_t magic = ((127 - 15) + (23 - 10) + 1) << 23;
+    half = asUint_(asFloat_(bits) + asFloat_(magic)) - magic;
+  }
+  else {
+    const uint32_t mantissaOdd = (bits >> 13) & 1;
+    bits += (uint32_t(15 - 127) << 23) + 0xfff;
+    bits += mantissaOdd;
+    half = bits >> 13;
+  }
+  return static_cast<uint16_t>(half | (sign >> 16));
+}
+
+// half -> float (exacto).
+static inline float halfToFloat_(uint16_t half) {
+  const uint32_t shiftedExp = 0x7c00u << 13;
+  uint32_t bits = (half & 0x7fffu) << 13;
+  const uint32_t exp = shiftedExp & bits;
+  bits += uint32_t(127 - 15) << 23;
+
+  float value;
+  if (exp == shiftedExp) {
+    bits += uint32_t(128 - 16) << 23;   // Inf / NaN.
+    value = asFloat_(bits);
+  }
+  else if (exp == 0) {
+    bits += 1u << 23;                   // Subnormal: renormalizo.
+    value = asFloat_(bits) - asFloat_(113u << 23);
+  }
+  else {
+    value = asFloat_(bits);
+  }
+  return (half & 0x8000u) ? -value : value;
+}
+
+static inline float clampf_(float value, float lo, float hi) {
+  return value < lo ? lo : (value > hi ? hi : value);
+}
+
+static inline int16_t floatToSnorm16_(float value) {
+  return static_cast<int16_t>(std::lrint(clampf_(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+static inline float snorm16ToFloat_(int16_t value) {
+  const float f = static_cast<float>(value) * (1.0f / 32767.0f);
+  return f < -1.0f ? -1.0f : f;
+}
+
+static inline uint16_t floatToUnorm16_(float value) {
+  return static_cast<uint16_t>(std::lrint(clampf_(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+// ---------------------------------------------------------------------------
+// Kernels
+// ---------------------------------------------------------------------------
+
+void
+VertexCompression::encodeHalf(const float* in, size_t count, uint16_t* out) {
+  size_t i = 0;
+#ifdef VERTEX_COMPRESSION_SSE2
+  // Mismo algoritmo que floatToHalf_, 8 valores por vuelta.
+  const __m128i signMask = _mm_set1_epi32(static_cast<int>(0x80000000u));
+  const __m128i f16Max = _mm_set1_epi32((127 + 16) << 23);
+  const __m128i nanBit = _mm_set1_epi32(0x200);
+  const __m128i infinity = _mm_set1_epi32(0x7c00);
+  const __m128i minNormal = _mm_set1_epi32((127 - 14) << 23);
+  const __m128i subnormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+  const __m128i normalBias = _mm_set1_epi32(0xfff - ((127 - 15) << 23));
+
+  auto convert4 = [&](__m128 f) -> __m128i {
+    const __m128 justSign = _mm_and_ps(_mm_castsi128_ps(signMask), f);
+    const __m128 absF = _mm_xor_ps(f, justSign);
+    const __m128i absI = _mm_castps_si128(absF);
+
+    const __m128i isNaN = _mm_castps_si128(_mm_cmpunord_ps(absF, absF));
+    const __m128i isRegular = _mm_cmpgt_epi32(f16Max, absI);
+    const __m128i infOrNaN = _mm_or_si128(_mm_and_si128(isNaN, nanBit), infinity);
+    const __m128i isSubnormal = _mm_cmpgt_epi32(minNormal, absI);
+
+    const __m128 sub1 = _mm_add_ps(absF, _mm_castsi128_ps(subnormalMagic));
+    const __m128i sub2 = _mm_sub_epi32(_mm_castps_si128(sub1), subnormalMagic);
+
+    const __m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(absI, 31 - 13), 31);
+    const __m128i rounded = _mm_sub_epi32(_mm_add_epi32(absI, normalBias), mantissaOdd);
+    const __m128i normal = _mm_srli_epi32(rounded, 13);
+
+    const __m128i finite = _mm_or_si128(_mm_and_si128(sub2, isSubnormal), _mm_andnot_si128(isSubnormal, normal));
+    const __m128i joined = _mm_or_si128(_mm_and_si128(finite, isRegular), _mm_andnot_si128(isRegular, infOrNaN));
+    // El signo queda extendido (0xFFFF8000) para que packs_epi32 no sature.
+    return _mm_or_si128(joined, _mm_srai_epi32(_mm_castps_si128(justSign), 16));
+  };
+
+  for (; i + 8 <= count; i += 8) {
+    const __m128i lo = convert4(_mm_loadu_ps(in + i));
+    const __m128i hi = convert4(_mm_loadu_ps(in + i + 4));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(lo, hi));
+  }
+#endif
+  for (; i < count; ++i) {
+    out[i] = floatToHalf_(in[i]);
+  }
+}
+
+void
+VertexCompression::decodeHalf(const uint16_t* in, size_t count, float* out) {
+  size_t i = 0;
+#ifdef VERTEX_COMPRESSION_SSE2
+  // Muevo exponente y mantisa a su lugar y multiplico por 2^112 para
+  // corregir el sesgo; eso tambin resuelve los subnormales.
+  const __m128i noSign = _mm_set1_epi32(0x7fff);
+  const __m128i magic = _mm_set1_epi32((254 - 15) << 23);
+  const __m128i wasInfNaN = _mm_set1_epi32(0x7bff);
+  const __m128i expInfNaN = _mm_set1_epi32(255 << 23);
+  const __m128i zero = _mm_setzero_si128();
+
+  auto convert4 = [&](__m128i h) -> __m128 {
+    const __m128i expMantissa = _mm_and_si128(noSign, h);
+    const __m128i justSign = _mm_xor_si128(h, expMantissa);
+    const __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expMantissa, 13)), _mm_castsi128_ps(magic));
+    const __m128i infNaN = _mm_and_si128(_mm_cmpgt_epi32(expMantissa, wasInfNaN), expInfNaN);
+    return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(_mm_slli_epi32(justSign, 16), infNaN)));
+  };
+
+  for (; i + 8 <= count; i += 8) {
+    const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    _mm_storeu_ps(out + i, convert4(_mm_unpacklo_epi16(h, zero)));
+    _mm_storeu_ps(out + i + 4, convert4(_mm_unpackhi_epi16(h, zero)));
+  }
+#endif
+  for (; i < count; ++i) {
+    out[i] = halfToFloat_(in[i]);
+  }
+}
+
+void
+VertexCompression::encodeSnorm16(const float* in, size_t count, int16_t* out) {
+  size_t i = 0;
+#ifdef VERTEX_COMPRESSION_SSE2
+  const __m128 lo = _mm_set1_ps(-1.0f);
+  const __m128 hi = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(32767.0f);
+  for (; i + 8 <= count; i += 8) {
+    const __m128 a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), lo), hi), scale);
+    const __m128 b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4), lo), hi), scale);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+      _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+  }
+#endif
+  for (; i < count; ++i) {
+    out[i] = floatToSnorm16_(in[i]);
+  }
+}
+
+void
+VertexCompression::decodeSnorm16(const int16_t* in, size_t count, float* out) {
+  size_t i = 0;
+#ifdef VERTEX_COMPRESSION_SSE2
+  const __m128 scale = _mm_set1_ps(1.0f / 32767.0f);
+  const __m128 lo = _mm_set1_ps(-1.0f);
+  for (; i + 8 <= count; i += 8) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    // Extiendo el signo de 16 a 32 bits.
+    const __m128i a = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+    const __m128i b = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+    _mm_storeu_ps(out + i, _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(a), scale), lo));
+    _mm_storeu_ps(out + i + 4, _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(b), scale), lo));
+  }
+#endif
+  for (; i < count; ++i) {
+    out[i] = snorm16ToFloat_(in[i]);
+  }
+}
+
+void
+VertexCompression::encodeUnorm16(const float* in, size_t count, uint16_t* out) {
+  size_t i = 0;
+#ifdef VERTEX_COMPRESSION_SSE2
+  // SSE2 no tiene packus_epi32: resto 32768, empaco con signo y regreso el bit alto.
+  const __m128 lo = _mm_setzero_ps();
+  const __m128 hi = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(65535.0f);
+  const __m128i bias32 = _mm_set1_epi32(32768);
+  const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+  for (; i + 8 <= count; i += 8) {
+    const __m128 a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), lo), hi), scale);
+    const __m128 b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4), lo), hi), scale);
+    const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(_mm_cvtps_epi32(a), bias32),
+      _mm_sub_epi32(_mm_cvtps_epi32(b), bias32));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(packed, bias16));
+  }
+#endif
+  for (; i < count; ++i) {
+    out[i] = floatToUnorm16_(in[i]);
+  }
+}
+
+void
+VertexCompression::decodeUnorm16(const uint16_t* in, size_t count, float* out) {
+  size_t i = 0;
+#ifdef VERTEX_COMPRESSION_SSE2
+  const __m128 scale = _mm_set1_ps(1.0f / 65535.0f);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= count; i += 8) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)), scale));
+    _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)), scale));
+  }
+#endif
+  for (; i < count; ++i) {
+    out[i] = static_cast<float>(in[i]) * (1.0f / 65535.0f);
+  }
+}
+
+void
+VertexCompression::encodeOctahedral(const float* in, size_t count, int16_t* out) {
+  // Proyecto cada vector sobre el octaedro |x|+|y|+|z| = 1 y doblo la mitad
+  // de abajo hacia afuera. El paso a snorm16 se hace con el kernel de arriba.
+  std::vector<float> octa(count * 2);
+  for (size_t i = 0; i < count; ++i) {
+    const float x = in[i * 3 + 0];
+    const float y = in[i * 3 + 1];
+    const float z = in[i * 3 + 2];
+    const float l1 = std::fabs(x) + std::fabs(y) + std::fabs(z);
+    float u = l1 > 0.0f ? x / l1 : 0.0f;
+    float v = l1 > 0.0f ? y / l1 : 0.0f;
+    if (z < 0.0f) {
+      const float fu = (1.0f - std::fabs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+      const float fv = (1.0f - std::fabs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+      u = fu;
+      v = fv;
+    }
+    octa[i * 2 + 0] = u;
+    octa[i * 2 + 1] = v;
+  }
+  encodeSnorm16(octa.data(), octa.size(), out);
+}
+
+void
+VertexCompression::decodeOctahedral(const int16_t* in, size_t count, float* out) {
+  std::vector<float> octa(count * 2);
+  decodeSnorm16(in, octa.size(), octa.data());
+  for (size_t i = 0; i < count; ++i) {
+    float x = octa[i * 2 + 0];
+    float y = octa[i * 2 + 1];
+    const float z = 1.0f - std::fabs(x) - std::fabs(y);
+    if (z < 0.0f) {
+      const float fx = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+      const float fy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+      x = fx;
+      y = fy;
+    }
+    const float length = std::sqrt(x * x + y * y + z * z);
+    const float inv = length > 0.0f ? 1.0f / length : 0.0f;
+    out[i * 3 + 0] = x * inv;
+    out[i * 3 + 1] = y * inv;
+    out[i * 3 + 2] = z * inv;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Empacado de mallas
+// ---------------------------------------------------------------------------
+
+size_t
+VertexCompression::vertexStride(VertexFormat format) {
+  return format == VertexFormat::Full ? sizeof(float) * 5 : sizeof(PackedVertex);
+}
+
+VertexFormat
+VertexCompression::compress(const void* vertices,
+  size_t vertexCount,
+  size_t vertexStride,
+  const VertexCompressionLimits& limits,
+  std::vector<PackedVertex>& packed,
+  VertexCompressionReport* report)
+{
+  VertexCompressionReport result;
+  result.bytesBefore = vertexCount * vertexStride;
+  result.bytesAfter = result.bytesBefore;
+  packed.clear();
+
+  if (!vertices || vertexCount == 0 || vertexStride < sizeof(float) * 5) {
+    if (report) *report = result;
+    return VertexFormat::Full;
+  }
+
+  // 1) Separo posiciones (x, y, z, 1) y uvs en arreglos continuos para los kernels.
+  const unsigned char* bytes = static_cast<const unsigned char*>(vertices);
+  std::vector<float> positions(vertexCount * 4);
+  std::vector<float> texCoords(vertexCount * 2);
+  float minP[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+  float maxP[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+  bool uvInUnitRange = true;
+
+  for (size_t v = 0; v < vertexCount; ++v) {
+    float attributes[5];
+    std::memcpy(attributes, bytes + v * vertexStride, sizeof(attributes));
+    for (int k = 0; k < 3; ++k) {
+      positions[v * 4 + k] = attributes[k];
+      if (attributes[k] < minP[k]) minP[k] = attributes[k];
+      if (attributes[k] > maxP[k]) maxP[k] = attributes[k];
+    }
+    positions[v * 4 + 3] = 1.0f;
+    texCoords[v * 2 + 0] = attributes[3];
+    texCoords[v * 2 + 1] = attributes[4];
+    uvInUnitRange = uvInUnitRange &&
+      attributes[3] >= 0.0f && attributes[3] <= 1.0f &&
+      attributes[4] >= 0.0f && attributes[4] <= 1.0f;
+  }
+
+  // 2) Posicin relativa a la caja: centro + media caja * [-1, 1].
+  float diagonal = 0.0f;
+  for (int k = 0; k < 3; ++k) {
+    result.offset[k] = 0.5f * (minP[k] + maxP[k]);
+    result.scale[k] = 0.5f * (maxP[k] - minP[k]);
+    if (!(result.scale[k] > 0.0f)) result.scale[k] = 1.0f;   // Eje plano (o NaN).
+    diagonal += (maxP[k] - minP[k]) * (maxP[k] - minP[k]);
+  }
+  diagonal = std::sqrt(diagonal);
+
+  std::vector<float> normalized(positions.size());
+  for (size_t v = 0; v < vertexCount; ++v) {
+    for (int k = 0; k < 3; ++k) {
+      normalized[v * 4 + k] = (positions[v * 4 + k] - result.offset[k]) / result.scale[k];
+    }
+    normalized[v * 4 + 3] = 1.0f;
+  }
+
+  std::vector<int16_t> packedPos(positions.size());
+  encodeSnorm16(normalized.data(), normalized.size(), packedPos.data());
+
+  // 3) Mido el error real regresando a float con los mismos kernels.
+  std::vector<float> decoded(positions.size());
+  decodeSnorm16(packedPos.data(), packedPos.size(), decoded.data());
+  float positionError = 0.0f;
+  for (size_t v = 0; v < vertexCount; ++v) {
+    for (int k = 0; k < 3; ++k) {
+      const float back = decoded[v * 4 + k] * result.scale[k] + result.offset[k];
+      const float error = std::fabs(back - positions[v * 4 + k]);
+      if (!(error <= positionError)) positionError = error;
+    }
+  }
+
+  std::vector<uint16_t> packedUV(texCoords.size());
+  std::vector<float> decodedUV(texCoords.size());
+  auto uvError = [&]() {
+    float maxError = 0.0f;
+    for (size_t i = 0; i < texCoords.size(); ++i) {
+      const float error = std::fabs(decodedUV[i] - texCoords[i]);
+      if (!(error <= maxError)) maxError = error;
+    }
+    return maxError;
+  };
+
+  // 4) Elijo el formato de uv: unorm16 si cabe en [0, 1], si no half.
+  VertexFormat format = VertexFormat::Full;
+  float texCoordError = 0.0f;
+  if (uvInUnitRange) {
+    encodeUnorm16(texCoords.data(), texCoords.size(), packedUV.data());
+    decodeUnorm16(packedUV.data(), packedUV.size(), decodedUV.data());
+    texCoordError = uvError();
+    format = VertexFormat::PackedUnorm;
+  }
+  if (format == VertexFormat::Full || texCoordError > limits.maxTexCoordError) {
+    encodeHalf(texCoords.data(), texCoords.size(), packedUV.data());
+    decodeHalf(packedUV.data(), packedUV.size(), decodedUV.data());
+    texCoordError = uvError();
+    format = VertexFormat::PackedHalf;
+  }
+
+  result.maxPositionError = positionError;
+  result.maxTexCoordError = texCoordError;
+
+  const float positionLimit = limits.maxPositionError * (diagonal > 0.0f ? diagonal : 1.0f);
+  if (!(positionError <= positionLimit) || !(texCoordError <= limits.maxTexCoordError)) {
+    if (report) *report = result;
+    return VertexFormat::Full;
+  }
+
+  // 5) Intercalo posicin y uv en el formato final.
+  packed.resize(vertexCount);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    std::memcpy(packed[v].pos, &packedPos[v * 4], sizeof(packed[v].pos));
+    std::memcpy(packed[v].tex, &packedUV[v * 2], sizeof(packed[v].tex));
+  }
+
+  result.format = format;
+  result.bytesAfter = vertexCount * sizeof(PackedVertex);
+  if (report) *report = result;
+  return format;
+}
+
+void
+VertexCompression::decompress(const PackedVertex* packed,
+  size_t count,
+  const VertexCompressionReport& report,
+  float* out)
+{
+  for (size_t v = 0; v < count; ++v) {
+    float position[4];
+    float texCoord[2];
+    decodeSnorm16(packed[v].pos, 4, position);
+    if (report.format == VertexFormat::PackedUnorm) {
+      decodeUnorm16(packed[v].tex, 2, texCoord);
+    }
+    else {
+      decodeHalf(packed[v].tex, 2, texCoord);
+    }
+    for (int k = 0; k < 3; ++k) {
+      out[v * 5 + k] = position[k] * report.scale[k] + report.offset[k];
+    }
+    out[v * 5 + 3] = texCoord[0];
+    out[v * 5 + 4] = texCoord[1];
+  }
+}
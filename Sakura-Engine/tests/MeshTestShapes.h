@@ -0,0 +1,62 @@
+#pragma once
+/*
+ * Mallas sintticas para las pruebas y los benchmarks de los procesos de
+ * malla. Usan SimpleVertex (posicin + uv), igual que lo que deja el
+ * importador despus de soldar.
+ */
+#include "Prerequisites.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+struct TestMesh {
+  std::vector<SimpleVertex> vertices;
+  std::vector<uint32_t> indices;
+
+  size_t triangleCount() const { return indices.size() / 3; }
+};
+
+/*
+ * Esfera uv de radio 'radius' con 'segments' divisiones alrededor y 'rings'
+ * de polo a polo. Como en un modelo exportado, la columna u = 1 repite las
+ * posiciones de u = 0 (una costura de uv) y cada polo tiene un vrtice por
+ * segmento. En todos los tringulos cross(b - a, c - a) apunta hacia fuera.
+ */
+inline TestMesh
+makeUvSphere(unsigned int segments, unsigned int rings, float radius = 1.0f) {
+  const float pi = 3.14159265358979f;
+  TestMesh mesh;
+  for (unsigned int r = 0; r <= rings; ++r) {
+    const float v = static_cast<float>(r) / rings;
+    // En el polo sur sin(pi) no da 0 exacto en float: se fija a mano
+    const float ringSin = r == rings ? 0.0f : std::sin(v * pi);
+    const float ringCos = r == rings ? -1.0f : std::cos(v * pi);
+    for (unsigned int s = 0; s <= segments; ++s) {
+      const float u = static_cast<float>(s) / segments;
+      // La costura usa el ngulo 0 para que las posiciones sean idnticas
+      const float phi = s == segments ? 0.0f : u * 2.0f * pi;
+      SimpleVertex vertex;
+      vertex.Pos = XMFLOAT3(radius * ringSin * std::cos(phi), radius * ringCos, radius * ringSin * std::sin(phi));
+      vertex.Tex = XMFLOAT2(u, v);
+      mesh.vertices.push_back(vertex);
+    }
+  }
+  const unsigned int row = segments + 1;
+  for (unsigned int r = 0; r < rings; ++r) {
+    for (unsigned int s = 0; s < segments; ++s) {
+      const uint32_t a = r * row + s;
+      const uint32_t b = a + 1;
+      const uint32_t c = a + row;
+      const uint32_t d = c + 1;
+      // En los polos uno de los dos tringulos no tiene rea
+      if (r != 0) {
+        mesh.indices.insert(mesh.indices.end(), { a, b, c });
+      }
+      if (r != rings - 1) {
+        mesh.indices.insert(mesh.indices.end(), { b, d, c });
+      }
+    }
+  }
+  return mesh;
+}
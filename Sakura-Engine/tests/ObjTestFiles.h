@@ -0,0 +1,74 @@
+#pragma once
+/*
+ * Archivos .obj sintticos para las pruebas y los benchmarks: una rejilla
+ * de columns x rows cuadros con v, vt y vn (un vrtice por esquina de la
+ * rejilla), caras de cuatro esquinas "v/vt/vn" y, si se pide, varios
+ * materiales intercalados. Se escribe lnea por lnea, as que generar un
+ * archivo grande no ocupa memoria.
+ */
+#include <cstdio>
+#include <string>
+
+struct ObjGridOptions {
+  bool texcoords = true;
+  bool normals = true;
+  unsigned int materials = 0;   // 0 = sin usemtl; si no, cambia de material cada fila.
+};
+
+inline bool
+writeGridObj(const std::string& path, unsigned int columns, unsigned int rows,
+  const ObjGridOptions& options = ObjGridOptions()) {
+  FILE* file = std::fopen(path.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  std::fprintf(file, "# rejilla %ux%u\no grid\n", columns, rows);
+
+  for (unsigned int y = 0; y <= rows; ++y) {
+    for (unsigned int x = 0; x <= columns; ++x) {
+      // Un poco de relieve para que no todos los vrtices sean coplanares
+      const float height = 0.05f * static_cast<float>((x * 7 + y * 13) % 11);
+      std::fprintf(file, "v %.4f %.4f %.4f\n", static_cast<float>(x) * 0.1f, height, static_cast<float>(y) * 0.1f);
+    }
+  }
+  if (options.texcoords) {
+    for (unsigned int y = 0; y <= rows; ++y) {
+      for (unsigned int x = 0; x <= columns; ++x) {
+        std::fprintf(file, "vt %.5f %.5f\n", static_cast<float>(x) / columns, static_cast<float>(y) / rows);
+      }
+    }
+  }
+  if (options.normals) {
+    std::fprintf(file, "vn 0 1 0\n");
+  }
+
+  for (unsigned int y = 0; y < rows; ++y) {
+    if (options.materials > 0) {
+      std::fprintf(file, "usemtl material%u\n", y % options.materials);
+    }
+    for (unsigned int x = 0; x < columns; ++x) {
+      const unsigned int corner[4] = {
+        y * (columns + 1) + x + 1,
+        y * (columns + 1) + x + 2,
+        (y + 1) * (columns + 1) + x + 2,
+        (y + 1) * (columns + 1) + x + 1 };
+      std::fputc('f', file);
+      for (unsigned int k = 0; k < 4; ++k) {
+        if (options.texcoords && options.normals) {
+          std::fprintf(file, " %u/%u/1", corner[k], corner[k]);
+        }
+        else if (options.texcoords) {
+          std::fprintf(file, " %u/%u", corner[k], corner[k]);
+        }
+        else if (options.normals) {
+          std::fprintf(file, " %u//1", corner[k]);
+        }
+        else {
+          std::fprintf(file, " %u", corner[k]);
+        }
+      }
+      std::fputc('\n', file);
+    }
+  }
+  return std::fclose(file) == 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+/*
+ * Lo mnimo para las pruebas, sin framework: CHECK anota el fallo y sigue,
+ * y main termina con testResult para que ctest vea el cdigo de salida.
+ */
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+inline int&
+testFailures() {
+  static int failures = 0;
+  return failures;
+}
+
+#define CHECK(condition) \
+  do { \
+    if (!(condition)) { \
+      ++testFailures(); \
+      std::fprintf(stderr, "%s:%d: fallo CHECK(%s)\n", __FILE__, __LINE__, #condition); \
+    } \
+  } while (0)
+
+inline int
+testResult(const char* name) {
+  if (testFailures() == 0) {
+    std::printf("%s: OK\n", name);
+    return 0;
+  }
+  std::printf("%s: %d fallos\n", name, testFailures());
+  return 1;
+}
+
+// Ruta para un archivo temporal de las pruebas (la carpeta se crea si no existe).
+inline std::string
+testTempPath(const std::string& fileName) {
+  const std::filesystem::path folder = std::filesystem::temp_directory_path() / "sakura_tests";
+  std::filesystem::create_directories(folder);
+  return (folder / fileName).string();
+}
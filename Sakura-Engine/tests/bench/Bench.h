@@ -0,0 +1,60 @@
+#pragma once
+/*
+ * Benchmarks del motor (ejecutable sakura_bench).
+ *
+ * Cada archivo bench_*.cpp registra los suyos con SAKURA_BENCH(nombre) y
+ * escribe sus resultados con printf. Con --quick los tamaos bajan para
+ * que ctest solo revise que corren; sin l se usan los tamaos grandes
+ * (los nmeros de Docs/Manual.md salen de ah).
+ */
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+struct BenchOptions {
+  bool quick = false;
+};
+
+typedef void (*BenchFunction)(const BenchOptions& options);
+
+// Agrega un benchmark a la lista (lo llama SAKURA_BENCH).
+int
+registerBench(const char* name, BenchFunction function);
+
+// Reservas de memoria (operator new) desde que empez el programa.
+size_t
+benchAllocations();
+
+#define SAKURA_BENCH(name) \
+  static void bench_##name##_(const BenchOptions& options); \
+  static const int kBenchRegistered_##name##_ = registerBench(#name, bench_##name##_); \
+  static void bench_##name##_(const BenchOptions& options)
+
+// Segundos desde 'start'.
+inline double
+benchSecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Mejor tiempo de 'repeats' corridas de fn, en segundos.
+template<typename Fn>
+double
+benchBest(int repeats, Fn&& fn) {
+  double best = 0.0;
+  for (int i = 0; i < repeats; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const double seconds = benchSecondsSince(start);
+    if (i == 0 || seconds < best) best = seconds;
+  }
+  return best;
+}
+
+// Evita que el compilador quite un clculo cuyo resultado no se usa.
+template<typename T>
+inline void
+benchKeep(const T& value) {
+  static volatile const void* sink;
+  sink = &value;
+  (void)sink;
+}
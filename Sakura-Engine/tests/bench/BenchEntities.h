@@ -0,0 +1,67 @@
+#pragma once
+/*
+ * Entidades con un objeto en el heap por componente, como los Actor: sirven
+ * para comparar Entity contra el World. Los componentes usan los tipos
+ * TRANSFORM y MESH de ComponentType para no depender de Direct3D.
+ */
+#include "ECS/Entity.h"
+
+struct BenchPosition {
+  float x = 0.0f, y = 0.0f, z = 0.0f;
+};
+
+struct BenchVelocity {
+  float x = 0.0f, y = 0.0f, z = 0.0f;
+};
+
+class BenchPositionComponent : public Component {
+public:
+  static constexpr ComponentType kType = TRANSFORM;
+
+  BenchPositionComponent() : Component(kType) {}
+
+  void init() override {}
+  void update(float) override {}
+  void render(DeviceContext&) override {}
+  void destroy() override {}
+
+  BenchPosition value;
+};
+
+class BenchVelocityComponent : public Component {
+public:
+  static constexpr ComponentType kType = MESH;
+
+  BenchVelocityComponent() : Component(kType) {}
+
+  void init() override {}
+  void update(float) override {}
+  void render(DeviceContext&) override {}
+  void destroy() override {}
+
+  BenchVelocity value;
+};
+
+class BenchEntity : public Entity {
+public:
+  void init() override {}
+  void update(float, DeviceContext&) override {}
+  void render(DeviceContext&) override {}
+  void destroy() override {}
+
+  /*
+   * getComponent como era antes de la tabla por tipo: recorre la lista y
+   * prueba dynamic_pointer_cast con cada uno.
+   */
+  template <typename T>
+  EU::TSharedPointer<T>
+    getComponentByCast() {
+    for (auto& component : m_components) {
+      EU::TSharedPointer<T> specificComponent = component.template dynamic_pointer_cast<T>();
+      if (specificComponent) {
+        return specificComponent;
+      }
+    }
+    return EU::TSharedPointer<T>();
+  }
+};
@@ -0,0 +1,92 @@
+#include "bench/Bench.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+  struct BenchEntry_ {
+    const char* name;
+    BenchFunction function;
+  };
+
+  std::vector<BenchEntry_>&
+  benches_() {
+    static std::vector<BenchEntry_> benches;
+    return benches;
+  }
+
+  std::atomic<size_t> g_allocations_(0);
+}
+
+// Cuenta las reservas para los benchmarks que miden si un camino reserva memoria
+void*
+operator new(size_t size) {
+  g_allocations_.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void
+operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+int
+registerBench(const char* name, BenchFunction function) {
+  benches_().push_back({ name, function });
+  return static_cast<int>(benches_().size());
+}
+
+size_t
+benchAllocations() {
+  return g_allocations_.load(std::memory_order_relaxed);
+}
+
+// sakura_bench [--quick] [--list] [nombre...]: sin nombres corre todos.
+int
+main(int argc, char** argv) {
+  BenchOptions options;
+  std::vector<std::string> names;
+  bool list = false;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--quick") == 0) {
+      options.quick = true;
+    }
+    else if (std::strcmp(argv[i], "--list") == 0) {
+      list = true;
+    }
+    else {
+      names.push_back(argv[i]);
+    }
+  }
+
+  int ran = 0;
+  for (const BenchEntry_& bench : benches_()) {
+    if (list) {
+      std::printf("%s\n", bench.name);
+      continue;
+    }
+    bool selected = names.empty();
+    for (const std::string& name : names) selected = selected || name == bench.name;
+    if (!selected) continue;
+    std::printf("== %s%s\n", bench.name, options.quick ? " (quick)" : "");
+    std::fflush(stdout);
+    bench.function(options);
+    std::fflush(stdout);
+    ++ran;
+  }
+  if (!list && ran == 0) {
+    std::fprintf(stderr, "Ningun benchmark con ese nombre (--list los muestra)\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,153 @@
+/*
+ * AabbTree de 10,000 a 1,000,000 de cajas de 0.1 a 3 unidades repartidas
+ * en un cubo que crece con la cantidad (densidad constante). Mide armar el
+ * rbol, mover el 1% de las cajas un poco (menos que el margen) y lejos
+ * (obliga a reinsertar), un frustum que encierra el 5% del volumen contra
+ * probar todas las cajas a fuerza bruta, un rayo que cruza la escena y una
+ * esfera de radio 5.
+ */
+#include "bench/Bench.h"
+#include "AabbTree.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+struct BenchBox {
+  float min[3];
+  float max[3];
+};
+
+// La caja queda toda fuera de algn plano (la misma prueba que queryFrustum).
+static bool
+outsideFrustum(const float planes[6][4], const BenchBox& box) {
+  for (int p = 0; p < 6; ++p) {
+    const float* plane = planes[p];
+    const float x = plane[0] >= 0.0f ? box.max[0] : box.min[0];
+    const float y = plane[1] >= 0.0f ? box.max[1] : box.min[1];
+    const float z = plane[2] >= 0.0f ? box.max[2] : box.min[2];
+    if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0.0f) return true;
+  }
+  return false;
+}
+
+SAKURA_BENCH(aabb_tree) {
+  const size_t counts[3] = { 10000, 100000, 1000000 };
+  const int repeats = options.quick ? 1 : 10;
+  const int queries = options.quick ? 100 : 1000;
+
+  std::printf("%-10s %11s %11s %11s %11s %11s %9s %9s %7s\n", "cajas", "armar ms", "poco ms", "lejos ms",
+    "frustum ms", "bruta ms", "rayo us", "esfera us", "altura");
+  for (size_t count : counts) {
+    if (options.quick && count > 10000) break;
+
+    // 1,000 unidades cbicas por caja: el lado crece con la raz cbica
+    const float side = 10.0f * std::cbrt(static_cast<float>(count));
+    std::mt19937 random(17);
+    std::uniform_real_distribution<float> coordinate(0.0f, side);
+    std::uniform_real_distribution<float> size(0.1f, 3.0f);
+    std::vector<BenchBox> boxes(count);
+    for (BenchBox& box : boxes) {
+      for (int k = 0; k < 3; ++k) {
+        box.min[k] = coordinate(random);
+        box.max[k] = box.min[k] + size(random);
+      }
+    }
+    const std::vector<BenchBox> home = boxes;
+
+    // Armar se mide aparte (el mejor de varios rboles, salvo con el milln)
+    const double buildSeconds = benchBest(count > 100000 ? 1 : repeats, [&]() {
+      AabbTree scratch;
+      for (size_t i = 0; i < count; ++i) scratch.insert(boxes[i].min, boxes[i].max, &boxes[i]);
+    });
+    AabbTree tree;
+    std::vector<uint32_t> proxies(count);
+    for (size_t i = 0; i < count; ++i) proxies[i] = tree.insert(boxes[i].min, boxes[i].max, &boxes[i]);
+
+    // El 1% de las cajas por frame, cada vez otras. Poco = a menos de 0.05
+    // de donde se insert, as que nunca sale del margen
+    const size_t moved = count / 100;
+    std::uniform_int_distribution<size_t> pick(0, count - 1);
+    std::uniform_real_distribution<float> jitter(-0.05f, 0.05f);
+    auto moveBoxes = [&](bool far) {
+      for (size_t m = 0; m < moved; ++m) {
+        const size_t i = pick(random);
+        BenchBox& box = boxes[i];
+        for (int k = 0; k < 3; ++k) {
+          const float extent = box.max[k] - box.min[k];
+          box.min[k] = far ? coordinate(random) : home[i].min[k] + jitter(random);
+          box.max[k] = box.min[k] + extent;
+        }
+        tree.update(proxies[i], box.min, box.max);
+      }
+    };
+    tree.resetCounters();
+    const double smallSeconds = benchBest(repeats, [&]() { moveBoxes(false); });
+    const size_t smallReinserts = tree.getStats().reinserts;
+    tree.resetCounters();
+    const double farSeconds = benchBest(repeats, [&]() { moveBoxes(true); });
+
+    // Frustum: caja en el centro con el 5% del volumen, como seis planos
+    const float half = 0.5f * side * std::cbrt(0.05f);
+    const float center = 0.5f * side;
+    float planes[6][4] = {};
+    for (int k = 0; k < 3; ++k) {
+      planes[k * 2][k] = 1.0f;
+      planes[k * 2][3] = -(center - half);
+      planes[k * 2 + 1][k] = -1.0f;
+      planes[k * 2 + 1][3] = center + half;
+    }
+    std::vector<void*> results;
+    const double frustumSeconds = benchBest(repeats, [&]() {
+      results.clear();
+      tree.queryFrustum(planes, results);
+    });
+    const size_t treeVisible = results.size();
+    size_t bruteVisible = 0;
+    const double bruteSeconds = benchBest(repeats, [&]() {
+      bruteVisible = 0;
+      for (const BenchBox& box : boxes) {
+        if (!outsideFrustum(planes, box)) ++bruteVisible;
+      }
+    });
+
+    // Rayos de una cara del cubo a la opuesta y esferas de radio 5, al azar
+    // (los mismos en cada repeticin)
+    std::vector<AabbRayHit> hits;
+    size_t rayHits = 0;
+    const double raySeconds = benchBest(repeats, [&]() {
+      std::mt19937 rays(23);
+      rayHits = 0;
+      for (int q = 0; q < queries; ++q) {
+        const float origin[3] = { coordinate(rays), coordinate(rays), -1.0f };
+        const float direction[3] = { coordinate(rays) - origin[0], coordinate(rays) - origin[1], side + 2.0f };
+        hits.clear();
+        tree.raycast(origin, direction, 1.0f, hits);
+        rayHits += hits.size();
+      }
+    }) / queries;
+
+    size_t sphereHits = 0;
+    const double sphereSeconds = benchBest(repeats, [&]() {
+      std::mt19937 spheres(29);
+      sphereHits = 0;
+      for (int q = 0; q < queries; ++q) {
+        const float sphereCenter[3] = { coordinate(spheres), coordinate(spheres), coordinate(spheres) };
+        results.clear();
+        tree.querySphere(sphereCenter, 5.0f, results);
+        sphereHits += results.size();
+      }
+    }) / queries;
+    benchKeep(rayHits);
+    benchKeep(sphereHits);
+
+    const AabbTreeStats stats = tree.getStats();
+    std::printf("%-10zu %11.3f %11.3f %11.3f %11.3f %11.3f %9.2f %9.2f %7d%s\n", count, buildSeconds * 1000.0,
+      smallSeconds * 1000.0, farSeconds * 1000.0, frustumSeconds * 1000.0, bruteSeconds * 1000.0,
+      raySeconds * 1.0e6, sphereSeconds * 1.0e6, stats.height,
+      treeVisible == bruteVisible ? "" : "  (el frustum no coincide con la fuerza bruta)");
+    std::printf("%-10s visibles %zu, %.1f cajas por rayo, %.1f por esfera, reinserciones: %zu poco, %zu de %zu lejos\n",
+      "", treeVisible, double(rayHits) / queries, double(sphereHits) / queries, smallReinserts, stats.reinserts,
+      stats.updates);
+  }
+}
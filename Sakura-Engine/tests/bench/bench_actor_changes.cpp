@@ -0,0 +1,142 @@
+/*
+ * Lo que hace el sistema Actors en cada frame, con 1,000,000 de actores en
+ * grupos de una raz y nueve hijos en el SceneGraph y 1,000 races movidas
+ * por frame (10,000 matrices mundo recalculadas). Compara tres formas de
+ * encontrar a quin actualizar:
+ *
+ *   - todos: World::forEach sobre todos los actores.
+ *   - marca: Query::forEachChanged ms recorrer la marca dispersa de los
+ *     que tienen padre (la versin anterior del sistema).
+ *   - nodos: Query::forEachChanged ms SceneGraph::forEachUpdated.
+ *
+ * "Actualizar" es lo mismo en las tres: si la versin de la matriz mundo
+ * cambi, copiar la traslacin, como Actor::update con su constant buffer.
+ */
+#include "bench/Bench.h"
+#include "bench/BenchEntities.h"
+#include "ECS/Query.h"
+#include "ECS/World.h"
+#include "SceneGraph.h"
+
+#include <random>
+#include <vector>
+
+struct BenchActor {
+  uint32_t node = SceneGraph::kInvalidNode;
+  uint32_t modelVersion = 0;
+  float model[3] = { 0.0f, 0.0f, 0.0f };
+};
+
+struct BenchActorRef {
+  BenchActor* actor = nullptr;
+};
+
+struct BenchSceneChild {
+  static constexpr bool kSparseStorage = true;
+};
+
+// Devuelve 1 si tuvo que subir algo (la matriz mundo cambi).
+static size_t
+updateActor(const SceneGraph& graph, BenchActor& actor) {
+  const uint32_t version = graph.getWorldVersion(actor.node);
+  if (version == actor.modelVersion) return 0;
+  const float* world = graph.getWorld(actor.node);
+  actor.model[0] = world[12];
+  actor.model[1] = world[13];
+  actor.model[2] = world[14];
+  actor.modelVersion = version;
+  return 1;
+}
+
+SAKURA_BENCH(actor_changes) {
+  const size_t count = options.quick ? 10000 : 1000000;
+  const size_t movedRoots = count / 1000;
+  const int frames = options.quick ? 2 : 20;
+
+  World world;
+  SceneGraph graph;
+  std::vector<BenchActor> actors(count);
+  std::vector<EntityHandle> entities(count);
+  for (size_t i = 0; i < count; ++i) {
+    const bool root = i % 10 == 0;
+    actors[i].node = graph.create(root ? SceneGraph::kInvalidNode : actors[i - i % 10].node);
+    graph.setUserData(actors[i].node, &actors[i]);
+    entities[i] = world.create(BenchPosition(), BenchActorRef{ &actors[i] });
+    if (!root) world.add<BenchSceneChild>(entities[i]);
+  }
+  graph.update(1);
+
+  Query<BenchActorRef> changed(world);
+  changed.watch<BenchPosition>();
+  changed.forEachChanged([&](BenchActorRef& ref) { updateActor(graph, *ref.actor); });
+
+  // Mueve 'roots' races al azar: Transform marcado y matriz local al SceneGraph
+  std::mt19937 random(3);
+  float matrix[16];
+  for (int i = 0; i < 16; ++i) matrix[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+  auto moveRoots = [&](size_t roots) {
+    for (size_t r = 0; r < roots; ++r) {
+      const size_t i = (random() % (count / 10)) * 10;
+      matrix[12] += 1.0f;
+      graph.setLocal(actors[i].node, matrix);
+      world.markChanged<BenchPosition>(entities[i]);
+    }
+    graph.update(1);
+  };
+
+  const char* names[3] = { "todos", "marca", "nodos" };
+  std::printf("%zu actores, %zu raices movidas por frame\n", count, movedRoots);
+  std::printf("%-8s %14s %14s %12s %14s\n", "forma", "movidos ms", "visitados", "subidos", "quieto ms");
+  for (int way = 0; way < 3; ++way) {
+    size_t visited = 0, uploaded = 0;
+    auto visit = [&](BenchActor& actor) {
+      ++visited;
+      uploaded += updateActor(graph, actor);
+    };
+    auto frame = [&]() {
+      visited = 0;
+      uploaded = 0;
+      if (way == 0) {
+        world.forEach<BenchActorRef>([&](BenchActorRef& ref) { visit(*ref.actor); });
+        return;
+      }
+      changed.forEachChanged([&](BenchActorRef& ref) { visit(*ref.actor); });
+      if (way == 1) {
+        world.pool<BenchSceneChild>().forEach([&](EntityHandle entity, BenchSceneChild&) {
+          visit(*world.get<BenchActorRef>(entity)->actor);
+        });
+      }
+      else {
+        graph.forEachUpdated([&](uint32_t node) {
+          BenchActor* actor = static_cast<BenchActor*>(graph.getUserData(node));
+          if (actor->modelVersion != graph.getWorldVersion(node)) visit(*actor);
+        });
+      }
+    };
+
+    double movedSeconds = 0.0;
+    size_t movedVisited = 0, movedUploaded = 0;
+    for (int f = 0; f < frames; ++f) {
+      moveRoots(movedRoots);
+      const auto start = std::chrono::steady_clock::now();
+      frame();
+      const double seconds = benchSecondsSince(start);
+      if (f == 0 || seconds < movedSeconds) movedSeconds = seconds;
+      movedVisited = visited;
+      movedUploaded = uploaded;
+    }
+
+    // Sin nada que se mueva (el update del SceneGraph no recalcula nada)
+    double quietSeconds = 0.0;
+    for (int f = 0; f < frames; ++f) {
+      moveRoots(0);
+      const auto start = std::chrono::steady_clock::now();
+      frame();
+      const double seconds = benchSecondsSince(start);
+      if (f == 0 || seconds < quietSeconds) quietSeconds = seconds;
+    }
+
+    std::printf("%-8s %14.3f %14zu %12zu %14.3f\n", names[way], movedSeconds * 1000.0, movedVisited, movedUploaded,
+      quietSeconds * 1000.0);
+  }
+}
@@ -0,0 +1,74 @@
+/*
+ * Altas y bajas con 100,000 entidades vivas: destruir una al azar y crear
+ * otra (posicin y velocidad), y poner y quitar una marca como componente
+ * disperso (ComponentPool) contra la misma marca en los arquetipos. Cuenta
+ * operaciones por segundo y revisa que los handles viejos dejen de valer.
+ */
+#include "bench/Bench.h"
+#include "bench/BenchEntities.h"
+#include "ECS/World.h"
+
+#include <random>
+#include <vector>
+
+struct BenchSparseMark {
+  static constexpr bool kSparseStorage = true;
+  int value = 0;
+};
+
+struct BenchArchetypeMark {
+  int value = 0;
+};
+
+SAKURA_BENCH(entity_churn) {
+  const size_t live = options.quick ? 10000 : 100000;
+  const size_t operations = options.quick ? 100000 : 2000000;
+
+  World world;
+  std::vector<EntityHandle> entities(live);
+  for (EntityHandle& entity : entities) entity = world.create(BenchPosition(), BenchVelocity());
+
+  // Destruir una al azar y crear otra en su lugar: 2 operaciones por vuelta
+  std::mt19937 random(5);
+  std::vector<uint32_t> picks(operations / 2);
+  for (uint32_t& pick : picks) pick = static_cast<uint32_t>(random() % live);
+  size_t staleAlive = 0;
+  const auto churnStart = std::chrono::steady_clock::now();
+  for (uint32_t pick : picks) {
+    const EntityHandle old = entities[pick];
+    world.destroy(old);
+    entities[pick] = world.create(BenchPosition(), BenchVelocity());
+    // El ndice se recicla, pero el handle viejo no debe apuntar a la nueva
+    if (world.isAlive(old)) ++staleAlive;
+  }
+  const double churnSeconds = benchSecondsSince(churnStart);
+
+  // Poner y quitar una marca en entidades al azar: 2 operaciones por vuelta
+  const auto sparseStart = std::chrono::steady_clock::now();
+  for (uint32_t pick : picks) {
+    world.add<BenchSparseMark>(entities[pick]);
+    world.remove<BenchSparseMark>(entities[pick]);
+  }
+  const double sparseSeconds = benchSecondsSince(sparseStart);
+
+  const auto archetypeStart = std::chrono::steady_clock::now();
+  for (uint32_t pick : picks) {
+    world.add<BenchArchetypeMark>(entities[pick]);
+    world.remove<BenchArchetypeMark>(entities[pick]);
+  }
+  const double archetypeSeconds = benchSecondsSince(archetypeStart);
+
+  size_t alive = 0;
+  for (const EntityHandle& entity : entities) {
+    if (world.isAlive(entity) && !world.has<BenchSparseMark>(entity) && !world.has<BenchArchetypeMark>(entity)) ++alive;
+  }
+
+  const double count = static_cast<double>(picks.size() * 2);
+  std::printf("%zu entidades vivas, %zu operaciones por prueba\n", live, picks.size() * 2);
+  std::printf("%-34s %14s\n", "", "millones op/s");
+  std::printf("%-34s %14.1f\n", "destroy + create", count / churnSeconds / 1.0e6);
+  std::printf("%-34s %14.1f\n", "add + remove disperso (pool)", count / sparseSeconds / 1.0e6);
+  std::printf("%-34s %14.1f\n", "add + remove en arquetipos", count / archetypeSeconds / 1.0e6);
+  std::printf("handles viejos que siguen vivos: %zu, entidades bien al final: %zu de %zu, World: %zu\n",
+    staleAlive, alive, live, world.size());
+}
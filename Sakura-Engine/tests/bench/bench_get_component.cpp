@@ -0,0 +1,61 @@
+/*
+ * Entity::getComponent con 100,000 entidades que tienen el Transform y
+ * despus la malla (el orden en que los agrega Actor), buscando los dos en
+ * cada una. Compara la versin anterior (recorrer la lista con
+ * dynamic_pointer_cast) contra la tabla por tipo con getComponent y con
+ * getComponentPtr.
+ */
+#include "bench/Bench.h"
+#include "bench/BenchEntities.h"
+
+#include <memory>
+#include <vector>
+
+SAKURA_BENCH(get_component) {
+  const size_t count = options.quick ? 10000 : 100000;
+  const int repeats = options.quick ? 1 : 20;
+
+  std::vector<std::unique_ptr<BenchEntity>> entities;
+  entities.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    std::unique_ptr<BenchEntity> entity(new BenchEntity());
+    EU::TSharedPointer<BenchPositionComponent> position(new BenchPositionComponent());
+    position->value.x = static_cast<float>(i);
+    entity->addComponent(position);
+    EU::TSharedPointer<BenchVelocityComponent> velocity(new BenchVelocityComponent());
+    velocity->value.x = 1.0f;
+    entity->addComponent(velocity);
+    entities.push_back(std::move(entity));
+  }
+
+  float castSum = 0.0f, sharedSum = 0.0f, pointerSum = 0.0f;
+  const double castSeconds = benchBest(repeats, [&]() {
+    castSum = 0.0f;
+    for (const std::unique_ptr<BenchEntity>& entity : entities) {
+      castSum += entity->getComponentByCast<BenchPositionComponent>()->value.x;
+      castSum += entity->getComponentByCast<BenchVelocityComponent>()->value.x;
+    }
+  });
+  const double sharedSeconds = benchBest(repeats, [&]() {
+    sharedSum = 0.0f;
+    for (const std::unique_ptr<BenchEntity>& entity : entities) {
+      sharedSum += entity->getComponent<BenchPositionComponent>()->value.x;
+      sharedSum += entity->getComponent<BenchVelocityComponent>()->value.x;
+    }
+  });
+  const double pointerSeconds = benchBest(repeats, [&]() {
+    pointerSum = 0.0f;
+    for (const std::unique_ptr<BenchEntity>& entity : entities) {
+      pointerSum += entity->getComponentPtr<BenchPositionComponent>()->value.x;
+      pointerSum += entity->getComponentPtr<BenchVelocityComponent>()->value.x;
+    }
+  });
+  benchKeep(castSum);
+
+  const double perLookup = 1.0e9 / (count * 2);
+  std::printf("%zu entidades, ns por busqueda (primer y segundo componente):\n", count);
+  std::printf("%-28s %10.1f\n", "dynamic_pointer_cast", castSeconds * perLookup);
+  std::printf("%-28s %10.1f\n", "getComponent (tabla)", sharedSeconds * perLookup);
+  std::printf("%-28s %10.1f\n", "getComponentPtr (tabla)", pointerSeconds * perLookup);
+  std::printf("mismo resultado: %s\n", castSum == sharedSum && sharedSum == pointerSum ? "si" : "NO");
+}
@@ -0,0 +1,48 @@
+/*
+ * LodSelector::select con 10,000 a 1,000,000 actores repartidos en un cubo
+ * de 2 km, la mitad con LODs generados (relativeError) y la mitad hechos a
+ * mano (screenSize), mientras la cmara avanza en cada frame.
+ */
+#include "bench/Bench.h"
+#include "LodSelector.h"
+
+#include <random>
+
+SAKURA_BENCH(lod_select) {
+  const size_t counts[3] = { 10000, 100000, 1000000 };
+  const int frames = options.quick ? 5 : 200;
+
+  std::printf("%-10s %12s %12s %12s\n", "actores", "ms/frame", "ns/actor", "cambios");
+  for (size_t count : counts) {
+    if (options.quick && count > 100000) break;
+
+    LodSelector selector;
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> coordinate(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> radius(0.5f, 5.0f);
+    const LodThreshold generated[3] = { { 0.0f, 0.002f }, { 0.0f, 0.008f }, { 0.0f, 0.03f } };
+    const LodThreshold authored[2] = { { 0.5f, 0.0f }, { 0.25f, 0.0f } };
+    for (size_t i = 0; i < count; ++i) {
+      const uint32_t slot = selector.add();
+      if (i % 2 == 0) selector.setLevels(slot, generated, 3);
+      else selector.setLevels(slot, authored, 2);
+      selector.setBounds(slot, coordinate(random), coordinate(random), coordinate(random), radius(random));
+    }
+
+    // cot(45 / 2) y un viewport de 1080 pixeles
+    const float projectionScale = 2.4142136f;
+    float camera[3] = { 0.0f, 0.0f, -1200.0f };
+    selector.select(camera, projectionScale, 1080.0f);
+
+    size_t switches = 0;
+    double best = 0.0;
+    for (int frame = 0; frame < frames; ++frame) {
+      camera[2] += 10.0f;
+      selector.select(camera, projectionScale, 1080.0f);
+      const LodSelectorStats& stats = selector.getLastStats();
+      switches += stats.switches;
+      if (frame == 0 || stats.seconds < best) best = stats.seconds;
+    }
+    std::printf("%-10zu %12.3f %12.2f %12zu\n", count, best * 1000.0, best * 1.0e9 / count, switches / frames);
+  }
+}
@@ -0,0 +1,65 @@
+/*
+ * MeshBounds con 1,000,000 y 4,000,000 de vrtices: la caja (SSE2) contra
+ * un recorrido escalar hecho aqu, y el radio de la esfera.
+ */
+#include "bench/Bench.h"
+#include "MeshBounds.h"
+#include "Prerequisites.h"
+
+#include <cfloat>
+#include <random>
+#include <vector>
+
+// Lo mismo que computeAabb, un vrtice por vuelta.
+static void
+scalarAabb(const std::vector<SimpleVertex>& vertices, float outMin[3], float outMax[3]) {
+  for (int k = 0; k < 3; ++k) {
+    outMin[k] = FLT_MAX;
+    outMax[k] = -FLT_MAX;
+  }
+  for (const SimpleVertex& vertex : vertices) {
+    const float p[3] = { vertex.Pos.x, vertex.Pos.y, vertex.Pos.z };
+    for (int k = 0; k < 3; ++k) {
+      if (p[k] < outMin[k]) outMin[k] = p[k];
+      if (p[k] > outMax[k]) outMax[k] = p[k];
+    }
+  }
+}
+
+SAKURA_BENCH(mesh_bounds) {
+  const size_t counts[2] = { 1000000, 4000000 };
+  const int repeats = options.quick ? 1 : 20;
+
+  std::printf("%-10s %12s %12s %12s %8s\n", "vertices", "caja ms", "escalar ms", "radio ms", "igual");
+  for (size_t count : counts) {
+    if (options.quick && count > 1000000) break;
+
+    std::vector<SimpleVertex> vertices(count);
+    std::mt19937 random(13);
+    std::uniform_real_distribution<float> coordinate(-50.0f, 50.0f);
+    for (SimpleVertex& vertex : vertices) {
+      vertex.Pos = XMFLOAT3(coordinate(random), coordinate(random), coordinate(random));
+      vertex.Tex = XMFLOAT2(0.0f, 0.0f);
+    }
+
+    float simdMin[3], simdMax[3], scalarMin[3], scalarMax[3];
+    const double simdSeconds = benchBest(repeats, [&]() {
+      MeshBounds::computeAabb(vertices.data(), count, sizeof(SimpleVertex), simdMin, simdMax);
+    });
+    const double scalarSeconds = benchBest(repeats, [&]() {
+      scalarAabb(vertices, scalarMin, scalarMax);
+      benchKeep(scalarMin[0]);
+    });
+    const float center[3] = { 0.5f * (simdMin[0] + simdMax[0]), 0.5f * (simdMin[1] + simdMax[1]), 0.5f * (simdMin[2] + simdMax[2]) };
+    float radius = 0.0f;
+    const double radiusSeconds = benchBest(repeats, [&]() {
+      radius = MeshBounds::computeRadius(vertices.data(), count, sizeof(SimpleVertex), center);
+    });
+    benchKeep(radius);
+
+    bool same = true;
+    for (int k = 0; k < 3; ++k) same = same && simdMin[k] == scalarMin[k] && simdMax[k] == scalarMax[k];
+    std::printf("%-10zu %12.3f %12.3f %12.3f %8s\n", count, simdSeconds * 1000.0, scalarSeconds * 1000.0,
+      radiusSeconds * 1000.0, same ? "si" : "NO");
+  }
+}
@@ -0,0 +1,83 @@
+/*
+ * Cach .sakmesh: arranque en fro (parsear el .obj y escribir la cach)
+ * contra arranque con cach (mapear, validar y copiar vrtices e ndices),
+ * y el arranque en que solo cambi la fecha del fuente (se calcula el hash
+ * una vez y la fecha queda guardada).
+ */
+#include "bench/Bench.h"
+#include "ObjTestFiles.h"
+#include "MeshCache.h"
+#include "OBJReader.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <filesystem>
+#include <vector>
+
+// Lo mismo que hace Model3D::LoadMeshCache con cada malla.
+static size_t
+copyFromCache(const MeshCache& cache) {
+  size_t indices = 0;
+  for (uint32_t m = 0; m < cache.meshCount(); ++m) {
+    const MeshCacheMeshView view = cache.mesh(m);
+    const SimpleVertex* vertices = static_cast<const SimpleVertex*>(view.vertices);
+    std::vector<SimpleVertex> vertexCopy(vertices, vertices + view.vertexCount);
+    std::vector<unsigned int> indexCopy(view.indices, view.indices + view.indexCount);
+    indices += indexCopy.size();
+    benchKeep(vertexCopy.data());
+  }
+  return indices;
+}
+
+SAKURA_BENCH(mesh_cache) {
+  const unsigned int side = options.quick ? 100 : 1000;
+  const std::string sourcePath = testTempPath("bench_cache.obj");
+  const std::string cachePath = sourcePath + ".sakmesh";
+  writeGridObj(sourcePath, side, side);
+  const uint64_t settings = 1;
+
+  const double coldSeconds = benchBest(1, [&]() {
+    ObjReader reader;
+    MeshComponent mesh;
+    reader.load(sourcePath, mesh);
+    MeshCacheSource source;
+    MeshCache::stampSource(sourcePath, source, true);
+    MeshCacheMesh cacheMesh;
+    cacheMesh.name = "grid";
+    cacheMesh.vertices = mesh.m_vertex.data();
+    cacheMesh.vertexCount = static_cast<uint32_t>(mesh.m_vertex.size());
+    cacheMesh.indices = mesh.m_index.data();
+    cacheMesh.indexCount = static_cast<uint32_t>(mesh.m_index.size());
+    MeshCache::write(cachePath, source, settings, sizeof(SimpleVertex), { cacheMesh });
+  });
+
+  bool warmOk = true;
+  const double warmSeconds = benchBest(options.quick ? 1 : 5, [&]() {
+    MeshCache cache;
+    warmOk = warmOk && cache.open(cachePath, sourcePath, settings, sizeof(SimpleVertex));
+    benchKeep(copyFromCache(cache));
+  });
+
+  // Solo cambia la fecha: la primera apertura compara el hash y la guarda
+  std::filesystem::last_write_time(sourcePath, std::filesystem::last_write_time(sourcePath) + std::chrono::hours(1));
+  bool touchedOk = true;
+  const double touchedSeconds = benchBest(1, [&]() {
+    MeshCache cache;
+    touchedOk = cache.open(cachePath, sourcePath, settings, sizeof(SimpleVertex));
+    benchKeep(copyFromCache(cache));
+  });
+  const double afterTouchSeconds = benchBest(options.quick ? 1 : 5, [&]() {
+    MeshCache cache;
+    touchedOk = touchedOk && cache.open(cachePath, sourcePath, settings, sizeof(SimpleVertex));
+    benchKeep(copyFromCache(cache));
+  });
+
+  std::printf("%-28s %10s\n", "arranque", "segundos");
+  std::printf("%-28s %10.3f\n", "frio (obj + escribir)", coldSeconds);
+  std::printf("%-28s %10.3f %s\n", "con cache", warmSeconds, warmOk ? "" : "(NO abrio)");
+  std::printf("%-28s %10.3f %s\n", "fecha cambiada (hash)", touchedSeconds, touchedOk ? "" : "(NO abrio)");
+  std::printf("%-28s %10.3f\n", "siguiente arranque", afterTouchSeconds);
+  std::printf("(obj %.1f MB, cache %.1f MB, %.1fx mas rapido con cache)\n",
+    std::filesystem::file_size(sourcePath) / (1024.0 * 1024.0),
+    std::filesystem::file_size(cachePath) / (1024.0 * 1024.0), coldSeconds / warmSeconds);
+}
@@ -0,0 +1,59 @@
+/*
+ * MeshOptimizer: ACMR y ATVR antes y despus de optimizeVertexCache +
+ * optimizeVertexFetch, y lo que tarda cada paso. El repositorio no trae
+ * modelos, as que se usan una rejilla leda con ObjReader (el orden en que
+ * la deja el importador, fila por fila) y la misma rejilla con los
+ * tringulos en orden aleatorio.
+ */
+#include "bench/Bench.h"
+#include "ObjTestFiles.h"
+#include "MeshOptimizer.h"
+#include "OBJReader.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+static void
+optimizeAndReport(const char* name, std::vector<SimpleVertex> vertices, std::vector<uint32_t> indices) {
+  const VertexCacheStats before = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+  auto start = std::chrono::steady_clock::now();
+  MeshOptimizer::optimizeVertexCache(indices.data(), indices.size(), vertices.size());
+  const double cacheSeconds = benchSecondsSince(start);
+
+  start = std::chrono::steady_clock::now();
+  const size_t kept = MeshOptimizer::optimizeVertexFetch(vertices.data(), vertices.size(), sizeof(SimpleVertex),
+    indices.data(), indices.size());
+  const double fetchSeconds = benchSecondsSince(start);
+  vertices.resize(kept);
+
+  const VertexCacheStats after = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+  std::printf("%-10s %10zu %7.3f %7.3f %7.3f %7.3f %10.3f %10.3f\n", name, before.triangles,
+    before.acmr, after.acmr, before.atvr, after.atvr, cacheSeconds, fetchSeconds);
+}
+
+SAKURA_BENCH(vertex_cache) {
+  const unsigned int side = options.quick ? 60 : 500;
+  const std::string path = testTempPath("bench_vertex_cache.obj");
+  writeGridObj(path, side, side, ObjGridOptions{ false, false, 0 });
+  ObjReader reader;
+  MeshComponent mesh;
+  reader.load(path, mesh);
+
+  std::printf("%-10s %10s %7s %7s %7s %7s %10s %10s\n", "orden", "triangulos",
+    "ACMR", "despues", "ATVR", "despues", "cache s", "fetch s");
+  optimizeAndReport("importado", mesh.m_vertex, mesh.m_index);
+
+  // Mismos tringulos en orden aleatorio (semilla fija)
+  std::vector<uint32_t> shuffled = mesh.m_index;
+  std::vector<size_t> order(shuffled.size() / 3);
+  for (size_t t = 0; t < order.size(); ++t) order[t] = t;
+  std::shuffle(order.begin(), order.end(), std::mt19937(7));
+  for (size_t t = 0; t < order.size(); ++t) {
+    for (int k = 0; k < 3; ++k) shuffled[t * 3 + k] = mesh.m_index[order[t] * 3 + k];
+  }
+  optimizeAndReport("aleatorio", mesh.m_vertex, shuffled);
+}
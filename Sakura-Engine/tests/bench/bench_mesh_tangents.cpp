@@ -0,0 +1,47 @@
+/*
+ * MeshTangents::generate sobre una esfera uv de 1024x1000 (unos 2 millones
+ * de tringulos y un milln de vrtices) con 1, 2, 4 y 8 hilos. Cada
+ * corrida empieza de los ndices originales (generate los reescribe para
+ * los duplicados) y la salida se compara con la de un hilo.
+ */
+#include "bench/Bench.h"
+#include "MeshTangents.h"
+#include "MeshTestShapes.h"
+
+#include <chrono>
+#include <vector>
+
+SAKURA_BENCH(mesh_tangents) {
+  const TestMesh sphere = options.quick ? makeUvSphere(128, 100) : makeUvSphere(1024, 1000);
+  const int repeats = options.quick ? 1 : 3;
+  const unsigned int threadCounts[4] = { 1, 2, 4, 8 };
+
+  std::printf("%zu vertices, %zu triangulos\n", sphere.vertices.size(), sphere.triangleCount());
+  std::printf("%-6s %10s %12s %11s %12s %8s\n", "hilos", "s", "Mtri/s", "separados", "degenerados", "iguales");
+
+  std::vector<float> firstNormals, firstTangents;
+  std::vector<uint32_t> indices, remap;
+  std::vector<float> normals, tangents;
+  for (unsigned int threads : threadCounts) {
+    double best = 0.0;
+    MeshTangentStats stats;
+    size_t kept = 0;
+    for (int r = 0; r < repeats; ++r) {
+      indices = sphere.indices;
+      const auto start = std::chrono::steady_clock::now();
+      kept = MeshTangents::generate(sphere.vertices.data(), sphere.vertices.size(), sizeof(SimpleVertex),
+        indices.data(), indices.size(), normals, tangents, remap, threads, &stats);
+      const double seconds = benchSecondsSince(start);
+      if (r == 0 || seconds < best) best = seconds;
+    }
+    benchKeep(kept);
+
+    if (threads == 1) {
+      firstNormals = normals;
+      firstTangents = tangents;
+    }
+    const bool same = normals == firstNormals && tangents == firstTangents;
+    std::printf("%-6u %10.3f %12.2f %11zu %12zu %8s\n", stats.threads, best,
+      sphere.triangleCount() / best / 1.0e6, stats.splitVertices, stats.degenerateTriangles, same ? "si" : "NO");
+  }
+}
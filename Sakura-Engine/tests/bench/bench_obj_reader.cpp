@@ -0,0 +1,98 @@
+/*
+ * Lectura de .obj: load (archivo mapeado, sin strings por lnea) contra
+ * loadLegacy (getline + stringstream + stof), en MB/s y reservas de memoria,
+ * load con 1 a 16 hilos, y el pre-escaneo encendido y apagado.
+ */
+#include "bench/Bench.h"
+#include "ObjTestFiles.h"
+#include "OBJReader.h"
+#include "TestCheck.h"
+
+#include <cstring>
+#include <thread>
+
+SAKURA_BENCH(obj_parse) {
+  // 1000 x 1000 cuadros son unos 2 millones de tringulos (~70 MB)
+  const unsigned int side = options.quick ? 100 : 1000;
+  const std::string path = testTempPath("bench_parse.obj");
+  writeGridObj(path, side, side);
+
+  std::printf("%-8s %10s %10s %10s %12s\n", "camino", "MB", "segundos", "MB/s", "reservas");
+  for (int legacy = 1; legacy >= 0; --legacy) {
+    ObjReader reader;
+    MeshComponent mesh;
+    const size_t allocationsBefore = benchAllocations();
+    legacy ? reader.loadLegacy(path, mesh) : reader.load(path, mesh);
+    const size_t allocations = benchAllocations() - allocationsBefore;
+    const ObjLoadStats& stats = reader.getLastStats();
+    std::printf("%-8s %10.1f %10.3f %10.1f %12zu\n", legacy ? "legacy" : "load",
+      stats.bytes / (1024.0 * 1024.0), stats.seconds, stats.megabytesPerSecond(), allocations);
+  }
+}
+
+SAKURA_BENCH(obj_threads) {
+  const unsigned int side = options.quick ? 400 : 1000;
+  const std::string path = testTempPath("bench_threads.obj");
+  writeGridObj(path, side, side);
+
+  ObjReader reader;
+  MeshComponent serial;
+  reader.setThreadCount(1);
+  reader.load(path, serial);
+  const double serialSeconds = reader.getLastStats().seconds;
+
+  std::printf("%-6s %10s %10s %10s %10s\n", "hilos", "segundos", "MB/s", "aumento", "igual");
+  const unsigned int threadCounts[] = { 1, 2, 4, 8, 16 };
+  for (unsigned int threads : threadCounts) {
+    MeshComponent mesh;
+    reader.setThreadCount(threads);
+    const double seconds = benchBest(options.quick ? 1 : 3, [&]() { reader.load(path, mesh); });
+    const bool same = mesh.m_index == serial.m_index &&
+      mesh.m_vertex.size() == serial.m_vertex.size() &&
+      std::memcmp(mesh.m_vertex.data(), serial.m_vertex.data(), mesh.m_vertex.size() * sizeof(SimpleVertex)) == 0;
+    const double megabytes = reader.getLastStats().bytes / (1024.0 * 1024.0);
+    std::printf("%-6u %10.3f %10.1f %9.2fx %10s\n", reader.getLastStats().threads, seconds,
+      megabytes / seconds, serialSeconds / seconds, same ? "si" : "NO");
+  }
+  std::printf("(nucleos en esta maquina: %u)\n", std::thread::hardware_concurrency());
+}
+
+// Con y sin pre-escaneo: veces que un vector o el cache tuvo que crecer,
+// reservas de memoria y tiempo total (incluido lo que cuesta contar). Con
+// materiales los rangos por material siguen creciendo, porque el
+// pre-escaneo solo cuenta el total.
+SAKURA_BENCH(obj_prescan) {
+  const unsigned int side = options.quick ? 100 : 1000;
+  std::printf("%-10s %-10s %-9s %10s %10s %12s %12s\n", "materiales", "carga", "escaneo", "segundos", "escaneo s", "crecimientos", "reservas");
+  for (unsigned int materials = 0; materials <= 4; materials += 4) {
+    const std::string path = testTempPath("bench_prescan.obj");
+    writeGridObj(path, side, side, ObjGridOptions{ true, true, materials });
+    for (int streaming = 0; streaming < 2; ++streaming) {
+      for (int preScan = 0; preScan < 2; ++preScan) {
+        ObjReader reader;
+        reader.setPreScan(preScan != 0);
+        size_t allocations = 0;
+        const double seconds = benchBest(options.quick ? 1 : 3, [&]() {
+          const size_t allocationsBefore = benchAllocations();
+          if (streaming) {
+            struct CountingSink : IObjBatchSink {
+              size_t triangles = 0;
+              bool onBatch(const ObjMeshBatch& batch) override { triangles += batch.indexCount / 3; return true; }
+            } sink;
+            reader.loadStreaming(path, sink);
+            benchKeep(sink.triangles);
+          }
+          else {
+            MeshComponent mesh;
+            reader.load(path, mesh);
+            benchKeep(mesh.m_numIndex);
+          }
+          allocations = benchAllocations() - allocationsBefore;
+        });
+        const ObjLoadStats& stats = reader.getLastStats();
+        std::printf("%-10u %-10s %-9s %10.3f %10.3f %12zu %12zu\n", materials, streaming ? "streaming" : "load",
+          preScan ? "si" : "no", seconds, stats.preScanSeconds, stats.reallocations, allocations);
+      }
+    }
+  }
+}
@@ -0,0 +1,78 @@
+/*
+ * SceneGraph::update en un hilo con dos formas extremas de 10,000 a
+ * 1,000,000 de nodos: una cadena (cada nodo hijo del anterior) y una raz
+ * con todos los dems como hijos. Mide el primer update (ordenar y calcular
+ * todo) y lo que cuesta mover la raz, el nodo de en medio, la ltima hoja
+ * y el 1% de las hojas.
+ */
+#include "bench/Bench.h"
+#include "SceneGraph.h"
+
+#include <vector>
+
+// Matriz de traslacin (vectores fila: la traslacin va en el ltimo rengln).
+static void
+translation(float x, float matrix[16]) {
+  for (int i = 0; i < 16; ++i) matrix[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+  matrix[12] = x;
+}
+
+// Mejor tiempo de cambiar la matriz local de 'nodes' y hacer update.
+static double
+timeMove(SceneGraph& graph, const std::vector<uint32_t>& nodes, int repeats, size_t& updated) {
+  float step = 0.0f;
+  float matrix[16];
+  const double seconds = benchBest(repeats, [&]() {
+    step += 1.0f;
+    translation(step, matrix);
+    for (uint32_t node : nodes) graph.setLocal(node, matrix);
+    graph.update(1);
+  });
+  updated = graph.getLastStats().updatedNodes;
+  return seconds;
+}
+
+SAKURA_BENCH(scene_graph) {
+  const size_t counts[3] = { 10000, 100000, 1000000 };
+  const int repeats = options.quick ? 1 : 20;
+
+  std::printf("%-8s %-10s %10s %10s %10s %10s %12s\n", "forma", "nodos", "armar ms", "raiz ms", "medio ms",
+    "hoja ms", "1% hojas ms");
+  for (size_t count : counts) {
+    if (options.quick && count > 10000) break;
+
+    for (int wide = 0; wide < 2; ++wide) {
+      SceneGraph graph;
+      std::vector<uint32_t> nodes(count);
+      nodes[0] = graph.create();
+      for (size_t i = 1; i < count; ++i) nodes[i] = graph.create(wide ? nodes[0] : nodes[i - 1]);
+
+      const auto buildStart = std::chrono::steady_clock::now();
+      graph.update(1);
+      const double buildSeconds = benchSecondsSince(buildStart);
+
+      size_t updated = 0;
+      const double rootSeconds = timeMove(graph, { nodes[0] }, repeats, updated);
+      const bool rootOk = updated == count;
+      const double middleSeconds = timeMove(graph, { nodes[count / 2] }, repeats, updated);
+      const bool middleOk = updated == (wide ? 1 : count - count / 2);
+      const double leafSeconds = timeMove(graph, { nodes[count - 1] }, repeats, updated);
+      const bool leafOk = updated == 1;
+
+      // El 1% de las hojas: en la cadena solo hay una, as que ah no aplica
+      char leavesText[32] = "-";
+      bool leavesOk = true;
+      if (wide) {
+        std::vector<uint32_t> leaves;
+        for (size_t i = 1; i < count; i += 100) leaves.push_back(nodes[i]);
+        const double leavesSeconds = timeMove(graph, leaves, repeats, updated);
+        leavesOk = updated == leaves.size();
+        std::snprintf(leavesText, sizeof(leavesText), "%.3f", leavesSeconds * 1000.0);
+      }
+
+      std::printf("%-8s %-10zu %10.3f %10.3f %10.3f %10.3f %12s%s\n", wide ? "ancha" : "cadena", count,
+        buildSeconds * 1000.0, rootSeconds * 1000.0, middleSeconds * 1000.0, leafSeconds * 1000.0, leavesText,
+        rootOk && middleOk && leafOk && leavesOk ? "" : "  (nodos recalculados inesperados)");
+    }
+  }
+}
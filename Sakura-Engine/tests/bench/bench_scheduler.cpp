@@ -0,0 +1,248 @@
+/*
+ * Frame sinttico de 100,000 entidades con SystemScheduler: mover, girar,
+ * matriz local, SceneGraph, caja, culling, LOD y una "subida" en el hilo
+ * principal, con 1, 2, 4 y 8 hilos. Revisa que el resultado sea el mismo
+ * con cualquier nmero de hilos.
+ *
+ * Adems compara SceneGraph::update repartiendo con hilos propios (se crean
+ * en cada llamada) contra repartir con SystemScheduler::parallelFor.
+ */
+#include "bench/Bench.h"
+#include "bench/BenchEntities.h"
+#include "ECS/SystemScheduler.h"
+#include "ECS/World.h"
+#include "LodSelector.h"
+#include "SceneGraph.h"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+struct BenchSpin {
+  float angle = 0.0f;
+  float speed = 0.0f;
+};
+
+struct BenchLocal {
+  float m[16];
+  uint32_t node = SceneGraph::kInvalidNode;
+};
+
+struct BenchBounds {
+  float center[3] = { 0.0f, 0.0f, 0.0f };
+  float radius = 1.0f;
+};
+
+struct BenchVisible {
+  bool value = false;
+};
+
+struct BenchLod {
+  uint32_t slot = 0;
+};
+
+// Etiquetas de los recursos que no son componentes
+struct BenchSceneAccess_ {};
+struct BenchLodAccess_ {};
+struct BenchUploadAccess_ {};
+
+// Giro en y y traslacin, por renglones (vectores fila).
+static void
+localMatrix(const BenchPosition& p, float angle, float m[16]) {
+  const float c = std::cos(angle), s = std::sin(angle);
+  const float values[16] = {
+    c, 0.0f, -s, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    s, 0.0f, c, 0.0f,
+    p.x, p.y, p.z, 1.0f };
+  std::memcpy(m, values, sizeof(values));
+}
+
+struct FrameResult {
+  double averageMs = 0.0;
+  double bestMs = 0.0;
+  double checksum = 0.0;
+  size_t visible = 0;
+  std::vector<SystemTiming> timings;  // Del ltimo frame.
+};
+
+static FrameResult
+runScene(size_t count, unsigned int threads, int frames) {
+  World world;
+  SceneGraph graph;
+  LodSelector selector;
+  SystemScheduler scheduler(threads);
+  std::vector<float> upload;
+
+  std::mt19937 random(21);
+  std::uniform_real_distribution<float> coordinate(-500.0f, 500.0f);
+  std::vector<uint32_t> nodes(count);
+  const LodThreshold levels[3] = { { 0.0f, 0.002f }, { 0.0f, 0.008f }, { 0.0f, 0.03f } };
+  for (size_t i = 0; i < count; ++i) {
+    // Grupos de 10: el primero es la raz y los otros nueve sus hijos
+    nodes[i] = graph.create(i % 10 == 0 ? SceneGraph::kInvalidNode : nodes[i - i % 10]);
+    BenchLocal local;
+    local.node = nodes[i];
+    BenchLod lod;
+    lod.slot = selector.add();
+    selector.setLevels(lod.slot, levels, 3);
+    const BenchPosition position{ coordinate(random), coordinate(random), coordinate(random) };
+    const BenchSpin spin{ 0.0f, static_cast<float>(i % 7) * 0.1f };
+    if (i % 2 == 0) {
+      world.create(position, BenchVelocity{ 1.0f, 0.0f, -0.5f }, spin, local, BenchBounds(), BenchVisible(), lod);
+    }
+    else {
+      world.create(position, spin, local, BenchBounds(), BenchVisible(), lod);
+    }
+  }
+
+  scheduler.addSystem("Mover", World::maskOf<BenchVelocity>(), World::maskOf<BenchPosition>(), [&](float dt) {
+    scheduler.parallelForChunks<BenchPosition, BenchVelocity>(world, 1024, [&](const WorldChunk& chunk) {
+      world.forEachInChunk<BenchPosition, BenchVelocity>(chunk, [dt](BenchPosition& p, const BenchVelocity& v) {
+        p.x += v.x * dt;
+        p.y += v.y * dt;
+        p.z += v.z * dt;
+      });
+    });
+  });
+  scheduler.addSystem("Girar", 0, World::maskOf<BenchSpin>(), [&](float dt) {
+    scheduler.parallelForChunks<BenchSpin>(world, 1024, [&](const WorldChunk& chunk) {
+      world.forEachInChunk<BenchSpin>(chunk, [dt](BenchSpin& spin) { spin.angle += spin.speed * dt; });
+    });
+  });
+  scheduler.addSystem("Matriz", World::maskOf<BenchPosition, BenchSpin>(),
+    World::maskOf<BenchLocal, BenchSceneAccess_>(), [&](float) {
+    scheduler.parallelForChunks<BenchPosition, BenchSpin, BenchLocal>(world, 1024, [&](const WorldChunk& chunk) {
+      std::vector<uint32_t> changed;
+      std::vector<float> matrices;
+      world.forEachInChunk<BenchPosition, BenchSpin, BenchLocal>(chunk,
+        [&](const BenchPosition& p, const BenchSpin& spin, BenchLocal& local) {
+        if (spin.speed == 0.0f) return;
+        localMatrix(p, spin.angle, local.m);
+        changed.push_back(local.node);
+        matrices.insert(matrices.end(), local.m, local.m + 16);
+      });
+      if (!changed.empty()) graph.setLocals(changed.data(), matrices.data(), changed.size());
+    });
+  });
+  scheduler.addSystem("SceneGraph", 0, World::maskOf<BenchSceneAccess_>(), [&](float) {
+    graph.update(scheduler.getThreadCount(),
+      [&](size_t tasks, const std::function<void(size_t, size_t)>& fn) { scheduler.parallelFor(tasks, 1, fn); });
+  });
+  scheduler.addSystem("Caja", World::maskOf<BenchLocal, BenchSceneAccess_>(), World::maskOf<BenchBounds>(),
+    [&](float) {
+    scheduler.parallelForChunks<BenchLocal, BenchBounds>(world, 1024, [&](const WorldChunk& chunk) {
+      world.forEachInChunk<BenchLocal, BenchBounds>(chunk, [&](const BenchLocal& local, BenchBounds& bounds) {
+        const float* matrix = graph.getWorld(local.node);
+        bounds.center[0] = matrix[12];
+        bounds.center[1] = matrix[13];
+        bounds.center[2] = matrix[14];
+      });
+    });
+  });
+  scheduler.addSystem("Culling", World::maskOf<BenchBounds>(), World::maskOf<BenchVisible>(), [&](float) {
+    scheduler.parallelForChunks<BenchBounds, BenchVisible>(world, 1024, [&](const WorldChunk& chunk) {
+      world.forEachInChunk<BenchBounds, BenchVisible>(chunk, [](const BenchBounds& bounds, BenchVisible& visible) {
+        // Una caja de 400 de lado frente a la cmara hace de frustum
+        bool inside = true;
+        for (int k = 0; k < 3; ++k) {
+          inside = inside && bounds.center[k] + bounds.radius >= -200.0f && bounds.center[k] - bounds.radius <= 200.0f;
+        }
+        visible.value = inside;
+      });
+    });
+  });
+  scheduler.addSystem("LOD", World::maskOf<BenchBounds, BenchLod>(), World::maskOf<BenchLodAccess_>(), [&](float) {
+    world.forEach<BenchBounds, BenchLod>([&](const BenchBounds& bounds, const BenchLod& lod) {
+      selector.setBounds(lod.slot, bounds.center[0], bounds.center[1], bounds.center[2], bounds.radius);
+    });
+    const float camera[3] = { 0.0f, 0.0f, -600.0f };
+    selector.select(camera, 2.4142136f, 1080.0f);
+  });
+  scheduler.addSystem("Subida", World::maskOf<BenchVisible, BenchLocal, BenchSceneAccess_>(),
+    World::maskOf<BenchUploadAccess_>(), [&](float) {
+    upload.clear();
+    world.forEach<BenchLocal, BenchVisible>([&](const BenchLocal& local, const BenchVisible& visible) {
+      if (!visible.value) return;
+      const float* matrix = graph.getWorld(local.node);
+      upload.insert(upload.end(), matrix, matrix + 16);
+    });
+  }, SystemScheduler::kMainThread);
+
+  // El primer frame arma el SceneGraph y calcula todas las matrices
+  scheduler.run(0.016f);
+
+  FrameResult result;
+  double total = 0.0;
+  for (int frame = 0; frame < frames; ++frame) {
+    const auto start = std::chrono::steady_clock::now();
+    scheduler.run(0.016f);
+    const double seconds = benchSecondsSince(start);
+    total += seconds;
+    if (frame == 0 || seconds < result.bestMs) result.bestMs = seconds;
+  }
+  result.averageMs = total * 1000.0 / frames;
+  result.timings = scheduler.getLastStats().timings;
+  result.bestMs *= 1000.0;
+  result.visible = upload.size() / 16;
+  for (float value : upload) result.checksum += value;
+  world.forEach<BenchLod>([&](const BenchLod& lod) { result.checksum += selector.lod(lod.slot); });
+  return result;
+}
+
+SAKURA_BENCH(scheduler_frame) {
+  const size_t count = options.quick ? 10000 : 100000;
+  const int frames = options.quick ? 3 : 100;
+  const unsigned int threadCounts[4] = { 1, 2, 4, 8 };
+
+  std::printf("%zu entidades, 8 sistemas\n", count);
+  std::printf("%-8s %12s %12s %10s %8s\n", "hilos", "ms/frame", "mejor ms", "visibles", "igual");
+  double reference = 0.0;
+  std::vector<SystemTiming> singleThread;
+  for (unsigned int threads : threadCounts) {
+    const FrameResult result = runScene(count, threads, frames);
+    if (threads == 1) {
+      reference = result.checksum;
+      singleThread = result.timings;
+    }
+    std::printf("%-8u %12.3f %12.3f %10zu %8s\n", threads, result.averageMs, result.bestMs, result.visible,
+      result.checksum == reference ? "si" : "NO");
+  }
+  std::printf("con 1 hilo, ultimo frame:");
+  for (const SystemTiming& timing : singleThread) std::printf(" %s %.2f ms", timing.name.c_str(), timing.seconds * 1000.0);
+  std::printf("\n");
+
+  // SceneGraph con nodos marcados: hilos nuevos en cada update contra los
+  // hilos del scheduler. Cada raz marcada arrastra a sus nueve hijos
+  SceneGraph graph;
+  std::vector<uint32_t> nodes(count);
+  for (size_t i = 0; i < count; ++i) nodes[i] = graph.create(i % 10 == 0 ? SceneGraph::kInvalidNode : nodes[i - i % 10]);
+  graph.update(1);
+  float matrix[16];
+  BenchPosition position{ 0.0f, 0.0f, 0.0f };
+  const int repeats = options.quick ? 1 : 50;
+  std::printf("\nSceneGraph::update\n");
+  std::printf("%-10s %-8s %14s %14s\n", "marcados", "hilos", "propios ms", "scheduler ms");
+  for (size_t rootStep = 100; rootStep >= 10; rootStep /= 10) {
+    for (unsigned int threads : threadCounts) {
+      SystemScheduler scheduler(threads);
+      const SceneGraph::ParallelFor parallelFor = [&](size_t tasks, const std::function<void(size_t, size_t)>& fn) {
+        scheduler.parallelFor(tasks, 1, fn);
+      };
+      double seconds[2];
+      size_t updated = 0;
+      for (int useScheduler = 0; useScheduler < 2; ++useScheduler) {
+        seconds[useScheduler] = benchBest(repeats, [&]() {
+          position.x += 1.0f;
+          localMatrix(position, 0.0f, matrix);
+          for (size_t i = 0; i < count; i += rootStep) graph.setLocal(nodes[i], matrix);
+          if (useScheduler) graph.update(threads, parallelFor);
+          else graph.update(threads);
+        });
+        updated = graph.getLastStats().updatedNodes;
+      }
+      std::printf("%-10zu %-8u %14.3f %14.3f\n", updated, threads, seconds[0] * 1000.0, seconds[1] * 1000.0);
+    }
+  }
+}
@@ -0,0 +1,74 @@
+/*
+ * World con 10,000, 100,000 y 1,000,000 de entidades: todas con posicin y
+ * la mitad con velocidad. Mide crearlas y un frame de forEach que suma la
+ * velocidad a la posicin, contra lo mismo con un objeto en el heap por
+ * componente (Entity y getComponentPtr, como los Actor).
+ */
+#include "bench/Bench.h"
+#include "bench/BenchEntities.h"
+#include "ECS/World.h"
+
+#include <memory>
+#include <vector>
+
+SAKURA_BENCH(world_iterate) {
+  const size_t counts[3] = { 10000, 100000, 1000000 };
+  const int repeats = options.quick ? 1 : 20;
+
+  std::printf("%-10s %12s %12s %12s %12s %8s\n", "entidades", "crear ms", "forEach ms", "heap crear", "heap ms",
+    "igual");
+  for (size_t count : counts) {
+    if (options.quick && count > 100000) break;
+
+    World world;
+    const auto createStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+      if (i % 2 == 0) world.create(BenchPosition(), BenchVelocity{ 1.0f, 0.5f, 0.25f });
+      else world.create(BenchPosition());
+    }
+    const double createSeconds = benchSecondsSince(createStart);
+
+    const double iterateSeconds = benchBest(repeats, [&]() {
+      world.forEach<BenchPosition, BenchVelocity>([](BenchPosition& p, const BenchVelocity& v) {
+        p.x += v.x * 0.016f;
+        p.y += v.y * 0.016f;
+        p.z += v.z * 0.016f;
+      });
+    });
+
+    std::vector<std::unique_ptr<BenchEntity>> entities;
+    entities.reserve(count);
+    const auto heapStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+      std::unique_ptr<BenchEntity> entity(new BenchEntity());
+      entity->addComponent(EU::TSharedPointer<BenchPositionComponent>(new BenchPositionComponent()));
+      if (i % 2 == 0) {
+        EU::TSharedPointer<BenchVelocityComponent> velocity(new BenchVelocityComponent());
+        velocity->value = BenchVelocity{ 1.0f, 0.5f, 0.25f };
+        entity->addComponent(velocity);
+      }
+      entities.push_back(std::move(entity));
+    }
+    const double heapCreateSeconds = benchSecondsSince(heapStart);
+
+    const double heapSeconds = benchBest(repeats, [&]() {
+      for (const std::unique_ptr<BenchEntity>& entity : entities) {
+        BenchVelocityComponent* velocity = entity->getComponentPtr<BenchVelocityComponent>();
+        if (!velocity) continue;
+        BenchPosition& p = entity->getComponentPtr<BenchPositionComponent>()->value;
+        p.x += velocity->value.x * 0.016f;
+        p.y += velocity->value.y * 0.016f;
+        p.z += velocity->value.z * 0.016f;
+      }
+    });
+
+    // Las dos versiones hicieron las mismas sumas el mismo nmero de veces
+    float worldSum = 0.0f, heapSum = 0.0f;
+    world.forEach<BenchPosition>([&](const BenchPosition& p) { worldSum += p.x; });
+    for (const std::unique_ptr<BenchEntity>& entity : entities) {
+      heapSum += entity->getComponentPtr<BenchPositionComponent>()->value.x;
+    }
+    std::printf("%-10zu %12.3f %12.3f %12.3f %12.3f %8s\n", count, createSeconds * 1000.0, iterateSeconds * 1000.0,
+      heapCreateSeconds * 1000.0, heapSeconds * 1000.0, worldSum == heapSum ? "si" : "NO");
+  }
+}
@@ -0,0 +1,7 @@
+#pragma once
+// Ver windows.h de esta carpeta: solo los formatos de ndice de MeshComponent.
+
+enum DXGI_FORMAT {
+  DXGI_FORMAT_R32_UINT = 42,
+  DXGI_FORMAT_R16_UINT = 57
+};
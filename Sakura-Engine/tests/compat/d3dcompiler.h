@@ -0,0 +1,2 @@
+#pragma once
+// Ver windows.h de esta carpeta.
@@ -0,0 +1,3 @@
+#pragma once
+// En Windows es el mismo Resource.h de include/ (no distingue maysculas).
+#include "Resource.h"
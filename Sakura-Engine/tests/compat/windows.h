@@ -0,0 +1,18 @@
+#pragma once
+/*
+ * Encabezados de plataforma para compilar las pruebas en Linux.
+ *
+ * Prerequisites.h incluye windows.h, xnamath.h y los de Direct3D. Las
+ * partes del motor que se prueban (lectores, procesos de malla, ECS) solo
+ * usan de ellos unos tipos y OutputDebugStringW, as que aqu va solo eso;
+ * nada que dibuje se compila en las pruebas.
+ */
+#include <cstdio>
+
+typedef unsigned int UINT;
+typedef long HRESULT;
+
+inline void
+OutputDebugStringW(const wchar_t* text) {
+  std::fprintf(stderr, "%ls", text);
+}
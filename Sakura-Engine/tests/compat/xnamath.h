@@ -0,0 +1,24 @@
+#pragma once
+// Ver windows.h de esta carpeta: solo los tipos que usa Prerequisites.h.
+
+struct XMFLOAT2 {
+  float x, y;
+  XMFLOAT2() = default;
+  XMFLOAT2(float _x, float _y) : x(_x), y(_y) {}
+};
+
+struct XMFLOAT3 {
+  float x, y, z;
+  XMFLOAT3() = default;
+  XMFLOAT3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {}
+};
+
+struct XMFLOAT4 {
+  float x, y, z, w;
+  XMFLOAT4() = default;
+  XMFLOAT4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+};
+
+struct XMMATRIX {
+  float m[4][4];
+};
@@ -0,0 +1,313 @@
+/*
+ * CommandQueue bajo carga: varias tareas del SystemScheduler anotan a la
+ * vez comandos al azar (create, destroy, add y remove de componentes de
+ * arquetipo y dispersos, sobre entidades vivas, nuevas del mismo buffer y
+ * ya destruidas) y despus de playback el World debe quedar igual que otro
+ * World al que se le aplicaron los mismos comandos directo, uno por uno.
+ * Se repite varios frames (las arenas se reutilizan) con 1, 4 y 8 hilos.
+ *
+ * Cada tarea solo toca sus propias entidades: entre buffers de hilos
+ * distintos el orden no est definido, dentro de uno s.
+ */
+#include "TestCheck.h"
+#include "ECS/CommandBuffer.h"
+#include "ECS/SystemScheduler.h"
+#include "ECS/World.h"
+
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+struct TestId {
+  uint64_t value = 0;
+};
+
+struct TestPosition {
+  float x = 0.0f;
+  int version = 0;
+};
+
+struct TestVelocity {
+  int value = 0;
+};
+
+struct TestHealth {
+  int value = 0;
+};
+
+// Con memoria propia: revisa que la arena mueva y destruya bien los componentes
+struct TestInventory {
+  std::vector<int> items;
+};
+
+struct TestMarked {
+  static constexpr bool kSparseStorage = true;
+  int value = 0;
+};
+
+enum class OpType {
+  Create,
+  Destroy,
+  AddId,
+  AddPosition,
+  AddVelocity,
+  RemoveVelocity,
+  AddHealth,
+  RemoveHealth,
+  AddInventory,
+  RemoveInventory,
+  AddMarked,
+  RemoveMarked
+};
+
+// A quin va dirigido un comando
+enum class TargetKind {
+  Existing,   // Entidad viva al empezar el frame (por su TestId).
+  Created,    // La k-sima entidad que cre la misma tarea.
+  Stale       // Entidad destruida en un frame anterior (su handle viejo).
+};
+
+struct Op {
+  OpType type;
+  TargetKind kind;
+  uint64_t target;   // TestId, o nmero de entidad creada.
+  int value;
+};
+
+// Handles de cada TestId en un World.
+struct Handles {
+  std::map<uint64_t, EntityHandle> alive;
+  std::map<uint64_t, EntityHandle> stale;
+};
+
+static const size_t kTasks = 16;
+static const size_t kInitialEntities = 20000;
+static const uint32_t kFrames = 8;
+
+static uint64_t
+createdId(uint32_t frame, size_t task, uint64_t local) {
+  return (uint64_t(frame + 1) << 40) | (uint64_t(task) << 20) | local;
+}
+
+// Comandos de una tarea en un frame: solo toca las entidades de su reparto.
+static std::vector<Op>
+makeScript(uint32_t frame, size_t task, const std::vector<uint64_t>& owned, const std::vector<uint64_t>& stale) {
+  std::mt19937 random(static_cast<uint32_t>(frame * 1000 + task));
+  const OpType changes[10] = { OpType::AddPosition, OpType::AddVelocity, OpType::RemoveVelocity, OpType::AddHealth,
+    OpType::RemoveHealth, OpType::AddInventory, OpType::RemoveInventory, OpType::AddMarked, OpType::RemoveMarked,
+    OpType::AddPosition };
+  std::vector<Op> script;
+
+  for (uint64_t id : owned) {
+    const int count = 1 + static_cast<int>(random() % 3);
+    for (int i = 0; i < count; ++i) {
+      const OpType type = random() % 20 == 0 ? OpType::Destroy : changes[random() % 10];
+      script.push_back({ type, TargetKind::Existing, id, static_cast<int>(random() % 1000) });
+    }
+  }
+
+  for (uint64_t local = 0; local < 20; ++local) {
+    script.push_back({ OpType::Create, TargetKind::Created, local, 0 });
+    script.push_back({ OpType::AddId, TargetKind::Created, local, 0 });
+    script.push_back({ OpType::AddPosition, TargetKind::Created, local, static_cast<int>(random() % 1000) });
+    if (random() % 2) script.push_back({ OpType::AddVelocity, TargetKind::Created, local, 5 });
+    if (random() % 3 == 0) script.push_back({ OpType::AddMarked, TargetKind::Created, local, 1 });
+    if (random() % 4 == 0) script.push_back({ OpType::AddInventory, TargetKind::Created, local, 3 });
+    // Lo que venga despus de un destroy no cuenta
+    if (random() % 10 == 0) {
+      script.push_back({ OpType::Destroy, TargetKind::Created, local, 0 });
+      script.push_back({ OpType::AddHealth, TargetKind::Created, local, 7 });
+    }
+  }
+
+  for (int n = 0; n < 5 && !stale.empty(); ++n) {
+    const OpType type = n == 0 ? OpType::Destroy : changes[random() % 10];
+    script.push_back({ type, TargetKind::Stale, stale[random() % stale.size()], static_cast<int>(random() % 1000) });
+  }
+  return script;
+}
+
+// Aplica los comandos directo al World; lo que va a entidades muertas se ignora.
+class DirectSink {
+public:
+  explicit DirectSink(World& world) : m_world(world) {}
+
+  EntityHandle
+    create() { return m_world.create(); }
+
+  void
+    destroy(EntityHandle entity) { m_world.destroy(entity); }
+
+  template <typename T>
+  void
+    add(EntityHandle entity, T component) {
+    if (m_world.isAlive(entity)) m_world.add<T>(entity, std::move(component));
+  }
+
+  template <typename T>
+  void
+    remove(EntityHandle entity) {
+    if (m_world.isAlive(entity)) m_world.remove<T>(entity);
+  }
+
+private:
+  World& m_world;
+};
+
+// Reproduce el script en 'sink' (un CommandBuffer o un DirectSink).
+template <typename Sink>
+static void
+applyScript(Sink& sink, uint32_t frame, size_t task, const std::vector<Op>& script, const Handles& handles) {
+  std::vector<EntityHandle> created;
+  for (const Op& op : script) {
+    if (op.type == OpType::Create) {
+      created.push_back(sink.create());
+      continue;
+    }
+    EntityHandle entity;
+    if (op.kind == TargetKind::Existing) entity = handles.alive.at(op.target);
+    else if (op.kind == TargetKind::Stale) entity = handles.stale.at(op.target);
+    else entity = created[op.target];
+
+    switch (op.type) {
+    case OpType::Destroy: sink.destroy(entity); break;
+    case OpType::AddId: sink.add(entity, TestId{ createdId(frame, task, op.target) }); break;
+    case OpType::AddPosition: sink.add(entity, TestPosition{ static_cast<float>(op.value), op.value }); break;
+    case OpType::AddVelocity: sink.add(entity, TestVelocity{ op.value }); break;
+    case OpType::RemoveVelocity: sink.template remove<TestVelocity>(entity); break;
+    case OpType::AddHealth: sink.add(entity, TestHealth{ op.value }); break;
+    case OpType::RemoveHealth: sink.template remove<TestHealth>(entity); break;
+    case OpType::AddInventory: {
+      TestInventory inventory;
+      inventory.items.assign(size_t(op.value % 5) + 1, op.value);
+      sink.add(entity, std::move(inventory));
+      break;
+    }
+    case OpType::RemoveInventory: sink.template remove<TestInventory>(entity); break;
+    case OpType::AddMarked: sink.add(entity, TestMarked{ op.value }); break;
+    case OpType::RemoveMarked: sink.template remove<TestMarked>(entity); break;
+    case OpType::Create: break;
+    }
+  }
+}
+
+// Todo lo que tiene cada entidad, por su TestId.
+static std::map<uint64_t, std::vector<int>>
+snapshot(World& world) {
+  std::map<uint64_t, std::vector<int>> state;
+  world.forEach<TestId>([&](EntityHandle entity, TestId& id) {
+    std::vector<int>& values = state[id.value];
+    const TestPosition* position = world.get<TestPosition>(entity);
+    const TestVelocity* velocity = world.get<TestVelocity>(entity);
+    const TestHealth* health = world.get<TestHealth>(entity);
+    const TestMarked* marked = world.get<TestMarked>(entity);
+    values.push_back(position ? position->version : -1);
+    values.push_back(position ? static_cast<int>(position->x) : -1);
+    values.push_back(velocity ? velocity->value : -1);
+    values.push_back(health ? health->value : -1);
+    values.push_back(marked ? marked->value : -1);
+    if (const TestInventory* inventory = world.get<TestInventory>(entity)) {
+      values.push_back(static_cast<int>(inventory->items.size()));
+      values.insert(values.end(), inventory->items.begin(), inventory->items.end());
+    }
+    else {
+      values.push_back(-1);
+    }
+  });
+  return state;
+}
+
+// Pone al da los handles: lo que ya no est vivo pasa a 'stale'.
+static void
+refreshHandles(World& world, Handles& handles) {
+  std::map<uint64_t, EntityHandle> alive;
+  world.forEach<TestId>([&](EntityHandle entity, TestId& id) { alive[id.value] = entity; });
+  for (const auto& entry : handles.alive) {
+    if (alive.find(entry.first) == alive.end()) handles.stale[entry.first] = entry.second;
+  }
+  handles.alive.swap(alive);
+}
+
+static void
+populate(World& world) {
+  for (uint64_t i = 0; i < kInitialEntities; ++i) {
+    const EntityHandle entity = world.create(TestId{ i }, TestPosition{ static_cast<float>(i), 0 });
+    if (i % 2 == 0) world.add(entity, TestVelocity{ 1 });
+    if (i % 5 == 0) world.add(entity, TestInventory{ { 1, 2, 3 } });
+    if (i % 7 == 0) world.add(entity, TestMarked{ 9 });
+  }
+}
+
+static void
+testAgainstReference(unsigned int threads) {
+  World world;
+  World reference;
+  populate(world);
+  populate(reference);
+  Handles handles, referenceHandles;
+  refreshHandles(world, handles);
+  refreshHandles(reference, referenceHandles);
+
+  SystemScheduler scheduler(threads);
+  CommandQueue queue;
+  DirectSink direct(reference);
+  size_t dropped = 0, destroyed = 0, moves = 0;
+  std::set<std::thread::id> recorders;   // Hilos que anotaron (depende de cmo se reparti).
+  std::mutex recordersMutex;
+
+  for (uint32_t frame = 0; frame < kFrames; ++frame) {
+    std::vector<std::vector<uint64_t>> owned(kTasks);
+    for (const auto& entry : handles.alive) owned[(entry.first * 2654435761u) % kTasks].push_back(entry.first);
+    std::vector<uint64_t> stale;
+    for (const auto& entry : handles.stale) stale.push_back(entry.first);
+
+    std::vector<std::vector<Op>> scripts(kTasks);
+    size_t expectedCommands = 0;
+    for (size_t task = 0; task < kTasks; ++task) {
+      scripts[task] = makeScript(frame, task, owned[task], stale);
+      expectedCommands += scripts[task].size();
+    }
+
+    // Todas las tareas anotan a la vez, cada una en el buffer de su hilo
+    scheduler.parallelFor(kTasks, 1, [&](size_t begin, size_t end) {
+      for (size_t task = begin; task < end; ++task) applyScript(queue.local(), frame, task, scripts[task], handles);
+      std::lock_guard<std::mutex> lock(recordersMutex);
+      recorders.insert(std::this_thread::get_id());
+    });
+    queue.playback(world);
+    for (size_t task = 0; task < kTasks; ++task) applyScript(direct, frame, task, scripts[task], referenceHandles);
+
+    const CommandStats& stats = queue.getLastStats();
+    CHECK(stats.commands == expectedCommands);
+    CHECK(stats.created == kTasks * 20);
+    dropped += stats.dropped;
+    destroyed += stats.destroyed;
+    moves += stats.moves;
+
+    CHECK(world.size() == reference.size());
+    const bool same = snapshot(world) == snapshot(reference);
+    CHECK(same);
+    if (!same) {
+      std::printf("%u hilos, frame %u: el World no coincide con la referencia\n", threads, frame);
+      break;
+    }
+    refreshHandles(world, handles);
+    refreshHandles(reference, referenceHandles);
+  }
+
+  std::printf("%u hilos (%zu anotaron): %zu entidades al final, %zu destruidas, %zu cambios de arquetipo, "
+    "%zu descartados\n", threads, recorders.size(), world.size(), destroyed, moves, dropped);
+  CHECK(destroyed > 0);
+  CHECK(dropped > 0);
+  CHECK(moves > 0);
+}
+
+int
+main() {
+  const unsigned int threadCounts[3] = { 1, 4, 8 };
+  for (unsigned int threads : threadCounts) testAgainstReference(threads);
+  return testResult("test_command_buffer");
+}
@@ -0,0 +1,82 @@
+/*
+ * Ancho de ndice: MeshOptimizer::chooseIndexWidth y packIndices16, y
+ * MeshComponent::packIndices que los usa antes de crear el index buffer.
+ * 0xFFFE es el ndice ms grande que cabe en 16 bits, porque 0xFFFF es el
+ * corte de strips en D3D y no se puede usar como vrtice.
+ */
+#include "TestCheck.h"
+#include "MeshComponent.h"
+#include "MeshOptimizer.h"
+
+#include <vector>
+
+static void
+testChooseWidth() {
+  const std::vector<uint32_t> fits = { 0, 7, 0xFFFE, 3 };
+  CHECK(MeshOptimizer::chooseIndexWidth(fits.data(), fits.size()) == 2);
+
+  const std::vector<uint32_t> stripCut = { 0, 7, 0xFFFF, 3 };
+  CHECK(MeshOptimizer::chooseIndexWidth(stripCut.data(), stripCut.size()) == 4);
+
+  const std::vector<uint32_t> large = { 0x10000, 1, 2 };
+  CHECK(MeshOptimizer::chooseIndexWidth(large.data(), large.size()) == 4);
+
+  CHECK(MeshOptimizer::chooseIndexWidth(nullptr, 0) == 2);
+}
+
+static void
+testPack16() {
+  std::vector<uint32_t> indices;
+  for (uint32_t i = 0; i < 1000; ++i) indices.push_back((i * 977u) % 0xFFFFu);
+  indices.push_back(0xFFFE);
+  CHECK(MeshOptimizer::chooseIndexWidth(indices.data(), indices.size()) == 2);
+
+  std::vector<uint16_t> packed(indices.size());
+  MeshOptimizer::packIndices16(indices.data(), indices.size(), packed.data());
+  bool same = true;
+  for (size_t i = 0; i < indices.size(); ++i) same = same && packed[i] == indices[i];
+  CHECK(same);
+}
+
+// packIndices en una malla: empaca, vuelve a 4 y otra vez a 2.
+static void
+testMeshComponent() {
+  MeshComponent mesh;
+
+  // Sin ndices: 2 bytes y m_index16 vaco
+  mesh.packIndices();
+  CHECK(mesh.m_indexWidth == 2);
+  CHECK(mesh.m_index16.empty());
+  CHECK(mesh.getIndexFormat() == DXGI_FORMAT_R16_UINT);
+
+  mesh.m_index = { 0, 1, 2, 2, 1, 0xFFFE };
+  mesh.packIndices();
+  CHECK(mesh.m_indexWidth == 2);
+  CHECK(mesh.getIndexFormat() == DXGI_FORMAT_R16_UINT);
+  CHECK(mesh.m_index16.size() == mesh.m_index.size());
+  bool roundTrip = mesh.m_index16.size() == mesh.m_index.size();
+  for (size_t i = 0; roundTrip && i < mesh.m_index.size(); ++i) {
+    roundTrip = static_cast<uint32_t>(mesh.m_index16[i]) == mesh.m_index[i];
+  }
+  CHECK(roundTrip);
+
+  // Un ndice de 0xFFFF la regresa a 4 bytes y vaca m_index16
+  mesh.m_index.push_back(0xFFFF);
+  mesh.packIndices();
+  CHECK(mesh.m_indexWidth == 4);
+  CHECK(mesh.getIndexFormat() == DXGI_FORMAT_R32_UINT);
+  CHECK(mesh.m_index16.empty());
+
+  mesh.m_index.pop_back();
+  mesh.packIndices();
+  CHECK(mesh.m_indexWidth == 2);
+  CHECK(mesh.m_index16.size() == mesh.m_index.size());
+}
+
+int
+main() {
+  testChooseWidth();
+  testPack16();
+  testMeshComponent();
+  return testResult("test_index_packing");
+}
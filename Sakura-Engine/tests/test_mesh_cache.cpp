@@ -0,0 +1,170 @@
+/*
+ * MeshCache: una malla escrita se vuelve a leer igual, open rechaza las
+ * cachs con ndices o rangos fuera de la malla, y cuando solo cambia la
+ * fecha del archivo fuente (mismo contenido) la fecha nueva queda guardada.
+ */
+#include "TestCheck.h"
+#include "MeshCache.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+static const uint64_t kSettings = 0x1234;
+static const uint32_t kStride = 5 * sizeof(float);
+
+// Dos tringulos (un cuadro) con una submalla por tringulo y un LOD.
+struct QuadMesh {
+  float vertices[4 * 5] = {
+    0, 0, 0, 0, 0,
+    1, 0, 0, 1, 0,
+    1, 1, 0, 1, 1,
+    0, 1, 0, 0, 1 };
+  uint32_t indices[6] = { 0, 1, 2, 0, 2, 3 };
+  uint32_t lodIndices[3] = { 0, 1, 2 };
+
+  MeshCacheMesh
+  describe() const {
+    MeshCacheMesh mesh;
+    mesh.name = "quad";
+    mesh.vertices = vertices;
+    mesh.vertexCount = 4;
+    mesh.indices = indices;
+    mesh.indexCount = 6;
+    MeshCacheSubMesh first;
+    first.materialName = "a";
+    first.startIndex = 0;
+    first.indexCount = 3;
+    MeshCacheSubMesh second = first;
+    second.materialName = "b";
+    second.startIndex = 3;
+    mesh.subMeshes = { first, second };
+    MeshCacheLod lod;
+    lod.indices = lodIndices;
+    lod.indexCount = 3;
+    lod.error = 0.5f;
+    lod.subMeshRanges = { { 0, 3 }, { 3, 0 } };
+    mesh.lods = { lod };
+    return mesh;
+  }
+};
+
+static std::string
+writeSource(const std::string& name, const char* text) {
+  const std::string path = testTempPath(name);
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out << text;
+  return path;
+}
+
+static bool
+writeCache(const std::string& cachePath, const std::string& sourcePath, const MeshCacheMesh& mesh) {
+  MeshCacheSource source;
+  return MeshCache::stampSource(sourcePath, source, true) &&
+    MeshCache::write(cachePath, source, kSettings, kStride, { mesh });
+}
+
+static void
+testRoundTrip() {
+  const std::string sourcePath = writeSource("cache_source.obj", "v 0 0 0\n");
+  const std::string cachePath = testTempPath("cache_roundtrip.sakmesh");
+  QuadMesh quad;
+  CHECK(writeCache(cachePath, sourcePath, quad.describe()));
+
+  MeshCache cache;
+  CHECK(cache.open(cachePath, sourcePath, kSettings, kStride));
+  CHECK(cache.meshCount() == 1);
+  const MeshCacheMeshView view = cache.mesh(0);
+  CHECK(view.name == "quad");
+  CHECK(view.vertexCount == 4 && view.indexCount == 6);
+  CHECK(std::memcmp(view.vertices, quad.vertices, sizeof(quad.vertices)) == 0);
+  CHECK(std::memcmp(view.indices, quad.indices, sizeof(quad.indices)) == 0);
+  CHECK(cache.subMesh(0, 1).materialName == "b");
+  CHECK(cache.lod(0, 0).indexCount == 3 && cache.lod(0, 0).error == 0.5f);
+
+  // Otras opciones de importacin u otro tamao de vrtice no sirven
+  CHECK(!cache.open(cachePath, sourcePath, kSettings + 1, kStride));
+  CHECK(!cache.open(cachePath, sourcePath, kSettings, kStride + 4));
+}
+
+// write no valida la malla, as que sirve para generar cachs corruptas.
+static void
+testRejectsBadRanges() {
+  const std::string sourcePath = writeSource("cache_source.obj", "v 0 0 0\n");
+  const std::string cachePath = testTempPath("cache_bad.sakmesh");
+  MeshCache cache;
+
+  for (int variant = 0; variant < 5; ++variant) {
+    QuadMesh quad;
+    MeshCacheMesh mesh = quad.describe();
+    switch (variant) {
+    case 0: quad.indices[4] = 4; break;                      // ndice == vertexCount
+    case 1: mesh.subMeshes[1].indexCount = 4; break;         // 3 + 4 > 6
+    case 2: mesh.subMeshes[0].startIndex = 0xFFFFFFFFu; break; // se desborda en 32 bits
+    case 3: mesh.lods[0].subMeshRanges[1] = { 2, 2 }; break; // 2 + 2 > 3 ndices del LOD
+    case 4: quad.lodIndices[2] = 100; break;                 // ndice del LOD fuera
+    }
+    CHECK(writeCache(cachePath, sourcePath, mesh));
+    if (cache.open(cachePath, sourcePath, kSettings, kStride)) {
+      std::fprintf(stderr, "variante %d: la cach corrupta se acept\n", variant);
+      CHECK(false);
+    }
+  }
+
+  // Truncada: el tamao no coincide con el del encabezado
+  QuadMesh quad;
+  CHECK(writeCache(cachePath, sourcePath, quad.describe()));
+  std::filesystem::resize_file(cachePath, std::filesystem::file_size(cachePath) - 4);
+  CHECK(!cache.open(cachePath, sourcePath, kSettings, kStride));
+}
+
+// Lee la fecha del fuente guardada en el encabezado (despus de magic,
+// versin, tamao de vrtice y tamao del fuente).
+static int64_t
+storedSourceMTime(const std::string& cachePath) {
+  std::ifstream in(cachePath, std::ios::binary);
+  int64_t mtime = 0;
+  in.seekg(8 + 4 + 4 + 8);
+  in.read(reinterpret_cast<char*>(&mtime), sizeof(mtime));
+  return mtime;
+}
+
+static void
+testSourceChanges() {
+  const std::string sourcePath = writeSource("cache_touch.obj", "v 1 2 3\n");
+  const std::string cachePath = testTempPath("cache_touch.sakmesh");
+  QuadMesh quad;
+  CHECK(writeCache(cachePath, sourcePath, quad.describe()));
+
+  // Misma informacin, otra fecha: se acepta y la fecha queda actualizada
+  const auto newTime = std::filesystem::last_write_time(sourcePath) + std::chrono::hours(1);
+  std::filesystem::last_write_time(sourcePath, newTime);
+  MeshCacheSource stamp;
+  CHECK(MeshCache::stampSource(sourcePath, stamp, false));
+  CHECK(storedSourceMTime(cachePath) != stamp.mtime);
+
+  MeshCache cache;
+  CHECK(cache.open(cachePath, sourcePath, kSettings, kStride));
+  CHECK(storedSourceMTime(cachePath) == stamp.mtime);
+  CHECK(cache.mesh(0).indexCount == 6);
+  cache.close();
+  CHECK(cache.open(cachePath, sourcePath, kSettings, kStride));
+  cache.close();
+
+  // Mismo tamao, otro contenido: se rechaza
+  writeSource("cache_touch.obj", "v 9 9 9\n");
+  CHECK(!cache.open(cachePath, sourcePath, kSettings, kStride));
+
+  // Sin archivo fuente la cach se usa tal cual
+  std::filesystem::remove(sourcePath);
+  CHECK(cache.open(cachePath, sourcePath, kSettings, kStride));
+}
+
+int
+main() {
+  testRoundTrip();
+  testRejectsBadRanges();
+  testSourceChanges();
+  return testResult("test_mesh_cache");
+}
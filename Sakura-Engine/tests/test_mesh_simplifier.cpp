@@ -0,0 +1,152 @@
+/*
+ * MeshSimplifier::simplify con los niveles de omisin de Model3D (0.5,
+ * 0.25 y 0.125 de los tringulos) sobre una esfera uv: en cada nivel los
+ * tringulos no pasan del objetivo, el error reportado no pasa de maxError
+ * y la superficie sigue cerca de la esfera. Adems, la misma entrada da la
+ * misma salida aunque cambien la direccin de memoria o el hilo.
+ */
+#include "TestCheck.h"
+#include "MeshTestShapes.h"
+#include "MeshSimplifier.h"
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+static const float kMaxError = 0.05f;
+static const float kAttributeWeight = 0.5f;
+
+static std::vector<uint32_t>
+simplifyTo(const TestMesh& mesh, float ratio, MeshSimplifyStats* stats = nullptr,
+  const unsigned char* lock = nullptr) {
+  std::vector<uint32_t> out(mesh.indices.size());
+  const size_t target = static_cast<size_t>(mesh.triangleCount() * ratio) * 3;
+  const size_t count = MeshSimplifier::simplify(mesh.vertices.data(), mesh.vertices.size(), sizeof(SimpleVertex),
+    mesh.indices.data(), mesh.indices.size(), target, kMaxError, kAttributeWeight, out.data(), lock, stats);
+  out.resize(count);
+  return out;
+}
+
+// Mayor distancia de un punto de la malla (vrtices y centros de
+// tringulo) a la esfera de radio 1: mide cunto se hundieron las caras.
+static float
+sphereDeviation(const TestMesh& mesh, const std::vector<uint32_t>& indices) {
+  float worst = 0.0f;
+  for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+    float center[3] = { 0.0f, 0.0f, 0.0f };
+    for (int k = 0; k < 3; ++k) {
+      const XMFLOAT3& p = mesh.vertices[indices[t + k]].Pos;
+      worst = std::fmax(worst, std::fabs(std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z) - 1.0f));
+      center[0] += p.x / 3.0f;
+      center[1] += p.y / 3.0f;
+      center[2] += p.z / 3.0f;
+    }
+    const float length = std::sqrt(center[0] * center[0] + center[1] * center[1] + center[2] * center[2]);
+    worst = std::fmax(worst, 1.0f - length);
+  }
+  return worst;
+}
+
+static void
+testLevels() {
+  const TestMesh sphere = makeUvSphere(128, 64);
+  const float extent = MeshSimplifier::extent(sphere.vertices.data(), sphere.vertices.size(), sizeof(SimpleVertex));
+  CHECK(std::fabs(extent - 2.0f) < 1.0e-4f);
+
+  const float ratios[3] = { 0.5f, 0.25f, 0.125f };
+  float previousError = 0.0f;
+  for (float ratio : ratios) {
+    MeshSimplifyStats stats;
+    const std::vector<uint32_t> lod = simplifyTo(sphere, ratio, &stats);
+    const size_t target = static_cast<size_t>(sphere.triangleCount() * ratio);
+
+    CHECK(lod.size() % 3 == 0);
+    CHECK(stats.trianglesBefore == sphere.triangleCount());
+    CHECK(stats.trianglesAfter == lod.size() / 3);
+    CHECK(lod.size() / 3 <= target);
+    // Una esfera lisa llega al objetivo sin acercarse a maxError
+    CHECK(lod.size() / 3 >= target * 9 / 10);
+    CHECK(stats.error <= kMaxError);
+    CHECK(stats.error >= previousError);
+    previousError = stats.error;
+
+    bool indicesOk = true;
+    for (size_t t = 0; t < lod.size(); t += 3) {
+      indicesOk = indicesOk && lod[t] < sphere.vertices.size() && lod[t + 1] < sphere.vertices.size() &&
+        lod[t + 2] < sphere.vertices.size() && lod[t] != lod[t + 1] && lod[t + 1] != lod[t + 2] && lod[t] != lod[t + 2];
+    }
+    CHECK(indicesOk);
+
+    // La desviacin real de la superficie queda dentro del error reportado
+    // (en unidades del modelo) ms lo que ya tena la esfera original. El
+    // error de la cudrica es la distancia a los planos de las caras
+    // originales, no a la esfera, as que se deja el doble de margen.
+    const float deviation = sphereDeviation(sphere, lod);
+    const float baseDeviation = sphereDeviation(sphere, sphere.indices);
+    std::printf("ratio %.3f: %zu -> %zu triangulos, error %.4f%% del tamano, desviacion %.5f (original %.5f)\n",
+      ratio, stats.trianglesBefore, stats.trianglesAfter, stats.error * 100.0f, deviation, baseDeviation);
+    CHECK(deviation <= baseDeviation + stats.error * extent * 2.0f + 1.0e-4f);
+  }
+}
+
+// Con maxError 0 en una esfera no se puede colapsar nada que deforme.
+static void
+testZeroError() {
+  const TestMesh sphere = makeUvSphere(32, 16);
+  std::vector<uint32_t> out(sphere.indices.size());
+  MeshSimplifyStats stats;
+  const size_t count = MeshSimplifier::simplify(sphere.vertices.data(), sphere.vertices.size(), sizeof(SimpleVertex),
+    sphere.indices.data(), sphere.indices.size(), sphere.indices.size() / 4, 0.0f, kAttributeWeight, out.data(),
+    nullptr, &stats);
+  CHECK(count > sphere.indices.size() / 4);
+  CHECK(stats.error == 0.0f);
+}
+
+// Los vrtices bloqueados siguen en la malla simplificada.
+static void
+testLockedVertices() {
+  const TestMesh sphere = makeUvSphere(64, 32);
+  std::vector<unsigned char> lock(sphere.vertices.size(), 0);
+  for (size_t v = 0; v < lock.size(); v += 7) lock[v] = 1;
+  const std::vector<uint32_t> lod = simplifyTo(sphere, 0.25f, nullptr, lock.data());
+
+  std::vector<unsigned char> used(sphere.vertices.size(), 0);
+  for (uint32_t index : sphere.indices) used[index] = 1;
+  std::vector<unsigned char> stillUsed(sphere.vertices.size(), 0);
+  for (uint32_t index : lod) stillUsed[index] = 1;
+  bool kept = true;
+  for (size_t v = 0; v < lock.size(); ++v) {
+    if (lock[v] && used[v]) kept = kept && stillUsed[v];
+  }
+  CHECK(kept);
+}
+
+// Misma entrada, misma salida: otra copia de los datos y otros hilos.
+static void
+testDeterminism() {
+  const TestMesh sphere = makeUvSphere(96, 48);
+  MeshSimplifyStats firstStats;
+  const std::vector<uint32_t> first = simplifyTo(sphere, 0.25f, &firstStats);
+
+  const TestMesh copy = sphere;
+  MeshSimplifyStats copyStats;
+  CHECK(simplifyTo(copy, 0.25f, &copyStats) == first);
+  CHECK(copyStats.error == firstStats.error && copyStats.passes == firstStats.passes);
+
+  std::vector<std::vector<uint32_t>> results(4);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < results.size(); ++i) {
+    threads.emplace_back([&, i]() { results[i] = simplifyTo(sphere, 0.25f); });
+  }
+  for (std::thread& thread : threads) thread.join();
+  for (const std::vector<uint32_t>& result : results) CHECK(result == first);
+}
+
+int
+main() {
+  testLevels();
+  testZeroError();
+  testLockedVertices();
+  testDeterminism();
+  return testResult("test_mesh_simplifier");
+}
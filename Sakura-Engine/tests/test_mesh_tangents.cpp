@@ -0,0 +1,224 @@
+/*
+ * MeshTangents::generate sobre una esfera uv: las normales y tangentes salen
+ * como las analticas (normal = posicin, tangente = dP/du, signo +1), una
+ * uv con la mitad en espejo separa justo la columna donde se refleja y sus
+ * caras quedan con signo -1, y la salida es la misma byte por byte con uno
+ * o con varios hilos.
+ */
+#include "TestCheck.h"
+#include "MeshTestShapes.h"
+#include "MeshTangents.h"
+
+#include <cmath>
+#include <vector>
+
+struct TangentResult {
+  std::vector<uint32_t> indices;
+  std::vector<float> normals;
+  std::vector<float> tangents;
+  std::vector<uint32_t> remap;
+  MeshTangentStats stats;
+  size_t count = 0;
+};
+
+static TangentResult
+generateTangents(const TestMesh& mesh, unsigned int threads) {
+  TangentResult result;
+  result.indices = mesh.indices;
+  result.count = MeshTangents::generate(mesh.vertices.data(), mesh.vertices.size(), sizeof(SimpleVertex),
+    result.indices.data(), result.indices.size(), result.normals, result.tangents, result.remap, threads,
+    &result.stats);
+  return result;
+}
+
+// La mitad u > 0.5 de la uv reflejada sobre la otra, como un modelo simtrico.
+static TestMesh
+mirrorHalf(TestMesh mesh) {
+  for (SimpleVertex& vertex : mesh.vertices) {
+    if (vertex.Tex.x > 0.5f) vertex.Tex.x = 1.0f - vertex.Tex.x;
+  }
+  return mesh;
+}
+
+/*
+ * Compara cada vrtice de salida contra la base analtica de la esfera:
+ * normal = posicin y tangente = signo * (-sin(phi), 0, cos(phi)).
+ *
+ * La tangente de cada tringulo es la cuerda de su fila, que apunta a la
+ * mitad del segmento; el vrtice promedia la de la izquierda y la de la
+ * derecha con pesos por ngulo, que cerca de los polos no son iguales. Por
+ * eso se puede ir hasta medio segmento (pi / segments) y no ms; en el
+ * ecuador los pesos son iguales y sale exacta. Los vrtices que ningn
+ * tringulo usa (uno en cada polo) no cuentan.
+ */
+static void
+compareWithAnalytic(const TangentResult& result, unsigned int segments, unsigned int rings,
+  float& worstNormal, float& worstTangent) {
+  const float pi = 3.14159265358979f;
+  worstNormal = 1.0f;
+  worstTangent = 1.0f;
+  std::vector<unsigned char> used(result.count, 0);
+  for (uint32_t index : result.indices) used[index] = 1;
+  for (size_t v = 0; v < result.count; ++v) {
+    if (!used[v]) continue;
+    const uint32_t original = result.remap[v];
+    const unsigned int ring = original / (segments + 1);
+    const unsigned int segment = original % (segments + 1);
+
+    const float theta = pi * ring / rings;
+    const float phi = 2.0f * pi * segment / segments;
+    const float normal[3] = { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+    const float* n = &result.normals[v * 3];
+    const float* t = &result.tangents[v * 4];
+    const float tangent[3] = { -std::sin(phi) * t[3], 0.0f, std::cos(phi) * t[3] };
+    worstNormal = std::fmin(worstNormal, n[0] * normal[0] + n[1] * normal[1] + n[2] * normal[2]);
+    worstTangent = std::fmin(worstTangent, t[0] * tangent[0] + t[1] * tangent[1] + t[2] * tangent[2]);
+  }
+}
+
+// Coseno de medio segmento, con margen para el redondeo de float.
+static float
+halfSegmentCos(unsigned int segments) {
+  return std::cos(3.14159265358979f / segments) - 1.0e-5f;
+}
+
+/*
+ * Cuntas esquinas apuntan a un vrtice con el signo equivocado: -1 en las
+ * caras de la mitad reflejada (alguna columna pasa de segments / 2) y +1 en
+ * las dems.
+ */
+static size_t
+wrongSigns(const TangentResult& result, unsigned int segments, bool mirrored) {
+  size_t wrong = 0;
+  for (size_t t = 0; t < result.indices.size(); t += 3) {
+    bool reflected = false;
+    for (int k = 0; k < 3; ++k) {
+      reflected = reflected || result.remap[result.indices[t + k]] % (segments + 1) > segments / 2;
+    }
+    const float expected = mirrored && reflected ? -1.0f : 1.0f;
+    for (int k = 0; k < 3; ++k) {
+      if (result.tangents[result.indices[t + k] * 4 + 3] != expected) ++wrong;
+    }
+  }
+  return wrong;
+}
+
+static void
+testAnalyticSphere() {
+  const unsigned int segments = 64, rings = 32;
+  const TestMesh sphere = makeUvSphere(segments, rings);
+  const TangentResult result = generateTangents(sphere, 1);
+
+  CHECK(result.count == sphere.vertices.size());
+  CHECK(result.stats.splitVertices == 0);
+  CHECK(result.stats.degenerateTriangles == 0);
+  CHECK(result.indices == sphere.indices);
+  CHECK(result.normals.size() == result.count * 3 && result.tangents.size() == result.count * 4);
+
+  float worstNormal, worstTangent;
+  compareWithAnalytic(result, segments, rings, worstNormal, worstTangent);
+  std::printf("esfera %ux%u: peor coseno normal %.7f, tangente %.7f\n", segments, rings, worstNormal, worstTangent);
+  CHECK(worstNormal > 0.99999f);
+  CHECK(worstTangent > halfSegmentCos(segments));
+  CHECK(wrongSigns(result, segments, false) == 0);
+}
+
+/*
+ * Con la mitad en espejo solo se separan los vrtices de la columna
+ * segments / 2 que usan caras de los dos lados: todos menos los dos polos
+ * (cada vrtice de polo lo usa un solo tringulo).
+ */
+static void
+testMirrorSeam() {
+  const unsigned int segments = 64, rings = 32;
+  const TestMesh sphere = mirrorHalf(makeUvSphere(segments, rings));
+  const TangentResult result = generateTangents(sphere, 1);
+
+  CHECK(result.stats.splitVertices == rings - 1);
+  CHECK(result.count == sphere.vertices.size() + rings - 1);
+  CHECK(result.remap.size() == result.count);
+
+  size_t wrongRemap = 0;
+  for (size_t v = 0; v < sphere.vertices.size(); ++v) {
+    if (result.remap[v] != v) ++wrongRemap;
+  }
+  for (size_t v = sphere.vertices.size(); v < result.count; ++v) {
+    const uint32_t original = result.remap[v];
+    const unsigned int ring = original / (segments + 1);
+    if (original % (segments + 1) != segments / 2 || ring == 0 || ring == rings) ++wrongRemap;
+    // El duplicado va con las caras reflejadas y el original con las otras
+    if (result.tangents[v * 4 + 3] != -1.0f || result.tangents[original * 4 + 3] != 1.0f) ++wrongRemap;
+  }
+  CHECK(wrongRemap == 0);
+
+  // Solo cambian las esquinas que pasaron a un duplicado
+  size_t changed = 0, wrongIndex = 0;
+  for (size_t c = 0; c < sphere.indices.size(); ++c) {
+    if (result.indices[c] != sphere.indices[c]) {
+      ++changed;
+      if (result.indices[c] < sphere.vertices.size() || result.remap[result.indices[c]] != sphere.indices[c]) {
+        ++wrongIndex;
+      }
+    }
+  }
+  CHECK(changed > 0);
+  CHECK(wrongIndex == 0);
+
+  float worstNormal, worstTangent;
+  compareWithAnalytic(result, segments, rings, worstNormal, worstTangent);
+  std::printf("espejo: %zu separados, peor coseno normal %.7f, tangente %.7f\n",
+    result.stats.splitVertices, worstNormal, worstTangent);
+  CHECK(worstNormal > 0.99999f);
+  CHECK(worstTangent > halfSegmentCos(segments));
+  CHECK(wrongSigns(result, segments, true) == 0);
+}
+
+/*
+ * Misma salida con 1 hilo y con varios. La esfera pasa de los 16,384
+ * elementos de un bloque en tringulos y vrtices, as que con ms de un
+ * hilo el trabajo s se reparte.
+ */
+static void
+testThreadDeterminism() {
+  const TestMesh sphere = mirrorHalf(makeUvSphere(256, 128));
+  const TangentResult single = generateTangents(sphere, 1);
+  CHECK(single.stats.threads == 1);
+  CHECK(single.stats.splitVertices == 127);
+
+  const unsigned int threadCounts[4] = { 2, 3, 4, 7 };
+  for (unsigned int threads : threadCounts) {
+    const TangentResult parallel = generateTangents(sphere, threads);
+    CHECK(parallel.stats.threads == threads);
+    CHECK(parallel.count == single.count);
+    CHECK(parallel.indices == single.indices);
+    CHECK(parallel.remap == single.remap);
+    // Comparacin exacta de floats: los hilos no pueden cambiar ni un bit
+    CHECK(parallel.normals == single.normals);
+    CHECK(parallel.tangents == single.tangents);
+    CHECK(parallel.stats.degenerateTriangles == single.stats.degenerateTriangles);
+  }
+}
+
+// Un ndice fuera de rango devuelve 0 y no toca nada.
+static void
+testBadIndex() {
+  TestMesh sphere = makeUvSphere(8, 4);
+  sphere.indices[5] = static_cast<uint32_t>(sphere.vertices.size());
+  const std::vector<uint32_t> before = sphere.indices;
+  TangentResult result;
+  result.indices = sphere.indices;
+  result.count = MeshTangents::generate(sphere.vertices.data(), sphere.vertices.size(), sizeof(SimpleVertex),
+    result.indices.data(), result.indices.size(), result.normals, result.tangents, result.remap, 1);
+  CHECK(result.count == 0);
+  CHECK(result.indices == before);
+  CHECK(result.normals.empty() && result.tangents.empty() && result.remap.empty());
+}
+
+int
+main() {
+  testAnalyticSphere();
+  testMirrorSeam();
+  testThreadDeterminism();
+  testBadIndex();
+  return testResult("test_mesh_tangents");
+}
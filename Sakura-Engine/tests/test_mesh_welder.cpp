@@ -0,0 +1,175 @@
+/*
+ * MeshWelder::weld en modo exacto y con epsilon: los duplicados se unen y
+ * los ndices apuntan al sobreviviente, 0.0 y -0.0 son el mismo valor, con
+ * epsilon nunca se unen vrtices ms lejos que epsilon, los sobrevivientes
+ * quedan en el orden en que aparecen por primera vez y MeshWeldStats cuenta
+ * bien el antes y el despus.
+ */
+#include "TestCheck.h"
+#include "MeshWelder.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Posicin y UV, como SimpleVertex pero sin Direct3D.
+struct WeldVertex {
+  float pos[3];
+  float uv[2];
+};
+
+static bool
+sameVertex(const WeldVertex& a, const WeldVertex& b) {
+  return a.pos[0] == b.pos[0] && a.pos[1] == b.pos[1] && a.pos[2] == b.pos[2] &&
+    a.uv[0] == b.uv[0] && a.uv[1] == b.uv[1];
+}
+
+// Seis vrtices con dos duplicados exactos: quedan cuatro, en orden.
+static void
+testExact() {
+  std::vector<WeldVertex> vertices = {
+    { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f } },   // 0 -> 0
+    { { 1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f } },   // 1 -> 1
+    { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f } },   // 2 -> 0
+    { { 0.0f, 1.0f, 0.0f }, { 0.0f, 1.0f } },   // 3 -> 2
+    { { 1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f } },   // 4 -> 1
+    { { 1.0f, 1.0f, 0.0f }, { 1.0f, 1.0f } },   // 5 -> 3
+  };
+  const std::vector<WeldVertex> original = vertices;
+  std::vector<uint32_t> indices = { 0, 1, 3, 2, 4, 5, 3, 4, 5 };
+
+  MeshWeldStats stats;
+  const size_t unique = MeshWelder::weld(vertices.data(), vertices.size(), sizeof(WeldVertex),
+    indices.data(), indices.size(), 0.0f, &stats);
+  CHECK(unique == 4);
+  CHECK(stats.verticesBefore == 6);
+  CHECK(stats.verticesAfter == 4);
+  CHECK(stats.ratio() == 1.5);
+
+  // Primera aparicin de cada vrtice distinto
+  CHECK(sameVertex(vertices[0], original[0]));
+  CHECK(sameVertex(vertices[1], original[1]));
+  CHECK(sameVertex(vertices[2], original[3]));
+  CHECK(sameVertex(vertices[3], original[5]));
+
+  const std::vector<uint32_t> expected = { 0, 1, 2, 0, 1, 3, 2, 1, 3 };
+  CHECK(indices == expected);
+
+  // Cada ndice sigue apuntando al mismo vrtice que antes
+  const std::vector<uint32_t> before = { 0, 1, 3, 2, 4, 5, 3, 4, 5 };
+  bool sameCorners = true;
+  for (size_t i = 0; i < indices.size(); ++i) {
+    sameCorners = sameCorners && sameVertex(vertices[indices[i]], original[before[i]]);
+  }
+  CHECK(sameCorners);
+
+  // Sin duplicados no cambia nada
+  std::vector<uint32_t> again = indices;
+  CHECK(MeshWelder::weld(vertices.data(), unique, sizeof(WeldVertex), again.data(), again.size(), 0.0f, &stats) == 4);
+  CHECK(stats.verticesBefore == 4 && stats.verticesAfter == 4);
+  CHECK(again == indices);
+}
+
+// 0.0 y -0.0 son iguales en cualquier componente; un valor apenas distinto no.
+static void
+testSignedZero() {
+  std::vector<WeldVertex> vertices = {
+    { { 0.0f, 1.0f, -0.0f }, { 0.0f, -0.0f } },
+    { { -0.0f, 1.0f, 0.0f }, { -0.0f, 0.0f } },
+    { { 0.0f, 1.0f, 1.0e-30f }, { 0.0f, 0.0f } },
+  };
+  std::vector<uint32_t> indices = { 2, 1, 0 };
+  MeshWeldStats stats;
+  const size_t unique = MeshWelder::weld(vertices.data(), vertices.size(), sizeof(WeldVertex),
+    indices.data(), indices.size(), 0.0f, &stats);
+  CHECK(unique == 2);
+  CHECK(stats.verticesAfter == 2);
+  CHECK(indices[0] == 1 && indices[1] == 0 && indices[2] == 0);
+  CHECK(vertices[1].pos[2] == 1.0e-30f);
+}
+
+// Con epsilon: vrtices al azar con varias copias movidas un poco. Ningn
+// vrtice puede terminar unido a uno ms lejos que epsilon, los que estn
+// a ms de epsilon nunca se unen y los casi idnticos s.
+static void
+testEpsilon() {
+  const float epsilon = 0.01f;
+  std::mt19937 random(7);
+  std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+  std::uniform_real_distribution<float> nudge(-0.75f * epsilon, 0.75f * epsilon);
+
+  std::vector<WeldVertex> vertices;
+  for (int i = 0; i < 2000; ++i) {
+    WeldVertex base;
+    for (float& f : base.pos) f = coordinate(random);
+    base.uv[0] = coordinate(random);
+    base.uv[1] = coordinate(random);
+    vertices.push_back(base);
+    for (int copy = 0; copy < 3; ++copy) {
+      WeldVertex moved = base;
+      for (float& f : moved.pos) f += nudge(random);
+      vertices.push_back(moved);
+    }
+  }
+  // Pares a 1.5 epsilon en un solo componente: nunca se unen
+  for (int i = 0; i < 100; ++i) {
+    WeldVertex a = { { coordinate(random), coordinate(random), coordinate(random) }, { 0.0f, 0.0f } };
+    WeldVertex b = a;
+    b.pos[i % 3] += 1.5f * epsilon;
+    vertices.push_back(a);
+    vertices.push_back(b);
+  }
+  // Un vrtice y una copia a un dcimo de epsilon, en el centro de una celda
+  vertices.push_back({ { 1.0f, 2.0f, 3.0f }, { 0.5f, 0.5f } });
+  vertices.push_back({ { 1.0f + 0.1f * epsilon, 2.0f, 3.0f }, { 0.5f, 0.5f } });
+
+  const std::vector<WeldVertex> original = vertices;
+  std::vector<uint32_t> indices(vertices.size());
+  for (size_t i = 0; i < indices.size(); ++i) indices[i] = static_cast<uint32_t>(i);
+
+  MeshWeldStats stats;
+  const size_t unique = MeshWelder::weld(vertices.data(), vertices.size(), sizeof(WeldVertex),
+    indices.data(), indices.size(), epsilon, &stats);
+  CHECK(stats.verticesBefore == original.size());
+  CHECK(stats.verticesAfter == unique);
+  CHECK(unique < original.size());
+
+  bool withinEpsilon = true;
+  for (size_t i = 0; i < original.size(); ++i) {
+    const WeldVertex& a = original[i];
+    const WeldVertex& b = vertices[indices[i]];
+    for (int k = 0; k < 3; ++k) withinEpsilon = withinEpsilon && std::fabs(a.pos[k] - b.pos[k]) <= epsilon;
+    for (int k = 0; k < 2; ++k) withinEpsilon = withinEpsilon && std::fabs(a.uv[k] - b.uv[k]) <= epsilon;
+  }
+  CHECK(withinEpsilon);
+
+  const size_t pairs = 2000 * 4;
+  bool farApart = true;
+  for (size_t i = pairs; i < pairs + 200; i += 2) farApart = farApart && indices[i] != indices[i + 1];
+  CHECK(farApart);
+  CHECK(indices[pairs + 200] == indices[pairs + 201]);
+
+  // El orden de los sobrevivientes es el de su primera aparicin: recorriendo
+  // los ndices (que estaban en orden) cada sobreviviente nuevo es el siguiente
+  bool firstAppearance = true;
+  uint32_t next = 0;
+  for (size_t i = 0; i < indices.size(); ++i) {
+    if (indices[i] == next) {
+      firstAppearance = firstAppearance && sameVertex(vertices[next], original[i]);
+      ++next;
+    }
+    else {
+      firstAppearance = firstAppearance && indices[i] < next;
+    }
+  }
+  CHECK(firstAppearance);
+  CHECK(next == unique);
+}
+
+int
+main() {
+  testExact();
+  testSignedZero();
+  testEpsilon();
+  return testResult("test_mesh_welder");
+}
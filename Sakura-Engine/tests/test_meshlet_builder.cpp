@@ -0,0 +1,156 @@
+/*
+ * MeshletBuilder sobre una esfera uv: cada tringulo queda en exactamente un
+ * meshlet con su winding, ningn meshlet pasa de los lmites de vrtices y
+ * tringulos, cada vrtice queda dentro de la esfera de su meshlet y cada
+ * cara dentro de su cono. cull nunca quita un tringulo que mira a la cmara
+ * ni uno que est dentro del frustum.
+ */
+#include "TestCheck.h"
+#include "MeshTestShapes.h"
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <set>
+#include <vector>
+
+struct BuiltMeshlets {
+  std::vector<Meshlet> meshlets;
+  std::vector<uint32_t> vertices;
+  std::vector<uint8_t> triangles;
+};
+
+static BuiltMeshlets
+buildMeshlets(const TestMesh& mesh, uint32_t maxVertices, uint32_t maxTriangles) {
+  BuiltMeshlets built;
+  MeshletStats stats;
+  const size_t count = MeshletBuilder::build(mesh.vertices.data(), mesh.vertices.size(), sizeof(SimpleVertex),
+    mesh.indices.data(), mesh.indices.size(), maxVertices, maxTriangles, 0,
+    built.meshlets, built.vertices, built.triangles, &stats);
+  CHECK(count == built.meshlets.size());
+  CHECK(stats.triangles == mesh.triangleCount());
+  return built;
+}
+
+// El tringulo rotado para que empiece en su ndice menor: as dos copias
+// con el mismo winding son iguales y una con el winding al revs no.
+static std::array<uint32_t, 3>
+canonical(uint32_t a, uint32_t b, uint32_t c) {
+  if (b < a && b < c) return { b, c, a };
+  if (c < a && c < b) return { c, a, b };
+  return { a, b, c };
+}
+
+static void
+normalOf(const TestMesh& mesh, uint32_t a, uint32_t b, uint32_t c, float n[3]) {
+  const XMFLOAT3& p0 = mesh.vertices[a].Pos;
+  const XMFLOAT3& p1 = mesh.vertices[b].Pos;
+  const XMFLOAT3& p2 = mesh.vertices[c].Pos;
+  const float e1[3] = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+  const float e2[3] = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+  n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+  n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+  n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+static void
+testCoverageAndBounds(uint32_t maxVertices, uint32_t maxTriangles) {
+  const TestMesh sphere = makeUvSphere(128, 64);
+  const BuiltMeshlets built = buildMeshlets(sphere, maxVertices, maxTriangles);
+
+  std::multiset<std::array<uint32_t, 3>> expected;
+  for (size_t t = 0; t < sphere.indices.size(); t += 3) {
+    expected.insert(canonical(sphere.indices[t], sphere.indices[t + 1], sphere.indices[t + 2]));
+  }
+
+  size_t limitsBroken = 0, localOutOfRange = 0, outsideSphere = 0, outsideCone = 0, notOnce = 0;
+  for (const Meshlet& meshlet : built.meshlets) {
+    if (meshlet.vertexCount == 0 || meshlet.vertexCount > maxVertices ||
+      meshlet.triangleCount == 0 || meshlet.triangleCount > maxTriangles) {
+      ++limitsBroken;
+    }
+    const uint32_t* vertices = built.vertices.data() + meshlet.vertexOffset;
+    for (uint32_t v = 0; v < meshlet.vertexCount; ++v) {
+      const XMFLOAT3& p = sphere.vertices[vertices[v]].Pos;
+      const float d[3] = { p.x - meshlet.center[0], p.y - meshlet.center[1], p.z - meshlet.center[2] };
+      if (std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]) > meshlet.radius * 1.0001f + 1.0e-6f) ++outsideSphere;
+    }
+    const float coneDot = std::sqrt(1.0f - meshlet.coneCutoff * meshlet.coneCutoff);
+    const uint8_t* local = built.triangles.data() + meshlet.triangleOffset;
+    for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+      if (local[t * 3] >= meshlet.vertexCount || local[t * 3 + 1] >= meshlet.vertexCount ||
+        local[t * 3 + 2] >= meshlet.vertexCount) {
+        ++localOutOfRange;
+        continue;
+      }
+      const uint32_t a = vertices[local[t * 3]], b = vertices[local[t * 3 + 1]], c = vertices[local[t * 3 + 2]];
+      const auto found = expected.find(canonical(a, b, c));
+      if (found == expected.end()) ++notOnce;
+      else expected.erase(found);
+
+      float n[3];
+      normalOf(sphere, a, b, c, n);
+      const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+      if (meshlet.coneCutoff < 1.0f && length > 0.0f &&
+        (n[0] * meshlet.coneAxis[0] + n[1] * meshlet.coneAxis[1] + n[2] * meshlet.coneAxis[2]) / length < coneDot - 1.0e-4f) {
+        ++outsideCone;
+      }
+    }
+  }
+  std::printf("limites %u/%u: %zu meshlets\n", maxVertices, maxTriangles, built.meshlets.size());
+  CHECK(limitsBroken == 0);
+  CHECK(localOutOfRange == 0);
+  CHECK(notOnce == 0);          // Ningn tringulo repetido ni con el winding volteado
+  CHECK(expected.empty());      // Ni ninguno perdido
+  CHECK(outsideSphere == 0);
+  CHECK(outsideCone == 0);
+  CHECK(built.meshlets.size() * maxTriangles >= sphere.triangleCount());
+}
+
+// cull es conservador: lo que descarta de verdad no se ve.
+static void
+testCull() {
+  const TestMesh sphere = makeUvSphere(128, 64);
+  const BuiltMeshlets built = buildMeshlets(sphere, MeshletBuilder::kDefaultMaxVertices, MeshletBuilder::kDefaultMaxTriangles);
+  const float camera[3] = { 0.3f, 0.2f, -4.0f };
+  // Un solo plano: x >= 0
+  const float planes[1][4] = { { 1.0f, 0.0f, 0.0f, 0.0f } };
+
+  for (int withPlane = 0; withPlane < 2; ++withPlane) {
+    std::vector<uint32_t> out(sphere.indices.size());
+    MeshletCullStats stats;
+    const size_t count = MeshletBuilder::cull(built.meshlets.data(), built.meshlets.size(), built.vertices.data(),
+      built.triangles.data(), camera, withPlane ? planes : nullptr, withPlane ? 1 : 0, out.data(), &stats);
+    CHECK(stats.visible + stats.backfacing + stats.outside == built.meshlets.size());
+    CHECK(stats.backfacing > 0);
+    CHECK(withPlane ? stats.outside > 0 : stats.outside == 0);
+
+    std::multiset<std::array<uint32_t, 3>> kept;
+    for (size_t i = 0; i < count; i += 3) kept.insert(canonical(out[i], out[i + 1], out[i + 2]));
+
+    size_t lost = 0;
+    for (size_t t = 0; t < sphere.indices.size(); t += 3) {
+      const uint32_t a = sphere.indices[t], b = sphere.indices[t + 1], c = sphere.indices[t + 2];
+      float n[3];
+      normalOf(sphere, a, b, c, n);
+      const XMFLOAT3& p = sphere.vertices[a].Pos;
+      const bool facing = n[0] * (p.x - camera[0]) + n[1] * (p.y - camera[1]) + n[2] * (p.z - camera[2]) < 0.0f;
+      const bool inFrustum = !withPlane || sphere.vertices[a].Pos.x >= 0.0f ||
+        sphere.vertices[b].Pos.x >= 0.0f || sphere.vertices[c].Pos.x >= 0.0f;
+      if (facing && inFrustum && kept.find(canonical(a, b, c)) == kept.end()) ++lost;
+    }
+    std::printf("cull (plano %d): %zu visibles, %zu de espaldas, %zu fuera\n",
+      withPlane, stats.visible, stats.backfacing, stats.outside);
+    CHECK(lost == 0);
+  }
+}
+
+int
+main() {
+  testCoverageAndBounds(MeshletBuilder::kDefaultMaxVertices, MeshletBuilder::kDefaultMaxTriangles);
+  testCoverageAndBounds(32, 40);
+  testCoverageAndBounds(MeshletBuilder::kMaxVertices, MeshletBuilder::kMaxTriangles);
+  testCull();
+  return testResult("test_meshlet_builder");
+}
@@ -0,0 +1,218 @@
+/*
+ * ObjReader::load (archivo mapeado y parser propio) contra loadLegacy
+ * (getline + stringstream + stof), y load con varios hilos contra un
+ * solo hilo: la misma malla byte por byte.
+ */
+#include "TestCheck.h"
+#include "ObjTestFiles.h"
+#include "OBJReader.h"
+
+#include <cstring>
+#include <vector>
+
+// Vrtices e ndices iguales byte por byte.
+static bool
+sameGeometry(const MeshComponent& a, const MeshComponent& b) {
+  return a.m_vertex.size() == b.m_vertex.size() &&
+    a.m_index == b.m_index &&
+    a.m_numVertex == b.m_numVertex &&
+    a.m_numIndex == b.m_numIndex &&
+    (a.m_vertex.empty() ||
+      std::memcmp(a.m_vertex.data(), b.m_vertex.data(), a.m_vertex.size() * sizeof(SimpleVertex)) == 0);
+}
+
+// Rejillas con y sin vt / vn, con la V invertida y sin invertir.
+static void
+testMatchesLegacy() {
+  const ObjGridOptions variants[3] = {
+    { true, true, 0 },
+    { true, false, 0 },
+    { false, true, 0 } };
+  for (int v = 0; v < 3; ++v) {
+    const std::string path = testTempPath("legacy_" + std::to_string(v) + ".obj");
+    CHECK(writeGridObj(path, 40, 30, variants[v]));
+    for (int flip = 0; flip < 2; ++flip) {
+      ObjReader reader;
+      MeshComponent fast;
+      MeshComponent legacy;
+      CHECK(reader.load(path, fast, flip != 0));
+      CHECK(reader.loadLegacy(path, legacy, flip != 0));
+      CHECK(fast.m_numIndex == 40 * 30 * 6);
+      CHECK(sameGeometry(fast, legacy));
+    }
+  }
+}
+
+// Nmeros escritos de todas las formas que acepta stof, comentarios,
+// espacios de ms, CRLF y caras de ms de cuatro esquinas.
+static void
+testNumberFormats() {
+  const std::string path = testTempPath("formats.obj");
+  FILE* file = std::fopen(path.c_str(), "wb");
+  CHECK(file != nullptr);
+  if (!file) return;
+  std::fputs(
+    "# comentario\r\n"
+    "v 1 2 3\r\n"
+    "v -0.5 +.25 1e-3\n"
+    "v\t1.5E+2   -2.e1 0.000001\n"
+    "v 3.14159265358979 -1234567.875 7\n"
+    "v .5 5. -0\n"
+    "vt 0.25 0.75\n"
+    "vt 1 0\n"
+    "vt 0.1 0.9 0\n"
+    "  # comentario con espacios\n"
+    "f 1/1 2/2 3/3\n"
+    "f 2/2 3/3 4/1 5/2 1/1\r\n"
+    "f   1/3   3/1   5/2  \n",
+    file);
+  std::fclose(file);
+
+  for (int flip = 0; flip < 2; ++flip) {
+    ObjReader reader;
+    MeshComponent fast;
+    MeshComponent legacy;
+    CHECK(reader.load(path, fast, flip != 0));
+    CHECK(reader.loadLegacy(path, legacy, flip != 0));
+    CHECK(fast.m_numIndex == 15);
+    CHECK(sameGeometry(fast, legacy));
+  }
+}
+
+// Guarda cada esquina de los lotes de loadStreaming como vrtice suelto.
+class CornerSink : public IObjBatchSink {
+public:
+  bool onBatch(const ObjMeshBatch& batch) override {
+    for (size_t i = 0; i < batch.indexCount; ++i) corners.push_back(batch.vertices[batch.indices[i]]);
+    return true;
+  }
+
+  std::vector<SimpleVertex> corners;
+};
+
+/*
+ * La misma tupla escrita de tres formas ("1/2/3", "01/2/3" y la relativa
+ * "-4/-1/-1") es un solo vrtice en load, que compara los ndices ya
+ * parseados; loadLegacy compara el texto y hace tres. Un vn fuera de rango
+ * cuenta igual que no ponerlo.
+ */
+static void
+testEquivalentTuples() {
+  const std::string path = testTempPath("tuples.obj");
+  FILE* file = std::fopen(path.c_str(), "wb");
+  CHECK(file != nullptr);
+  if (!file) return;
+  std::fputs(
+    "v 0 0 0\n"
+    "v 1 0 0\n"
+    "v 0 1 0\n"
+    "v 1 1 0\n"
+    "vt 0.5 0.5\n"
+    "vt 0.25 0.75\n"
+    "vn 0 0 1\n"
+    "vn 0 1 0\n"
+    "vn 1 0 0\n"
+    "f 1/2/3 2/1/1 3/1/1\n"
+    "f 01/2/3 3/1/1 4/1/1\n"
+    "f -4/-1/-1 4/1/1 2/1/1\n"
+    "f 2/2/9 3/2 4/2/2\n"
+    "f 2/2 4/2/2 1/1/1\n",
+    file);
+  std::fclose(file);
+
+  ObjReader reader;
+  MeshComponent fast;
+  MeshComponent legacy;
+  CHECK(reader.load(path, fast, false));
+  CHECK(reader.loadLegacy(path, legacy, false));
+  CHECK(fast.m_numIndex == 15 && legacy.m_numIndex == 15);
+  if (fast.m_index.size() != 15 || legacy.m_index.size() != 15) return;
+
+  // Primera esquina de las tres primeras caras: el mismo vrtice en load
+  CHECK(fast.m_index[0] == fast.m_index[3] && fast.m_index[0] == fast.m_index[6]);
+  CHECK(legacy.m_index[0] != legacy.m_index[3] && legacy.m_index[3] != legacy.m_index[6] &&
+    legacy.m_index[0] != legacy.m_index[6]);
+  // "2/2/9" (vn 9 no existe) y "2/2" son el mismo vrtice en load
+  CHECK(fast.m_index[9] == fast.m_index[12]);
+  CHECK(legacy.m_index[9] != legacy.m_index[12]);
+
+  // Tuplas distintas en load: 1/2/3, 2/1/1, 3/1/1, 4/1/1, 2/2/-, 3/2/-, 4/2/2, 1/1/1.
+  // loadLegacy suma dos por 01/2/3 y -4/-1/-1 y una por 2/2
+  CHECK(fast.m_numVertex == 8);
+  CHECK(legacy.m_numVertex == 11);
+
+  // Lo que se dibuja es lo mismo: cada esquina tiene la misma posicin y UV
+  bool samePoints = true;
+  for (size_t i = 0; i < 15; ++i) {
+    const SimpleVertex& a = fast.m_vertex[fast.m_index[i]];
+    const SimpleVertex& b = legacy.m_vertex[legacy.m_index[i]];
+    samePoints = samePoints && std::memcmp(&a, &b, sizeof(SimpleVertex)) == 0;
+  }
+  CHECK(samePoints);
+
+  // loadStreaming resuelve los negativos igual
+  CornerSink sink;
+  CHECK(reader.loadStreaming(path, sink, 1024, false));
+  bool sameCorners = sink.corners.size() == 15;
+  for (size_t i = 0; sameCorners && i < 15; ++i) {
+    sameCorners = std::memcmp(&sink.corners[i], &fast.m_vertex[fast.m_index[i]], sizeof(SimpleVertex)) == 0;
+  }
+  CHECK(sameCorners);
+}
+
+// Mismos rangos por material (nombre, inicio y cantidad).
+static bool
+sameSubMeshes(const MeshComponent& a, const MeshComponent& b) {
+  if (a.m_subMeshes.size() != b.m_subMeshes.size()) return false;
+  for (size_t i = 0; i < a.m_subMeshes.size(); ++i) {
+    if (a.m_subMeshes[i].materialName != b.m_subMeshes[i].materialName ||
+      a.m_subMeshes[i].startIndex != b.m_subMeshes[i].startIndex ||
+      a.m_subMeshes[i].indexCount != b.m_subMeshes[i].indexCount) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Los bloques son de al menos 1 MB, as que el archivo tiene que pasar de
+// varios MB para que de verdad se parta. Con y sin materiales (los cambios
+// de usemtl caen en bloques distintos) y con y sin pre-escaneo.
+static void
+testThreadsMatchSerial() {
+  const std::string paths[2] = { testTempPath("threads.obj"), testTempPath("threads_mtl.obj") };
+  ObjGridOptions withMaterials;
+  withMaterials.materials = 3;
+  CHECK(writeGridObj(paths[0], 400, 300));
+  CHECK(writeGridObj(paths[1], 400, 300, withMaterials));
+
+  for (const std::string& path : paths) {
+    for (int preScan = 0; preScan < 2; ++preScan) {
+      ObjReader reader;
+      reader.setPreScan(preScan != 0);
+      MeshComponent serial;
+      reader.setThreadCount(1);
+      CHECK(reader.load(path, serial));
+
+      const unsigned int threadCounts[] = { 2, 3, 4, 8, 16 };
+      for (unsigned int threads : threadCounts) {
+        MeshComponent parallel;
+        reader.setThreadCount(threads);
+        CHECK(reader.load(path, parallel));
+        // (nunca ms hilos que bloques de 1 MB)
+        CHECK(reader.getLastStats().threads > 1 && reader.getLastStats().threads <= threads);
+        CHECK(sameGeometry(serial, parallel));
+        CHECK(sameSubMeshes(serial, parallel));
+        CHECK(serial.m_name == parallel.m_name);
+      }
+    }
+  }
+}
+
+int
+main() {
+  testMatchesLegacy();
+  testNumberFormats();
+  testEquivalentTuples();
+  testThreadsMatchSerial();
+  return testResult("test_obj_reader");
+}
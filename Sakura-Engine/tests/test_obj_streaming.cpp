@@ -0,0 +1,138 @@
+/*
+ * ObjReader::loadStreaming sobre un .obj grande generado: cada lote se lee
+ * completo dentro del sink (ndices dentro del lote, vrtices vlidos), los
+ * tringulos suman lo mismo que load, y el pico de RSS del proceso queda
+ * acotado por peakWorkingSetBytes ms la ventana del archivo, muy por debajo
+ * del tamao del archivo.
+ */
+#include "TestCheck.h"
+#include "ObjTestFiles.h"
+#include "OBJReader.h"
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+static const unsigned int kColumns = 800;
+static const unsigned int kRows = 800;
+
+// Lee una lnea "Clave:   1234 kB" de /proc/self/status, en bytes (0 si no existe).
+static size_t
+procStatusBytes(const char* key) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  const size_t keyLength = std::strlen(key);
+  while (std::getline(status, line)) {
+    if (line.compare(0, keyLength, key) == 0 && line.size() > keyLength && line[keyLength] == ':') {
+      return static_cast<size_t>(std::strtoull(line.c_str() + keyLength + 1, nullptr, 10)) * 1024;
+    }
+  }
+  return 0;
+}
+
+// Reinicia VmHWM para medir solo la carga. Si el kernel no lo permite, el
+// pico se toma de las muestras que hace el sink en cada lote.
+static bool
+resetPeakRss() {
+  std::ofstream clearRefs("/proc/self/clear_refs");
+  clearRefs << "5";
+  clearRefs.flush();
+  return clearRefs.good();
+}
+
+// Sink que recorre cada lote completo mientras es vlido.
+class CheckingSink : public IObjBatchSink {
+public:
+  bool onBatch(const ObjMeshBatch& batch) override {
+    if (batch.batchIndex != batches || batch.firstTriangle != triangles ||
+      batch.indexCount % 3 != 0 || batch.vertexCount == 0) {
+      ++badBatches;
+    }
+    for (size_t i = 0; i < batch.indexCount; ++i) {
+      if (batch.indices[i] >= batch.vertexCount) {
+        ++badIndices;
+      }
+    }
+    for (size_t i = 0; i < batch.vertexCount; ++i) {
+      const SimpleVertex& vertex = batch.vertices[i];
+      checksum += vertex.Pos.x + vertex.Pos.y + vertex.Pos.z + vertex.Tex.x + vertex.Tex.y;
+      if (!std::isfinite(vertex.Pos.x) || vertex.Tex.x < 0.0f || vertex.Tex.x > 1.0f) {
+        ++badVertices;
+      }
+    }
+    triangles += batch.indexCount / 3;
+    ++batches;
+
+    const size_t rss = procStatusBytes("VmRSS");
+    if (rss > sampledPeakRss) sampledPeakRss = rss;
+    return batches != stopAfter;
+  }
+
+  size_t batches = 0;
+  size_t triangles = 0;
+  size_t badBatches = 0;
+  size_t badIndices = 0;
+  size_t badVertices = 0;
+  size_t stopAfter = 0;   // 0 = no cancelar.
+  size_t sampledPeakRss = 0;
+  double checksum = 0.0;
+};
+
+// Todos los tringulos llegan y la memoria del proceso no crece con el archivo.
+static void
+testLargeFileBound(const std::string& path) {
+  const size_t fileBytes = static_cast<size_t>(std::filesystem::file_size(path));
+  for (int preScan = 0; preScan < 2; ++preScan) {
+    ObjReader reader;
+    reader.setPreScan(preScan != 0);
+    CheckingSink sink;
+
+    const size_t rssBefore = procStatusBytes("VmRSS");
+    const bool peakReset = resetPeakRss();
+    CHECK(reader.loadStreaming(path, sink, 16384));
+    const size_t peakRss = peakReset ? procStatusBytes("VmHWM") : sink.sampledPeakRss;
+
+    const ObjLoadStats& stats = reader.getLastStats();
+    CHECK(sink.triangles == static_cast<size_t>(kColumns) * kRows * 2);
+    CHECK(sink.batches == stats.batches);
+    CHECK(sink.batches >= sink.triangles / 16384);
+    CHECK(sink.badBatches == 0);
+    CHECK(sink.badIndices == 0);
+    CHECK(sink.badVertices == 0);
+    CHECK(stats.peakWorkingSetBytes > 0);
+
+    // Margen: la ventana del archivo que sigue residente (4 MB), el heap
+    // que el allocator no devuelve y las muestras de /proc.
+    const size_t slack = 24u << 20;
+    const size_t growth = (peakRss > rssBefore) ? peakRss - rssBefore : 0;
+    std::printf("preScan=%d archivo=%zu MB pico RSS +%zu MB peakWorkingSet=%zu MB (%s)\n",
+      preScan, fileBytes >> 20, growth >> 20, stats.peakWorkingSetBytes >> 20,
+      peakReset ? "VmHWM" : "muestras");
+    CHECK(growth <= stats.peakWorkingSetBytes + slack);
+    CHECK(growth < fileBytes / 2);
+  }
+}
+
+// Si el sink regresa false la carga se detiene en ese lote.
+static void
+testCancel(const std::string& path) {
+  ObjReader reader;
+  CheckingSink sink;
+  sink.stopAfter = 2;
+  CHECK(!reader.loadStreaming(path, sink, 1000));
+  CHECK(sink.batches == 2);
+  CHECK(sink.triangles == 2000);
+  CHECK(sink.badIndices == 0);
+}
+
+int
+main() {
+  const std::string path = testTempPath("streaming_large.obj");
+  CHECK(writeGridObj(path, kColumns, kRows));
+  testLargeFileBound(path);
+  testCancel(path);
+  std::filesystem::remove(path);
+  return testResult("test_obj_streaming");
+}
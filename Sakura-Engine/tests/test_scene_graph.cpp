@@ -0,0 +1,148 @@
+/*
+ * SceneGraph::forEachUpdated, que usa el sistema Actors para visitar solo
+ * los actores que se movieron: despus de cada update debe pasar
+ * exactamente por los nodos a los que les cambi getWorldVersion, una vez
+ * cada uno, y sus matrices mundo deben ser las de multiplicar la cadena de
+ * padres. Se prueba con un solo hilo y repartiendo en el SystemScheduler
+ * (ah los subrboles grandes se parten en tareas).
+ */
+#include "TestCheck.h"
+#include "ECS/SystemScheduler.h"
+#include "SceneGraph.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Traslacin (vectores fila: la traslacin va en el ltimo rengln).
+static void
+translation(float x, float y, float matrix[16]) {
+  for (int i = 0; i < 16; ++i) matrix[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+  matrix[12] = x;
+  matrix[13] = y;
+}
+
+// Con puras traslaciones la matriz mundo es la suma de las locales de la cadena.
+static bool
+worldMatchesChain(const SceneGraph& graph, uint32_t node, const std::vector<float>& localX,
+  const std::vector<float>& localY) {
+  float x = 0.0f, y = 0.0f;
+  for (uint32_t n = node; n != SceneGraph::kInvalidNode; n = graph.getParent(n)) {
+    x += localX[n];
+    y += localY[n];
+  }
+  const float* world = graph.getWorld(node);
+  return std::fabs(world[12] - x) < 1.0e-3f && std::fabs(world[13] - y) < 1.0e-3f;
+}
+
+// Mueve nodos al azar, hace update y compara lo que visita forEachUpdated
+// contra los nodos cuya versin cambi.
+static void
+testUpdatedNodes(unsigned int threads) {
+  SceneGraph graph;
+  SystemScheduler scheduler(threads);
+  const SceneGraph::ParallelFor parallelFor = [&](size_t count, const std::function<void(size_t, size_t)>& fn) {
+    scheduler.parallelFor(count, 1, fn);
+  };
+
+  // Bosque de 40,000 nodos: cada uno cuelga de uno anterior al azar o es raz
+  const size_t count = 40000;
+  std::mt19937 random(11);
+  std::vector<uint32_t> nodes(count);
+  std::vector<int> owners(count);
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t parent = (i == 0 || random() % 50 == 0) ? SceneGraph::kInvalidNode : nodes[random() % i];
+    nodes[i] = graph.create(parent);
+    owners[i] = static_cast<int>(i);
+    graph.setUserData(nodes[i], &owners[i]);
+  }
+  std::vector<float> localX(count, 0.0f), localY(count, 0.0f);
+
+  size_t maxUpdated = 0, minUpdated = count;
+  unsigned int maxThreads = 0;
+  for (int frame = 0; frame < 12; ++frame) {
+    // Unos frames mueven pocos nodos, otros la mitad (as se reparte en tareas)
+    const size_t moves = frame % 3 == 0 ? count / 2 : 1 + random() % 200;
+    for (size_t m = 0; m < moves; ++m) {
+      const uint32_t node = nodes[random() % count];
+      localX[node] = static_cast<float>(random() % 100);
+      localY[node] = static_cast<float>(random() % 100);
+      float matrix[16];
+      translation(localX[node], localY[node], matrix);
+      graph.setLocal(node, matrix);
+    }
+
+    std::vector<uint32_t> before(count);
+    for (size_t i = 0; i < count; ++i) before[i] = graph.getWorldVersion(nodes[i]);
+    graph.update(threads, parallelFor);
+
+    std::vector<int> visits(count, 0);
+    size_t visited = 0;
+    bool ownersOk = true;
+    graph.forEachUpdated([&](uint32_t node) {
+      ++visits[node];
+      ++visited;
+      ownersOk = ownersOk && graph.getUserData(node) == &owners[node];
+    });
+    CHECK(ownersOk);
+    CHECK(visited == graph.getLastStats().updatedNodes);
+
+    bool sameNodes = true, worldOk = true;
+    for (size_t i = 0; i < count; ++i) {
+      const bool changed = graph.getWorldVersion(nodes[i]) != before[i];
+      sameNodes = sameNodes && visits[nodes[i]] == (changed ? 1 : 0);
+      worldOk = worldOk && worldMatchesChain(graph, nodes[i], localX, localY);
+    }
+    CHECK(sameNodes);
+    CHECK(worldOk);
+    if (visited > maxUpdated) maxUpdated = visited;
+    if (visited < minUpdated) minUpdated = visited;
+    if (graph.getLastStats().threads > maxThreads) maxThreads = graph.getLastStats().threads;
+  }
+  CHECK(minUpdated < count / 10);
+  // Con varios hilos los frames grandes se reparten
+  CHECK(maxThreads == threads);
+
+  // Sin cambios no visita nada
+  graph.update(threads, parallelFor);
+  size_t idle = 0;
+  graph.forEachUpdated([&](uint32_t) { ++idle; });
+  CHECK(idle == 0);
+  std::printf("%u hilos: de %zu a %zu nodos recalculados por update\n", threads, minUpdated, maxUpdated);
+}
+
+// destroy mueve slots: los rangos del ltimo update se descartan y el nodo
+// reciclado empieza sin dato del usuario.
+static void
+testDestroy() {
+  SceneGraph graph;
+  int data[3] = { 0, 1, 2 };
+  uint32_t nodes[3];
+  for (int i = 0; i < 3; ++i) {
+    nodes[i] = graph.create(i == 0 ? SceneGraph::kInvalidNode : nodes[0]);
+    graph.setUserData(nodes[i], &data[i]);
+  }
+  graph.update(1);
+  size_t visited = 0;
+  graph.forEachUpdated([&](uint32_t) { ++visited; });
+  CHECK(visited == 3);
+
+  graph.destroy(nodes[1]);
+  visited = 0;
+  graph.forEachUpdated([&](uint32_t) { ++visited; });
+  CHECK(visited == 0);
+  CHECK(graph.getUserData(nodes[1]) == nullptr);
+
+  const uint32_t reused = graph.create();
+  CHECK(reused == nodes[1]);
+  CHECK(graph.getUserData(reused) == nullptr);
+  CHECK(graph.getUserData(nodes[2]) == &data[2]);
+}
+
+int
+main() {
+  testUpdatedNodes(1);
+  testUpdatedNodes(4);
+  testDestroy();
+  return testResult("test_scene_graph");
+}
@@ -0,0 +1,164 @@
+/*
+ * VertexCompression: los kernels (half, snorm16, unorm16, octadrica) con
+ * cantidades que no son mltiplo de 4 para pasar por SSE2 y por el resto
+ * escalar, y compress/decompress de una malla con su reporte de error.
+ */
+#include "TestCheck.h"
+#include "VertexCompression.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+static const size_t kCount = 1027;
+
+static void
+testHalf() {
+  // Valores que half representa exactos
+  const float exact[7] = { 0.0f, 1.0f, -2.0f, 0.5f, 65504.0f, -0.25f, 1024.0f };
+  uint16_t encoded[7];
+  float decoded[7];
+  VertexCompression::encodeHalf(exact, 7, encoded);
+  VertexCompression::decodeHalf(encoded, 7, decoded);
+  for (int i = 0; i < 7; ++i) CHECK(decoded[i] == exact[i]);
+
+  // Error relativo de a lo ms media unidad del ltimo bit (2^-11)
+  std::mt19937 random(3);
+  std::uniform_real_distribution<float> value(-100.0f, 100.0f);
+  std::vector<float> in(kCount), out(kCount);
+  std::vector<uint16_t> halves(kCount);
+  for (float& v : in) v = value(random);
+  VertexCompression::encodeHalf(in.data(), kCount, halves.data());
+  VertexCompression::decodeHalf(halves.data(), kCount, out.data());
+  for (size_t i = 0; i < kCount; ++i) {
+    CHECK(std::fabs(out[i] - in[i]) <= std::fabs(in[i]) * (1.0f / 2048.0f) + 1.0e-7f);
+  }
+}
+
+static void
+testNormalized() {
+  std::mt19937 random(5);
+  std::uniform_real_distribution<float> value(-1.2f, 1.2f);
+  std::vector<float> in(kCount), out(kCount);
+  std::vector<int16_t> snorm(kCount);
+  std::vector<uint16_t> unorm(kCount);
+  for (float& v : in) v = value(random);
+
+  VertexCompression::encodeSnorm16(in.data(), kCount, snorm.data());
+  VertexCompression::decodeSnorm16(snorm.data(), kCount, out.data());
+  for (size_t i = 0; i < kCount; ++i) {
+    const float clamped = std::fmin(1.0f, std::fmax(-1.0f, in[i]));
+    CHECK(std::fabs(out[i] - clamped) <= 0.5f / 32767.0f + 1.0e-7f);
+  }
+
+  VertexCompression::encodeUnorm16(in.data(), kCount, unorm.data());
+  VertexCompression::decodeUnorm16(unorm.data(), kCount, out.data());
+  for (size_t i = 0; i < kCount; ++i) {
+    const float clamped = std::fmin(1.0f, std::fmax(0.0f, in[i]));
+    CHECK(std::fabs(out[i] - clamped) <= 0.5f / 65535.0f + 1.0e-7f);
+  }
+}
+
+// Vectores unitarios en todos los octantes: regresan unitarios y casi iguales.
+static void
+testOctahedral() {
+  std::mt19937 random(9);
+  std::normal_distribution<float> gauss;
+  std::vector<float> in(kCount * 3), out(kCount * 3);
+  std::vector<int16_t> encoded(kCount * 2);
+  for (size_t i = 0; i < kCount; ++i) {
+    float v[3] = { gauss(random), gauss(random), gauss(random) };
+    const float length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    for (int k = 0; k < 3; ++k) in[i * 3 + k] = v[k] / length;
+  }
+  // Los ejes y el polo de abajo son los casos del doblez
+  const float axes[4][3] = { { 0, 0, 1 }, { 0, 0, -1 }, { 1, 0, 0 }, { 0, -1, 0 } };
+  for (int a = 0; a < 4; ++a) {
+    for (int k = 0; k < 3; ++k) in[a * 3 + k] = axes[a][k];
+  }
+
+  VertexCompression::encodeOctahedral(in.data(), kCount, encoded.data());
+  VertexCompression::decodeOctahedral(encoded.data(), kCount, out.data());
+  float worstAngle = 0.0f;
+  for (size_t i = 0; i < kCount; ++i) {
+    const float* a = &in[i * 3];
+    const float* b = &out[i * 3];
+    const float length = std::sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2]);
+    CHECK(std::fabs(length - 1.0f) < 1.0e-4f);
+    const float cosine = (a[0] * b[0] + a[1] * b[1] + a[2] * b[2]) / length;
+    worstAngle = std::fmax(worstAngle, std::acos(std::fmin(1.0f, cosine)));
+  }
+  CHECK(worstAngle < 1.0e-3f);
+}
+
+// Rejilla de 'side' x 'side' vrtices con uv de 0 a uvMax.
+static std::vector<float>
+gridVertices(int side, float uvMax) {
+  std::vector<float> vertices;
+  for (int y = 0; y < side; ++y) {
+    for (int x = 0; x < side; ++x) {
+      const float u = static_cast<float>(x) / (side - 1);
+      const float v = static_cast<float>(y) / (side - 1);
+      const float row[5] = { 10.0f * u - 3.0f, std::sin(7.0f * u) * std::cos(5.0f * v), 4.0f * v, uvMax * u, uvMax * v };
+      vertices.insert(vertices.end(), row, row + 5);
+    }
+  }
+  return vertices;
+}
+
+static void
+testCompress() {
+  for (int variant = 0; variant < 2; ++variant) {
+    // uv en [0, 1] -> PackedUnorm; uv repetida hasta 4 -> PackedHalf, que
+    // ah tiene pasos de 2^-9 y necesita ms tolerancia que la de omisin
+    const float uvMax = variant == 0 ? 1.0f : 4.0f;
+    VertexCompressionLimits limits;
+    if (variant == 1) limits.maxTexCoordError = 1.0f / 256.0f;
+    const std::vector<float> vertices = gridVertices(64, uvMax);
+    const size_t count = vertices.size() / 5;
+
+    std::vector<PackedVertex> packed;
+    VertexCompressionReport report;
+    const VertexFormat format = VertexCompression::compress(vertices.data(), count, 5 * sizeof(float),
+      limits, packed, &report);
+    CHECK(format == (variant == 0 ? VertexFormat::PackedUnorm : VertexFormat::PackedHalf));
+    CHECK(report.format == format);
+    CHECK(packed.size() == count);
+    CHECK(report.bytesAfter * 5 == report.bytesBefore * 3);   // 12 de 20 bytes
+    CHECK(report.maxTexCoordError <= limits.maxTexCoordError);
+    if (packed.size() != count) continue;
+
+    // El error medido al regresar a float es el que dice el reporte
+    std::vector<float> decoded(count * 5);
+    VertexCompression::decompress(packed.data(), count, report, decoded.data());
+    float positionError = 0.0f;
+    float texCoordError = 0.0f;
+    for (size_t i = 0; i < count * 5; ++i) {
+      const float error = std::fabs(decoded[i] - vertices[i]);
+      if (i % 5 < 3) positionError = std::fmax(positionError, error);
+      else texCoordError = std::fmax(texCoordError, error);
+    }
+    CHECK(positionError <= report.maxPositionError * 1.001f + 1.0e-6f);
+    CHECK(texCoordError <= report.maxTexCoordError * 1.001f + 1.0e-7f);
+  }
+
+  // Una tolerancia imposible deja la malla en Full
+  VertexCompressionLimits strict;
+  strict.maxPositionError = 1.0e-9f;
+  const std::vector<float> vertices = gridVertices(16, 1.0f);
+  std::vector<PackedVertex> packed;
+  VertexCompressionReport report;
+  CHECK(VertexCompression::compress(vertices.data(), vertices.size() / 5, 5 * sizeof(float), strict, packed, &report) ==
+    VertexFormat::Full);
+  CHECK(packed.empty());
+  CHECK(report.bytesAfter == report.bytesBefore);
+}
+
+int
+main() {
+  testHalf();
+  testNormalized();
+  testOctahedral();
+  testCompress();
+  return testResult("test_vertex_compression");
+}